@@ -0,0 +1,594 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____  _            _    __  __                                
+// |  _ \| |          | |  |  \/  |                               
+// | |_) | | ___   ___| | _| \  / | __ _ _ __     ___ _ __  _ __  
+// |  _ <| |/ _ \ / __| |/ / |\/| |/ _` | '_ \   / __| '_ \| '_ \ 
+// | |_) | | (_) | (__|   <| |  | | (_| | |_) |_| (__| |_) | |_) |
+// |____/|_|\___/ \___|_|\_\_|  |_|\__,_| .__/(_)\___| .__/| .__/ 
+//                                      | |          | |   | |    
+//                                      |_|          |_|   |_|    
+//
+// Description:
+//
+//   Per-block fingerprints of a set's data files
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "BlockMap.h"
+#include "OverlappedRead.h"
+#include "Crc32c.h"
+#include "EngineStats.h"
+
+#ifdef	_LINUX
+#include <pthread.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	char	blockMapIdentifier[8] = "FSRBMAP";
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Shared state for the quick-check worker threads
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	struct	tag_quick_check_job
+{
+	const	BlockMap *		blockMap;
+	const	DataFileArray *		dataFiles;
+	const	fstl::intArray *	indices;
+		fstl::boolArray *	passed;
+		EngineStats *		stats;
+		Trace *			trace;
+	volatile LONG			nextIndex;
+	volatile LONG			kChecked;
+	volatile LONG			finished;
+	volatile bool			cancelled;
+} QuickCheckJob;
+
+#ifndef	_LINUX
+static	DWORD	WINAPI	quickCheckThread(LPVOID param)
+#else
+static	void *		quickCheckThread(void * param)
+#endif
+{
+	QuickCheckJob &	job = *reinterpret_cast<QuickCheckJob *>(param);
+	EngineStatsScope	statsScope(job.stats);
+	TraceScope		traceScope(job.trace);
+
+	// Each thread grabs the next unchecked file until they're all gone
+
+	for(;;)
+	{
+		LONG	i = InterlockedIncrement(&job.nextIndex) - 1;
+		if (i >= static_cast<LONG>(job.indices->size()) || job.cancelled) break;
+
+		unsigned int	index = (*job.indices)[i];
+		(*job.passed)[i] = job.blockMap->quickCheckFile(index, (*job.dataFiles)[index], job.kChecked, job.cancelled);
+	}
+
+	InterlockedIncrement(&job.finished);
+	return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BlockMap::BlockMap()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BlockMap::~BlockMap()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BlockMap::reset()
+{
+	fileSizes().erase();
+	blockHashes().erase();
+	blockCrcs().erase();
+	pending().erase();
+	pendingLengths().erase();
+	pendingCrcs().erase();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BlockMap::start(const DataFileArray & dataFiles)
+{
+	reset();
+
+	fileSizes().reserve(dataFiles.size());
+	blockHashes().reserve(dataFiles.size());
+	blockCrcs().reserve(dataFiles.size());
+	for (unsigned int i = 0; i < dataFiles.size(); ++i)
+	{
+		fileSizes() += dataFiles[i].fileSize();
+		blockHashes() += fstl::ucharArray();
+		blockHashes()[i].reserve(blockCount(dataFiles[i].fileSize()) * EmDeeFive::HASH_SIZE_IN_BYTES);
+		blockCrcs() += fstl::uintArray();
+		blockCrcs()[i].reserve(blockCount(dataFiles[i].fileSize()));
+	}
+
+	pending().populate(EmDeeFive(), dataFiles.size());
+	pendingLengths().populate(0, dataFiles.size());
+	pendingCrcs().populate(0, dataFiles.size());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::process(const unsigned int index, const unsigned char * data, const unsigned int length)
+{
+	if (index >= pending().size()) return false;
+
+	// Split the data up along block boundaries
+
+	unsigned int	remaining = length;
+	while(remaining)
+	{
+		unsigned int	count = fstl::min(remaining, BLOCK_SIZE - pendingLengths()[index]);
+		if (!pending()[index].processBits(data, count * 8)) return false;
+		pendingCrcs()[index] = Crc32c::update(pendingCrcs()[index], data, count);
+
+		pendingLengths()[index] += count;
+		data += count;
+		remaining -= count;
+
+		if (pendingLengths()[index] == BLOCK_SIZE && !flush(index)) return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::flush(const unsigned int index)
+{
+	pending()[index].finish();
+	const unsigned char *	hash = pending()[index].getHash();
+	if (!hash) return false;
+
+	for (unsigned int i = 0; i < EmDeeFive::HASH_SIZE_IN_BYTES; ++i)
+	{
+		blockHashes()[index] += hash[i];
+	}
+	blockCrcs()[index] += pendingCrcs()[index];
+
+	pending()[index].start();
+	pendingLengths()[index] = 0;
+	pendingCrcs()[index] = 0;
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::finish()
+{
+	// Take care of the partial blocks at the ends of the files
+
+	for (unsigned int i = 0; i < pending().size(); ++i)
+	{
+		if (pendingLengths()[i] && !flush(i)) return false;
+
+		// Make sure we saw all of the file
+
+		if (blockHashes()[i].size() != blockCount(fileSizes()[i]) * EmDeeFive::HASH_SIZE_IN_BYTES) return false;
+	}
+
+	pending().erase();
+	pendingLengths().erase();
+	pendingCrcs().erase();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::read(const fstl::wstring & filespec, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const DataFileArray & dataFiles)
+{
+	reset();
+
+	FILE *	fp = NULL;
+
+	try
+	{
+		fp = _wfopen(filespec.asArray(), _T("rb"));
+		if (!fp) throw false;
+
+		// The map has to belong to this set (a set hash covers the data file hashes, so if it matches, the sizes should too)
+
+		BlockMapHeader	header;
+		if (fread(&header, sizeof(header), 1, fp) != 1) throw false;
+		if (memcmp(header.identifier, blockMapIdentifier, sizeof(header.identifier))) throw false;
+		if (header.version < 1 || header.version > VERSION || header.blockSize != BLOCK_SIZE) throw false;
+		if (memcmp(header.setHash, setHash, EmDeeFive::HASH_SIZE_IN_BYTES)) throw false;
+		if (header.fileCount != dataFiles.size()) throw false;
+
+		for (unsigned int i = 0; i < header.fileCount; ++i)
+		{
+			unsigned int	fileSize;
+			if (fread(&fileSize, sizeof(fileSize), 1, fp) != 1) throw false;
+			if (fileSize != dataFiles[i].fileSize()) throw false;
+
+			fstl::ucharArray	hashes;
+			unsigned int		hashBytes = blockCount(fileSize) * EmDeeFive::HASH_SIZE_IN_BYTES;
+			if (hashBytes)
+			{
+				hashes.resize_uninitialized(hashBytes);
+				if (fread(&hashes[0], hashBytes, 1, fp) != 1) throw false;
+			}
+
+			fileSizes() += fileSize;
+			blockHashes() += fstl::move(hashes);
+
+			// Version 2 added a CRC32C per block (for quick checks), a version 1 map just won't have them
+
+			if (header.version >= 2)
+			{
+				fstl::uintArray	crcs;
+				if (blockCount(fileSize))
+				{
+					crcs.resize_uninitialized(blockCount(fileSize));
+					if (fread(&crcs[0], crcs.size() * sizeof(unsigned int), 1, fp) != 1) throw false;
+				}
+
+				blockCrcs() += fstl::move(crcs);
+			}
+		}
+
+		fclose(fp);
+	}
+	catch (const bool)
+	{
+		// No map (or not one for this set) isn't an error, it just means we won't be able to do partial repairs
+
+		if (fp) fclose(fp);
+		reset();
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::write(const fstl::wstring & filespec, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES]) const
+{
+	if (!isLoaded()) return false;
+
+	FILE *	fp = _wfopen(filespec.asArray(), _T("wb"));
+	if (!fp) return false;
+
+	BlockMapHeader	header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.identifier, blockMapIdentifier, sizeof(header.identifier));
+	header.version = hasCrcs() ? VERSION : 1;
+	header.blockSize = BLOCK_SIZE;
+	memcpy(header.setHash, setHash, EmDeeFive::HASH_SIZE_IN_BYTES);
+	header.fileCount = fileSizes().size();
+
+	bool	ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	for (unsigned int i = 0; ok && i < fileSizes().size(); ++i)
+	{
+		ok = fwrite(&fileSizes()[i], sizeof(unsigned int), 1, fp) == 1;
+		if (ok && blockHashes()[i].size()) ok = fwrite(&blockHashes()[i][0], blockHashes()[i].size(), 1, fp) == 1;
+		if (ok && hasCrcs() && blockCrcs()[i].size()) ok = fwrite(&blockCrcs()[i][0], blockCrcs()[i].size() * sizeof(unsigned int), 1, fp) == 1;
+	}
+
+	fclose(fp);
+	return ok;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::mapDamage(const unsigned int index, const DataFile & df, fstl::boolArray & damaged, progressCallback callback, void * callbackData) const
+{
+	if (index >= fileSizes().size()) return false;
+
+	// Everything is damaged until proven otherwise (that way, anything past the end of a short file counts as damaged)
+
+	unsigned int	blocks = blockCount(fileSizes()[index]);
+	damaged.erase();
+	damaged.populate(true, blocks);
+
+	fstl::wstring	spec;
+	if (!doesFileExist(df.filespec(spec))) return true;
+
+	OverlappedRead	overlappedRead;
+	if (!overlappedRead.open(spec, 0, fileSizes()[index])) return true;
+	if (!overlappedRead.startRead()) return false;
+
+	EmDeeFive	md5;
+	unsigned int	block = 0;
+	unsigned int	blockLength = 0;
+	for(;;)
+	{
+		// Keep the user informed
+
+		float	percent = static_cast<float>(overlappedRead.bytesRead()) / static_cast<float>(fstl::max(fileSizes()[index], 1U)) * 100.0f;
+		if (callback && !callback(callbackData, _T("Mapping damaged blocks..."), percent)) return false;
+
+		unsigned int	readCount;
+		unsigned char *	ptr = overlappedRead.finishRead(readCount);
+		if (!ptr) return false;
+		if (!readCount) break;
+
+		if (!overlappedRead.startRead()) return false;
+
+		// Hash each block and compare it to the map (the reads are 64K, so they never straddle a block boundary)
+
+		md5.processBits(ptr, readCount * 8);
+		blockLength += readCount;
+
+		unsigned int	expectedLength = fstl::min(static_cast<unsigned int>(BLOCK_SIZE), fileSizes()[index] - block * BLOCK_SIZE);
+		if (blockLength >= expectedLength)
+		{
+			md5.finish();
+			damaged[block] = memcmp(md5.getHash(), &blockHashes()[index][block * EmDeeFive::HASH_SIZE_IN_BYTES], EmDeeFive::HASH_SIZE_IN_BYTES) != 0;
+
+			md5.start();
+			blockLength = 0;
+			if (++block >= blocks) break;
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::rebuild(const unsigned int index, const DataFile & df)
+{
+	if (index >= fileSizes().size()) return false;
+
+	fileSizes()[index] = df.fileSize();
+	blockHashes()[index].erase();
+	if (hasCrcs()) blockCrcs()[index].erase();
+	if (!df.fileSize()) return true;
+
+	OverlappedRead	overlappedRead;
+	if (!overlappedRead.open(df.filespec())) return false;
+	if (!overlappedRead.startRead()) return false;
+
+	EmDeeFive	md5;
+	unsigned int	crc = 0;
+	unsigned int	blockLength = 0;
+	for(;;)
+	{
+		unsigned int	readCount;
+		unsigned char *	ptr = overlappedRead.finishRead(readCount);
+		if (!ptr) return false;
+		if (!readCount) break;
+
+		if (!overlappedRead.startRead()) return false;
+
+		md5.processBits(ptr, readCount * 8);
+		crc = Crc32c::update(crc, ptr, readCount);
+		blockLength += readCount;
+
+		if (blockLength == BLOCK_SIZE || overlappedRead.finishedReadingFile())
+		{
+			md5.finish();
+			const unsigned char *	hash = md5.getHash();
+			for (unsigned int i = 0; i < EmDeeFive::HASH_SIZE_IN_BYTES; ++i)
+			{
+				blockHashes()[index] += hash[i];
+			}
+			if (hasCrcs()) blockCrcs()[index] += crc;
+
+			md5.start();
+			crc = 0;
+			blockLength = 0;
+		}
+	}
+
+	return blockHashes()[index].size() == blockCount(fileSizes()[index]) * EmDeeFive::HASH_SIZE_IN_BYTES;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Checks a set of data files against their block CRCs, using one thread per CPU (each thread takes a whole file at a time), or
+// no more than 'maxThreads', if it's non-zero. For each entry in 'indices', 'passed' is set to true if the file checked out.
+// Returns false if the user cancelled.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::quickCheck(const DataFileArray & dataFiles, const fstl::intArray & indices, fstl::boolArray & passed, progressCallback callback, void * callbackData, const unsigned int maxThreads) const
+{
+	passed.erase();
+	passed.populate(false, indices.size());
+	if (!hasCrcs() || !indices.size()) return true;
+
+	// How much are we checking? (progress is counted in K, so a large set doesn't overflow the counter)
+
+	unsigned int	totalK = 0;
+	for (unsigned int i = 0; i < indices.size(); ++i)
+	{
+		totalK += dataFiles[indices[i]].fileSize() / 1024 + 1;
+		EngineStats::count(EngineStats::InputBytes, dataFiles[indices[i]].fileSize());
+	}
+	EngineStats::count(EngineStats::InputFiles, indices.size());
+
+	QuickCheckJob	job;
+	job.blockMap = this;
+	job.dataFiles = &dataFiles;
+	job.indices = &indices;
+	job.passed = &passed;
+	job.stats = EngineStats::current();
+	job.trace = Trace::current();
+	job.nextIndex = 0;
+	job.kChecked = 0;
+	job.finished = 0;
+	job.cancelled = false;
+
+	unsigned int	cpuCount = maxThreads ? maxThreads : getProcessorCount();
+
+#ifdef	_LINUX
+
+	// One thread per CPU (no more than we have files)
+
+	unsigned int	threadCount = fstl::min(cpuCount, indices.size());
+	if (!threadCount) threadCount = 1;
+
+	fstl::array<pthread_t>	threads;
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		pthread_t	t;
+		if (!pthread_create(&t, NULL, quickCheckThread, &job)) threads += t;
+	}
+
+	if (!threads.size())
+	{
+		quickCheckThread(&job);
+		return true;
+	}
+
+	// There's no timed wait-for-all, so the workers count themselves out as they finish
+
+	bool	result = true;
+	while(job.finished < static_cast<LONG>(threads.size()))
+	{
+		usleep(100000);
+
+		float	percent = static_cast<float>(job.kChecked) / static_cast<float>(totalK) * 100.0f;
+		if (callback && !callback(callbackData, _T("Quick-checking data files..."), fstl::min(percent, 100.0f)))
+		{
+			job.cancelled = true;
+			result = false;
+			break;
+		}
+	}
+
+	for (unsigned int i = 0; i < threads.size(); ++i)
+	{
+		pthread_join(threads[i], NULL);
+	}
+
+	return result;
+
+#else
+
+	// One thread per CPU (no more than we have files) -- WaitForMultipleObjects can't handle more than 64
+
+	unsigned int	threadCount = fstl::min(fstl::min(cpuCount, indices.size()), static_cast<unsigned int>(MAXIMUM_WAIT_OBJECTS));
+	if (!threadCount) threadCount = 1;
+
+	fstl::array<HANDLE>	threads;
+	for (unsigned int i = 0; i < threadCount; ++i)
+	{
+		DWORD	id;
+		HANDLE	h = CreateThread(NULL, 0, quickCheckThread, &job, 0, &id);
+		if (h) threads += h;
+	}
+
+	// If we couldn't start any threads, just do it ourselves
+
+	if (!threads.size())
+	{
+		quickCheckThread(&job);
+		return true;
+	}
+
+	// Keep the user informed while the workers do their thing
+
+	bool	result = true;
+	while(WaitForMultipleObjects(threads.size(), &threads[0], TRUE, 100) == WAIT_TIMEOUT)
+	{
+		float	percent = static_cast<float>(job.kChecked) / static_cast<float>(totalK) * 100.0f;
+		if (callback && !callback(callbackData, _T("Quick-checking data files..."), fstl::min(percent, 100.0f)))
+		{
+			job.cancelled = true;
+			result = false;
+			WaitForMultipleObjects(threads.size(), &threads[0], TRUE, INFINITE);
+			break;
+		}
+	}
+
+	for (unsigned int i = 0; i < threads.size(); ++i)
+	{
+		CloseHandle(threads[i]);
+	}
+
+	return result;
+
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Runs on a worker thread, so it must not touch anything but its own file (and the interlocked progress counter)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	BlockMap::quickCheckFile(const unsigned int index, const DataFile & df, volatile LONG & kChecked, volatile bool & cancelled) const
+{
+	if (index >= fileSizes().size() || index >= blockCrcs().size()) return false;
+
+	// The CRCs only cover the length we expect, so a file of the wrong length fails outright
+
+	fstl::wstring	spec;
+	if (!doesFileExist(df.filespec(spec))) return false;
+	if (getFileLength(spec) != fileSizes()[index]) return false;
+	if (!fileSizes()[index]) return true;
+
+	OverlappedRead	overlappedRead;
+	if (!overlappedRead.open(spec, 0, fileSizes()[index])) return false;
+	if (!overlappedRead.startRead()) return false;
+
+	unsigned int	blocks = blockCount(fileSizes()[index]);
+	unsigned int	block = 0;
+	unsigned int	blockLength = 0;
+	unsigned int	crc = 0;
+	while(!cancelled)
+	{
+		unsigned int	readCount;
+		unsigned char *	ptr = overlappedRead.finishRead(readCount);
+		if (!ptr) return false;
+		if (!readCount) break;
+
+		if (!overlappedRead.startRead()) return false;
+
+		crc = Crc32c::update(crc, ptr, readCount);
+		blockLength += readCount;
+		InterlockedExchangeAdd(const_cast<LONG *>(&kChecked), readCount / 1024);
+
+		// Bail on the first bad block -- the full check will sort out the details
+
+		unsigned int	expectedLength = fstl::min(static_cast<unsigned int>(BLOCK_SIZE), fileSizes()[index] - block * BLOCK_SIZE);
+		if (blockLength >= expectedLength)
+		{
+			if (crc != blockCrcs()[index][block]) return false;
+
+			crc = 0;
+			blockLength = 0;
+			if (++block >= blocks) return true;
+		}
+	}
+
+	return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// BlockMap.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,130 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____  _            _    __  __                _     
+// |  _ \| |          | |  |  \/  |              | |    
+// | |_) | | ___   ___| | _| \  / | __ _ _ __    | |__  
+// |  _ <| |/ _ \ / __| |/ / |\/| |/ _` | '_ \   | '_ \ 
+// | |_) | | (_) | (__|   <| |  | | (_| | |_) |_ | | | |
+// |____/|_|\___/ \___|_|\_\_|  |_|\__,_| .__/(_)|_| |_|
+//                                      | |             
+//                                      |_|             
+//
+// Description:
+//
+//   Per-block (1MB) fingerprints of a set's data files, stored in a sidecar next to the PAR file. These let us
+//   map the damage within a corrupt file, so only the damaged ranges need to be rebuilt. Each block also gets a
+//   CRC32C, which is far cheaper to check than an MD5, for quick (multi-threaded) scrubs of a set.
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_BLOCKMAP
+#define _H_BLOCKMAP
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "EmDeeFive.h"
+#include "DataFile.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	BlockMap
+{
+public:
+	// Enumerations
+
+		enum			{BLOCK_SIZE = 1024*1024};
+		enum			{VERSION = 2};
+
+	// Types
+
+		#pragma pack(1)
+		typedef	struct	tag_block_map_header
+		{
+			char		identifier[8];
+			unsigned int	version;
+			unsigned int	blockSize;
+			unsigned char	setHash[16];
+			unsigned int	fileCount;
+		} BlockMapHeader;
+		#pragma pack()
+
+	// Construction/Destruction
+
+					BlockMap();
+virtual					~BlockMap();
+
+	// Implementation
+
+virtual		void			reset();
+virtual		void			start(const DataFileArray & dataFiles);
+virtual		bool			process(const unsigned int index, const unsigned char * data, const unsigned int length);
+virtual		bool			finish();
+virtual		bool			read(const fstl::wstring & filespec, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const DataFileArray & dataFiles);
+virtual		bool			write(const fstl::wstring & filespec, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES]) const;
+virtual		bool			mapDamage(const unsigned int index, const DataFile & df, fstl::boolArray & damaged, progressCallback callback = NULL, void * callbackData = NULL) const;
+virtual		bool			rebuild(const unsigned int index, const DataFile & df);
+virtual		bool			quickCheck(const DataFileArray & dataFiles, const fstl::intArray & indices, fstl::boolArray & passed, progressCallback callback = NULL, void * callbackData = NULL, const unsigned int maxThreads = 0) const;
+virtual		bool			quickCheckFile(const unsigned int index, const DataFile & df, volatile LONG & kChecked, volatile bool & cancelled) const;
+
+static		unsigned int		blockCount(const unsigned int fileSize) {return (fileSize + BLOCK_SIZE - 1) / BLOCK_SIZE;}
+static		fstl::wstring		sidecarFilespec(const fstl::wstring & path, const fstl::wstring & baseName) {return path + PATH_SEPARATOR + baseName + _T(".fsb");}
+
+	// Accessors
+
+inline		fstl::uintArray &	fileSizes()			{return _fileSizes;}
+inline	const	fstl::uintArray &	fileSizes() const		{return _fileSizes;}
+inline		fstl::array<fstl::ucharArray> & blockHashes()		{return _blockHashes;}
+inline	const	fstl::array<fstl::ucharArray> & blockHashes() const	{return _blockHashes;}
+inline		fstl::array<fstl::uintArray> & blockCrcs()		{return _blockCrcs;}
+inline	const	fstl::array<fstl::uintArray> & blockCrcs() const	{return _blockCrcs;}
+inline		EmDeeFiveArray &	pending()			{return _pending;}
+inline	const	EmDeeFiveArray &	pending() const			{return _pending;}
+inline		fstl::uintArray &	pendingLengths()		{return _pendingLengths;}
+inline	const	fstl::uintArray &	pendingLengths() const		{return _pendingLengths;}
+inline		fstl::uintArray &	pendingCrcs()			{return _pendingCrcs;}
+inline	const	fstl::uintArray &	pendingCrcs() const		{return _pendingCrcs;}
+
+inline	const	bool			isLoaded() const		{return blockHashes().size() != 0;}
+inline	const	bool			hasCrcs() const			{return isLoaded() && blockCrcs().size() == blockHashes().size();}
+
+private:
+	// Private implementation
+
+virtual		bool			flush(const unsigned int index);
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					BlockMap(const BlockMap & rhs);
+inline		BlockMap &		operator =(const BlockMap & rhs);
+
+	// Data members
+
+		fstl::uintArray		_fileSizes;
+		fstl::array<fstl::ucharArray> _blockHashes;
+		fstl::array<fstl::uintArray> _blockCrcs;
+		EmDeeFiveArray		_pending;
+		fstl::uintArray		_pendingLengths;
+		fstl::uintArray		_pendingCrcs;
+};
+
+#endif // _H_BLOCKMAP
+// ---------------------------------------------------------------------------------------------------------------------------------
+// BlockMap.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
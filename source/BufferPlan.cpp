@@ -0,0 +1,314 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____         __  __          _____  _                                 
+// |  _ \       / _|/ _|        |  __ \| |                                
+// | |_) |_   _| |_| |_ ___ _ __| |__) | | __ _ _ __      ___ _ __  _ __  
+// |  _ <| | | |  _|  _/ _ \ '__|  ___/| |/ _` | '_ \    / __| '_ \| '_ \ 
+// | |_) | |_| | | | ||  __/ |  | |    | | (_| | | | | _| (__| |_) | |_) |
+// |____/ \__,_|_| |_| \___|_|  |_|    |_|\__,_|_| |_|(_)\___| .__/| .__/ 
+//                                                           | |   | |    
+//                                                           |_|   |_|    
+//
+// Description:
+//
+//   Models the passes, seeks and memory of an operation, and picks its tile size and order
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "BufferPlan.h"
+#include "ParityOptions.h"
+#include "OverlappedRead.h"
+#include <math.h>
+
+#ifdef	_LINUX
+#include <sys/sysmacros.h>
+#endif
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Rough costs for the two kinds of device we can tell apart (anything we can't identify is assumed to be a spinning disk)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	double	ROTATIONAL_SEEK = 0.008;
+static	const	double	ROTATIONAL_RATE = 120.0 * 1024 * 1024;
+static	const	double	SOLID_STATE_SEEK = 0.0001;
+static	const	double	SOLID_STATE_RATE = 400.0 * 1024 * 1024;
+
+// Only this much of the available memory is ours to take (the rest is left for the page cache and everybody else)
+
+static	const	double	AVAILABLE_SHARE = 0.8;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Tiles are always a whole number of read buffers
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	unsigned int	roundTile(const double bytes)
+{
+	const double	unit = OverlappedRead::BUFFER_SIZE;
+	const double	largest = static_cast<double>(0xffffffff) - unit + 1;
+
+	double	tile = ceil(bytes / unit) * unit;
+	if (tile < unit) tile = unit;
+	if (tile > largest) tile = largest;
+	return static_cast<unsigned int>(tile);
+}
+
+static	unsigned int	tilesIn(const unsigned int size, const unsigned int tile)
+{
+	return static_cast<unsigned int>((static_cast<double>(size) + tile - 1) / tile);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BufferPlan::BufferPlan()
+{
+	reset();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BufferPlan::~BufferPlan()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlan::reset()
+{
+	budget() = 0;
+	bufferCount() = 1;
+	outputCount() = 0;
+	outputBytes() = 0;
+	allowFileMajor() = false;
+	inputSizes().erase();
+	inputFeeds().erase();
+
+	inputSeek() = outputSeek() = ROTATIONAL_SEEK;
+	inputRate() = outputRate() = ROTATIONAL_RATE;
+	sameDevice() = true;
+
+	order() = GroupMajor;
+	tileSize() = OverlappedRead::BUFFER_SIZE;
+	passes() = 0;
+	seeks() = 0;
+	memory() = 0;
+	seconds() = 0;
+	otherSeconds() = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// An input that's read in full. If it 'feeds the outputs', every tile of it changes every output (inputs that are only hashed,
+// or are only there to be copied, don't.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlan::addInput(const unsigned int size, const bool feedsOutputs)
+{
+	inputSizes() += size;
+	inputFeeds() += feedsOutputs;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlan::setDevices(const fstl::wstring & inputFilespec, const fstl::wstring & outputFilespec)
+{
+	unsigned long long	inputDevice, outputDevice;
+	profileDevice(inputFilespec, inputSeek(), inputRate(), inputDevice);
+	profileDevice(outputFilespec, outputSeek(), outputRate(), outputDevice);
+	sameDevice() = inputDevice == outputDevice;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlan::build()
+{
+	const unsigned int	unit = OverlappedRead::BUFFER_SIZE;
+
+	// The furthest any pass has to reach
+
+	unsigned int	span = outputBytes();
+	double		inputBytes = 0;
+	double		feedBytes = 0;
+	for (unsigned int i = 0; i < inputSizes().size(); ++i)
+	{
+		span = fstl::max(span, inputSizes()[i]);
+		inputBytes += inputSizes()[i];
+		if (inputFeeds()[i]) feedBytes += inputSizes()[i];
+	}
+
+	// Group-major: the biggest tile the budget allows sets the number of passes, then the tile shrinks to fit them evenly
+
+	unsigned int	largestTile = roundTile(fstl::max(floor(budget() / fstl::max(bufferCount(), static_cast<unsigned int>(1)) / unit), 1.0) * unit);
+	largestTile = fstl::min(largestTile, roundTile(span));
+
+	unsigned int	groupPasses = span ? tilesIn(span, largestTile) : 0;
+	unsigned int	groupTile = groupPasses ? roundTile(static_cast<double>(span) / groupPasses) : unit;
+
+	double	groupInputSeeks = 0;
+	for (unsigned int i = 0; i < inputSizes().size(); ++i)
+	{
+		groupInputSeeks += tilesIn(inputSizes()[i], groupTile);
+	}
+
+	double	groupOutputSeeks = static_cast<double>(outputCount()) * groupPasses;
+	double	groupSeconds = groupInputSeeks * inputSeek() + inputBytes / inputRate()
+			     + groupOutputSeeks * outputSeek() + static_cast<double>(outputCount()) * outputBytes() / outputRate();
+
+	// File-major: one tile of input and one of output in memory; the outputs are zero-filled first, then every tile of every
+	// feeding input is folded into every output on disk
+
+	unsigned int	fileTile = fstl::min(roundTile(fstl::max(floor(budget() / 2 / unit), 1.0) * unit), roundTile(span));
+
+	double	fileInputTiles = 0;
+	double	fileFeedTiles = 0;
+	for (unsigned int i = 0; i < inputSizes().size(); ++i)
+	{
+		unsigned int	tiles = tilesIn(inputSizes()[i], fileTile);
+		fileInputTiles += tiles;
+		if (inputFeeds()[i]) fileFeedTiles += tiles;
+	}
+
+	double	fileInputSeeks = sameDevice() ? fileInputTiles : inputSizes().size();
+	double	fileOutputSeeks = static_cast<double>(outputCount()) * (1 + fileFeedTiles * 2);
+	double	fileOutputBytes = static_cast<double>(outputCount()) * (static_cast<double>(outputBytes()) + feedBytes * 2);
+	double	fileSeconds = fileInputSeeks * inputSeek() + inputBytes / inputRate() + fileOutputSeeks * outputSeek() + fileOutputBytes / outputRate();
+
+	// Pick one
+
+	if (allowFileMajor() && fileSeconds < groupSeconds)
+	{
+		order() = FileMajor;
+		tileSize() = fileTile;
+		passes() = 1;
+		seeks() = fileInputSeeks + fileOutputSeeks;
+		memory() = static_cast<double>(fileTile) * 2;
+		seconds() = fileSeconds;
+		otherSeconds() = groupSeconds;
+	}
+	else
+	{
+		order() = GroupMajor;
+		tileSize() = groupTile;
+		passes() = groupPasses;
+		seeks() = groupInputSeeks + groupOutputSeeks;
+		memory() = static_cast<double>(groupTile) * bufferCount();
+		seconds() = groupSeconds;
+		otherSeconds() = allowFileMajor() ? fileSeconds : 0;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::wstring	BufferPlan::summary() const
+{
+	TCHAR	buf[128];
+	if (order() == FileMajor)
+	{
+		swprintf(buf, _T(" tiles, file by file (%.0f seeks, about %.1f seconds)"), seeks(), seconds());
+		return _T("Plan: ") + sizeString(tileSize()) + buf;
+	}
+
+	swprintf(buf, _T(" tiles in %u pass%s (%.0f seeks, about %.1f seconds)"), passes(), passes() == 1 ? _T("") : _T("es"), seeks(), seconds());
+	return _T("Plan: ") + sizeString(tileSize()) + buf;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	BufferPlan::fields(const bool json) const
+{
+	char		buf[256];
+	const char *	name = order() == FileMajor ? "file" : "group";
+	if (json)	sprintf(buf, "\"order\":\"%s\",\"tile\":%u,\"passes\":%u,\"seeks\":%.0f,\"memory\":%.0f,\"budget\":%.0f,\"seconds\":%.1f", name, tileSize(), passes(), seeks(), memory(), budget(), seconds());
+	else		sprintf(buf, "order=%s tile=%u passes=%u seeks=%.0f memory=%.0f budget=%.0f seconds=%.1f", name, tileSize(), passes(), seeks(), memory(), budget(), seconds());
+
+	fstl::string	result = buf;
+	if (allowFileMajor())
+	{
+		sprintf(buf, json ? ",\"other_seconds\":%.1f" : " other_seconds=%.1f", otherSeconds());
+		result += buf;
+	}
+
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The most an operation should allocate: what the options allow, but never more than our share of what's actually free
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+double	BufferPlan::memoryBudget(const ParityOptions & options)
+{
+	double	budget = options.memoryToUse();
+	double	available = getAvailableMemory() * AVAILABLE_SHARE;
+	if (available > 0 && available < budget) budget = available;
+	return fstl::max(budget, static_cast<double>(OverlappedRead::BUFFER_SIZE));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Figures out what kind of device a file lives on (or would live on, if it doesn't exist yet)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlan::profileDevice(const fstl::wstring & filespec, double & seekSeconds, double & bytesPerSecond, unsigned long long & device)
+{
+	seekSeconds = ROTATIONAL_SEEK;
+	bytesPerSecond = ROTATIONAL_RATE;
+	device = 0;
+
+#ifdef	_LINUX
+	struct	stat	st;
+	if (stat(fstl::string(filespec.asArray()).asArray(), &st))
+	{
+		fstl::wstring	path = _T(".");
+		int		idx = filespec.rfind(PATH_SEPARATOR);
+		if (idx == 0)		path = PATH_SEPARATOR;
+		else if (idx > 0)	path = filespec.substring(0, idx);
+		if (stat(fstl::string(path.asArray()).asArray(), &st)) return;
+	}
+
+	device = static_cast<unsigned long long>(st.st_dev);
+
+	// Partitions don't have a queue of their own, their disk does
+
+	char	name[128];
+	double	rotational;
+	sprintf(name, "/sys/dev/block/%u:%u/queue/rotational", major(st.st_dev), minor(st.st_dev));
+	FILE *	fp = fopen(name, "r");
+	if (!fp)
+	{
+		sprintf(name, "/sys/dev/block/%u:%u/../queue/rotational", major(st.st_dev), minor(st.st_dev));
+		fp = fopen(name, "r");
+	}
+	if (!fp) return;
+
+	if (fscanf(fp, "%lf", &rotational) == 1 && rotational == 0)
+	{
+		seekSeconds = SOLID_STATE_SEEK;
+		bytesPerSecond = SOLID_STATE_RATE;
+	}
+	fclose(fp);
+#else
+	fstl::wstring	root = filespec.substring(0, 3);
+	device = static_cast<unsigned long long>(towlower(root[0]));
+#endif
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// BufferPlan.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
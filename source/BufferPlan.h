@@ -0,0 +1,154 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ____         __  __          _____  _                 _     
+// |  _ \       / _|/ _|        |  __ \| |               | |    
+// | |_) |_   _| |_| |_ ___ _ __| |__) | | __ _ _ __     | |__  
+// |  _ <| | | |  _|  _/ _ \ '__|  ___/| |/ _` | '_ \    | '_ \ 
+// | |_) | |_| | | | ||  __/ |  | |    | | (_| | | | | _ | | | |
+// |____/ \__,_|_| |_| \___|_|  |_|    |_|\__,_|_| |_|(_)|_| |_|
+//                                                              
+//                                                              
+//
+// Description:
+//
+//   Models the passes, seeks and memory of an operation, and picks its tile size and order
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_BUFFERPLAN
+#define _H_BUFFERPLAN
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	ParityOptions;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Decides how an operation should use its memory. Every input is read in pieces: the group-major order reads one tile from each
+// input per pass, so halving the tile doubles the passes (and the seeks, since each pass reopens every input.) The file-major
+// order reads each input once, straight through, but has to read-modify-write the outputs on disk for every tile of input; it
+// only pays off when memory is tight and the outputs live on something that seeks a lot faster than the inputs do.
+//
+// The plan estimates both from the device each side lives on, and picks the cheaper. Within the group-major order, it picks the
+// smallest tile that needs no more passes than the largest tile would.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	BufferPlan
+{
+public:
+	// Enumerations
+
+		enum			Order {GroupMajor, FileMajor};
+
+	// Construction/Destruction
+
+					BufferPlan();
+virtual					~BufferPlan();
+
+	// Implementation
+
+virtual		void			reset();
+virtual		void			addInput(const unsigned int size, const bool feedsOutputs = true);
+virtual		void			setDevices(const fstl::wstring & inputFilespec, const fstl::wstring & outputFilespec);
+virtual		void			build();
+virtual		fstl::wstring		summary() const;
+virtual		fstl::string		fields(const bool json) const;
+static		double			memoryBudget(const ParityOptions & options);
+
+	// Inputs
+
+inline		double &		budget()			{return _budget;}
+inline	const	double			budget() const			{return _budget;}
+inline		unsigned int &		bufferCount()			{return _bufferCount;}
+inline	const	unsigned int		bufferCount() const		{return _bufferCount;}
+inline		unsigned int &		outputCount()			{return _outputCount;}
+inline	const	unsigned int		outputCount() const		{return _outputCount;}
+inline		unsigned int &		outputBytes()			{return _outputBytes;}
+inline	const	unsigned int		outputBytes() const		{return _outputBytes;}
+inline		bool &			allowFileMajor()		{return _allowFileMajor;}
+inline	const	bool			allowFileMajor() const		{return _allowFileMajor;}
+inline		fstl::uintArray &	inputSizes()			{return _inputSizes;}
+inline	const	fstl::uintArray &	inputSizes() const		{return _inputSizes;}
+inline		fstl::boolArray &	inputFeeds()			{return _inputFeeds;}
+inline	const	fstl::boolArray &	inputFeeds() const		{return _inputFeeds;}
+
+	// Device costs (setDevices fills these in, but they may be overridden)
+
+inline		double &		inputSeek()			{return _inputSeek;}
+inline	const	double			inputSeek() const		{return _inputSeek;}
+inline		double &		inputRate()			{return _inputRate;}
+inline	const	double			inputRate() const		{return _inputRate;}
+inline		double &		outputSeek()			{return _outputSeek;}
+inline	const	double			outputSeek() const		{return _outputSeek;}
+inline		double &		outputRate()			{return _outputRate;}
+inline	const	double			outputRate() const		{return _outputRate;}
+inline		bool &			sameDevice()			{return _sameDevice;}
+inline	const	bool			sameDevice() const		{return _sameDevice;}
+
+	// Results (valid after build)
+
+inline		Order &			order()				{return _order;}
+inline	const	Order			order() const			{return _order;}
+inline		unsigned int &		tileSize()			{return _tileSize;}
+inline	const	unsigned int		tileSize() const		{return _tileSize;}
+inline		unsigned int &		passes()			{return _passes;}
+inline	const	unsigned int		passes() const			{return _passes;}
+inline		double &		seeks()				{return _seeks;}
+inline	const	double			seeks() const			{return _seeks;}
+inline		double &		memory()			{return _memory;}
+inline	const	double			memory() const			{return _memory;}
+inline		double &		seconds()			{return _seconds;}
+inline	const	double			seconds() const			{return _seconds;}
+inline		double &		otherSeconds()			{return _otherSeconds;}
+inline	const	double			otherSeconds() const		{return _otherSeconds;}
+
+private:
+	// Private implementation
+
+static		void			profileDevice(const fstl::wstring & filespec, double & seekSeconds, double & bytesPerSecond, unsigned long long & device);
+
+	// Data members
+
+		double			_budget;
+		unsigned int		_bufferCount;
+		unsigned int		_outputCount;
+		unsigned int		_outputBytes;
+		bool			_allowFileMajor;
+		fstl::uintArray		_inputSizes;
+		fstl::boolArray		_inputFeeds;
+
+		double			_inputSeek;
+		double			_inputRate;
+		double			_outputSeek;
+		double			_outputRate;
+		bool			_sameDevice;
+
+		Order			_order;
+		unsigned int		_tileSize;
+		unsigned int		_passes;
+		double			_seeks;
+		double			_memory;
+		double			_seconds;
+		double			_otherSeconds;
+};
+
+#endif // _H_BUFFERPLAN
+// ---------------------------------------------------------------------------------------------------------------------------------
+// BufferPlan.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
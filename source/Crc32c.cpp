@@ -0,0 +1,211 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____          ____ ___                          
+//  / ____|        |___ \__ \                         
+// | |     _ __ ___  __) | ) |___     ___ _ __  _ __  
+// | |    | '__/ __||__ < / // __|   / __| '_ \| '_ \ 
+// | |____| | | (__ ___) / /| (__  _| (__| |_) | |_) |
+//  \_____|_|  \___|____/____\___|(_)\___| .__/| .__/ 
+//                                       | |   | |    
+//                                       |_|   |_|    
+//
+// Description:
+//
+//   CRC32C (Castagnoli) checksums
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "Crc32c.h"
+
+#if	defined(_MSC_VER) && _MSC_VER >= 1500 && (defined(_M_IX86) || defined(_M_X64))
+#define	CRC32C_HARDWARE
+#include <intrin.h>
+#include <nmmintrin.h>
+#elif	defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define	CRC32C_HARDWARE
+#include <cpuid.h>
+#include <nmmintrin.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	Crc32c::_tables[8][0x100];
+bool		Crc32c::_tablesGenerated = false;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Continues a CRC from a previous call (start with 0). The CRC is the standard Castagnoli CRC (the one iSCSI & SSE4.2 use).
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	Crc32c::update(const unsigned int crc, const unsigned char * data, const unsigned int length)
+{
+	static	bool	useHardware = hardwareSupported();
+
+	if (useHardware) return ~updateHardware(~crc, data, length);
+	return ~updateSoftware(~crc, data, length);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	Crc32c::hardwareSupported()
+{
+#if	defined(CRC32C_HARDWARE) && defined(_MSC_VER)
+	int	info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 20)) != 0;
+#elif	defined(CRC32C_HARDWARE)
+	unsigned int	eax, ebx, ecx, edx;
+	if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) return false;
+	return (ecx & (1 << 20)) != 0;
+#else
+	return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Crc32c::genTables()
+{
+	// The first table is the classic byte-at-a-time table, the others let us do 8 bytes at a time ("slicing-by-8")
+
+	for (unsigned int i = 0; i < 0x100; ++i)
+	{
+		unsigned int	crc = i;
+		for (unsigned int j = 0; j < 8; ++j)
+		{
+			crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+		}
+		_tables[0][i] = crc;
+	}
+
+	for (unsigned int i = 0; i < 0x100; ++i)
+	{
+		for (unsigned int j = 1; j < 8; ++j)
+		{
+			_tables[j][i] = (_tables[j-1][i] >> 8) ^ _tables[0][_tables[j-1][i] & 0xff];
+		}
+	}
+
+	_tablesGenerated = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	Crc32c::updateSoftware(unsigned int crc, const unsigned char * data, unsigned int length)
+{
+	if (!_tablesGenerated) genTables();
+
+	// Get ourselves aligned
+
+	while(length && (reinterpret_cast<size_t>(data) & 3))
+	{
+		crc = (crc >> 8) ^ _tables[0][(crc ^ *data++) & 0xff];
+		--length;
+	}
+
+	// The bulk of it, 8 bytes at a time
+
+	while(length >= 8)
+	{
+		unsigned int	lo = *reinterpret_cast<const unsigned int *>(data) ^ crc;
+		unsigned int	hi = *reinterpret_cast<const unsigned int *>(data + 4);
+
+		crc =	_tables[7][ lo        & 0xff] ^ _tables[6][(lo >>  8) & 0xff] ^
+			_tables[5][(lo >> 16) & 0xff] ^ _tables[4][ lo >> 24        ] ^
+			_tables[3][ hi        & 0xff] ^ _tables[2][(hi >>  8) & 0xff] ^
+			_tables[1][(hi >> 16) & 0xff] ^ _tables[0][ hi >> 24        ];
+
+		data += 8;
+		length -= 8;
+	}
+
+	// Leftovers
+
+	while(length--)
+	{
+		crc = (crc >> 8) ^ _tables[0][(crc ^ *data++) & 0xff];
+	}
+
+	return crc;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#if	defined(CRC32C_HARDWARE) && defined(__GNUC__)
+__attribute__((target("sse4.2")))
+#endif
+unsigned int	Crc32c::updateHardware(unsigned int crc, const unsigned char * data, unsigned int length)
+{
+#ifdef	CRC32C_HARDWARE
+
+	// Get ourselves aligned
+
+	while(length && (reinterpret_cast<size_t>(data) & 7))
+	{
+		crc = _mm_crc32_u8(crc, *data++);
+		--length;
+	}
+
+	// The bulk of it
+
+	#if	defined(_M_X64) || defined(__x86_64__)
+	{
+		unsigned __int64	crc64 = crc;
+		while(length >= 8)
+		{
+			crc64 = _mm_crc32_u64(crc64, *reinterpret_cast<const unsigned __int64 *>(data));
+			data += 8;
+			length -= 8;
+		}
+		crc = static_cast<unsigned int>(crc64);
+	}
+	#endif
+
+	while(length >= 4)
+	{
+		crc = _mm_crc32_u32(crc, *reinterpret_cast<const unsigned int *>(data));
+		data += 4;
+		length -= 4;
+	}
+
+	// Leftovers
+
+	while(length--)
+	{
+		crc = _mm_crc32_u8(crc, *data++);
+	}
+
+	return crc;
+
+#else
+
+	return updateSoftware(crc, data, length);
+
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Crc32c.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,66 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____          ____ ___          _     
+//  / ____|        |___ \__ \        | |    
+// | |     _ __ ___  __) | ) |___    | |__  
+// | |    | '__/ __||__ < / // __|   | '_ \ 
+// | |____| | | (__ ___) / /| (__  _ | | | |
+//  \_____|_|  \___|____/____\___|(_)|_| |_|
+//                                          
+//                                          
+//
+// Description:
+//
+//   CRC32C (Castagnoli) checksums, using the SSE4.2 crc32 instruction when it's available
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_CRC32C
+#define _H_CRC32C
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	Crc32c
+{
+public:
+	// Implementation
+
+static		unsigned int		update(const unsigned int crc, const unsigned char * data, const unsigned int length);
+static		bool			hardwareSupported();
+
+private:
+	// Private implementation
+
+static		unsigned int		updateSoftware(unsigned int crc, const unsigned char * data, unsigned int length);
+static		unsigned int		updateHardware(unsigned int crc, const unsigned char * data, unsigned int length);
+static		void			genTables();
+
+	// Data members
+
+static		unsigned int		_tables[8][0x100];
+static		bool			_tablesGenerated;
+};
+
+#endif // _H_CRC32C
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Crc32c.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -31,8 +31,10 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "DataFile.h"
+#include "OverlappedRead.h"
+#include "EngineStats.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -43,7 +45,7 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 	DataFile::DataFile()
-	: _fileSize(0), _recoverable(true), _status(Unknown)
+	: _fileSize(0), _recoverable(true), _status(Unknown), _runningHashLength(0)
 {
 	memset(_hash,  0, sizeof(_hash));
 	memset(_hashFirst16K,  0, sizeof(_hashFirst16K));
@@ -62,11 +64,12 @@ bool	DataFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES],
 {
 	// Clear out the actual hash until we calculate a valid one
 
-	memset(actualHash, 0, sizeof(actualHash));
+	memset(actualHash, 0, EmDeeFive::HASH_SIZE_IN_BYTES);
 
 	// Does the file specifically exist?
 
-	if (!doesFileExist(filespec()))
+	fstl::wstring	spec;
+	if (!doesFileExist(filespec(spec)))
 	{
 		status() = Missing;
 		statusString() = _T("Missing");
@@ -75,7 +78,7 @@ bool	DataFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES],
 
 	// Get the file length
 
-	unsigned int	size = getFileLength(filespec());
+	unsigned int	size = getFileLength(spec);
 	if (!size)
 	{
 		status() = Error;
@@ -99,7 +102,10 @@ bool	DataFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES],
 
 	// Get the MD5 checksum of the file
 
-	if (!EmDeeFive::processFile(filespec(), actualHash, totalFiles, curIndex, callback, callbackData))
+	EngineStats::count(EngineStats::InputFiles, 1);
+	EngineStats::count(EngineStats::InputBytes, size);
+
+	if (!EmDeeFive::processFile(spec, actualHash, totalFiles, curIndex, callback, callbackData))
 	{
 		status() = Error;
 		statusString() = _T("Unable to read the file");
@@ -151,9 +157,9 @@ bool	DataFile::readParHeader(FILE * fp, const fstl::wstring & path)
 				_T("in the file header has exceeded a 32-bit value");
 		}
 
-		// Read in the filename
+		// Read in the filename (it's stored as 16-bit Unicode, which isn't the size of a TCHAR everywhere)
 
-		TCHAR	dataFilename[MAX_PATH];
+		unsigned short	dataFilename[MAX_PATH];
 		memset(dataFilename, 0, sizeof(dataFilename));
 
 		unsigned int	nameLength = fileEntry.entrySizeLow - 0x38;
@@ -165,7 +171,12 @@ bool	DataFile::readParHeader(FILE * fp, const fstl::wstring & path)
 
 		// Setup the rest of my stuff
 
-		fileName() = dataFilename;
+		fileName().erase();
+		for (unsigned int i = 0; i < nameLength / 2 && dataFilename[i]; ++i)
+		{
+			TCHAR	c[2] = {static_cast<TCHAR>(dataFilename[i]), 0};
+			fileName() += c;
+		}
 		fileName() = oemToAnsi(fileName());
 
 		memcpy(hash(), fileEntry.md5Hash, EmDeeFive::HASH_SIZE_IN_BYTES);
@@ -199,20 +210,17 @@ fstl::ucharArray	DataFile::storeParHeader() const
 	memcpy(fileEntry.md5Hash, hash(), EmDeeFive::HASH_SIZE_IN_BYTES);
 	memcpy(fileEntry.md5Hash16K, hashFirst16K(), EmDeeFive::HASH_SIZE_IN_BYTES);
 
-	// Store the datafile header
+	// Store the datafile header, followed by the filename (16-bit Unicode, little-endian)
 
-	result.populate(0, sizeof(fileEntry));
+	result.resize_uninitialized(sizeof(fileEntry) + oemName.length() * 2);
 	memcpy(&result[0], &fileEntry, sizeof(fileEntry));
 
-	// Store the filename (Unicode)
-
-	int	s = result.size();
+	unsigned char *	name = &result[sizeof(fileEntry)];
 	for (unsigned int i = 0; i < oemName.length(); ++i)
 	{
-		result += 0;
-		result += 0;
+		name[i*2+0] = static_cast<unsigned char>(oemName[i] & 0xff);
+		name[i*2+1] = static_cast<unsigned char>((oemName[i] >> 8) & 0xff);
 	}
-	memcpy(&result[s], &oemName[0], oemName.length() * 2);
 
 	return result;
 }
@@ -228,7 +236,7 @@ bool	DataFile::writeParHeader(FILE * fp) const
 	// Generate a header
 
 	fstl::ucharArray	headerBuffer = storeParHeader();
-	if (!headerBuffer.size()) throw "";
+	if (!headerBuffer.size()) return false;
 
 	// Write it
 
@@ -239,6 +247,95 @@ bool	DataFile::writeParHeader(FILE * fp) const
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+bool	DataFile::updateRunningHash(const unsigned int currentLength)
+{
+	// Nothing to hash?
+
+	if (!fileSize()) return false;
+
+	// If the file got shorter, somebody restarted it, so we'll have to start over too
+
+	if (currentLength < runningHashLength()) resetRunningHash();
+
+	// Only hash whole blocks of a file that's still growing (so that our reads stay aligned), but once it's reached its full
+	// length, take it all
+
+	unsigned int	end = (currentLength / OverlappedRead::BUFFER_SIZE) * OverlappedRead::BUFFER_SIZE;
+	if (currentLength >= fileSize()) end = fileSize();
+	if (end <= runningHashLength()) return true;
+
+	// Read the new stuff (sharing the file with whomever is writing it)
+
+	OverlappedRead	overlappedRead;
+	if (!overlappedRead.open(filespec(), runningHashLength(), end, true)) return false;
+	if (!overlappedRead.startRead()) return false;
+
+	for(;;)
+	{
+		unsigned int	readCount;
+		unsigned char *	ptr = overlappedRead.finishRead(readCount);
+		if (!ptr)
+		{
+			resetRunningHash();
+			return false;
+		}
+
+		if (!readCount) break;
+
+		if (!overlappedRead.startRead())
+		{
+			resetRunningHash();
+			return false;
+		}
+
+		// The first 16K gets its own hash, too
+
+		if (runningHashLength() < 1024*16)
+		{
+			unsigned int	count = fstl::min(readCount, 1024*16 - runningHashLength());
+			runningHash16K().processBits(ptr, count * 8);
+		}
+
+		runningHash().processBits(ptr, readCount * 8);
+		runningHashLength() += readCount;
+	}
+
+	// Is that the whole thing?
+
+	if (runningHashLength() >= fileSize())
+	{
+		runningHash().finish();
+		runningHash16K().finish();
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	DataFile::resetRunningHash()
+{
+	runningHash().start();
+	runningHash16K().start();
+	runningHashLength() = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	DataFile::runningHashMatches()
+{
+	// Still waiting on some of the file?
+
+	if (!fileSize() || runningHashLength() != fileSize() || !static_cast<const EmDeeFive &>(runningHash()).finished()) return false;
+
+	// Both hashes have to agree with what the PAR file says
+
+	if (memcmp(runningHash16K().getHash(), hashFirst16K(), EmDeeFive::HASH_SIZE_IN_BYTES)) return false;
+	return memcmp(runningHash().getHash(), hash(), EmDeeFive::HASH_SIZE_IN_BYTES) == 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 fstl::wstring	DataFile::getStatusString(const FileStatus status)
 {
 	switch(status)
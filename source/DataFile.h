@@ -38,6 +38,7 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "EmDeeFive.h"
+#include "SharedPath.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -68,23 +69,35 @@ public:
 
 					DataFile();
 virtual					~DataFile();
+#ifdef	FSTL_MOVE
+					DataFile(const DataFile & rhs) = default;
+					DataFile(DataFile && rhs) = default;
+#endif
 
 	// Operators
 
+#ifdef	FSTL_MOVE
+		DataFile &		operator =(const DataFile & rhs) = default;
+		DataFile &		operator =(DataFile && rhs) = default;
+#endif
+
 	// Implementation
 
 virtual		bool			validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES], const unsigned int totalFiles, const unsigned int curIndex, progressCallback callback = NULL, void * callbackData = NULL);
 virtual		bool			readParHeader(FILE * fp, const fstl::wstring & path = _T(""));
 virtual		bool			writeParHeader(FILE * fp) const;
 virtual		fstl::ucharArray	storeParHeader() const;
+virtual		bool			updateRunningHash(const unsigned int currentLength);
+virtual		void			resetRunningHash();
+virtual		bool			runningHashMatches();
 static		fstl::wstring		getStatusString(const FileStatus status);
 
 	// Accessors
 
 inline		fstl::wstring &		fileName()		{return _fileName;}
 inline	const	fstl::wstring &		fileName() const	{return _fileName;}
-inline		fstl::wstring &		filePath()		{return _filePath;}
-inline	const	fstl::wstring &		filePath() const	{return _filePath;}
+inline		SharedPath &		filePath()		{return _filePath;}
+inline	const	fstl::wstring &		filePath() const	{return _filePath.path();}
 inline		unsigned int &		fileSize()		{return _fileSize;}
 inline	const	unsigned int		fileSize() const	{return _fileSize;}
 inline		unsigned char *		hash()			{return _hash;}
@@ -97,20 +110,30 @@ inline		FileStatus &		status()		{return _status;}
 inline	const	FileStatus		status() const		{return _status;}
 inline		fstl::wstring &		statusString()		{return _statusString;}
 inline	const	fstl::wstring &		statusString() const	{return _statusString;}
+inline		EmDeeFive &		runningHash()		{return _runningHash;}
+inline	const	EmDeeFive &		runningHash() const	{return _runningHash;}
+inline		EmDeeFive &		runningHash16K()	{return _runningHash16K;}
+inline	const	EmDeeFive &		runningHash16K() const	{return _runningHash16K;}
+inline		unsigned int &		runningHashLength()	{return _runningHashLength;}
+inline	const	unsigned int		runningHashLength() const {return _runningHashLength;}
 
-inline	const	fstl::wstring		filespec() const	{return filePath() + _T("\\") + fileName();}
+inline	const	fstl::wstring		filespec() const	{fstl::wstring spec; return _filePath.filespec(fileName(), spec);}
+inline	const	fstl::wstring &		filespec(fstl::wstring & buffer) const {return _filePath.filespec(fileName(), buffer);}
 
 private:
 	// Data members
 
 		fstl::wstring		_fileName;
-		fstl::wstring		_filePath;
+		SharedPath		_filePath;
 		unsigned int		_fileSize;
 		unsigned char		_hash[EmDeeFive::HASH_SIZE_IN_BYTES];
 		unsigned char		_hashFirst16K[EmDeeFive::HASH_SIZE_IN_BYTES];
 		bool			_recoverable;
 		FileStatus		_status;
 		fstl::wstring		_statusString;
+		EmDeeFive		_runningHash;
+		EmDeeFive		_runningHash16K;
+		unsigned int		_runningHashLength;
 };
 
 typedef	fstl::array<DataFile>		DataFileArray;
@@ -0,0 +1,329 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____  _               _                   __  __             _ _                              
+// |  __ \(_)             | |                 |  \/  |           (_) |                             
+// | |  | |_ _ __ ___  ___| |_ ___  _ __ _   _| \  / | ___  _ __  _| |_ ___  _ __  ___ _ __  _ __  
+// | |  | | | '__/ _ \/ __| __/ _ \| '__| | | | |\/| |/ _ \| '_ \| | __/ _ \| '__|/ __| '_ \| '_ \ 
+// | |__| | | | |  __/ (__| || (_) | |  | |_| | |  | | (_) | | | | | || (_) | | _| (__| |_) | |_) |
+// |_____/|_|_|  \___|\___|\__\___/|_|   \__, |_|  |_|\___/|_| |_|_|\__\___/|_|(_)\___| .__/| .__/ 
+//                                        __/ |                                       | |   | |    
+//                                       |___/                                        |_|   |_|    
+//
+// Description:
+//
+//   Watches a directory for file-system change notifications
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "DirectoryMonitor.h"
+
+#ifdef	_LINUX
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_LINUX
+	DirectoryMonitor::DirectoryMonitor()
+	: _overflowed(false), _buffer(static_cast<unsigned char *>(0)), _handle(INVALID_HANDLE_VALUE), _pending(false)
+{
+	memset(&overlapped(), 0, sizeof(OVERLAPPED));
+}
+#else
+	DirectoryMonitor::DirectoryMonitor()
+	: _overflowed(false), _buffer(static_cast<unsigned char *>(0)), _handle(-1)
+{
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	DirectoryMonitor::~DirectoryMonitor()
+{
+	close();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	DirectoryMonitor::open(const fstl::wstring & dir)
+{
+	// Start clean
+
+	close();
+
+	// Our event buffer (DWORD aligned, as required by ReadDirectoryChangesW)
+
+	buffer() = new unsigned char[BUFFER_SIZE];
+	if (!buffer()) return false;
+
+	path() = dir;
+	overflowed() = false;
+
+#ifndef	_LINUX
+
+	// Open the directory itself, allowing everybody else to keep on writing files into it
+
+	handle() = CreateFile(path().asArray(), FILE_LIST_DIRECTORY, FILE_SHARE_READ|FILE_SHARE_WRITE|FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS|FILE_FLAG_OVERLAPPED, NULL);
+	if (handle() == INVALID_HANDLE_VALUE)
+	{
+		close();
+		return false;
+	}
+
+	// Start watching (this will fail on platforms that don't support change notifications, such as Win9x)
+
+	if (!startWatch())
+	{
+		close();
+		return false;
+	}
+
+#else
+
+	handle() = inotify_init();
+	if (handle() < 0)
+	{
+		close();
+		return false;
+	}
+
+	// We never want poll() to block
+
+	fcntl(handle(), F_SETFL, fcntl(handle(), F_GETFL) | O_NONBLOCK);
+
+	// Convert the path to a multi-byte string for the kernel
+
+	fstl::charArray	mbPath;
+	mbPath.populate(0, path().length() * MB_CUR_MAX + 1);
+	if (wcstombs(&mbPath[0], path().asArray(), mbPath.size()) == static_cast<size_t>(-1))
+	{
+		close();
+		return false;
+	}
+
+	// Close-after-write is the important one... it means a file is finished (or at least, its writer thinks it is)
+
+	if (inotify_add_watch(handle(), &mbPath[0], IN_CLOSE_WRITE|IN_MOVED_TO|IN_MOVED_FROM|IN_MODIFY|IN_CREATE|IN_DELETE) < 0)
+	{
+		close();
+		return false;
+	}
+
+#endif
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	DirectoryMonitor::close()
+{
+#ifndef	_LINUX
+
+	if (handle() != INVALID_HANDLE_VALUE)
+	{
+		// Make sure the kernel is no longer writing into our buffer before we free it
+
+		if (pending())
+		{
+			DWORD	br;
+			CancelIo(handle());
+			GetOverlappedResult(handle(), &overlapped(), &br, TRUE);
+			pending() = false;
+		}
+
+		CloseHandle(handle());
+		handle() = INVALID_HANDLE_VALUE;
+	}
+
+#else
+
+	if (handle() >= 0)
+	{
+		::close(handle());
+		handle() = -1;
+	}
+
+#endif
+
+	delete[] buffer();
+	buffer() = static_cast<unsigned char *>(0);
+	path() = _T("");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_LINUX
+bool	DirectoryMonitor::startWatch()
+{
+	memset(&overlapped(), 0, sizeof(OVERLAPPED));
+
+	// Windows doesn't have a close-after-write notification, so we watch for size & write-time changes, and let the caller
+	// decide when a file is complete (by its length)
+
+	DWORD	filter = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE;
+	DWORD	br = 0;
+	if (!ReadDirectoryChangesW(handle(), buffer(), BUFFER_SIZE, FALSE, filter, &br, &overlapped(), NULL)) return false;
+
+	pending() = true;
+	return true;
+}
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	DirectoryMonitor::poll(DirectoryEventArray & events)
+{
+	if (!isOpen()) return false;
+
+#ifndef	_LINUX
+
+	for(;;)
+	{
+		// Anything come in yet?
+
+		DWORD	br = 0;
+		if (!GetOverlappedResult(handle(), &overlapped(), &br, FALSE))
+		{
+			if (GetLastError() == ERROR_IO_INCOMPLETE) return true;
+
+			// The watch has died on us (i.e. the directory was removed)
+
+			pending() = false;
+			return false;
+		}
+
+		pending() = false;
+
+		// A zero-length result means the system's buffer overflowed, and we've lost events. The caller will need to rescan
+		// everything.
+
+		if (!br)
+		{
+			overflowed() = true;
+		}
+		else
+		{
+			unsigned int	offset = 0;
+			for(;;)
+			{
+				FILE_NOTIFY_INFORMATION *	fni = reinterpret_cast<FILE_NOTIFY_INFORMATION *>(buffer() + offset);
+
+				// The filename isn't null-terminated
+
+				fstl::wstring	name;
+				{
+					TCHAR		fname[MAX_PATH+1];
+					unsigned int	len = fstl::min(static_cast<unsigned int>(fni->FileNameLength / sizeof(WCHAR)), static_cast<unsigned int>(MAX_PATH));
+					memcpy(fname, fni->FileName, len * sizeof(WCHAR));
+					fname[len] = 0;
+					name = fname;
+				}
+
+				switch(fni->Action)
+				{
+					case FILE_ACTION_ADDED:
+					case FILE_ACTION_RENAMED_NEW_NAME:
+						events += DirectoryEvent(DirectoryEvent::Renamed, name);
+						break;
+
+					case FILE_ACTION_REMOVED:
+					case FILE_ACTION_RENAMED_OLD_NAME:
+						events += DirectoryEvent(DirectoryEvent::Removed, name);
+						break;
+
+					default:
+						events += DirectoryEvent(DirectoryEvent::Modified, name);
+						break;
+				}
+
+				if (!fni->NextEntryOffset) break;
+				offset += fni->NextEntryOffset;
+			}
+		}
+
+		// Keep watching
+
+		if (!startWatch()) return false;
+	}
+
+#else
+
+	for(;;)
+	{
+		int	br = read(handle(), buffer(), BUFFER_SIZE);
+		if (br < 0)
+		{
+			if (errno == EAGAIN || errno == EINTR) return true;
+			return false;
+		}
+
+		int	offset = 0;
+		while (offset < br)
+		{
+			inotify_event *	ie = reinterpret_cast<inotify_event *>(buffer() + offset);
+			offset += sizeof(inotify_event) + ie->len;
+
+			// Lost events?
+
+			if (ie->mask & IN_Q_OVERFLOW)
+			{
+				overflowed() = true;
+				continue;
+			}
+
+			// The watched directory itself went away
+
+			if (ie->mask & IN_IGNORED) return false;
+			if (!ie->len) continue;
+
+			// Convert the name
+
+			fstl::wstring	name;
+			{
+				wchar_t	wName[1024];
+				size_t	len = mbstowcs(wName, ie->name, sizeof(wName) / sizeof(wchar_t) - 1);
+				if (len == static_cast<size_t>(-1)) continue;
+				wName[len] = 0;
+				name = wName;
+			}
+
+			if (ie->mask & IN_CLOSE_WRITE)			events += DirectoryEvent(DirectoryEvent::Closed, name);
+			else if (ie->mask & (IN_MOVED_TO|IN_CREATE))	events += DirectoryEvent(DirectoryEvent::Renamed, name);
+			else if (ie->mask & (IN_MOVED_FROM|IN_DELETE))	events += DirectoryEvent(DirectoryEvent::Removed, name);
+			else						events += DirectoryEvent(DirectoryEvent::Modified, name);
+		}
+	}
+
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// DirectoryMonitor.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,144 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____  _               _                   __  __             _ _              _     
+// |  __ \(_)             | |                 |  \/  |           (_) |            | |    
+// | |  | |_ _ __ ___  ___| |_ ___  _ __ _   _| \  / | ___  _ __  _| |_ ___  _ __ | |__  
+// | |  | | | '__/ _ \/ __| __/ _ \| '__| | | | |\/| |/ _ \| '_ \| | __/ _ \| '__|| '_ \ 
+// | |__| | | | |  __/ (__| || (_) | |  | |_| | |  | | (_) | | | | | || (_) | | _ | | | |
+// |_____/|_|_|  \___|\___|\__\___/|_|   \__, |_|  |_|\___/|_| |_|_|\__\___/|_|(_)|_| |_|
+//                                        __/ |                                          
+//                                       |___/                                           
+//
+// Description:
+//
+//   Watches a directory for file-system change notifications (ReadDirectoryChangesW on Windows, inotify
+//   under _LINUX) so the download monitor only has to re-check the files that actually changed.
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_DIRECTORYMONITOR
+#define _H_DIRECTORYMONITOR
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	DirectoryEvent
+{
+public:
+	// Enumerations
+
+		enum		EventType {Modified, Closed, Renamed, Removed};
+
+	// Construction/Destruction
+
+				DirectoryEvent() : _type(Modified) {}
+				DirectoryEvent(const EventType t, const fstl::wstring & name) : _type(t), _fileName(name) {}
+
+	// Accessors
+
+inline		EventType &	type()				{return _type;}
+inline	const	EventType	type() const			{return _type;}
+inline		fstl::wstring &	fileName()			{return _fileName;}
+inline	const	fstl::wstring &	fileName() const		{return _fileName;}
+
+private:
+	// Data members
+
+		EventType	_type;
+		fstl::wstring	_fileName;
+};
+
+typedef	fstl::array<DirectoryEvent>	DirectoryEventArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	DirectoryMonitor
+{
+public:
+	// Enumerations
+
+		enum		{BUFFER_SIZE = 64*1024};
+
+	// Construction/Destruction
+
+				DirectoryMonitor();
+virtual				~DirectoryMonitor();
+
+	// Implementation
+
+virtual		bool		open(const fstl::wstring & path);
+virtual		void		close();
+virtual		bool		poll(DirectoryEventArray & events);
+
+	// Accessors
+
+inline		fstl::wstring &	path()				{return _path;}
+inline	const	fstl::wstring &	path() const			{return _path;}
+inline		bool &		overflowed()			{return _overflowed;}
+inline	const	bool		overflowed() const		{return _overflowed;}
+inline		unsigned char *&buffer()			{return _buffer;}
+inline	const	unsigned char *	buffer() const			{return _buffer;}
+#ifndef	_LINUX
+inline		HANDLE &	handle()			{return _handle;}
+inline	const	HANDLE		handle() const			{return _handle;}
+inline		OVERLAPPED &	overlapped()			{return _overlapped;}
+inline	const	OVERLAPPED &	overlapped() const		{return _overlapped;}
+inline		bool &		pending()			{return _pending;}
+inline	const	bool		pending() const			{return _pending;}
+
+inline		bool		isOpen() const			{return handle() != INVALID_HANDLE_VALUE;}
+#else
+inline		int &		handle()			{return _handle;}
+inline	const	int		handle() const			{return _handle;}
+
+inline		bool		isOpen() const			{return handle() >= 0;}
+#endif
+
+private:
+	// Private implementation
+
+#ifndef	_LINUX
+virtual		bool		startWatch();
+#endif
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+				DirectoryMonitor(const DirectoryMonitor & rhs);
+inline		DirectoryMonitor & operator =(const DirectoryMonitor & rhs);
+
+	// Data members
+
+		fstl::wstring	_path;
+		bool		_overflowed;
+		unsigned char *	_buffer;
+#ifndef	_LINUX
+		HANDLE		_handle;
+		OVERLAPPED	_overlapped;
+		bool		_pending;
+#else
+		int		_handle;
+#endif
+};
+
+#endif // _H_DIRECTORYMONITOR
+// ---------------------------------------------------------------------------------------------------------------------------------
+// DirectoryMonitor.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
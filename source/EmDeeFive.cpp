@@ -34,9 +34,10 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "OverlappedRead.h"
 #include "EmDeeFive.h"
+#include "EngineStats.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -185,6 +186,8 @@ bool	EmDeeFive::processBits(const unsigned char * data, const unsigned int bitCo
 	if (!started()) return false;
 	if (finished()) return false;
 
+	EngineTimer	timer(EngineStats::Hashing);
+
 	// Speedier byte-aligned version of this routine
 
 	if (!(bitCount % 8) && !(workingBufferLengthBits() % 8))
@@ -489,7 +492,7 @@ bool	EmDeeFive::processFile(const fstl::wstring & filename, unsigned char finger
 	// Used to show progress...
 
 	fstl::wstring	shortName = filename;
-	int		idx = shortName.rfind(_T("\\"));
+	int		idx = shortName.rfind(PATH_SEPARATOR);
 	if (idx >= 0) shortName.erase(0, idx+1);
 	fstl::wstring	progressMessage = _T("Validating  --  ") + shortName;
 	float		minPercent = 0, percentRange = 0;
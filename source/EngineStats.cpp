@@ -0,0 +1,162 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______             _             _____ _        _                           
+// |  ____|           (_)           / ____| |      | |                          
+// | |__   _ __   __ _ _ _ __   ___| (___ | |_ __ _| |_ ___     ___ _ __  _ __  
+// |  __| | '_ \ / _` | | '_ \ / _ \\___ \| __/ _` | __/ __|   / __| '_ \| '_ \ 
+// | |____| | | | (_| | | | | |  __/____) | || (_| | |_\__ \ _| (__| |_) | |_) |
+// |______|_| |_|\__, |_|_| |_|\___|_____/ \__\__,_|\__|___/(_)\___| .__/| .__/ 
+//                __/ |                                            | |   | |    
+//               |___/                                             |_|   |_|    
+//
+// Description:
+//
+//   Per-operation counters for where the engine's time went (disk, hashing, GF arithmetic, writes)
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "EngineStats.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	EngineStats::EngineStats()
+{
+	reset();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	EngineStats::EngineStats(const EngineStats & rhs)
+{
+	*this = rhs;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	EngineStats::~EngineStats()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+EngineStats &	EngineStats::operator =(const EngineStats & rhs)
+{
+	for (unsigned int i = 0; i < COUNTER_COUNT; ++i) _counters[i] = rhs._counters[i];
+	return *this;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+EngineStats &	EngineStats::operator +=(const EngineStats & rhs)
+{
+	for (unsigned int i = 0; i < COUNTER_COUNT; ++i) add(static_cast<Counter>(i), rhs._counters[i]);
+	return *this;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	EngineStats::reset()
+{
+	for (unsigned int i = 0; i < COUNTER_COUNT; ++i) _counters[i] = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+double	EngineStats::seconds(const Counter counter) const
+{
+	return static_cast<double>(_counters[counter]) / 1000000000.0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How many times over the input was read (1.0 means every byte was read once; an operation that works through the set in groups
+// may have to come back for more)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+double	EngineStats::amplification() const
+{
+	if (!_counters[InputBytes]) return 0;
+	return static_cast<double>(_counters[BytesRead]) / static_cast<double>(_counters[InputBytes]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Whichever timer got the most time (the timers run on every thread that did the work, so they can add up to more than the run)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	EngineStats::bottleneck() const
+{
+	unsigned int	worst = ReadWait;
+	for (unsigned int i = ReadWait; i <= Writing; ++i)
+	{
+		if (_counters[i] > _counters[worst]) worst = i;
+	}
+
+	return _counters[worst] ? timerName(static_cast<Counter>(worst)) : "none";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	EngineStats::fields(const bool json) const
+{
+	double	files = static_cast<double>(_counters[InputFiles]);
+	double	perFile = files > 0 ? static_cast<double>(_counters[BytesRead]) / files : 0;
+
+	char	buf[512];
+	if (json)
+	{
+		sprintf(buf, "\"read_wait_seconds\":%.3f,\"md5_seconds\":%.3f,\"gf_seconds\":%.3f,\"write_seconds\":%.3f,\"bytes_read\":%.0f,"
+			     "\"bytes_written\":%.0f,\"opens\":%.0f,\"input_files\":%.0f,\"bytes_per_file\":%.0f,\"amplification\":%.2f,\"bottleneck\":\"%s\"",
+			seconds(ReadWait), seconds(Hashing), seconds(Galois), seconds(Writing), static_cast<double>(_counters[BytesRead]),
+			static_cast<double>(_counters[BytesWritten]), static_cast<double>(_counters[Opens]), files, perFile, amplification(), bottleneck());
+	}
+	else
+	{
+		sprintf(buf, "read_wait_seconds=%.3f md5_seconds=%.3f gf_seconds=%.3f write_seconds=%.3f bytes_read=%.0f "
+			     "bytes_written=%.0f opens=%.0f input_files=%.0f bytes_per_file=%.0f amplification=%.2f bottleneck=%s",
+			seconds(ReadWait), seconds(Hashing), seconds(Galois), seconds(Writing), static_cast<double>(_counters[BytesRead]),
+			static_cast<double>(_counters[BytesWritten]), static_cast<double>(_counters[Opens]), files, perFile, amplification(), bottleneck());
+	}
+
+	return buf;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The short name of a timer (it's what the bottleneck and the trace events are called)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	EngineStats::timerName(const Counter counter)
+{
+	switch(counter)
+	{
+		case ReadWait:	return "read";
+		case Hashing:	return "md5";
+		case Galois:	return "gf";
+		case Writing:	return "write";
+		default:	return "none";
+	}
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// EngineStats.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______             _             _____ _        _           _     
+// |  ____|           (_)           / ____| |      | |         | |    
+// | |__   _ __   __ _ _ _ __   ___| (___ | |_ __ _| |_ ___    | |__  
+// |  __| | '_ \ / _` | | '_ \ / _ \\___ \| __/ _` | __/ __|   | '_ \ 
+// | |____| | | | (_| | | | | |  __/____) | || (_| | |_\__ \ _ | | | |
+// |______|_| |_|\__, |_|_| |_|\___|_____/ \__\__,_|\__|___/(_)|_| |_|
+//                __/ |                                               
+//               |___/                                                
+//
+// Description:
+//
+//   Per-operation counters for where the engine's time went (disk, hashing, GF arithmetic, writes)
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_ENGINESTATS
+#define _H_ENGINESTATS
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "Trace.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Where an operation's time went: waiting on reads, hashing, GF arithmetic and writing, plus how much it read (and how many times
+// it opened files to do it.) With that, a slow run says whether it was disk-, MD5- or GF-bound.
+//
+// The readers, writers, hashes and codecs report to whichever stats object is current on their thread (see EngineStatsScope), so
+// nothing has to be passed down to them, and when nobody is collecting, the cost is a thread-local read. The counters are only
+// ever added to, atomically, so one object can collect from a whole pool.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	EngineStats
+{
+public:
+	// Enumerations (the timers are in nanoseconds)
+
+		enum			Counter {ReadWait, Hashing, Galois, Writing, BytesRead, BytesWritten, Opens, InputBytes, InputFiles,
+					         COUNTER_COUNT};
+
+	// Construction/Destruction
+
+					EngineStats();
+					EngineStats(const EngineStats & rhs);
+virtual					~EngineStats();
+
+	// Operators
+
+virtual		EngineStats &		operator =(const EngineStats & rhs);
+virtual		EngineStats &		operator +=(const EngineStats & rhs);
+
+	// Implementation
+
+virtual		void			reset();
+virtual		double			seconds(const Counter counter) const;
+virtual		double			amplification() const;
+virtual		const	char *		bottleneck() const;
+virtual		fstl::string		fields(const bool json) const;
+static		const	char *		timerName(const Counter counter);
+
+inline		void			add(const Counter counter, const LONGLONG value)
+					{
+						InterlockedExchangeAdd64(&_counters[counter], value);
+					}
+
+				// Adds to the current thread's stats, if anybody is collecting them
+
+static	inline	void			count(const Counter counter, const LONGLONG value)
+					{
+						EngineStats *	stats = current();
+						if (stats) stats->add(counter, value);
+					}
+
+				// The stats that this thread's engine work is counted against (NULL if nobody is collecting)
+
+static	inline	EngineStats *&		current()
+					{
+						static	FSTL_THREAD_LOCAL	EngineStats *	threadStats = static_cast<EngineStats *>(0);
+						return threadStats;
+					}
+
+	// Accessors
+
+inline	const	LONGLONG		counter(const Counter counter) const {return _counters[counter];}
+
+private:
+	// Data members
+
+	volatile LONGLONG		_counters[COUNTER_COUNT];
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Counts this thread's engine work against 'stats' for as long as it lives (NULL to stop counting.) The reads, writes, hashes and
+// multiplies are tallied by the low-level routines themselves, so an entry point needs just one of these at the top for everything
+// beneath it to be counted. Work handed to the pool carries EngineStats::current() along and opens its own scope on the worker.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	EngineStatsScope
+{
+public:
+inline				EngineStatsScope(EngineStats * stats)
+				: _saved(EngineStats::current())
+				{
+					EngineStats::current() = stats;
+				}
+
+inline				~EngineStatsScope()
+				{
+					EngineStats::current() = _saved;
+				}
+
+private:
+		EngineStats *		_saved;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Adds the time it lives to one of the current stats' timers, and records it in the current trace (the clock is only read if
+// somebody is collecting one or the other)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	EngineTimer
+{
+public:
+inline				EngineTimer(const EngineStats::Counter counter)
+				: _stats(EngineStats::current()), _trace(Trace::current()), _counter(counter), _start(_stats || _trace ? getSeconds() : 0)
+				{
+				}
+
+inline				~EngineTimer()
+				{
+					if (!_stats && !_trace) return;
+
+					double	end = getSeconds();
+					if (_stats) _stats->add(_counter, static_cast<LONGLONG>((end - _start) * 1000000000.0));
+					if (_trace) _trace->record(EngineStats::timerName(_counter), _start, end);
+				}
+
+private:
+		EngineStats *		_stats;
+		Trace *			_trace;
+		EngineStats::Counter	_counter;
+		double			_start;
+};
+
+#endif // _H_ENGINESTATS
+// ---------------------------------------------------------------------------------------------------------------------------------
+// EngineStats.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -33,6 +33,10 @@
 #include "stdafx.h"
 #include "FSRaid.h"
 #include "FSRaidDialog.h"
+#include "FftCodec.h"
+#include "ParityOptions.h"
+#include "LocalParity.h"
+#include "OverlappedRead.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -127,6 +131,36 @@ BOOL	FSRaidApp::InitInstance()
 		if (idx >= 0) args.erase(idx);
 	}
 
+	// Codec benchmark? (FFT vs. Vandermonde at a few set sizes, with 10% parity and 8MB of data spread across the files)
+
+	if (args.ncfind(_T("/benchmark")) == 0)
+	{
+		const unsigned int	fileCounts[] = {100, 1000, 10000};
+		fstl::wstring		report = _T("Encode / decode times, in seconds:\n\n");
+
+		for (unsigned int i = 0; i < sizeof(fileCounts) / sizeof(fileCounts[0]); ++i)
+		{
+			unsigned int	fileCount = fileCounts[i];
+			unsigned int	bytes = ((8 * 1024 * 1024) / fileCount) & ~1;
+			double		fftEncode, fftDecode, vandEncode, vandDecode;
+			TCHAR		line[256];
+
+			if (FftCodec::benchmark(fileCount, fileCount / 10, bytes, fftEncode, fftDecode, vandEncode, vandDecode))
+			{
+				swprintf(line, _T("%u files:  FFT %.3f / %.3f,  Vandermonde %.3f / %.3f\n"), fileCount, fftEncode, fftDecode, vandEncode, vandDecode);
+			}
+			else
+			{
+				swprintf(line, _T("%u files:  failed\n"), fileCount);
+			}
+
+			report += line;
+		}
+
+		AfxMessageBox(report.asArray(), MB_ICONINFORMATION);
+		return FALSE;
+	}
+
 	// Send whatever else is left to the dialog...
 
 	FSRaidDialog dlg;
@@ -289,6 +323,25 @@ void	FSRaidApp::deleteSubkey(const fstl::wstring & key, const fstl::wstring & su
 	}
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The parity core doesn't know about the registry, so we hand it the user's preferences
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FSRaidApp::loadParityOptions(ParityOptions & options)
+{
+	options.memoryPercent() = GetProfileInt(_T("Options"), _T("memoryPercent"), 10);
+	options.writeBlockMap() = GetProfileInt(_T("Options"), _T("writeBlockMap"), 1) ? true:false;
+	options.fftCodec() = GetProfileInt(_T("Options"), _T("fftCodec"), 0) ? true:false;
+	options.localParity() = GetProfileInt(_T("Options"), _T("localParity"), 0) ? true:false;
+	options.localGroupSize() = GetProfileInt(_T("Options"), _T("localGroupSize"), LocalParity::DEFAULT_GROUP_SIZE);
+	options.localRepair() = GetProfileInt(_T("Options"), _T("localRepair"), 1) ? true:false;
+	options.errorCorrection() = GetProfileInt(_T("Options"), _T("errorCorrection"), 1) ? true:false;
+	options.quickCheck() = GetProfileInt(_T("Options"), _T("quickCheck"), 0) ? true:false;
+	options.syndromeCheck() = GetProfileInt(_T("Options"), _T("syndromeCheck"), 0) ? true:false;
+
+	OverlappedRead::overlappedDisabled() = GetProfileInt(_T("Options"), _T("disableOverlappingIO"), 0) ? true:false;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // FSRaid.cpp - End of file
 // ---------------------------------------------------------------------------------------------------------------------------------
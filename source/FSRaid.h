@@ -36,23 +36,19 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "resource.h"
-#include "fstl/fstl"
+#include "FSRaidCore.h"
 #include <io.h>
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#include "Utils.h"
-
-// ---------------------------------------------------------------------------------------------------------------------------------
-// Types
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-typedef	bool	(*progressCallback)(void * userData, const fstl::wstring & displayText, const float percent);
+#define	PROGRAM_NAME_STRING	_T("FSRaid")
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-#define	PROGRAM_NAME_STRING	_T("FSRaid")
+class	ParityOptions;
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -64,6 +60,7 @@ virtual		BOOL			InitInstance();
 virtual		void			renameKey();
 virtual		fstl::WStringArray	copyKey(const fstl::wstring & source, const fstl::wstring & dest);
 virtual		void			deleteSubkey(const fstl::wstring & key, const fstl::wstring & subkey);
+virtual		void			loadParityOptions(ParityOptions & options);
 
 inline	const	fstl::wstring &		programFilename() const	{return _programFilename;}
 inline		fstl::wstring &		programFilename()	{return _programFilename;}
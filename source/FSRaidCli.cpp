@@ -0,0 +1,620 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______ _____ _____       _     _  _____ _ _                     
+// |  ____/ ____|  __ \     (_)   | |/ ____| (_)                    
+// | |__ | (___ | |__) |__ _ _  __| | |    | |_     ___ _ __  _ __  
+// |  __| \___ \|  _  // _` | |/ _` | |    | | |   / __| '_ \| '_ \ 
+// | |    ____) | | \ \ (_| | | (_| | |____| | | _| (__| |_) | |_) |
+// |_|   |_____/|_|  \_\__,_|_|\__,_|\_____|_|_|(_)\___| .__/| .__/ 
+//                                                     | |   | |    
+//                                                     |_|   |_|    
+//
+// Description:
+//
+//   Command-line front end for the parity core (create, verify, repair, scrub & benchmark), for platforms without
+//   the MFC dialog
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "ParityJob.h"
+#include "ParityBatch.h"
+#include "FftCodec.h"
+#include <locale.h>
+#include <pthread.h>
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Exit codes (so scripts can tell a damaged set from a broken command line)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+enum	{EXIT_OK = 0, EXIT_ERROR = 1, EXIT_DAMAGED = 2};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	struct	tag_cli_settings
+{
+	unsigned int		benchFiles;
+	unsigned int		benchMegabytes;
+	unsigned int		batchThreads;
+	bool			json;
+	bool			progress;
+	bool			stats;
+} CliSettings;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	usage()
+{
+	fprintf(stderr,
+		"usage: fsraid create [options] <set.par> <file> [file...]\n"
+		"       fsraid verify [options] <set.par> [set.par...]\n"
+		"       fsraid repair [options] <set.par> [set.par...]\n"
+		"       fsraid scrub  [options] <set.par> [set.par...]\n"
+		"       fsraid bench  [options] [directory]\n"
+		"\n"
+		"options:\n"
+		"  -r <count>            recovery volumes to create (default 1)\n"
+		"  -u <file>             add a file to the set without protecting it\n"
+		"  -m <percent>          percent of physical memory to use for buffers (default 10)\n"
+		"  --threads <count>     most threads to use for checking (default: one per CPU)\n"
+		"  --fft                 use the FFT codec (for very large sets)\n"
+		"  --local[=<size>]      also write local XOR parity, one volume per <size> files (default 10)\n"
+		"  --no-blockmap         don't write the block map\n"
+		"  --quick               check data files against the block map's CRCs before hashing them\n"
+		"  --syndrome            check the whole set with a single syndrome pass first\n"
+		"  --no-local-repair     don't repair from the local parity volumes\n"
+		"  --no-error-correction don't fall back to correcting scattered damage a byte at a time\n"
+		"  --huge-pages <mode>   back the big buffers with off, transparent (default) or explicit (reserved) huge pages\n"
+		"  --pin-threads         keep each worker thread (and the memory it touches) on one CPU\n"
+		"  --trace <file>        write a timeline of the reads, hashing, GF work and writes (Chrome trace, for Perfetto)\n"
+		"  --files <count>       bench: number of data files (default 20)\n"
+		"  --size <megabytes>    bench: total size of the data files (default 64)\n"
+		"  --jobs <count>        threads shared by all the sets given (default: one per CPU)\n"
+		"  --json                one JSON object per line, instead of key=value pairs\n"
+		"  --progress            show progress on stderr\n"
+		"  --stats               show where the time went (read wait, md5, gf, write) and how much was read\n"
+		"\n"
+		"A scrub hashes every file (ignoring --quick and --syndrome), repairs the data and rebuilds damaged recovery volumes.\n"
+		"Given more than one set (or --jobs), the sets are processed concurrently, and their files in parallel.\n"
+		"\n"
+		"exit status: 0 ok, 1 error, 2 the set is damaged (or is still damaged after a repair); for several sets, the worst of them\n");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	printLine(const CliSettings & settings, const char * op, const fstl::string & fields)
+{
+	if (settings.json)	printf("{\"op\":\"%s\",%s}\n", op, fields.asArray());
+	else			printf("op=%s %s\n", op, fields.asArray());
+	fflush(stdout);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Anything that isn't valid gets its own line (before the summary), so a script can find out what's wrong without parsing the
+// message
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	printJob(const CliSettings & settings, const ParityJob & job)
+{
+	for (unsigned int i = 0; i < job.problemNames().size(); ++i)
+	{
+		printLine(settings, "file", job.problemFields(i, settings.json));
+	}
+
+	if (job.plan().budget() > 0)
+	{
+		printLine(settings, "plan", job.plan().fields(settings.json));
+	}
+
+	if (job.placement().buffers())
+	{
+		printLine(settings, "memory", job.placement().fields(settings.json));
+	}
+
+	if (settings.stats)
+	{
+		printLine(settings, "stats", job.stats().fields(settings.json));
+	}
+
+	if (settings.json)	printf("{%s}\n", job.fields(true).asArray());
+	else			printf("%s\n", job.fields(false).asArray());
+	fflush(stdout);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	exitCode(const ParityJob & job)
+{
+	switch(job.status())
+	{
+		case ParityJob::Ok:
+		case ParityJob::Repaired:	return EXIT_OK;
+		case ParityJob::Damaged:	return EXIT_DAMAGED;
+		default:			return EXIT_ERROR;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// The jobs run without a callback (so the engine only keeps their progress counters up to date), and --progress has a thread of
+// its own that looks at them a few times a second
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	unsigned int	PROGRESS_INTERVAL_MS = 200;
+
+typedef	struct	tag_progress_sampler
+{
+	const ParityJob *	jobs;
+	unsigned int		jobCount;
+	volatile bool		finished;
+	pthread_t		thread;
+} ProgressSampler;
+
+static	void	showProgress(const ProgressSampler & sampler)
+{
+	if (sampler.jobCount == 1)
+	{
+		const Progress &	progress = sampler.jobs[0].progress();
+		fprintf(stderr, "\r%-12s %5.1f%%", Progress::stageName(progress.stage()), progress.percent());
+	}
+	else
+	{
+		// Several sets: how many are finished, and the first one that isn't
+
+		unsigned int		finished = 0;
+		const ParityJob *	current = NULL;
+		for (unsigned int i = 0; i < sampler.jobCount; ++i)
+		{
+			if (sampler.jobs[i].progress().stage() == Progress::StageDone)	++finished;
+			else if (!current)						current = &sampler.jobs[i];
+		}
+
+		if (current)	fprintf(stderr, "\r[%u/%u] %-12s %5.1f%%", finished, sampler.jobCount, Progress::stageName(current->progress().stage()), current->progress().percent());
+		else		fprintf(stderr, "\r[%u/%u] %-12s %5.1f%%", finished, sampler.jobCount, Progress::stageName(Progress::StageDone), 100.0f);
+	}
+
+	fflush(stderr);
+}
+
+static	void *	samplerThread(void * param)
+{
+	ProgressSampler &	sampler = *reinterpret_cast<ProgressSampler *>(param);
+	while(!sampler.finished)
+	{
+		showProgress(sampler);
+		usleep(PROGRESS_INTERVAL_MS * 1000);
+	}
+
+	return NULL;
+}
+
+static	bool	startSampler(const CliSettings & settings, ProgressSampler & sampler, const ParityJob * jobs, const unsigned int jobCount)
+{
+	sampler.jobs = jobs;
+	sampler.jobCount = jobCount;
+	sampler.finished = false;
+	if (!settings.progress || !jobCount) return false;
+
+	return pthread_create(&sampler.thread, NULL, samplerThread, &sampler) == 0;
+}
+
+static	void	stopSampler(ProgressSampler & sampler, const bool started)
+{
+	if (!started) return;
+
+	sampler.finished = true;
+	pthread_join(sampler.thread, NULL);
+
+	// One last look, so the line ends where the job did
+
+	showProgress(sampler);
+	fprintf(stderr, "\n");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	runJob(CliSettings & settings, ParityJob & job)
+{
+	ProgressSampler	sampler;
+	bool		sampling = startSampler(settings, sampler, &job, 1);
+	job.run();
+	stopSampler(sampler, sampling);
+
+	printJob(settings, job);
+	return exitCode(job);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The same job on every set given, all at once. Results come out in the order the sets were given, followed by a summary line.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	runBatch(CliSettings & settings, const ParityJob & prototype, const fstl::WStringArray & parFilespecs)
+{
+	ParityBatch	batch;
+	for (unsigned int i = 0; i < parFilespecs.size(); ++i)
+	{
+		ParityJob	job = prototype;
+		job.parFilespec() = parFilespecs[i];
+		batch.jobs() += job;
+	}
+
+	// The batch doesn't touch its job list while it runs, so the sampler can look at it
+
+	ProgressSampler	sampler;
+	bool		sampling = startSampler(settings, sampler, &batch.jobs()[0], batch.jobs().size());
+	bool		started = batch.run(settings.batchThreads);
+	stopSampler(sampler, sampling);
+
+	if (!started)
+	{
+		printLine(settings, "batch", settings.json ? "\"status\":\"error\",\"message\":\"Unable to start the worker threads\"" : "status=error message=\"Unable to start the worker threads\"");
+		return EXIT_ERROR;
+	}
+
+	// Errors trump damage
+
+	int		rc = EXIT_OK;
+	double		bytes = 0;
+	for (unsigned int i = 0; i < batch.jobs().size(); ++i)
+	{
+		const ParityJob &	job = batch.jobs()[i];
+		printJob(settings, job);
+
+		bytes += job.bytes();
+		if (exitCode(job) == EXIT_ERROR)				rc = EXIT_ERROR;
+		else if (exitCode(job) == EXIT_DAMAGED && rc == EXIT_OK)	rc = EXIT_DAMAGED;
+	}
+
+	char	buf[256];
+	double	mbps = batch.seconds() > 0 ? bytes / (1024.0 * 1024.0) / batch.seconds() : 0;
+	if (settings.json)	sprintf(buf, "\"sets\":%u,\"bytes\":%.0f,\"seconds\":%.3f,\"mbps\":%.1f", batch.jobs().size(), bytes, batch.seconds(), mbps);
+	else			sprintf(buf, "sets=%u bytes=%.0f seconds=%.3f mbps=%.1f", batch.jobs().size(), bytes, batch.seconds(), mbps);
+	printLine(settings, "batch", buf);
+
+	return rc;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Times growing an array one element at a time (A decides the growth policy), the way header and directory lists get built
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+template <class A>
+static	double	timeByteAppends(const unsigned int count)
+{
+	double	start = getSeconds();
+	A	ar;
+	for (unsigned int i = 0; i < count; ++i) ar += static_cast<unsigned char>(i);
+	return getSeconds() - start;
+}
+
+template <class A>
+static	double	timeNameAppends(const unsigned int count)
+{
+	double	start = getSeconds();
+	A	ar;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		TCHAR	name[32];
+		swprintf(name, _T("file-%06u.bin"), i);
+		ar += fstl::wstring(name);
+	}
+	return getSeconds() - start;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The old fixed-step growth against the geometric growth, plus bulk appends against single ones
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	benchmarkAppends(const CliSettings & settings)
+{
+	const	unsigned int	byteCount = 64 * 1024;
+	const	unsigned int	nameCount = 16 * 1024;
+	const	unsigned int	bulkBytes = 16 * 1024 * 1024;
+	const	unsigned int	chunkBytes = 4096;
+
+	double	bytesFixed = timeByteAppends<fstl::array<unsigned char, 2, 0> >(byteCount);
+	double	bytesGeometric = timeByteAppends<fstl::ucharArray>(byteCount);
+	double	namesFixed = timeNameAppends<fstl::array<fstl::wstring, 2, 0> >(nameCount);
+	double	namesGeometric = timeNameAppends<fstl::WStringArray>(nameCount);
+
+	// A large buffer, a byte at a time and a chunk at a time
+
+	fstl::ucharArray	chunk;
+	chunk.populate(0x5a, chunkBytes);
+
+	double	start = getSeconds();
+	{
+		fstl::ucharArray	ar;
+		for (unsigned int i = 0; i < bulkBytes; ++i) ar += chunk[i % chunkBytes];
+	}
+	double	bulkSingle = getSeconds() - start;
+
+	start = getSeconds();
+	{
+		fstl::ucharArray	ar;
+		for (unsigned int i = 0; i < bulkBytes; i += chunkBytes) ar.append(&chunk[0], chunkBytes);
+	}
+	double	bulkChunked = getSeconds() - start;
+
+	char	buf[512];
+	if (settings.json)	sprintf(buf, "\"bytes\":%u,\"bytes_fixed\":%.4f,\"bytes_geometric\":%.4f,\"names\":%u,\"names_fixed\":%.4f,\"names_geometric\":%.4f,\"bulk_bytes\":%u,\"bulk_single\":%.4f,\"bulk_append\":%.4f", byteCount, bytesFixed, bytesGeometric, nameCount, namesFixed, namesGeometric, bulkBytes, bulkSingle, bulkChunked);
+	else			sprintf(buf, "bytes=%u bytes_fixed=%.4f bytes_geometric=%.4f names=%u names_fixed=%.4f names_geometric=%.4f bulk_bytes=%u bulk_single=%.4f bulk_append=%.4f", byteCount, bytesFixed, bytesGeometric, nameCount, namesFixed, namesGeometric, bulkBytes, bulkSingle, bulkChunked);
+	printLine(settings, "append", buf);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Times filling a table with file indexes keyed by checksum-like ids, then looking every one up (and as many that aren't there)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+template <class H>
+static	void	timeHash(const fstl::uintArray & keys, double & insertSeconds, double & lookupSeconds)
+{
+	H	table;
+
+	double	start = getSeconds();
+	for (unsigned int i = 0; i < keys.size(); ++i) table[keys[i]] = i;
+	insertSeconds = getSeconds() - start;
+
+	unsigned int	found = 0;
+	start = getSeconds();
+	for (unsigned int pass = 0; pass < 4; ++pass)
+	{
+		for (unsigned int i = 0; i < keys.size(); ++i)
+		{
+			if (table.exist(keys[i])) ++found;
+			if (table.exist(~keys[i])) ++found;
+		}
+	}
+	lookupSeconds = getSeconds() - start;
+
+	// (keeps the lookups from being optimized away)
+
+	if (found < keys.size()) insertSeconds = -1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The bucket-and-list hash against the flat one
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	benchmarkHashes(const CliSettings & settings)
+{
+	const	unsigned int	keyCount = 64 * 1024;
+
+	fstl::uintArray	keys;
+	keys.reserve(keyCount);
+	unsigned int	seed = 0x12345678;
+	for (unsigned int i = 0; i < keyCount; ++i)
+	{
+		seed = seed * 1664525 + 1013904223;
+		keys += seed;
+	}
+
+	double	listInsert, listLookup, flatInsert, flatLookup;
+	timeHash<fstl::hash<unsigned int> >(keys, listInsert, listLookup);
+	timeHash<fstl::flathash<unsigned int> >(keys, flatInsert, flatLookup);
+
+	char	buf[256];
+	if (settings.json)	sprintf(buf, "\"keys\":%u,\"list_insert\":%.4f,\"list_lookup\":%.4f,\"flat_insert\":%.4f,\"flat_lookup\":%.4f", keyCount, listInsert, listLookup, flatInsert, flatLookup);
+	else			sprintf(buf, "keys=%u list_insert=%.4f list_lookup=%.4f flat_insert=%.4f flat_lookup=%.4f", keyCount, listInsert, listLookup, flatInsert, flatLookup);
+	printLine(settings, "hash", buf);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Builds a set of files full of noise, and times creating, verifying and repairing it (plus the raw codec and container speeds)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	benchmark(CliSettings & settings, const ParityJob & prototype, const fstl::wstring & directory)
+{
+	// Somewhere to work
+
+	TCHAR	dirName[64];
+	swprintf(dirName, _T("fsraid-bench-%d"), static_cast<int>(getpid()));
+
+	fstl::wstring	path = directory + PATH_SEPARATOR + dirName;
+	if (mkdir(fstl::string(path.asArray()).asArray(), 0777))
+	{
+		printLine(settings, "bench", fstl::string(settings.json ? "\"status\":\"error\",\"message\":" : "status=error message=") + ParityJob::quoted(_T("Unable to create ") + path));
+		return EXIT_ERROR;
+	}
+
+	// The data files (a simple xorshift generator is plenty random enough to defeat any caching by the drive)
+
+	unsigned int	fileCount = fstl::max(settings.benchFiles, static_cast<unsigned int>(2));
+	unsigned int	fileSize = static_cast<unsigned int>((static_cast<double>(settings.benchMegabytes) * 1024 * 1024) / fileCount);
+	if (!fileSize) fileSize = 1;
+
+	fstl::WStringArray	files;
+	fstl::ucharArray	buffer;
+	buffer.populate(0, fileSize);
+
+	unsigned int	seed = 0x2545f491;
+	for (unsigned int i = 0; i < fileCount; ++i)
+	{
+		for (unsigned int j = 0; j < fileSize; ++j)
+		{
+			seed ^= seed << 13;
+			seed ^= seed >> 17;
+			seed ^= seed << 5;
+			buffer[j] = static_cast<unsigned char>(seed);
+		}
+
+		TCHAR	name[32];
+		swprintf(name, _T("data%05u.bin"), i);
+		files += path + PATH_SEPARATOR + name;
+		writeFileRange(files[i], 0, &buffer[0], fileSize);
+	}
+
+	// Enough volumes to rebuild 10% of the files (and at least the two we're about to break), unless we were told otherwise
+
+	ParityJob	job = prototype;
+	job.parFilespec() = path + PATH_SEPARATOR + _T("bench.par");
+	job.dataFilespecs() = files;
+	if (!job.volumeCount()) job.volumeCount() = fstl::max(fileCount / 10, static_cast<unsigned int>(2));
+
+	job.type() = ParityJob::Create;
+	int	rc = runJob(settings, job);
+
+	if (rc == EXIT_OK)
+	{
+		job.type() = ParityJob::Verify;
+		rc = runJob(settings, job);
+	}
+
+	// Lose one file and scribble over another, then put them back
+
+	if (rc == EXIT_OK)
+	{
+		_wunlink(files[0].asArray());
+
+		unsigned char	junk[4096];
+		memset(junk, 0xa5, sizeof(junk));
+		writeFileRange(files[1], fileSize / 2, junk, fstl::min(static_cast<unsigned int>(sizeof(junk)), fileSize - fileSize / 2));
+
+		job.type() = ParityJob::Repair;
+		rc = runJob(settings, job);
+	}
+
+	// The codecs on their own (10% parity, no disk involved)
+
+	{
+		double		fftEncode, fftDecode, vandEncode, vandDecode;
+		unsigned int	bytes = (fileSize + 1) & ~1;
+
+		if (FftCodec::benchmark(fileCount, fstl::max(fileCount / 10, static_cast<unsigned int>(1)), bytes, fftEncode, fftDecode, vandEncode, vandDecode))
+		{
+			char	buf[256];
+			if (settings.json)	sprintf(buf, "\"status\":\"ok\",\"files\":%u,\"bytes\":%u,\"fft_encode\":%.3f,\"fft_decode\":%.3f,\"vandermonde_encode\":%.3f,\"vandermonde_decode\":%.3f", fileCount, bytes * fileCount, fftEncode, fftDecode, vandEncode, vandDecode);
+			else			sprintf(buf, "status=ok files=%u bytes=%u fft_encode=%.3f fft_decode=%.3f vandermonde_encode=%.3f vandermonde_decode=%.3f", fileCount, bytes * fileCount, fftEncode, fftDecode, vandEncode, vandDecode);
+			printLine(settings, "codec", buf);
+		}
+		else
+		{
+			printLine(settings, "codec", settings.json ? "\"status\":\"error\"" : "status=error");
+		}
+	}
+
+	// The containers
+
+	benchmarkAppends(settings);
+	benchmarkHashes(settings);
+
+	// Clean up after ourselves
+
+	fstl::WStringArray	names;
+	findFiles(path, _T("bench"), names);
+	for (unsigned int i = 0; i < names.size(); ++i) _wunlink((path + PATH_SEPARATOR + names[i]).asArray());
+	for (unsigned int i = 0; i < files.size(); ++i) _wunlink(files[i].asArray());
+	rmdir(fstl::string(path.asArray()).asArray());
+
+	return rc;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	main(int argc, char ** argv)
+{
+	// Filenames are converted to & from the user's locale (i.e. UTF-8)
+
+	setlocale(LC_ALL, "");
+
+	CliSettings	settings;
+	settings.benchFiles = 20;
+	settings.benchMegabytes = 64;
+	settings.batchThreads = 0;
+	settings.json = false;
+	settings.progress = false;
+	settings.stats = false;
+
+	if (argc < 2)
+	{
+		usage();
+		return EXIT_ERROR;
+	}
+
+	fstl::WStringArray	args;
+	for (int i = 1; i < argc; ++i) args += fstl::wstring(argv[i]);
+
+	// The job options are shared with the daemon; the rest are ours
+
+	ParityJob		job;
+	bool			bench = args[0] == _T("bench");
+	bool			ok = bench || job.parseCommand(args[0]);
+	bool			explicitCount = false;
+	bool			batch = false;
+	fstl::WStringArray	benchArgs;
+	fstl::WStringArray	parFilespecs;
+
+	for (unsigned int i = 1; ok && i < args.size(); ++i)
+	{
+		int	used = job.parseOption(args, i);
+		if (used < 0) ok = false;
+		if (used > 0)
+		{
+			if (args[i] == _T("-r")) explicitCount = true;
+			i += used - 1;
+			continue;
+		}
+
+		const fstl::wstring &	arg = args[i];
+		if	(arg == _T("--json"))				settings.json = true;
+		else if (arg == _T("--progress"))			settings.progress = true;
+		else if (arg == _T("--stats"))				settings.stats = true;
+		else if (arg == _T("--files") && i + 1 < args.size())	settings.benchFiles = args[++i].asUInt();
+		else if (arg == _T("--size") && i + 1 < args.size())	settings.benchMegabytes = args[++i].asUInt();
+		else if (arg == _T("--jobs") && i + 1 < args.size())
+		{
+			settings.batchThreads = args[++i].asUInt();
+			batch = true;
+		}
+		else if (arg.length() > 1 && arg[0] == _T('-'))		ok = false;
+		else if (bench)						benchArgs += arg;
+		else if (job.type() != ParityJob::Create)		parFilespecs += arg;
+		else							ok = job.addArgument(arg);
+	}
+
+	// Everything but create takes any number of sets
+
+	if (ok && !bench && job.type() != ParityJob::Create)
+	{
+		if (parFilespecs.size()) job.addArgument(parFilespecs[0]);
+		if (parFilespecs.size() > 1) batch = true;
+	}
+
+	// Bench picks its own volume count unless it was given one
+
+	if (bench && ok && benchArgs.size() <= 1)
+	{
+		if (!explicitCount) job.volumeCount() = 0;
+		return benchmark(settings, job, benchArgs.size() ? benchArgs[0] : getTempDirectory());
+	}
+
+	if (!ok || bench || !job.isComplete())
+	{
+		usage();
+		return EXIT_ERROR;
+	}
+
+	if (batch) return runBatch(settings, job, parFilespecs);
+	return runJob(settings, job);
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// FSRaidCli.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,63 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______ _____ _____       _     _  _____                   _     
+// |  ____/ ____|  __ \     (_)   | |/ ____|                 | |    
+// | |__ | (___ | |__) |__ _ _  __| | |     ___  _ __ ___    | |__  
+// |  __| \___ \|  _  // _` | |/ _` | |    / _ \| '__/ _ \   | '_ \ 
+// | |    ____) | | \ \ (_| | | (_| | |___| (_) | | |  __/ _ | | | |
+// |_|   |_____/|_|  \_\__,_|_|\__,_|\_____\___/|_|  \___|(_)|_| |_|
+//                                                                  
+//                                                                  
+//
+// Description:
+//
+//   Everything the parity core needs, without MFC -- the dialog app and the command-line tool both
+//   build on top of this
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_FSRAIDCORE
+#define _H_FSRAIDCORE
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "fstl/fstl"
+#include "Utils.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	bool	(*progressCallback)(void * userData, const fstl::wstring & displayText, const float percent);
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_LINUX
+#define	PATH_SEPARATOR		_T("\\")
+#define	PATH_SEPARATOR_CHAR	_T('\\')
+#else
+#define	PATH_SEPARATOR		_T("/")
+#define	PATH_SEPARATOR_CHAR	_T('/')
+#endif
+
+#endif // _H_FSRAIDCORE
+// ---------------------------------------------------------------------------------------------------------------------------------
+// FSRaidCore.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,578 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______ _____ _____       _     _ _____                                                       
+// |  ____/ ____|  __ \     (_)   | |  __ \                                                      
+// | |__ | (___ | |__) |__ _ _  __| | |  | | __ _  ___ _ __ ___   ___  _ __      ___ _ __  _ __  
+// |  __| \___ \|  _  // _` | |/ _` | |  | |/ _` |/ _ \ '_ ` _ \ / _ \| '_ \    / __| '_ \| '_ \ 
+// | |    ____) | | \ \ (_| | | (_| | |__| | (_| |  __/ | | | | | (_) | | | | _| (__| |_) | |_) |
+// |_|   |_____/|_|  \_\__,_|_|\__,_|_____/ \__,_|\___|_| |_| |_|\___/|_| |_|(_)\___| .__/| .__/ 
+//                                                                                  | |   | |    
+//                                                                                  |_|   |_|    
+//
+// Description:
+//
+//   Long-running job daemon: accepts create/verify/repair/scrub jobs over a Unix-domain socket, schedules them
+//   and streams their progress back to the clients
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "JobScheduler.h"
+#include <locale.h>
+#include <signal.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	Connection
+{
+public:
+	// Construction/Destruction
+
+					Connection() : _fd(-1), _id(0), _json(false), _watching(false), _closing(false) {}
+
+	// Accessors
+
+inline		int &			fd()				{return _fd;}
+inline	const	int			fd() const			{return _fd;}
+inline		int &			id()				{return _id;}
+inline	const	int			id() const			{return _id;}
+inline		fstl::string &		input()				{return _input;}
+inline	const	fstl::string &		input() const			{return _input;}
+inline		fstl::string &		output()			{return _output;}
+inline	const	fstl::string &		output() const			{return _output;}
+inline		bool &			json()				{return _json;}
+inline	const	bool			json() const			{return _json;}
+inline		bool &			watching()			{return _watching;}
+inline	const	bool			watching() const		{return _watching;}
+inline		bool &			closing()			{return _closing;}
+inline	const	bool			closing() const			{return _closing;}
+
+private:
+	// Data members
+
+		int			_fd;
+		int			_id;
+		fstl::string		_input;
+		fstl::string		_output;
+		bool			_json;
+		bool			_watching;
+		bool			_closing;
+};
+
+typedef	fstl::array<Connection>		ConnectionArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Clients can't send us a line longer than this (a 'create' with a few thousand files fits comfortably)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	unsigned int	MAX_LINE_LENGTH = 1024 * 1024;
+
+static	volatile sig_atomic_t	quitRequested = 0;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	usage()
+{
+	fprintf(stderr,
+		"usage: fsraidd [options]\n"
+		"\n"
+		"options:\n"
+		"  --socket <path>       where to listen (default $XDG_RUNTIME_DIR/fsraidd.sock, or /tmp/fsraidd-<uid>.sock)\n"
+		"  --jobs <count>        most jobs to run at once (default 2)\n"
+		"  --memory <megabytes>  buffer memory shared by the running jobs (default 25%% of physical memory)\n"
+		"  --per-device <count>  most jobs to run at once on any one device, 0 for no limit (default 1)\n"
+		"  --threads <count>     checking threads shared by the running jobs (default: one per CPU)\n"
+		"\n"
+		"Clients send one command per line:\n"
+		"\n"
+		"  create|verify|repair|scrub [--priority <n>] [fsraid options] <set.par> [files...]\n"
+		"  cancel <id>\n"
+		"  pause <id>            hold a running job where it is (it keeps its place, and its memory)\n"
+		"  resume <id>\n"
+		"  status\n"
+		"  watch                 receive events for every job, not just this connection's\n"
+		"  json                  send JSON objects (one per line) instead of key=value pairs\n"
+		"  quit\n"
+		"\n"
+		"and receive 'queued', 'started', 'progress', 'file', 'stats' and 'done' events for their jobs. Relative paths are relative\n"
+		"to the daemon's working directory.\n");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	onSignal(int)
+{
+	quitRequested = 1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Splits a command line into words (double quotes group words, and a backslash escapes the next character)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	bool	splitWords(const fstl::string & line, fstl::WStringArray & words)
+{
+	fstl::string	word;
+	bool		inWord = false;
+	bool		quoted = false;
+
+	for (unsigned int i = 0; i < line.length(); ++i)
+	{
+		char	c = line[i];
+
+		if (c == '\\' && i + 1 < line.length())
+		{
+			char	ch[2] = {line[++i], 0};
+			word += ch;
+			inWord = true;
+		}
+		else if (c == '"')
+		{
+			quoted = !quoted;
+			inWord = true;
+		}
+		else if (!quoted && (c == ' ' || c == '\t' || c == '\r'))
+		{
+			if (inWord) words += fstl::wstring(word.asArray());
+			word.erase();
+			inWord = false;
+		}
+		else
+		{
+			char	ch[2] = {c, 0};
+			word += ch;
+			inWord = true;
+		}
+	}
+
+	if (inWord) words += fstl::wstring(word.asArray());
+	return !quoted;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	reply(Connection & conn, const char * event, const fstl::wstring & message)
+{
+	if (conn.json())	conn.output() += fstl::string("{\"event\":\"") + event + "\",\"message\":" + ParityJob::quoted(message) + "}\n";
+	else			conn.output() += fstl::string("event=") + event + " message=" + ParityJob::quoted(message) + "\n";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Events from the workers (and the progress of their jobs) go to whoever submitted the job, and to anybody watching
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	deliverEvents(ConnectionArray & connections, JobScheduler & scheduler)
+{
+	JobEventArray	events;
+	scheduler.takeEvents(events);
+	for (unsigned int i = 0; i < events.size(); ++i)
+	{
+		for (unsigned int j = 0; j < connections.size(); ++j)
+		{
+			Connection &	conn = connections[j];
+			if (conn.id() != events[i].client() && !conn.watching()) continue;
+			conn.output() += (conn.json() ? events[i].json() : events[i].text()) + "\n";
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	handleCommand(Connection & conn, const fstl::string & line, JobScheduler & scheduler, ConnectionArray & connections)
+{
+	fstl::WStringArray	words;
+	if (!splitWords(line, words))
+	{
+		reply(conn, "error", _T("Unterminated quote"));
+		return;
+	}
+
+	if (!words.size()) return;
+
+	const fstl::wstring &	command = words[0];
+
+	if (command == _T("quit"))
+	{
+		conn.closing() = true;
+		return;
+	}
+
+	if (command == _T("json"))
+	{
+		conn.json() = true;
+		return;
+	}
+
+	if (command == _T("watch"))
+	{
+		conn.watching() = true;
+		return;
+	}
+
+	if (command == _T("status"))
+	{
+		// Anything that happened before the status has to reach the clients before it does (the 'queued' for a job this
+		// client just submitted, for one)
+
+		deliverEvents(connections, scheduler);
+
+		JobEventArray	lines;
+		scheduler.listJobs(lines, conn.id());
+		for (unsigned int i = 0; i < lines.size(); ++i)
+		{
+			conn.output() += (conn.json() ? lines[i].json() : lines[i].text()) + "\n";
+		}
+		return;
+	}
+
+	if (command == _T("cancel"))
+	{
+		if (words.size() != 2 || !scheduler.cancel(words[1].asUInt())) reply(conn, "error", _T("No such job"));
+		return;
+	}
+
+	if (command == _T("pause") || command == _T("resume"))
+	{
+		if (words.size() != 2 || !scheduler.pause(words[1].asUInt(), command == _T("pause"))) reply(conn, "error", _T("No such running job"));
+		return;
+	}
+
+	// Anything else is a job
+
+	ParityJob	job;
+	if (!job.parseCommand(command))
+	{
+		reply(conn, "error", _T("Unknown command: ") + command);
+		return;
+	}
+
+	int	priority = 0;
+	for (unsigned int i = 1; i < words.size(); ++i)
+	{
+		if (words[i] == _T("--priority") && i + 1 < words.size())
+		{
+			priority = words[++i].asInt();
+			continue;
+		}
+
+		int	used = job.parseOption(words, i);
+		if (used > 0)
+		{
+			i += used - 1;
+			continue;
+		}
+
+		if (used < 0 || (words[i].length() > 1 && words[i][0] == _T('-')) || !job.addArgument(words[i]))
+		{
+			reply(conn, "error", _T("Bad argument: ") + words[i]);
+			return;
+		}
+	}
+
+	if (!job.isComplete())
+	{
+		reply(conn, "error", _T("Incomplete command"));
+		return;
+	}
+
+	scheduler.submit(job, priority, conn.id());
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	bool	readFromClient(Connection & conn, JobScheduler & scheduler, ConnectionArray & connections)
+{
+	char	buf[4096];
+	bool	hungUp = false;
+	for(;;)
+	{
+		int	count = static_cast<int>(recv(conn.fd(), buf, sizeof(buf) - 1, 0));
+		if (count == 0)
+		{
+			hungUp = true;
+			break;
+		}
+
+		if (count < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) return false;
+			break;
+		}
+
+		buf[count] = 0;
+		conn.input() += buf;
+	}
+
+	// Run every complete line (a client that sends its commands and hangs up still gets them run, and gets whatever replies
+	// we have ready before we close our end)
+
+	for(;;)
+	{
+		int	idx = conn.input().find("\n");
+		if (idx < 0) break;
+
+		fstl::string	line = conn.input().substring(0, idx);
+		conn.input().erase(0, idx + 1);
+		handleCommand(conn, line, scheduler, connections);
+	}
+
+	if (hungUp) conn.closing() = true;
+	return conn.input().length() <= MAX_LINE_LENGTH;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	bool	writeToClient(Connection & conn)
+{
+	while (conn.output().length())
+	{
+		int	count = static_cast<int>(send(conn.fd(), conn.output().asArray(), conn.output().length(), MSG_NOSIGNAL));
+		if (count < 0) return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+		conn.output().erase(0, count);
+	}
+
+	return !conn.closing();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	openSocket(const fstl::string & path)
+{
+	sockaddr_un	addr;
+	memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	if (path.length() >= sizeof(addr.sun_path)) return -1;
+	strcpy(addr.sun_path, path.asArray());
+
+	int	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+
+	// If a daemon answers on the path, it's still running, and it keeps it. Only a stale socket from one that died (nobody
+	// listening) or nothing at all is fair game.
+
+	if (!connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)))
+	{
+		close(fd);
+		errno = EADDRINUSE;
+		return -1;
+	}
+
+	int	err = errno;
+	close(fd);
+	if (err != ECONNREFUSED && err != ENOENT)
+	{
+		errno = err;
+		return -1;
+	}
+
+	if (err == ECONNREFUSED) unlink(path.asArray());
+
+	// A socket that has tried to connect can't be bound, so start over with a fresh one
+
+	fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0) return -1;
+
+	// Only our own user gets to talk to us
+
+	mode_t	oldMask = umask(0077);
+	bool	bound = !bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+	umask(oldMask);
+
+	if (!bound || listen(fd, 16))
+	{
+		close(fd);
+		return -1;
+	}
+
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+	fcntl(fd, F_SETFD, FD_CLOEXEC);
+	return fd;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	main(int argc, char ** argv)
+{
+	// Filenames are converted to & from the user's locale (i.e. UTF-8)
+
+	setlocale(LC_ALL, "");
+
+	fstl::string	socketPath;
+	unsigned int	jobs = 2;
+	double		memory = getPhysicalMemory() / 4;
+	unsigned int	perDevice = 1;
+	unsigned int	threads = 0;
+
+	const char *	runtimeDir = getenv("XDG_RUNTIME_DIR");
+	if (runtimeDir && *runtimeDir)
+	{
+		socketPath = fstl::string(runtimeDir) + "/fsraidd.sock";
+	}
+	else
+	{
+		char	buf[64];
+		sprintf(buf, "/tmp/fsraidd-%u.sock", static_cast<unsigned int>(getuid()));
+		socketPath = buf;
+	}
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *	arg = argv[i];
+		const char *	next = i + 1 < argc ? argv[i+1] : static_cast<const char *>(0);
+
+		if	(!strcmp(arg, "--socket") && next)	{socketPath = next; ++i;}
+		else if (!strcmp(arg, "--jobs") && next)	{jobs = atoi(next); ++i;}
+		else if (!strcmp(arg, "--memory") && next)	{memory = atof(next) * 1024 * 1024; ++i;}
+		else if (!strcmp(arg, "--per-device") && next)	{perDevice = atoi(next); ++i;}
+		else if (!strcmp(arg, "--threads") && next)	{threads = atoi(next); ++i;}
+		else
+		{
+			usage();
+			return 1;
+		}
+	}
+
+	int	listener = openSocket(socketPath);
+	if (listener < 0)
+	{
+		if (errno == EADDRINUSE)	fprintf(stderr, "fsraidd: another daemon is already listening on %s\n", socketPath.asArray());
+		else				fprintf(stderr, "fsraidd: unable to listen on %s: %s\n", socketPath.asArray(), strerror(errno));
+		return 1;
+	}
+
+	struct	sigaction	sa;
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = onSignal;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+	signal(SIGPIPE, SIG_IGN);
+
+	JobScheduler	scheduler;
+	if (!scheduler.start(jobs, memory, perDevice, threads))
+	{
+		fprintf(stderr, "fsraidd: unable to start the workers\n");
+		close(listener);
+		unlink(socketPath.asArray());
+		return 1;
+	}
+
+	fprintf(stderr, "fsraidd: listening on %s (jobs=%u memory_mb=%.0f per_device=%u threads=%u)\n", socketPath.asArray(), scheduler.workerCount(), scheduler.memoryBudget() / (1024*1024), scheduler.deviceLimit(), scheduler.threadBudget());
+
+	ConnectionArray	connections;
+	int		nextConnectionId = 1;
+
+	// Nothing running, nothing to wake up for (a job that starts pokes the scheduler's handle)
+
+	int		timeout = -1;
+
+	while (!quitRequested)
+	{
+		// Who are we waiting on?
+
+		fstl::array<pollfd>	fds;
+		pollfd			pfd;
+
+		pfd.fd = listener;
+		pfd.events = POLLIN;
+		pfd.revents = 0;
+		fds += pfd;
+
+		pfd.fd = scheduler.wakeHandle();
+		fds += pfd;
+
+		for (unsigned int i = 0; i < connections.size(); ++i)
+		{
+			pfd.fd = connections[i].fd();
+			pfd.events = POLLIN | (connections[i].output().length() ? POLLOUT : 0);
+			fds += pfd;
+		}
+
+		if (poll(&fds[0], fds.size(), timeout) < 0 && errno != EINTR) break;
+
+		// New clients
+
+		if (fds[0].revents & POLLIN)
+		{
+			for(;;)
+			{
+				int	fd = accept(listener, NULL, NULL);
+				if (fd < 0) break;
+
+				fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+				fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+				Connection	conn;
+				conn.fd() = fd;
+				conn.id() = nextConnectionId++;
+				connections += conn;
+			}
+		}
+
+		// Pass on what the workers have been up to
+
+		timeout = scheduler.sampleProgress();
+		deliverEvents(connections, scheduler);
+
+		// Talk to the clients (the ones that were just accepted aren't in 'fds' yet, so they wait for the next time around)
+
+		unsigned int	polled = fds.size() - 2;
+		unsigned int	k = 0;
+		for (unsigned int i = 0; i < connections.size(); ++i, ++k)
+		{
+			Connection &	conn = connections[i];
+			bool		alive = true;
+
+			if (k < polled && (fds[k+2].revents & (POLLIN | POLLHUP | POLLERR)))
+			{
+				alive = readFromClient(conn, scheduler, connections);
+			}
+
+			if (alive) alive = writeToClient(conn);
+
+			// Jobs outlive their connections (they just don't have anybody to tell when they're done)
+
+			if (!alive)
+			{
+				close(conn.fd());
+				connections.erase(i, 1);
+				--i;
+			}
+		}
+	}
+
+	fprintf(stderr, "fsraidd: shutting down\n");
+
+	scheduler.stop();
+	for (unsigned int i = 0; i < connections.size(); ++i)
+	{
+		close(connections[i].fd());
+	}
+	close(listener);
+	unlink(socketPath.asArray());
+
+	return 0;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// FSRaidDaemon.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
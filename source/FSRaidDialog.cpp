@@ -40,6 +40,7 @@
 #include "PreferencesDialog.h"
 #include "CreateParityDialog.h"
 #include "RenameConfirmationDialog.h"
+#include "RegInfo.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -65,6 +66,7 @@
 
 static	const unsigned int	startupTimer = 12345;
 static	const unsigned int	monitorTimer = startupTimer + 1;
+static	const unsigned int	monitorPollInterval = 500;
 
 DECLARE_HANDLE(HMONITOR);
 
@@ -260,6 +262,7 @@ END_MESSAGE_MAP()
 {
 	potentialPercent = 0;
 	validPercent = 0;
+	monitorRescan = true;
 	m_hIcon = AfxGetApp()->LoadIcon(IDR_MAINFRAME);
 }
 
@@ -325,6 +328,10 @@ BOOL	FSRaidDialog::OnInitDialog()
 	SetIcon(m_hIcon, TRUE);			// Set big icon
 	SetIcon(m_hIcon, FALSE);		// Set small icon
 
+	// The parity core's settings come from the user's preferences
+
+	theApp.loadParityOptions(parityInfo().options());
+
 	// Initial dialog rect (for resizing it to expose the progress bar)
 
 	GetWindowRect(initialDialogRect);
@@ -767,6 +774,7 @@ void	FSRaidDialog::OnTimer(UINT nIDEvent)
 			PreferencesDialog	dlg;
 			dlg.DoModal();
 			theApp.WriteProfileInt(_T("Options"), _T("optionsSet"), 1);
+			theApp.loadParityOptions(parityInfo().options());
 		}
 
 		// Set file associations?
@@ -898,6 +906,10 @@ void	FSRaidDialog::OnRButtonUp(UINT nFlags, CPoint point)
 		if (needed || df.status() == DataFile::Valid || df.recoverable() == false) disabled = disabledFlags;
 		menu.AppendMenu(MF_STRING|busyDisabledFlags|disabled, MENU_REPAIR_DATA_FILE, _T("Repair this file"));
 
+		disabled = 0;
+		if (df.status() == DataFile::Missing) disabled = disabledFlags;
+		menu.AppendMenu(MF_STRING|busyDisabledFlags|disabled, MENU_UPDATE_DATA_FILE, _T("Update parity for changes to this file..."));
+
 		menu.AppendMenu(MF_STRING, MENU_COPY_DATA_FILE, _T("Copy filename to clipboard"));
 		menu.AppendMenu(MF_SEPARATOR);
 
@@ -933,6 +945,16 @@ void	FSRaidDialog::OnRButtonUp(UINT nFlags, CPoint point)
 
 		menu.AppendMenu(MF_STRING|busyDisabledFlags, MENU_CHECK_PARITY_FILE, _T("Check this file"));
 //		menu.AppendMenu(MF_STRING, MENU_REPAIR_PARITY_FILE, _T("Repair this file"));
+
+		CMenu	extendMenu;
+		extendMenu.CreatePopupMenu();
+		extendMenu.AppendMenu(MF_STRING, MENU_EXTEND_PARITY_1, _T("1 volume"));
+		extendMenu.AppendMenu(MF_STRING, MENU_EXTEND_PARITY_2, _T("2 volumes"));
+		extendMenu.AppendMenu(MF_STRING, MENU_EXTEND_PARITY_5, _T("5 volumes"));
+		extendMenu.AppendMenu(MF_STRING, MENU_EXTEND_PARITY_10, _T("10 volumes"));
+		menu.AppendMenu(MF_POPUP|busyDisabledFlags, reinterpret_cast<UINT_PTR>(extendMenu.GetSafeHmenu()), _T("Add recovery volumes"));
+		extendMenu.Detach();
+
 		menu.AppendMenu(MF_STRING, MENU_COPY_PARITY_FILE, _T("Copy filename to clipboard"));
 
 		menu.AppendMenu(MF_SEPARATOR);
@@ -998,6 +1020,19 @@ BOOL	FSRaidDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 			MessageBeep(MB_ICONASTERISK);
 			saveStates(parityInfo().setHash(), parityInfo().parityFiles(), parityInfo().dataFiles());
 		}
+		else if (wParam == MENU_UPDATE_DATA_FILE)
+		{
+			resizeWindow(true);
+			progressText().SetWindowText(_T("Updating parity data..."));
+			bool	ok = updateParityForDataFile(contextIndex());
+			resizeWindow(false);
+
+			if (ok)
+			{
+				MessageBeep(MB_ICONASTERISK);
+				saveStates(parityInfo().setHash(), parityInfo().parityFiles(), parityInfo().dataFiles());
+			}
+		}
 		else if (wParam == MENU_COPY_DATA_FILE)
 		{
 			copyStringToClipboard(parityInfo().dataFiles()[contextIndex()].fileName());
@@ -1044,6 +1079,21 @@ BOOL	FSRaidDialog::OnCommand(WPARAM wParam, LPARAM lParam)
 		else if (wParam == MENU_REPAIR_PARITY_FILE)
 		{
 		}
+		else if (wParam == MENU_EXTEND_PARITY_1 || wParam == MENU_EXTEND_PARITY_2 || wParam == MENU_EXTEND_PARITY_5 || wParam == MENU_EXTEND_PARITY_10)
+		{
+			unsigned int	volumeCount = 1;
+			if (wParam == MENU_EXTEND_PARITY_2) volumeCount = 2;
+			else if (wParam == MENU_EXTEND_PARITY_5) volumeCount = 5;
+			else if (wParam == MENU_EXTEND_PARITY_10) volumeCount = 10;
+
+			resizeWindow(true);
+			progressText().SetWindowText(_T("Adding recovery volumes..."));
+			bool	ok = extendParitySet(volumeCount);
+			resizeWindow(false);
+
+			if (ok) MessageBeep(MB_ICONASTERISK);
+			saveStates(parityInfo().setHash(), parityInfo().parityFiles(), parityInfo().dataFiles());
+		}
 		else if (wParam == MENU_COPY_PARITY_FILE)
 		{
 			copyStringToClipboard(parityInfo().parityFiles()[contextIndex()].fileName());
@@ -1082,9 +1132,26 @@ void	FSRaidDialog::OnBnClickedMonitordownloadButton()
 	resizeWindow();
 	progress().ShowWindow(SW_HIDE);
 
-	// Start the monitor...
+	// Start the monitor... (from scratch)
 
 	monitorFlag() = true;
+	monitorRescan = true;
+	monitorPending.erase();
+	directoryMonitor().close();
+
+	// Accumulate the recovery data as the files arrive, so that a repair at the end won't need to read them all over again
+
+	unsigned int	recoverableCount = 0;
+	for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+	{
+		if (parityInfo().dataFiles()[i].recoverable()) ++recoverableCount;
+	}
+
+	unsigned int	accumulatorRows = fstl::min(theApp.GetProfileInt(_T("Options"), _T("accumulatorRows"), 4), recoverableCount);
+	if (ParityInfo::isFftCoded(parityInfo().parityFiles())) accumulatorRows = 0;
+	if (accumulatorRows)	recoveryAccumulator().open(parityInfo().setHash(), accumulatorRows, recoverableCount);
+	else			recoveryAccumulator().close();
+
 	SetTimer(monitorTimer, 0, NULL);
 }
 
@@ -1163,14 +1230,15 @@ void	FSRaidDialog::OnBnClickedLoadButton()
 	pauseButton().EnableWindow(FALSE);
 	progressText().SetWindowText(_T("Loading..."));
 
-	// Load the PAR file
+	// Load the PAR file (anything we've accumulated belongs to the old one)
 
+	recoveryAccumulator().close();
 	bool	loadOK = parityInfo().loadParFile(filename);
 	drawMaps();
 
 	if (!loadOK)
 	{
-		AfxMessageBox(_T("Unable to load file"));
+		AfxMessageBox(parityInfo().lastError().length() ? parityInfo().lastError().asArray() : _T("Unable to load file"));
 		resizeWindow(false);
 		return;
 	}
@@ -1333,7 +1401,7 @@ void	FSRaidDialog::OnBnClickedCreateButton()
 		}
 
 		unsigned char	setHash[EmDeeFive::HASH_SIZE_IN_BYTES];
-		if (!parityInfo().genParFiles(setHash, parityVolumes, dataVolumes, progCallback, this)) throw _T("");
+		if (!parityInfo().genParFiles(setHash, parityVolumes, dataVolumes, progCallback, this)) throw parityInfo().lastError().asArray();
 
 		// Normal
 
@@ -1351,7 +1419,7 @@ void	FSRaidDialog::OnBnClickedCreateButton()
 
 			for (unsigned int i = 0; allSameDir && i < dataVolumes.size(); ++i)
 			{
-				if (dataVolumes[i].filePath().ncCompare(parityVolumes[0].filePath()))
+				if (dataVolumes[i].filePath().path().ncCompare(parityVolumes[0].filePath()))
 				{
 					allSameDir = false;
 				}
@@ -1915,7 +1983,14 @@ void	FSRaidDialog::OnBnClickedRepairButton()
 
 	try
 	{
-		if (!parityInfo().recoverFiles(parityInfo().parityFiles(), parityInfo().dataFiles(), progCallback, this)) throw _T("");
+		// Let the core pick the cheapest way to fix what's broken
+
+		RecoveryAccumulator *	accumulator = recoveryAccumulator().isOpen() ? &recoveryAccumulator() : NULL;
+		if (!parityInfo().repairSet(progCallback, this, accumulator)) throw parityInfo().lastError().asArray();
+
+		// The repaired files were never accumulated, so the accumulator no longer describes the set
+
+		recoveryAccumulator().close();
 
 		// Force a check
 
@@ -1966,6 +2041,10 @@ void	FSRaidDialog::OnBnClickedPrefsButton()
 	PreferencesDialog	dlg;
 	dlg.DoModal();
 
+	// Pick up any changes to the parity settings
+
+	theApp.loadParityOptions(parityInfo().options());
+
 	// Update the file associations?
 
 	if (theApp.GetProfileInt(_T("Options"), _T("associatePAR"), 1))
@@ -2497,6 +2576,89 @@ void	FSRaidDialog::checkFiles(bool & allOK)
 		return;
 	}
 
+	// Syndrome check? (a single pass over the data files & parity volumes that also finds where any damage is -- whatever it
+	// settles, one way or the other, is skipped by the per-file checks below)
+
+	fstl::boolArray	dataSettled;
+	fstl::boolArray	paritySettled;
+	dataSettled.populate(false, parityInfo().dataFiles().size());
+	paritySettled.populate(false, parityInfo().parityFiles().size());
+
+	if (parityInfo().options().syndromeCheck())
+	{
+		// Anything that isn't known to be good is unknown until proven otherwise (so we can tell what the check settled)
+
+		for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+		{
+			if (parityInfo().dataFiles()[i].status() != DataFile::Valid) parityInfo().dataFiles()[i].status() = DataFile::Unknown;
+		}
+
+		for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+		{
+			if (parityInfo().parityFiles()[i].status() != ParityFile::Valid) parityInfo().parityFiles()[i].status() = ParityFile::Unknown;
+		}
+
+		fstl::array<DamageRangeArray>	dataDamage;
+		fstl::array<DamageRangeArray>	parityDamage;
+		DamageRangeArray		unlocated;
+		if (parityInfo().verifySyndromes(parityInfo().parityFiles(), parityInfo().dataFiles(), dataDamage, parityDamage, unlocated, progCallback, reinterpret_cast<void *>(this)))
+		{
+			// Recount what's left for the per-file checks
+
+			dataFileCount = 0;
+			for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+			{
+				DataFile &	df = parityInfo().dataFiles()[i];
+				dataSettled[i] = df.status() == DataFile::Valid || df.status() == DataFile::Corrupt;
+				if (!dataSettled[i]) dataFileCount++;
+			}
+
+			parityFileCount = 0;
+			for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+			{
+				ParityFile &	pf = parityInfo().parityFiles()[i];
+				paritySettled[i] = pf.status() == ParityFile::Valid || pf.status() == ParityFile::Corrupt;
+				if (!paritySettled[i]) parityFileCount++;
+			}
+
+			drawMaps();
+		}
+		else if (cancelFlag())
+		{
+			allOK = false;
+			return;
+		}
+	}
+
+	// Quick check? (CRCs from the block map, in parallel -- anything that fails falls through to the full MD5 check below)
+
+	if (parityInfo().options().quickCheck() && parityInfo().blockMap().hasCrcs())
+	{
+		fstl::intArray	indices;
+		for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+		{
+			if (parityInfo().dataFiles()[i].status() != DataFile::Valid && !dataSettled[i]) indices += i;
+		}
+
+		fstl::boolArray	passed;
+		if (!parityInfo().blockMap().quickCheck(parityInfo().dataFiles(), indices, passed, progCallback, reinterpret_cast<void *>(this)))
+		{
+			allOK = false;
+			return;
+		}
+
+		for (unsigned int i = 0; i < indices.size(); ++i)
+		{
+			if (!passed[i]) continue;
+
+			parityInfo().dataFiles()[indices[i]].status() = DataFile::Valid;
+			parityInfo().dataFiles()[indices[i]].statusString() = _T("Valid (quick check)");
+			dataFileCount--;
+		}
+
+		drawMaps();
+	}
+
 	allOK = true;
 	unsigned int	checkedCount = 0;
 	for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
@@ -2512,9 +2674,9 @@ void	FSRaidDialog::checkFiles(bool & allOK)
 			parityInfo().dataFiles()[i].statusString() = _T("Missing");
 		}
 
-		// Skip files that are A-OK
+		// Skip files that are A-OK (or that the syndrome check already found the damage in)
 
-		if (parityInfo().dataFiles()[i].status() == DataFile::Valid)
+		if (parityInfo().dataFiles()[i].status() == DataFile::Valid || dataSettled[i])
 		{
 			continue;
 		}
@@ -2545,9 +2707,9 @@ void	FSRaidDialog::checkFiles(bool & allOK)
 
 	for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
 	{
-		// Skip files that are A-OK
+		// Skip files that are A-OK (or that the syndrome check already found the damage in)
 
-		if (parityInfo().parityFiles()[i].status() == ParityFile::Valid) continue;
+		if (parityInfo().parityFiles()[i].status() == ParityFile::Valid || paritySettled[i]) continue;
 
 		// Validate it
 
@@ -2646,11 +2808,29 @@ bool	FSRaidDialog::checkDataFile(const int index, const unsigned int totalFiles,
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+bool	FSRaidDialog::showCoreError() const
+{
+	// Nothing to show if the user cancelled
+
+	if (parityInfo().lastError().length()) AfxMessageBox(parityInfo().lastError().asArray());
+	return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 bool	FSRaidDialog::repairDataFile(const int index)
 {
-	// Repair the file
+	// Repair the file (from its local parity group if we can, since that's much less reading)
 
-	if (!parityInfo().recoverFiles(parityInfo().parityFiles(), parityInfo().dataFiles(), progCallback, this, index)) return false;
+	if (parityInfo().localParity().isLoaded() && parityInfo().options().localRepair())
+	{
+		if (!parityInfo().recoverLocal(parityInfo().dataFiles(), progCallback, this, index)) return showCoreError();
+	}
+
+	if (parityInfo().dataFiles()[index].status() != DataFile::Valid)
+	{
+		if (!parityInfo().recoverFiles(parityInfo().parityFiles(), parityInfo().dataFiles(), progCallback, this, index)) return showCoreError();
+	}
 
 	// Update the datafile map
 
@@ -2663,6 +2843,125 @@ bool	FSRaidDialog::repairDataFile(const int index)
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+bool	FSRaidDialog::updateParityForDataFile(const int index)
+{
+	DataFile &	df = parityInfo().dataFiles()[index];
+
+	// We need the original version of the file to know what changed
+
+	const int	fnameSize = 8192;
+	TCHAR		fname[fnameSize];
+	memset(fname, 0, sizeof(fname));
+
+	TCHAR		filters[] =	_T("All files (*.*)\0")
+					_T("*.*\0")
+					_T("\0\0");
+
+	fstl::wstring	title = _T("Choose the original version of ") + df.fileName();
+
+	OPENFILENAME	of;
+	memset(&of, 0, sizeof(OPENFILENAME));
+
+	of.lStructSize  = sizeof(OPENFILENAME);
+	of.hwndOwner    = GetSafeHwnd();
+	of.lpstrFilter  = filters;
+	of.nFilterIndex = 1;
+	of.lpstrFile    = fname;
+	of.nMaxFile     = fnameSize;
+	of.lpstrTitle   = title.asArray();
+	of.Flags        = OFN_HIDEREADONLY | OFN_PATHMUSTEXIST | OFN_FILEMUSTEXIST | OFN_EXPLORER;
+	of.lpstrInitialDir = parityInfo().defaultPath().asArray();
+
+	if (!GetOpenFileName(&of)) return false;
+
+	fstl::wstring	oldFilespec = of.lpstrFile;
+	if (!oldFilespec.ncCompare(df.filespec()))
+	{
+		AfxMessageBox(_T("The original version of the file must be a separate copy of it"));
+		return false;
+	}
+
+	// Update the parity volumes in place
+
+	if (!parityInfo().updateParFiles(index, oldFilespec, progCallback, this)) return showCoreError();
+
+	// The file now matches the set (which has a new hash, so anything we've accumulated is no longer any good)
+
+	recoveryAccumulator().close();
+	df.status() = DataFile::Valid;
+	df.statusString() = _T("Valid (parity updated)");
+
+	for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+	{
+		ParityFile &	pf = parityInfo().parityFiles()[i];
+		if (pf.status() != ParityFile::Valid && pf.status() != ParityFile::Missing)
+		{
+			pf.status() = ParityFile::Corrupt;
+			pf.statusString() = _T("Not updated (no longer part of this set)");
+		}
+	}
+
+	drawMaps();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FSRaidDialog::extendParitySet(const unsigned int volumeCount)
+{
+	// New volumes are numbered after the highest one we know about
+
+	int	highestVolume = 0;
+	for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+	{
+		highestVolume = fstl::max(highestVolume, parityInfo().parityFiles()[i].volumeNumber());
+	}
+
+	ParityFileArray	newVolumes;
+	for (unsigned int i = 1; i <= volumeCount; ++i)
+	{
+		ParityFile	pf;
+		pf.volumeNumber() = highestVolume + i;
+		pf.filePath() = parityInfo().defaultPath();
+
+		// What's this sucker's extension? (p01-p99, q00-q99, etc.)
+
+		TCHAR	dsp[10];
+		swprintf(dsp, _T(".%c%02d"), (pf.volumeNumber() / 100) + _T('p'), pf.volumeNumber() % 100);
+		pf.fileName() = parityInfo().defaultBaseName() + dsp;
+
+		// Don't clobber anything (it may be a volume we just haven't found, yet)
+
+		if (doesFileExist(pf.filespec()))
+		{
+			fstl::wstring	err = _T("Unable to add recovery volumes, because this file is in the way:\n\n") + pf.fileName();
+			AfxMessageBox(err.asArray());
+			return false;
+		}
+
+		newVolumes += pf;
+	}
+
+	if (!parityInfo().extendParFiles(newVolumes, parityInfo().dataFiles(), progCallback, this)) return showCoreError();
+
+	// Pick up the new volumes (we know they're good, we just made them)
+
+	scanForParityFiles();
+	for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+	{
+		ParityFile &	pf = parityInfo().parityFiles()[i];
+		if (pf.volumeNumber() <= highestVolume) continue;
+
+		pf.status() = ParityFile::Valid;
+		pf.statusString() = _T("Just created");
+	}
+
+	drawMaps();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 bool	FSRaidDialog::checkParityFile(const int index, const unsigned int totalFiles, const unsigned int curIndex)
 {
 	// Validate the file
@@ -3110,6 +3409,8 @@ bool	FSRaidDialog::scanForParityFiles()
 void	FSRaidDialog::killDownloadMonitor()
 {
 	KillTimer(monitorTimer);
+	directoryMonitor().close();
+	monitorPending.erase();
 	monitorFlag() = false;
 	resizeWindow(false);
 	progress().ShowWindow(SW_SHOW);
@@ -3117,6 +3418,111 @@ void	FSRaidDialog::killDownloadMonitor()
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+void	FSRaidDialog::refreshMonitoredFile(const fstl::wstring & name, bool & validatedThisPass)
+{
+	// Is it a parity file?
+
+	for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+	{
+		ParityFile &	pf = parityInfo().parityFiles()[i];
+		if (name.ncCompare(pf.fileName())) continue;
+
+		// Missing?
+
+		if (!doesFileExist(pf.filespec()))
+		{
+			// File no longer exists.. update it's status
+
+			pf.status() = ParityFile::Missing;
+			pf.statusString() = _T("Missing");
+			monitorParitySizes[i] = 0;
+			continue;
+		}
+
+		monitorParitySizes[i] = getFileLength(pf.filespec());
+
+		// If not valid, try to validate... but don't bother hashing a volume that hasn't finished arriving yet
+
+		if (pf.status() != ParityFile::Valid && monitorParitySizes[i] >= pf.dataOffset() + pf.dataSize() && !validatedThisPass)
+		{
+			parityInfo().validateParFile(pf, 1, 0);
+			drawMaps();
+
+			// If we just validated a file, stop validating so our stats can update
+
+			if (pf.status() == ParityFile::Valid) validatedThisPass = true;
+		}
+	}
+
+	// Is it a data file?
+
+	for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+	{
+		DataFile &	df = parityInfo().dataFiles()[i];
+		if (name.ncCompare(df.fileName())) continue;
+
+		// Missing?
+
+		if (!doesFileExist(df.filespec()))
+		{
+			// File no longer exists.. update it's status
+
+			df.status() = DataFile::Missing;
+			df.statusString() = _T("Missing");
+			df.resetRunningHash();
+			monitorDataSizes[i] = 0;
+			continue;
+		}
+
+		monitorDataSizes[i] = getFileLength(df.filespec());
+
+		// If not valid, try to validate...
+
+		if (df.status() != DataFile::Valid && !validatedThisPass)
+		{
+			// Hash whatever has arrived since we last looked, so that by the time the file is complete, we already know if
+			// it's any good. If the running hash doesn't agree (the downloader may have gone back and rewritten part of the
+			// file, for example) we fall back to a full validation.
+
+			df.updateRunningHash(monitorDataSizes[i]);
+
+			if (monitorDataSizes[i] == df.fileSize() && df.runningHashMatches())
+			{
+				df.status() = DataFile::Valid;
+				df.statusString() = _T("Valid");
+			}
+			else
+			{
+				parityInfo().validateDataFile(df, 1, 0);
+			}
+
+			drawMaps();
+
+			// If we just validated a file, stop validating so our stats can update
+
+			if (df.status() == DataFile::Valid)
+			{
+				validatedThisPass = true;
+
+				// Fold it into the recovery accumulator while it's still fresh in the cache
+
+				if (recoveryAccumulator().isOpen()) parityInfo().accumulateDataFile(recoveryAccumulator(), i);
+			}
+		}
+
+		// Files that were already valid when we started monitoring still need accumulating (one per pass, like validation)
+
+		else if (df.status() == DataFile::Valid && recoveryAccumulator().isOpen() && !validatedThisPass)
+		{
+			unsigned int	foldedCount = recoveryAccumulator().foldedCount();
+			parityInfo().accumulateDataFile(recoveryAccumulator(), i);
+			if (recoveryAccumulator().foldedCount() != foldedCount) validatedThisPass = true;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 void	FSRaidDialog::monitorDownload()
 {
 	// Kill the timer
@@ -3150,45 +3556,104 @@ void	FSRaidDialog::monitorDownload()
 
 		if (cancelFlag()) throw true;
 
-		// Scan for new parity files
+		// Find out what has changed since the last pass. The watch is started before any scanning, so we can't miss a change
+		// that happens while we're busy. If the system can't give us change notifications (or it dropped some on the floor)
+		// we fall back to rescanning everything, which is what the monitor always used to do.
 
-		scanForParityFiles();
+		if (!directoryMonitor().isOpen())
+		{
+			directoryMonitor().open(parityInfo().defaultPath());
+			monitorRescan = true;
+		}
+		else
+		{
+			DirectoryEventArray	events;
+			if (!directoryMonitor().poll(events))
+			{
+				directoryMonitor().close();
+				monitorRescan = true;
+			}
 
-		// Count parity files
+			if (directoryMonitor().overflowed())
+			{
+				directoryMonitor().overflowed() = false;
+				monitorRescan = true;
+			}
 
-		unsigned int	validParityFiles = 0;
-		unsigned int	validatedThisPass = false;
+			// Track the files that need a look (once each, no matter how many times they were written to)
 
-		for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+			for (unsigned int i = 0; i < events.size(); ++i)
+			{
+				bool	found = false;
+				for (unsigned int j = 0; !found && j < monitorPending.size(); ++j)
+				{
+					if (!monitorPending[j].ncCompare(events[i].fileName())) found = true;
+				}
+
+				if (!found) monitorPending += events[i].fileName();
+			}
+		}
+
+		// If the file lists changed underneath us, our cached sizes are no good
+
+		if (monitorDataSizes.size() != parityInfo().dataFiles().size() || monitorParitySizes.size() != parityInfo().parityFiles().size())
 		{
-			ParityFile &	pf = parityInfo().parityFiles()[i];
+			monitorRescan = true;
+		}
 
-			// Missing?
+		// Any new parity volumes? These show up as names from our set that we don't know about yet.
 
-			if (!doesFileExist(pf.filespec()))
-			{
-				// File no longer exists.. update it's status
+		bool	rescanParity = monitorRescan;
+		for (unsigned int i = 0; !rescanParity && i < monitorPending.size(); ++i)
+		{
+			const fstl::wstring &	name = monitorPending[i];
+			if (name.ncCompare(parityInfo().defaultBaseName(), parityInfo().defaultBaseName().length())) continue;
 
-				pf.status() = ParityFile::Missing;
-				pf.statusString() = _T("Missing");
+			bool	known = false;
+			for (unsigned int j = 0; !known && j < parityInfo().parityFiles().size(); ++j)
+			{
+				if (!name.ncCompare(parityInfo().parityFiles()[j].fileName())) known = true;
 			}
 
-			// If not valid, try to validate...
+			if (!known) rescanParity = true;
+		}
+
+		if (rescanParity)
+		{
+			// Scan for new parity files
+
+			scanForParityFiles();
 
-			if (pf.status() != ParityFile::Valid && !validatedThisPass)
+			monitorParitySizes.erase();
+			monitorParitySizes.populate(0, parityInfo().parityFiles().size());
+			for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
 			{
-				parityInfo().validateParFile(pf, 1, 0);
-				drawMaps();
+				monitorParitySizes[i] = getFileLength(parityInfo().parityFiles()[i].filespec());
+				if (parityInfo().parityFiles()[i].status() != ParityFile::Valid) monitorPending += parityInfo().parityFiles()[i].fileName();
+			}
+		}
 
-				// If we just validated a file, stop validating so our stats can update
+		// A full rescan looks at everything (this is also how we get our baseline on the first pass)
 
-				if (pf.status() == ParityFile::Valid) validatedThisPass = true;
+		if (monitorRescan)
+		{
+			monitorDataSizes.erase();
+			monitorDataSizes.populate(0, parityInfo().dataFiles().size());
+			for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+			{
+				monitorPending += parityInfo().dataFiles()[i].fileName();
 			}
 
-			// Validated?
+			monitorRescan = false;
+		}
 
-			if (pf.volumeNumber() && pf.status() == ParityFile::Valid) ++validParityFiles;
+		// Re-check only the files that changed
+
+		bool	validatedThisPass = false;
+		bool	somethingChanged = monitorPending.size() != 0;
 
+		for (unsigned int i = 0; i < monitorPending.size();)
+		{
 			// Inform the user, handle pause, cancel, etc...
 
 			if (!progCallback(this, _T("Monitoring downloads..."), 0)) throw true;
@@ -3196,42 +3661,40 @@ void	FSRaidDialog::monitorDownload()
 			// Cancelled?
 
 			if (!monitorFlag()) throw true;
-		}
 
-		// Count data files
+			// If we've already validated something, this one will have to wait for the next pass
 
-		unsigned int	dataFilesNeeded = 0;
-		unsigned int	validDataFiles = 0;
-		float		averageDataFileSize = 0.0f;
-		for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
-		{
-			// Inform the user, handle pause, cancel, etc...
-
-			if (!progCallback(this, _T("Monitoring downloads..."), 0)) throw true;
+			if (validatedThisPass)
+			{
+				++i;
+				continue;
+			}
 
-			DataFile &	df = parityInfo().dataFiles()[i];
+			refreshMonitoredFile(monitorPending[i], validatedThisPass);
+			monitorPending.erase(i, 1);
+		}
 
-			// Missing?
+		// Count parity files
 
-			if (!doesFileExist(df.filespec()))
-			{
-				// File no longer exists.. update it's status
+		unsigned int	validParityFiles = 0;
 
-				df.status() = DataFile::Missing;
-				df.statusString() = _T("Missing");
-			}
+		for (unsigned int i = 0; i < parityInfo().parityFiles().size(); ++i)
+		{
+			ParityFile &	pf = parityInfo().parityFiles()[i];
 
-			// If not valid, try to validate...
+			// Validated?
 
-			if (df.status() != DataFile::Valid && !validatedThisPass)
-			{
-				parityInfo().validateDataFile(df, 1, 0);
-				drawMaps();
+			if (pf.volumeNumber() && pf.status() == ParityFile::Valid) ++validParityFiles;
+		}
 
-				// If we just validated a file, stop validating so our stats can update
+		// Count data files
 
-				if (df.status() == DataFile::Valid) validatedThisPass = true;
-			}
+		unsigned int	dataFilesNeeded = 0;
+		unsigned int	validDataFiles = 0;
+		float		averageDataFileSize = 0.0f;
+		for (unsigned int i = 0; i < parityInfo().dataFiles().size(); ++i)
+		{
+			DataFile &	df = parityInfo().dataFiles()[i];
 
 			// Only track stats on recoverable files
 
@@ -3249,14 +3712,6 @@ void	FSRaidDialog::monitorDownload()
 
 				if (df.status() == DataFile::Valid) ++validDataFiles;
 			}
-
-			// Inform the user, handle pause, cancel, etc...
-
-			if (!progCallback(this, _T("Monitoring downloads..."), 0)) throw true;
-
-			// Cancelled?
-
-			if (!monitorFlag()) throw true;
 		}
 
 		averageDataFileSize /= dataFilesNeeded;
@@ -3344,10 +3799,9 @@ void	FSRaidDialog::monitorDownload()
 
 			else
 			{
-				// Get the file size, and count that...
+				// Count what we've seen of the file so far...
 
-				unsigned int	size = getFileLength(df.filespec());
-				dataBytesDownloaded += size;
+				dataBytesDownloaded += monitorDataSizes[i];
 			}
 		}
 
@@ -3381,10 +3835,9 @@ void	FSRaidDialog::monitorDownload()
 
 			else
 			{
-				// Get the file size, and count that...
+				// Count what we've seen of the file so far...
 
-				unsigned int	size = getFileLength(pf.filespec());
-				dataBytesDownloaded += size;
+				dataBytesDownloaded += monitorParitySizes[i];
 			}
 		}
 
@@ -3399,11 +3852,17 @@ void	FSRaidDialog::monitorDownload()
 
 		// Remember stuff
 
-		saveStates(parityInfo().setHash(), parityInfo().parityFiles(), parityInfo().dataFiles());
+		if (somethingChanged) saveStates(parityInfo().setHash(), parityInfo().parityFiles(), parityInfo().dataFiles());
+
+		// When the system is telling us about changes, all we need to do between passes is collect them, which costs next to
+		// nothing, so we can afford to check often.
+
+		if (directoryMonitor().isOpen()) downloadMonitorInterval = monitorPollInterval;
+		else monitorRescan = true;
 
-		// If we just validated a file, use a shorter interval so we can keep going
+		// If we just validated a file (or have more waiting), use a shorter interval so we can keep going
 
-		if (validatedThisPass) downloadMonitorInterval = 0;
+		if (validatedThisPass || monitorPending.size()) downloadMonitorInterval = 0;
 
 		// Keep the love alive!
 
@@ -40,6 +40,7 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "ParityInfo.h"
+#include "DirectoryMonitor.h"
 
 class	AboutBox;
 class	HelpDialog;
@@ -68,6 +69,9 @@ virtual		void		checkFiles(bool & allOK);
 virtual		void		scanForMissingFiles();
 virtual		bool		checkDataFile(const int index, const unsigned int totalFiles, const unsigned int curIndex);
 virtual		bool		repairDataFile(const int index);
+virtual		bool		showCoreError() const;
+virtual		bool		extendParitySet(const unsigned int volumeCount);
+virtual		bool		updateParityForDataFile(const int index);
 virtual		bool		checkParityFile(const int index, const unsigned int totalFiles, const unsigned int curIndex);
 virtual		void		copyStringToClipboard(const fstl::wstring & str);
 virtual		void		calcStats(unsigned int & valid, unsigned int & corrupt, unsigned int & misnamed, unsigned int & missing, unsigned int & unknown, unsigned int & error, unsigned int & needed, unsigned int & recoverable, unsigned int & validRecoverable);
@@ -79,6 +83,7 @@ virtual		bool		loadStates(const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BY
 virtual		bool		scanForParityFiles();
 virtual		void		killDownloadMonitor();
 virtual		void		monitorDownload();
+virtual		void		refreshMonitoredFile(const fstl::wstring & name, bool & validatedThisPass);
 virtual		void		drawMonitorProgress();
 
 	// Generated message map functions
@@ -131,6 +136,10 @@ inline		bool &		busy()		{return _busy;}
 inline	const	bool		busy() const		{return _busy;}
 inline		ParityInfo &	parityInfo()		{return _parityInfo;}
 inline	const	ParityInfo &	parityInfo() const	{return _parityInfo;}
+inline		DirectoryMonitor & directoryMonitor()	{return _directoryMonitor;}
+inline	const	DirectoryMonitor & directoryMonitor() const {return _directoryMonitor;}
+inline		RecoveryAccumulator & recoveryAccumulator() {return _recoveryAccumulator;}
+inline	const	RecoveryAccumulator & recoveryAccumulator() const {return _recoveryAccumulator;}
 inline		CToolTipCtrl *&	toolTip()		{return _toolTip;}
 inline	const	CToolTipCtrl *	toolTip() const		{return _toolTip;}
 inline		CProgressCtrl &	progress()		{return _progress;}
@@ -158,6 +167,8 @@ private:
 		bool		_silent;
 		bool		_busy;
 		ParityInfo	_parityInfo;
+		DirectoryMonitor _directoryMonitor;
+		RecoveryAccumulator _recoveryAccumulator;
 		CToolTipCtrl *	_toolTip;
 
 		fstl::wstring	_startupFile;
@@ -201,6 +212,10 @@ private:
 		unsigned int	resizeDistance;
 		float		validPercent;
 		float		potentialPercent;
+		bool		monitorRescan;
+		fstl::WStringArray monitorPending;
+		fstl::uintArray	monitorDataSizes;
+		fstl::uintArray	monitorParitySizes;
 		int		windowX;
 		int		windowY;
 		int		windowW;
@@ -31,8 +31,13 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "FastWrite.h"
+#include "EngineStats.h"
+
+#ifdef	_LINUX
+#include <fcntl.h>
+#endif
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -42,10 +47,17 @@
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+#ifndef	_LINUX
 	FastWrite::FastWrite()
 	: _bytesWritten(0), _handle(INVALID_HANDLE_VALUE)
 {
 }
+#else
+	FastWrite::FastWrite()
+	: _bytesWritten(0), _handle(-1)
+{
+}
+#endif
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -60,7 +72,7 @@ bool	FastWrite::open(const fstl::wstring & name)
 {
 	// Make sure we can open a file
 
-	if (handle() != INVALID_HANDLE_VALUE) return false;
+	if (isOpen()) return false;
 
 	// Init these...
 
@@ -69,8 +81,12 @@ bool	FastWrite::open(const fstl::wstring & name)
 
 	// Open the file
 
+#ifndef	_LINUX
 	handle() = CreateFile(filename().asArray(), GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_FLAG_WRITE_THROUGH|FILE_FLAG_SEQUENTIAL_SCAN, NULL);
-	if (handle() == INVALID_HANDLE_VALUE) return false;
+#else
+	handle() = ::open(fstl::string(filename().asArray()).asArray(), O_WRONLY|O_CREAT|O_TRUNC, 0666);
+#endif
+	if (!isOpen()) return false;
 
 	// Done
 
@@ -84,11 +100,15 @@ void	FastWrite::close()
 	bytesWritten() = 0;
 	filename() = _T("");
 
-	if (handle() != INVALID_HANDLE_VALUE)
-	{
-		CloseHandle(handle());
-		handle() = INVALID_HANDLE_VALUE;
-	}
+	if (!isOpen()) return;
+
+#ifndef	_LINUX
+	CloseHandle(handle());
+	handle() = INVALID_HANDLE_VALUE;
+#else
+	::close(handle());
+	handle() = -1;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -97,25 +117,24 @@ bool	FastWrite::write(void * buffer, const unsigned int count)
 {
 	// Make sure we have an open file
 
-	if (handle() == INVALID_HANDLE_VALUE) return false;
-
-	// Write some data
+	if (!isOpen()) return false;
 
-	DWORD	br = 0;
-	if (!WriteFile(handle(), buffer, count, &br, NULL))
-	{
-		DWORD	er = GetLastError();
+	EngineTimer	timer(EngineStats::Writing);
 
-		// Okay, we got an error we don't allow, inform the caller
+	// Write some data (if it fails, the caller knows what it was writing, and tells the user)
 
-		fstl::wstring	err = _T("Unable to write: ") + getLastErrorString(er);
-		AfxMessageBox(err.asArray());
-		return false;
-	}
+#ifndef	_LINUX
+	DWORD	br = 0;
+	if (!WriteFile(handle(), buffer, count, &br, NULL)) return false;
+#else
+	ssize_t	br = ::write(handle(), buffer, count);
+	if (br != static_cast<ssize_t>(count)) return false;
+#endif
 
 	// Keep track of where we are...
 
 	bytesWritten() += br;
+	EngineStats::count(EngineStats::BytesWritten, br);
 
 	// Return the buffer
 
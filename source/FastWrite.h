@@ -61,15 +61,28 @@ inline		fstl::wstring &	filename()			{return _filename;}
 inline	const	fstl::wstring &	filename() const		{return _filename;}
 inline		unsigned int &	bytesWritten()			{return _bytesWritten;}
 inline	const	unsigned int	bytesWritten() const		{return _bytesWritten;}
+#ifndef	_LINUX
 inline		HANDLE &	handle()			{return _handle;}
 inline	const	HANDLE		handle() const			{return _handle;}
 
+inline		bool		isOpen() const			{return handle() != INVALID_HANDLE_VALUE;}
+#else
+inline		int &		handle()			{return _handle;}
+inline	const	int		handle() const			{return _handle;}
+
+inline		bool		isOpen() const			{return handle() >= 0;}
+#endif
+
 private:
 	// Data members
 
 		fstl::wstring	_filename;
 		unsigned int	_bytesWritten;
+#ifndef	_LINUX
 		HANDLE		_handle;
+#else
+		int		_handle;
+#endif
 };
 
 typedef	fstl::array<FastWrite>		FastWriteArray;
@@ -0,0 +1,754 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______ __ _    _____          _                               
+// |  ____/ _| |  / ____|        | |                              
+// | |__ | |_| |_| |     ___   __| | ___  ___     ___ _ __  _ __  
+// |  __||  _| __| |    / _ \ / _` |/ _ \/ __|   / __| '_ \| '_ \ 
+// | |   | | | |_| |___| (_) | (_| |  __/ (__  _| (__| |_) | |_) |
+// |_|   |_|  \__|\_____\___/ \__,_|\___|\___|(_)\___| .__/| .__/ 
+//                                                   | |   | |    
+//                                                   |_|   |_|    
+//
+// Description:
+//
+//   Additive-FFT Reed-Solomon codec
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "FftCodec.h"
+#include "EngineStats.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The field is GF(2^16), generated by x^16 + x^5 + x^3 + x^2 + 1. Field elements are stored as 16-bit little-endian words, so
+// every buffer handed to this codec must be an even number of bytes long.
+//
+// Codeword positions are field elements (we use the standard basis, so position i is simply the element i.) Data file i lives
+// at position i, and parity volume j lives at position dataSpan() + j, so the layout doesn't depend on how many parity volumes
+// there are (volumes can go missing without us needing to know how many there were.) The data is interpolated (IFFT) into
+// the Lin-Chung-Han "novel polynomial basis" and then evaluated (FFT) at the parity positions, which costs O(n log n) rather
+// than the O(data x parity) of a Vandermonde matrix.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	unsigned int	FIELD_POLYNOMIAL = 0x1002D;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	unsigned int	powerOfTwo(const unsigned int value)
+{
+	unsigned int	result = 1;
+	while (result < value) result <<= 1;
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	FftCodec::FftCodec()
+	: _gflog(static_cast<unsigned short *>(0)), _gfexp(static_cast<unsigned short *>(0)), _workBytes(0)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	FftCodec::~FftCodec()
+{
+	freeWork();
+	delete[] gflog();
+	delete[] gfexp();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::init()
+{
+	if (isInitialized()) return true;
+
+	// Log & exponent tables (the exponent table is doubled, so we never need to reduce a sum of two logs)
+
+	gflog() = new unsigned short[FIELD_SIZE];
+	gfexp() = new unsigned short[MODULUS * 2 + 1];
+	if (!gflog() || !gfexp())
+	{
+		delete[] gflog();
+		delete[] gfexp();
+		gflog() = static_cast<unsigned short *>(0);
+		gfexp() = static_cast<unsigned short *>(0);
+		return false;
+	}
+
+	unsigned int	b = 1;
+	for (unsigned int l = 0; l < MODULUS; ++l)
+	{
+		gflog()[b] = static_cast<unsigned short>(l);
+		gfexp()[l] = static_cast<unsigned short>(b);
+		gfexp()[l + MODULUS] = static_cast<unsigned short>(b);
+		b <<= 1;
+		if (b & FIELD_SIZE) b ^= FIELD_POLYNOMIAL;
+	}
+	gfexp()[MODULUS * 2] = gfexp()[0];
+	gflog()[0] = 0;
+
+	// Subspace vanishing polynomials: s_0(x) = x, s_(j+1)(x) = s_j(x) * (s_j(x) + s_j(2^j)). These are linear, so we only need
+	// their values at each basis element (2^b). We store them normalized, so that s_j(2^j) == 1.
+
+	unsigned int	s[BITS+1][BITS];
+	for (unsigned int i = 0; i < BITS; ++i) s[0][i] = 1 << i;
+	for (unsigned int j = 0; j < BITS; ++j)
+	{
+		for (unsigned int i = 0; i < BITS; ++i)
+		{
+			s[j+1][i] = gfMUL(s[j][i], s[j][i] ^ s[j][j]);
+		}
+	}
+
+	subspaceValues().erase();
+	subspaceValues().reserve(BITS * BITS);
+	for (unsigned int j = 0; j < BITS; ++j)
+	{
+		for (unsigned int i = 0; i < BITS; ++i)
+		{
+			subspaceValues() += gfDIV(s[j][i], s[j][j]);
+		}
+	}
+
+	// The (normalized) subspace polynomials are linear, so their derivative is a constant: the product of the non-zero
+	// elements of the subspace they vanish on, over the normalization factor. We store them as logs.
+
+	derivativeLogs().erase();
+	unsigned int	product = 1;
+	unsigned int	next = 1;
+	for (unsigned int j = 0; j < BITS; ++j)
+	{
+		for (; next < (1U << j); ++next) product = gfMUL(product, next);
+		derivativeLogs() += (gflog()[product] + MODULUS - gflog()[s[j][j]]) % MODULUS;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::supports(const unsigned int dataCount, const unsigned int parityCount)
+{
+	if (!dataCount || !parityCount) return false;
+	if (dataCount >= MODULUS || parityCount >= MODULUS) return false;
+	return dataSpan(dataCount) + parityCount <= FIELD_SIZE;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	FftCodec::dataSpan(const unsigned int dataCount)
+{
+	return powerOfTwo(dataCount);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	FftCodec::codewordSpan(const unsigned int dataCount, const unsigned int parityCount)
+{
+	return powerOfTwo(dataSpan(dataCount) + parityCount);
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::encode(const fstl::array<unsigned char *> & data, fstl::array<unsigned char *> & parity, const unsigned int bytes)
+{
+	unsigned int	k = data.size();
+	unsigned int	m = parity.size();
+	if (!init() || !supports(k, m) || (bytes & 1)) return false;
+
+	EngineTimer	timer(EngineStats::Galois);
+
+	unsigned int	span = dataSpan(k);
+	if (!allocWork(span * 2, bytes)) return false;
+
+	// Interpolate the data (padded with zeros) into the novel polynomial basis
+
+	unsigned char **	coefficients = &work()[0];
+	unsigned char **	evaluation = &work()[span];
+
+	for (unsigned int i = 0; i < span; ++i)
+	{
+		if (i < k)	memcpy(coefficients[i], data[i], bytes);
+		else		memset(coefficients[i], 0, bytes);
+	}
+
+	ifft(coefficients, span, 0, bytes);
+
+	// Evaluate that polynomial at the parity positions, one span at a time
+
+	for (unsigned int base = 0; base < m; base += span)
+	{
+		for (unsigned int i = 0; i < span; ++i) memcpy(evaluation[i], coefficients[i], bytes);
+
+		fft(evaluation, span, span + base, bytes);
+
+		for (unsigned int i = 0; i < span && base + i < m; ++i)
+		{
+			memcpy(parity[base + i], evaluation[i], bytes);
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::decode(fstl::array<unsigned char *> & data, const fstl::boolArray & dataPresent, const fstl::array<unsigned char *> & parity, const fstl::boolArray & parityPresent, const unsigned int bytes)
+{
+	unsigned int	k = data.size();
+	unsigned int	m = parity.size();
+	if (!init() || !supports(k, m) || (bytes & 1)) return false;
+	if (dataPresent.size() != k || parityPresent.size() != m) return false;
+
+	EngineTimer	timer(EngineStats::Galois);
+
+	unsigned int	span = dataSpan(k);
+	unsigned int	size = codewordSpan(k, m);
+
+	// Which positions do we know? (The padding past the end of the data is always known to be zero)
+
+	unsigned int	known = span - k;
+	unsigned int	missing = 0;
+	fstl::boolArray	erased;
+	erased.populate(true, size);
+
+	for (unsigned int i = 0; i < span; ++i)
+	{
+		if (i >= k || dataPresent[i]) erased[i] = false;
+		if (i < k && dataPresent[i]) ++known;
+		if (i < k && !dataPresent[i]) ++missing;
+	}
+
+	for (unsigned int i = 0; i < m; ++i)
+	{
+		if (parityPresent[i]) {erased[span + i] = false; ++known;}
+	}
+
+	if (!missing) return true;
+	if (known < span) return false;
+
+	// The error locator L(x) = product of (x - e) over each erased position e. We need log(L(p)) at each known position p, and
+	// log(L'(e)) at each erased position e. Both are the sum over erased positions of log(p ^ e) (skipping p == e), which is
+	// an XOR-convolution, so we do it in O(n log n) with a Walsh-Hadamard transform (mod 2^16-1, the order of the logs.)
+	//
+	// This only depends on which positions were erased, so we hang on to it for the next piece of the same set.
+
+	if (erased != lastErasures() || lastLocator().size() != size)
+	{
+		if (logWalsh().size() != size)
+		{
+			logWalsh().erase();
+			logWalsh().reserve(size);
+			logWalsh() += 0;
+			for (unsigned int i = 1; i < size; ++i) logWalsh() += gflog()[i];
+			walsh(logWalsh());
+		}
+
+		fstl::uintArray	&	locator = lastLocator();
+		locator.erase();
+		locator.reserve(size);
+		for (unsigned int i = 0; i < size; ++i) locator += erased[i] ? 1:0;
+		walsh(locator);
+
+		for (unsigned int i = 0; i < size; ++i) locator[i] = (locator[i] * logWalsh()[i]) % MODULUS;
+		walsh(locator);
+
+		// The transform is its own inverse, up to a factor of size (and 2^16 == 1, mod 2^16-1)
+
+		unsigned int	scale = FIELD_SIZE / size;
+		for (unsigned int i = 0; i < size; ++i) locator[i] = (locator[i] * scale) % MODULUS;
+
+		lastErasures() = erased;
+	}
+
+	if (!allocWork(size, bytes)) return false;
+
+	// Evaluations of L(x) * f(x) at every position (zero at the erasures)
+
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		const unsigned char *	src = static_cast<const unsigned char *>(0);
+		if (!erased[i])
+		{
+			if (i < k)						src = data[i];
+			else if (i >= span && i < span + m)			src = parity[i - span];
+		}
+
+		if (!src)
+		{
+			memset(work()[i], 0, bytes);
+			continue;
+		}
+
+		memcpy(work()[i], src, bytes);
+		mul(work()[i], lastLocator()[i], bytes);
+	}
+
+	// (L(x) * f(x))' == L'(x) * f(x) at the erased positions (since L(e) == 0 there), so the formal derivative gives us the
+	// missing data
+
+	ifft(&work()[0], size, 0, bytes);
+	derivative(&work()[0], size, bytes);
+	fft(&work()[0], size, 0, bytes);
+
+	for (unsigned int i = 0; i < k; ++i)
+	{
+		if (dataPresent[i]) continue;
+
+		memcpy(data[i], work()[i], bytes);
+		mul(data[i], MODULUS - lastLocator()[i], bytes);
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::encodeVandermonde(const fstl::array<unsigned char *> & data, fstl::array<unsigned char *> & parity, const unsigned int bytes)
+{
+	unsigned int	k = data.size();
+	unsigned int	m = parity.size();
+	if (!init() || !supports(k, m) || (bytes & 1)) return false;
+
+	// Parity row j is the sum of (i+1)^j * data[i] (the same matrix as the PAR engine, only in a bigger field)
+
+	for (unsigned int j = 0; j < m; ++j)
+	{
+		memset(parity[j], 0, bytes);
+		for (unsigned int i = 0; i < k; ++i)
+		{
+			mulAdd(parity[j], data[i], (gflog()[i+1] * j) % MODULUS, bytes);
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::decodeVandermonde(fstl::array<unsigned char *> & data, const fstl::boolArray & dataPresent, const fstl::array<unsigned char *> & parity, const fstl::boolArray & parityPresent, const unsigned int bytes)
+{
+	unsigned int	k = data.size();
+	unsigned int	m = parity.size();
+	if (!init() || !supports(k, m) || (bytes & 1)) return false;
+	if (dataPresent.size() != k || parityPresent.size() != m) return false;
+
+	fstl::uintArray	lost;
+	for (unsigned int i = 0; i < k; ++i) if (!dataPresent[i]) lost += i;
+
+	fstl::uintArray	rows;
+	for (unsigned int i = 0; i < m && rows.size() < lost.size(); ++i) if (parityPresent[i]) rows += i;
+
+	if (!lost.size()) return true;
+	if (rows.size() < lost.size()) return false;
+
+	unsigned int	count = lost.size();
+	if (!allocWork(count, bytes)) return false;
+
+	// Remove the known data from each parity row we're using
+
+	for (unsigned int r = 0; r < count; ++r)
+	{
+		memcpy(work()[r], parity[rows[r]], bytes);
+		for (unsigned int i = 0; i < k; ++i)
+		{
+			if (dataPresent[i]) mulAdd(work()[r], data[i], (gflog()[i+1] * rows[r]) % MODULUS, bytes);
+		}
+	}
+
+	// Invert the square matrix of the lost columns (Gauss-Jordan)
+
+	fstl::uintArray	matrix;
+	fstl::uintArray	inverse;
+	matrix.populate(0, count * count);
+	inverse.populate(0, count * count);
+	for (unsigned int r = 0; r < count; ++r)
+	{
+		for (unsigned int c = 0; c < count; ++c)
+		{
+			matrix[r * count + c] = gfexp()[(gflog()[lost[c]+1] * rows[r]) % MODULUS];
+		}
+		inverse[r * count + r] = 1;
+	}
+
+	for (unsigned int c = 0; c < count; ++c)
+	{
+		unsigned int	pivot = c;
+		while (pivot < count && !matrix[pivot * count + c]) ++pivot;
+		if (pivot == count) return false;
+
+		if (pivot != c)
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				fstl::swap(matrix[pivot * count + i], matrix[c * count + i]);
+				fstl::swap(inverse[pivot * count + i], inverse[c * count + i]);
+			}
+		}
+
+		unsigned int	div = matrix[c * count + c];
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			matrix[c * count + i] = gfDIV(matrix[c * count + i], div);
+			inverse[c * count + i] = gfDIV(inverse[c * count + i], div);
+		}
+
+		for (unsigned int r = 0; r < count; ++r)
+		{
+			if (r == c) continue;
+			unsigned int	factor = matrix[r * count + c];
+			if (!factor) continue;
+
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				matrix[r * count + i] ^= gfMUL(factor, matrix[c * count + i]);
+				inverse[r * count + i] ^= gfMUL(factor, inverse[c * count + i]);
+			}
+		}
+	}
+
+	// Apply it
+
+	for (unsigned int l = 0; l < count; ++l)
+	{
+		memset(data[lost[l]], 0, bytes);
+		for (unsigned int r = 0; r < count; ++r)
+		{
+			unsigned int	factor = inverse[l * count + r];
+			if (factor) mulAdd(data[lost[l]], work()[r], gflog()[factor], bytes);
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::benchmark(const unsigned int dataCount, const unsigned int parityCount, const unsigned int bytes, double & fftEncodeSeconds, double & fftDecodeSeconds, double & vandermondeEncodeSeconds, double & vandermondeDecodeSeconds)
+{
+	FftCodec	codec;
+	if (!codec.init() || !supports(dataCount, parityCount) || (bytes & 1)) return false;
+
+	// Random data
+
+	fstl::array<unsigned char *>	data;
+	fstl::array<unsigned char *>	parity;
+	fstl::array<unsigned char *>	original;
+	bool				result = false;
+
+	data.populate(static_cast<unsigned char *>(0), dataCount);
+	parity.populate(static_cast<unsigned char *>(0), parityCount);
+
+	// Lose as many data files as we can recover, spread across the set
+
+	unsigned int	lostCount = fstl::min(dataCount, parityCount);
+	fstl::boolArray	dataPresent;
+	fstl::boolArray	parityPresent;
+	dataPresent.populate(true, dataCount);
+	parityPresent.populate(true, parityCount);
+	for (unsigned int i = 0; i < lostCount; ++i) dataPresent[static_cast<unsigned int>(static_cast<double>(i) * dataCount / lostCount)] = false;
+
+	original.populate(static_cast<unsigned char *>(0), lostCount);
+
+	try
+	{
+		for (unsigned int i = 0; i < dataCount; ++i)
+		{
+			data[i] = new unsigned char[bytes];
+			if (!data[i]) throw false;
+			for (unsigned int j = 0; j < bytes; ++j) data[i][j] = static_cast<unsigned char>(rand());
+		}
+
+		for (unsigned int i = 0; i < parityCount; ++i)
+		{
+			parity[i] = new unsigned char[bytes];
+			if (!parity[i]) throw false;
+		}
+
+		for (unsigned int i = 0, l = 0; i < dataCount; ++i)
+		{
+			if (dataPresent[i]) continue;
+			original[l] = new unsigned char[bytes];
+			if (!original[l]) throw false;
+			memcpy(original[l++], data[i], bytes);
+		}
+
+		for (unsigned int pass = 0; pass < 2; ++pass)
+		{
+			double &	encodeSeconds = pass ? vandermondeEncodeSeconds : fftEncodeSeconds;
+			double &	decodeSeconds = pass ? vandermondeDecodeSeconds : fftDecodeSeconds;
+
+			clock_t	start = clock();
+			if (!(pass ? codec.encodeVandermonde(data, parity, bytes) : codec.encode(data, parity, bytes))) throw false;
+			encodeSeconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+			for (unsigned int i = 0; i < dataCount; ++i) if (!dataPresent[i]) memset(data[i], 0, bytes);
+
+			start = clock();
+			if (!(pass ? codec.decodeVandermonde(data, dataPresent, parity, parityPresent, bytes) : codec.decode(data, dataPresent, parity, parityPresent, bytes))) throw false;
+			decodeSeconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+			// Make sure we got it right
+
+			for (unsigned int i = 0, l = 0; i < dataCount; ++i)
+			{
+				if (dataPresent[i]) continue;
+				if (memcmp(original[l++], data[i], bytes)) throw false;
+			}
+		}
+
+		result = true;
+	}
+	catch (const bool)
+	{
+	}
+
+	for (unsigned int i = 0; i < data.size(); ++i) delete[] data[i];
+	for (unsigned int i = 0; i < parity.size(); ++i) delete[] parity[i];
+	for (unsigned int i = 0; i < original.size(); ++i) delete[] original[i];
+
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	FftCodec::gfMUL(const unsigned int a, const unsigned int b) const
+{
+	if (!a || !b) return 0;
+	return gfexp()[gflog()[a] + gflog()[b]];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	FftCodec::gfDIV(const unsigned int a, const unsigned int b) const
+{
+	if (!a) return 0;
+	return gfexp()[gflog()[a] + MODULUS - gflog()[b]];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	FftCodec::subspaceValue(const unsigned int level, const unsigned int index) const
+{
+	const unsigned int *	row = &subspaceValues()[level * BITS];
+	unsigned int		result = 0;
+	for (unsigned int i = 0; i < BITS; ++i)
+	{
+		if (index & (1 << i)) result ^= row[i];
+	}
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Multiplication by a constant is linear, so we build two 256-entry tables (one for each byte of the element) from 16
+// multiplies, and then each element costs two lookups.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	buildTables(const unsigned short * gflog, const unsigned short * gfexp, const unsigned int logFactor, unsigned short lo[256], unsigned short hi[256])
+{
+	lo[0] = hi[0] = 0;
+	for (unsigned int b = 0; b < 8; ++b)
+	{
+		unsigned short	l = gfexp[gflog[1 << b] + logFactor];
+		unsigned short	h = gfexp[gflog[1 << (b + 8)] + logFactor];
+		unsigned int	bit = 1 << b;
+		for (unsigned int i = 0; i < bit; ++i)
+		{
+			lo[bit + i] = lo[i] ^ l;
+			hi[bit + i] = hi[i] ^ h;
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::mulAdd(unsigned char * dst, const unsigned char * src, const unsigned int logFactor, const unsigned int bytes) const
+{
+	unsigned short	lo[256], hi[256];
+	buildTables(gflog(), gfexp(), logFactor, lo, hi);
+
+	unsigned short *	d = reinterpret_cast<unsigned short *>(dst);
+	const unsigned short *	s = reinterpret_cast<const unsigned short *>(src);
+	unsigned int		count = bytes / 2;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned short	v = s[i];
+		d[i] ^= lo[v & 0xff] ^ hi[v >> 8];
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::mul(unsigned char * dst, const unsigned int logFactor, const unsigned int bytes) const
+{
+	if (!(logFactor % MODULUS)) return;
+
+	unsigned short	lo[256], hi[256];
+	buildTables(gflog(), gfexp(), logFactor % MODULUS, lo, hi);
+
+	unsigned short *	d = reinterpret_cast<unsigned short *>(dst);
+	unsigned int		count = bytes / 2;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		unsigned short	v = d[i];
+		d[i] = lo[v & 0xff] ^ hi[v >> 8];
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	xorBuffer(unsigned char * dst, const unsigned char * src, const unsigned int bytes)
+{
+	unsigned int *		d = reinterpret_cast<unsigned int *>(dst);
+	const unsigned int *	s = reinterpret_cast<const unsigned int *>(src);
+	unsigned int		count = bytes / sizeof(unsigned int);
+	for (unsigned int i = 0; i < count; ++i) d[i] ^= s[i];
+	for (unsigned int i = count * sizeof(unsigned int); i < bytes; ++i) dst[i] ^= src[i];
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Evaluates a polynomial (in the novel polynomial basis) with 'size' coefficients at positions [offset, offset+size). The offset
+// must be a multiple of size.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::fft(unsigned char ** buffers, const unsigned int size, const unsigned int offset, const unsigned int bytes) const
+{
+	unsigned int	level = 0;
+	while ((2U << level) < size) ++level;
+
+	for (unsigned int half = size / 2; half; half /= 2, --level)
+	{
+		for (unsigned int block = 0; block < size; block += half * 2)
+		{
+			unsigned int	skew = subspaceValue(level, offset + block);
+			for (unsigned int i = block; i < block + half; ++i)
+			{
+				if (skew) mulAdd(buffers[i], buffers[i + half], gflog()[skew], bytes);
+				xorBuffer(buffers[i + half], buffers[i], bytes);
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The inverse of fft(): the values at positions [offset, offset+size) become coefficients in the novel polynomial basis
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::ifft(unsigned char ** buffers, const unsigned int size, const unsigned int offset, const unsigned int bytes) const
+{
+	unsigned int	level = 0;
+	for (unsigned int half = 1; half < size; half *= 2, ++level)
+	{
+		for (unsigned int block = 0; block < size; block += half * 2)
+		{
+			unsigned int	skew = subspaceValue(level, offset + block);
+			for (unsigned int i = block; i < block + half; ++i)
+			{
+				xorBuffer(buffers[i + half], buffers[i], bytes);
+				if (skew) mulAdd(buffers[i], buffers[i + half], gflog()[skew], bytes);
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Formal derivative in the novel polynomial basis. Each basis polynomial X_i is the product of the subspace polynomials for the
+// bits set in i, and each of those has a constant derivative, so X_i' is the sum over those bits j of (s_j' * X_(i ^ 2^j)).
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::derivative(unsigned char ** buffers, const unsigned int size, const unsigned int bytes) const
+{
+	// X_0 is a constant, and everything else only contributes to lower indices (which we've already visited)
+
+	memset(buffers[0], 0, bytes);
+	for (unsigned int i = 1; i < size; ++i)
+	{
+		for (unsigned int j = 0; (1U << j) <= i; ++j)
+		{
+			if (i & (1 << j)) mulAdd(buffers[i ^ (1 << j)], buffers[i], derivativeLogs()[j], bytes);
+		}
+		memset(buffers[i], 0, bytes);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// In-place Walsh-Hadamard transform, mod 2^16-1
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::walsh(fstl::uintArray & values) const
+{
+	unsigned int	size = values.size();
+	for (unsigned int half = 1; half < size; half *= 2)
+	{
+		for (unsigned int block = 0; block < size; block += half * 2)
+		{
+			for (unsigned int i = block; i < block + half; ++i)
+			{
+				unsigned int	a = values[i];
+				unsigned int	b = values[i + half];
+				values[i] = (a + b) % MODULUS;
+				values[i + half] = (a + MODULUS - b) % MODULUS;
+			}
+		}
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	FftCodec::allocWork(const unsigned int count, const unsigned int bytes)
+{
+	if (workBytes() == bytes && work().size() >= count) return true;
+
+	freeWork();
+
+	work().populate(static_cast<unsigned char *>(0), count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		work()[i] = new unsigned char[bytes];
+		if (!work()[i])
+		{
+			freeWork();
+			return false;
+		}
+	}
+
+	workBytes() = bytes;
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	FftCodec::freeWork()
+{
+	for (unsigned int i = 0; i < work().size(); ++i) delete[] work()[i];
+	work().erase();
+	workBytes() = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// FftCodec.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
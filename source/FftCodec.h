@@ -0,0 +1,129 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  ______ __ _    _____          _               _     
+// |  ____/ _| |  / ____|        | |             | |    
+// | |__ | |_| |_| |     ___   __| | ___  ___    | |__  
+// |  __||  _| __| |    / _ \ / _` |/ _ \/ __|   | '_ \ 
+// | |   | | | |_| |___| (_) | (_| |  __/ (__  _ | | | |
+// |_|   |_|  \__|\_____\___/ \__,_|\___|\___|(_)|_| |_|
+//                                                      
+//                                                      
+//
+// Description:
+//
+//   Additive-FFT (Lin-Chung-Han) Reed-Solomon codec over GF(2^16), used for sets that are too big for the
+//   Vandermonde engine (it's O(n log n) for both encode and decode, rather than O(data x parity) and O(k^3))
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_FFTCODEC
+#define _H_FFTCODEC
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	FftCodec
+{
+public:
+	// Enumerations
+
+		enum			{BITS = 16};
+		enum			{FIELD_SIZE = 1 << BITS};
+		enum			{MODULUS = FIELD_SIZE - 1};
+
+	// Construction/Destruction
+
+					FftCodec();
+virtual					~FftCodec();
+
+	// Implementation
+
+virtual		bool			init();
+virtual		bool			encode(const fstl::array<unsigned char *> & data, fstl::array<unsigned char *> & parity, const unsigned int bytes);
+virtual		bool			decode(fstl::array<unsigned char *> & data, const fstl::boolArray & dataPresent, const fstl::array<unsigned char *> & parity, const fstl::boolArray & parityPresent, const unsigned int bytes);
+virtual		bool			encodeVandermonde(const fstl::array<unsigned char *> & data, fstl::array<unsigned char *> & parity, const unsigned int bytes);
+virtual		bool			decodeVandermonde(fstl::array<unsigned char *> & data, const fstl::boolArray & dataPresent, const fstl::array<unsigned char *> & parity, const fstl::boolArray & parityPresent, const unsigned int bytes);
+
+static		bool			supports(const unsigned int dataCount, const unsigned int parityCount);
+static		unsigned int		dataSpan(const unsigned int dataCount);
+static		unsigned int		codewordSpan(const unsigned int dataCount, const unsigned int parityCount);
+static		bool			benchmark(const unsigned int dataCount, const unsigned int parityCount, const unsigned int bytes, double & fftEncodeSeconds, double & fftDecodeSeconds, double & vandermondeEncodeSeconds, double & vandermondeDecodeSeconds);
+
+	// Accessors
+
+inline		unsigned short *&	gflog()				{return _gflog;}
+inline	const	unsigned short *	gflog() const			{return _gflog;}
+inline		unsigned short *&	gfexp()				{return _gfexp;}
+inline	const	unsigned short *	gfexp() const			{return _gfexp;}
+inline		fstl::uintArray &	subspaceValues()		{return _subspaceValues;}
+inline	const	fstl::uintArray &	subspaceValues() const		{return _subspaceValues;}
+inline		fstl::uintArray &	derivativeLogs()		{return _derivativeLogs;}
+inline	const	fstl::uintArray &	derivativeLogs() const		{return _derivativeLogs;}
+inline		fstl::uintArray &	logWalsh()			{return _logWalsh;}
+inline	const	fstl::uintArray &	logWalsh() const		{return _logWalsh;}
+inline		fstl::array<unsigned char *> & work()			{return _work;}
+inline	const	fstl::array<unsigned char *> & work() const		{return _work;}
+inline		unsigned int &		workBytes()			{return _workBytes;}
+inline	const	unsigned int		workBytes() const		{return _workBytes;}
+inline		fstl::boolArray &	lastErasures()			{return _lastErasures;}
+inline	const	fstl::boolArray &	lastErasures() const		{return _lastErasures;}
+inline		fstl::uintArray &	lastLocator()			{return _lastLocator;}
+inline	const	fstl::uintArray &	lastLocator() const		{return _lastLocator;}
+
+inline	const	bool			isInitialized() const		{return gflog() != NULL;}
+
+private:
+	// Private implementation
+
+virtual		unsigned int		gfMUL(const unsigned int a, const unsigned int b) const;
+virtual		unsigned int		gfDIV(const unsigned int a, const unsigned int b) const;
+virtual		unsigned int		subspaceValue(const unsigned int level, const unsigned int index) const;
+virtual		void			mulAdd(unsigned char * dst, const unsigned char * src, const unsigned int logFactor, const unsigned int bytes) const;
+virtual		void			mul(unsigned char * dst, const unsigned int logFactor, const unsigned int bytes) const;
+virtual		void			fft(unsigned char ** buffers, const unsigned int size, const unsigned int offset, const unsigned int bytes) const;
+virtual		void			ifft(unsigned char ** buffers, const unsigned int size, const unsigned int offset, const unsigned int bytes) const;
+virtual		void			derivative(unsigned char ** buffers, const unsigned int size, const unsigned int bytes) const;
+virtual		void			walsh(fstl::uintArray & values) const;
+virtual		bool			allocWork(const unsigned int count, const unsigned int bytes);
+virtual		void			freeWork();
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					FftCodec(const FftCodec & rhs);
+inline		FftCodec &		operator =(const FftCodec & rhs);
+
+	// Data members
+
+		unsigned short *	_gflog;
+		unsigned short *	_gfexp;
+		fstl::uintArray		_subspaceValues;
+		fstl::uintArray		_derivativeLogs;
+		fstl::uintArray		_logWalsh;
+		fstl::array<unsigned char *> _work;
+		unsigned int		_workBytes;
+		fstl::boolArray		_lastErasures;
+		fstl::uintArray		_lastLocator;
+};
+
+#endif // _H_FFTCODEC
+// ---------------------------------------------------------------------------------------------------------------------------------
+// FftCodec.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
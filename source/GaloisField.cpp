@@ -0,0 +1,147 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____       _       _     ______ _      _     _                     
+//  / ____|     | |     (_)   |  ____(_)    | |   | |                    
+// | |  __  __ _| | ___  _ ___| |__   _  ___| | __| |    ___ _ __  _ __  
+// | | |_ |/ _` | |/ _ \| / __|  __| | |/ _ \ |/ _` |   / __| '_ \| '_ \ 
+// | |__| | (_| | | (_) | \__ \ |    | |  __/ | (_| | _| (__| |_) | |_) |
+//  \_____|\__,_|_|\___/|_|___/_|    |_|\___|_|\__,_|(_)\___| .__/| .__/ 
+//                                                          | |   | |    
+//                                                          |_|   |_|    
+//
+// Description:
+//
+//   Shared, immutable Galois Field log & inverse log tables
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "GaloisField.h"
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// One slot per supported bit depth (4, 8 and 16)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	GaloisField * volatile	fields[3];
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	GaloisField::GaloisField(const unsigned int bits)
+	: _bits(bits), _log(static_cast<unsigned int *>(0)), _exp(static_cast<unsigned int *>(0))
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	GaloisField::~GaloisField()
+{
+	delete[] _log;
+	delete[] _exp;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Returns the shared tables for the given bit depth (or NULL for an unsupported depth.) Two threads may race to build the same
+// field; the loser throws its copy away and uses the winner's.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	GaloisField *	GaloisField::fieldFor(const unsigned int bits)
+{
+	unsigned int	slot;
+	switch(bits)
+	{
+		case 4:  slot = 0; break;
+		case 8:  slot = 1; break;
+		case 16: slot = 2; break;
+		default: return static_cast<GaloisField *>(0);
+	}
+
+	if (fields[slot]) return fields[slot];
+
+	GaloisField *	field = new GaloisField(bits);
+	if (!field) return static_cast<GaloisField *>(0);
+	if (!field->build())
+	{
+		delete field;
+		return static_cast<GaloisField *>(0);
+	}
+
+	PVOID	previous = InterlockedCompareExchangePointer(reinterpret_cast<PVOID volatile *>(&fields[slot]), field, NULL);
+	if (previous)
+	{
+		delete field;
+		return static_cast<GaloisField *>(previous);
+	}
+
+	return field;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	GaloisField::build()
+{
+	// Compute the Galois Fields log & inverse log tables
+
+	unsigned int	x_to_w = 1 << bits();
+	unsigned int	wordLimit = x_to_w - 1;
+	unsigned int	q_x;
+	switch	(bits())
+	{
+		case 4:
+			q_x = (1<< 4) + (2) + 1;
+			break;
+		case 8:
+			q_x = (1<< 8) + (1<<4) + (1<<3) + (1<<2) + 1;
+			break;
+		case 16:
+			q_x = (1<<16) + (1<<12) + (1<<3) + (2) + 1;
+			break;
+		default:
+			return false;
+	}
+
+	// Allocate the tables
+
+	_log = new unsigned int[x_to_w];
+	if (!_log) return false;
+	memset(_log, 0, x_to_w * sizeof(unsigned int));
+
+	_exp = new unsigned int[x_to_w*2];
+	if (!_exp) return false;
+	memset(_exp, 0, x_to_w * 2 * sizeof(unsigned int));
+
+	for (unsigned int log = 0, bin = 1; log < wordLimit; ++log)
+	{
+		_log[bin] = log;
+		_exp[log] = bin;
+		_exp[log+wordLimit] = bin;
+
+		bin <<= 1;
+		if (bin > wordLimit) bin ^= q_x;
+	}
+	_exp[wordLimit] = _exp[0];
+
+	return true;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// GaloisField.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
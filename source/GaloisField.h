@@ -0,0 +1,84 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____       _       _     ______ _      _     _     _     
+//  / ____|     | |     (_)   |  ____(_)    | |   | |   | |    
+// | |  __  __ _| | ___  _ ___| |__   _  ___| | __| |   | |__  
+// | | |_ |/ _` | |/ _ \| / __|  __| | |/ _ \ |/ _` |   | '_ \ 
+// | |__| | (_| | | (_) | \__ \ |    | |  __/ | (_| | _ | | | |
+//  \_____|\__,_|_|\___/|_|___/_|    |_|\___|_|\__,_|(_)|_| |_|
+//                                                             
+//                                                             
+//
+// Description:
+//
+//   Shared, immutable Galois Field log & inverse log tables
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_GALOISFIELD
+#define _H_GALOISFIELD
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The log & inverse log tables for one field size. A field is built the first time anybody asks for it, and from then on is
+// shared (read-only) by every ParityInfo in the process, so any number of sets can be worked on at once without each one owning
+// (and rebuilding) its own copy.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	GaloisField
+{
+public:
+	// Implementation
+
+static	const	GaloisField *		fieldFor(const unsigned int bits);
+
+	// Accessors
+
+inline	const	unsigned int		bits() const			{return _bits;}
+inline	const	unsigned int *		log() const			{return _log;}
+inline	const	unsigned int *		exp() const			{return _exp;}
+
+private:
+	// Construction/Destruction (fields live for the life of the process)
+
+					GaloisField(const unsigned int bits);
+					~GaloisField();
+
+	// Private implementation
+
+		bool			build();
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					GaloisField(const GaloisField & rhs);
+inline		GaloisField &		operator =(const GaloisField & rhs);
+
+	// Data members
+
+		unsigned int		_bits;
+		unsigned int *		_log;
+		unsigned int *		_exp;
+};
+
+#endif // _H_GALOISFIELD
+// ---------------------------------------------------------------------------------------------------------------------------------
+// GaloisField.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
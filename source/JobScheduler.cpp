@@ -0,0 +1,491 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//       _       _     _____      _              _       _                            
+//      | |     | |   / ____|    | |            | |     | |                           
+//      | | ___ | |__| (___   ___| |__   ___  __| |_   _| | ___ _ __  ___ _ __  _ __  
+//  _   | |/ _ \| '_ \\___ \ / __| '_ \ / _ \/ _` | | | | |/ _ \ '__|/ __| '_ \| '_ \ 
+// | |__| | (_) | |_) |___) | (__| | | |  __/ (_| | |_| | |  __/ | _| (__| |_) | |_) |
+//  \____/ \___/|_.__/_____/ \___|_| |_|\___|\__,_|\__,_|_|\___|_|(_)\___| .__/| .__/ 
+//                                                                       | |   | |    
+//                                                                       |_|   |_|    
+//
+// Description:
+//
+//   Schedules parity jobs across a pool of workers
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "JobScheduler.h"
+#include <fcntl.h>
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A running job's progress is sampled (and reported) this often
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	double	PROGRESS_INTERVAL = 0.5;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	JobScheduler::JobScheduler()
+	: _workerCount(0), _memoryBudget(0), _deviceLimit(1), _threadBudget(0), _stopping(false), _nextId(1)
+{
+	pthread_mutex_init(&_lock, NULL);
+	pthread_cond_init(&_wake, NULL);
+	_wakePipe[0] = -1;
+	_wakePipe[1] = -1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	JobScheduler::~JobScheduler()
+{
+	stop();
+	pthread_cond_destroy(&_wake);
+	pthread_mutex_destroy(&_lock);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Starts the workers. Each worker runs one job at a time, so 'workers' is the most jobs that will ever run at once. The memory
+// budget is shared between the running jobs, and no more than 'deviceLimit' of them (0 = no limit) will work on the same device.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	JobScheduler::start(const unsigned int workers, const double memoryBudget, const unsigned int deviceLimit, const unsigned int threadBudget)
+{
+	workerCount() = fstl::max(workers, static_cast<unsigned int>(1));
+	this->memoryBudget() = memoryBudget;
+	this->deviceLimit() = deviceLimit;
+	this->threadBudget() = threadBudget ? threadBudget : getProcessorCount();
+
+	// The main loop sleeps in poll(), so the workers need a file descriptor to poke when they have events for it
+
+	if (pipe(_wakePipe)) return false;
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		fcntl(_wakePipe[i], F_SETFL, fcntl(_wakePipe[i], F_GETFL) | O_NONBLOCK);
+		fcntl(_wakePipe[i], F_SETFD, FD_CLOEXEC);
+	}
+
+	_stopping = false;
+	for (unsigned int i = 0; i < workerCount(); ++i)
+	{
+		pthread_t	t;
+		if (!pthread_create(&t, NULL, workerThread, this)) _workers += t;
+	}
+
+	return _workers.size() != 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Cancels whatever is running, drops whatever is queued and waits for the workers to finish
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	JobScheduler::stop()
+{
+	pthread_mutex_lock(&_lock);
+	_stopping = true;
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		if (_jobs[i]->state() == ScheduledJob::Running) _jobs[i]->job().progress().cancel();
+	}
+	pthread_cond_broadcast(&_wake);
+	pthread_mutex_unlock(&_lock);
+
+	for (unsigned int i = 0; i < _workers.size(); ++i)
+	{
+		pthread_join(_workers[i], NULL);
+	}
+	_workers.erase();
+
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		delete _jobs[i];
+	}
+	_jobs.erase();
+
+	for (unsigned int i = 0; i < 2; ++i)
+	{
+		if (_wakePipe[i] >= 0) close(_wakePipe[i]);
+		_wakePipe[i] = -1;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	JobScheduler::submit(const ParityJob & job, const int priority, const int client)
+{
+	ScheduledJob *	sj = new ScheduledJob;
+	sj->job() = job;
+	sj->priority() = priority;
+	sj->client() = client;
+	sj->device() = deviceOf(job.parFilespec());
+
+	// Each job asks for what its own options say it should use, but never more than the whole budget
+
+	sj->memory() = fstl::min(job.options().memoryToUse(), memoryBudget());
+
+	pthread_mutex_lock(&_lock);
+	sj->id() = _nextId++;
+	pthread_mutex_unlock(&_lock);
+
+	// The 'queued' event has to go out before a worker can get its hands on the job (and possibly finish it)
+
+	char	buf[64];
+	sprintf(buf, "op=%s priority=%d", job.typeName(), priority);
+	fstl::string	text = fstl::string(buf) + " set=" + ParityJob::quoted(job.parFilespec());
+	sprintf(buf, "\"op\":\"%s\",\"priority\":%d", job.typeName(), priority);
+	fstl::string	json = fstl::string(buf) + ",\"set\":" + ParityJob::quoted(job.parFilespec());
+	postEvent(*sj, "queued", text, json);
+
+	pthread_mutex_lock(&_lock);
+	_jobs += sj;
+	pthread_cond_broadcast(&_wake);
+	pthread_mutex_unlock(&_lock);
+
+	return sj->id();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A queued job is simply dropped; a running job is asked to stop, and reports its own (cancelled) result when it does
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	JobScheduler::cancel(const unsigned int id)
+{
+	ScheduledJob *	dropped = NULL;
+
+	pthread_mutex_lock(&_lock);
+	bool	found = false;
+	for (unsigned int i = 0; i < _jobs.size() && !found; ++i)
+	{
+		if (_jobs[i]->id() != id) continue;
+		found = true;
+
+		if (_jobs[i]->state() == ScheduledJob::Running)
+		{
+			_jobs[i]->job().progress().cancel();
+		}
+		else
+		{
+			dropped = _jobs[i];
+			_jobs.erase(i, 1);
+		}
+	}
+	pthread_mutex_unlock(&_lock);
+
+	if (dropped)
+	{
+		postEvent(*dropped, "done", fstl::string("op=") + dropped->job().typeName() + " status=cancelled", fstl::string("\"op\":\"") + dropped->job().typeName() + "\",\"status\":\"cancelled\"");
+		delete dropped;
+	}
+
+	return found;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Only a running job can be paused (it keeps its worker and its memory while it waits)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	JobScheduler::pause(const unsigned int id, const bool paused)
+{
+	pthread_mutex_lock(&_lock);
+	bool	found = false;
+	for (unsigned int i = 0; i < _jobs.size() && !found; ++i)
+	{
+		if (_jobs[i]->id() != id || _jobs[i]->state() != ScheduledJob::Running) continue;
+		found = true;
+
+		if (paused)	_jobs[i]->job().progress().pause();
+		else		_jobs[i]->job().progress().resume();
+	}
+	pthread_mutex_unlock(&_lock);
+
+	return found;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Reports the progress of any running job that has moved on since it was last reported (and wasn't reported too recently.)
+// Returns how long until the next sample is due, in milliseconds, or -1 if nothing is running -- ready to hand to poll().
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	JobScheduler::sampleProgress()
+{
+	double	now = getSeconds();
+	double	due = PROGRESS_INTERVAL;
+	bool	running = false;
+
+	pthread_mutex_lock(&_lock);
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		ScheduledJob &	sj = *_jobs[i];
+		if (sj.state() != ScheduledJob::Running) continue;
+		running = true;
+
+		double	waited = now - sj.lastProgress();
+		if (waited < PROGRESS_INTERVAL)
+		{
+			due = fstl::min(due, PROGRESS_INTERVAL - waited);
+			continue;
+		}
+
+		// A paused job (or one that's just slow) doesn't say the same thing again
+
+		const Progress &	progress = sj.job().progress();
+		float			percent = progress.percent();
+		Progress::Stage		stage = progress.stage();
+		if (percent == sj.percent() && stage == sj.stage()) continue;
+
+		sj.lastProgress() = now;
+		sj.percent() = percent;
+		sj.stage() = stage;
+
+		char	buf[32];
+		sprintf(buf, "%.1f", percent);
+		_events += makeEvent(sj, "progress", fstl::string("percent=") + buf + " stage=" + Progress::stageName(stage),
+						     fstl::string("\"percent\":") + buf + ",\"stage\":\"" + Progress::stageName(stage) + "\"");
+	}
+	pthread_mutex_unlock(&_lock);
+
+	return running ? static_cast<int>(due * 1000) + 1 : -1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	JobScheduler::listJobs(JobEventArray & lines, const int client)
+{
+	pthread_mutex_lock(&_lock);
+
+	unsigned int	running = 0;
+	double		memoryInUse = 0;
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		const ScheduledJob &	sj = *_jobs[i];
+		const char *		state = sj.state() == ScheduledJob::Running ? "running" : "queued";
+		if (sj.state() == ScheduledJob::Running)
+		{
+			++running;
+			memoryInUse += sj.memory();
+		}
+
+		JobEvent	line(sj.id(), client);
+		char		buf[256];
+		const Progress &	progress = sj.job().progress();
+		sprintf(buf, "event=job id=%u op=%s state=%s stage=%s priority=%d percent=%.1f set=", sj.id(), sj.job().typeName(), state, Progress::stageName(progress.stage()), sj.priority(), progress.percent());
+		line.text() = fstl::string(buf) + ParityJob::quoted(sj.job().parFilespec());
+		sprintf(buf, "{\"event\":\"job\",\"id\":%u,\"op\":\"%s\",\"state\":\"%s\",\"stage\":\"%s\",\"priority\":%d,\"percent\":%.1f,\"set\":", sj.id(), sj.job().typeName(), state, Progress::stageName(progress.stage()), sj.priority(), progress.percent());
+		line.json() = fstl::string(buf) + ParityJob::quoted(sj.job().parFilespec()) + "}";
+		lines += line;
+	}
+
+	JobEvent	summary(0, client);
+	char		buf[256];
+	sprintf(buf, "event=status queued=%u running=%u workers=%u memory_mb=%.0f budget_mb=%.0f", _jobs.size() - running, running, workerCount(), memoryInUse / (1024*1024), memoryBudget() / (1024*1024));
+	summary.text() = buf;
+	sprintf(buf, "{\"event\":\"status\",\"queued\":%u,\"running\":%u,\"workers\":%u,\"memory_mb\":%.0f,\"budget_mb\":%.0f}", _jobs.size() - running, running, workerCount(), memoryInUse / (1024*1024), memoryBudget() / (1024*1024));
+	summary.json() = buf;
+	lines += summary;
+
+	pthread_mutex_unlock(&_lock);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	JobScheduler::takeEvents(JobEventArray & events)
+{
+	// Drain the wake-up pipe first, so an event posted after we've taken the list still wakes the main loop
+
+	char	buf[256];
+	while (read(wakeHandle(), buf, sizeof(buf)) > 0);
+
+	pthread_mutex_lock(&_lock);
+	events += _events;
+	_events.erase();
+	pthread_mutex_unlock(&_lock);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void *	JobScheduler::workerThread(void * param)
+{
+	reinterpret_cast<JobScheduler *>(param)->workerLoop();
+	return NULL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	JobScheduler::workerLoop()
+{
+	pthread_mutex_lock(&_lock);
+
+	while (!_stopping)
+	{
+		ScheduledJob *	sj = pickJob();
+		if (!sj)
+		{
+			pthread_cond_wait(&_wake, &_lock);
+			continue;
+		}
+
+		// Hand the job its share of the machine (a job that asked for fewer threads keeps its own limit)
+
+		unsigned int	threads = fstl::max(threadBudget() / workerCount(), static_cast<unsigned int>(1));
+		ParityOptions &	options = sj->job().options();
+		options.memoryLimit() = sj->memory();
+		if (!options.threadLimit() || options.threadLimit() > threads) options.threadLimit() = threads;
+
+		// It's queued as started along with becoming running, so nobody can see it running before they hear that it started
+
+		sj->state() = ScheduledJob::Running;
+		_events += makeEvent(*sj, "started", fstl::string("op=") + sj->job().typeName(), fstl::string("\"op\":\"") + sj->job().typeName() + "\"");
+		pthread_mutex_unlock(&_lock);
+
+		char	c = 0;
+		if (write(_wakePipe[1], &c, 1) < 0) {}
+
+		// No callback: the job keeps its own progress, and the main loop samples it (see sampleProgress)
+
+		sj->job().run();
+
+		// Its resources are free again, which might let something else in (it's off the list before anybody hears that it's
+		// done, so a status request never shows a finished job as running)
+
+		pthread_mutex_lock(&_lock);
+		int	idx = _jobs.find(sj);
+		if (idx >= 0) _jobs.erase(idx, 1);
+		pthread_cond_broadcast(&_wake);
+		pthread_mutex_unlock(&_lock);
+
+		const ParityJob &	job = sj->job();
+		for (unsigned int i = 0; i < job.problemNames().size(); ++i)
+		{
+			postEvent(*sj, "file", job.problemFields(i, false), job.problemFields(i, true));
+		}
+		postEvent(*sj, "stats", job.stats().fields(false), job.stats().fields(true));
+		postEvent(*sj, "done", job.fields(false), job.fields(true));
+		delete sj;
+
+		pthread_mutex_lock(&_lock);
+	}
+
+	pthread_mutex_unlock(&_lock);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Highest priority first, oldest first within a priority. A job that can't run yet (its device is busy, or there isn't enough
+// memory) doesn't hold up the jobs behind it. Called with the lock held.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+ScheduledJob *	JobScheduler::pickJob()
+{
+	double	memoryInUse = 0;
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		if (_jobs[i]->state() == ScheduledJob::Running) memoryInUse += _jobs[i]->memory();
+	}
+
+	ScheduledJob *	best = NULL;
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		ScheduledJob *	sj = _jobs[i];
+		if (sj->state() != ScheduledJob::Queued || !isRunnable(*sj, memoryInUse)) continue;
+
+		if (!best || sj->priority() > best->priority() || (sj->priority() == best->priority() && sj->id() < best->id())) best = sj;
+	}
+
+	return best;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	JobScheduler::isRunnable(const ScheduledJob & candidate, const double memoryInUse) const
+{
+	unsigned int	running = 0;
+	unsigned int	sameDevice = 0;
+	for (unsigned int i = 0; i < _jobs.size(); ++i)
+	{
+		const ScheduledJob &	sj = *_jobs[i];
+		if (sj.state() != ScheduledJob::Running) continue;
+
+		// Two jobs on the same set would trip over each other (one might be repairing the files the other is reading)
+
+		if (sj.job().parFilespec() == candidate.job().parFilespec()) return false;
+
+		++running;
+		if (sj.device() == candidate.device()) ++sameDevice;
+	}
+
+	if (deviceLimit() && sameDevice >= deviceLimit()) return false;
+
+	// If nothing else is running, the job gets to run regardless (its buffers will be sized down to the budget)
+
+	return !running || memoryInUse + candidate.memory() <= memoryBudget();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	JobScheduler::postEvent(const ScheduledJob & sj, const char * event, const fstl::string & textFields, const fstl::string & jsonFields)
+{
+	JobEvent	e = makeEvent(sj, event, textFields, jsonFields);
+
+	pthread_mutex_lock(&_lock);
+	_events += e;
+	pthread_mutex_unlock(&_lock);
+
+	// If the pipe is full, the main loop has plenty of reasons to wake up already
+
+	char	c = 0;
+	if (write(_wakePipe[1], &c, 1) < 0) {}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+JobEvent	JobScheduler::makeEvent(const ScheduledJob & sj, const char * event, const fstl::string & textFields, const fstl::string & jsonFields)
+{
+	JobEvent	e(sj.id(), sj.client());
+
+	char		buf[64];
+	sprintf(buf, "event=%s id=%u", event, sj.id());
+	e.text() = buf;
+	if (textFields.length()) e.text() += fstl::string(" ") + textFields;
+
+	sprintf(buf, "{\"event\":\"%s\",\"id\":%u", event, sj.id());
+	e.json() = buf;
+	if (jsonFields.length()) e.json() += fstl::string(",") + jsonFields;
+	e.json() += "}";
+
+	return e;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The device holding a file's directory (jobs on the same device compete for the same spindles)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned long long	JobScheduler::deviceOf(const fstl::wstring & filespec)
+{
+	fstl::wstring	path = _T(".");
+	int		idx = filespec.rfind(PATH_SEPARATOR);
+	if (idx == 0)		path = PATH_SEPARATOR;
+	else if (idx > 0)	path = filespec.substring(0, idx);
+
+	struct	stat	st;
+	if (stat(fstl::string(path.asArray()).asArray(), &st)) return 0;
+	return static_cast<unsigned long long>(st.st_dev);
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// JobScheduler.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,205 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//       _       _     _____      _              _       _            _     
+//      | |     | |   / ____|    | |            | |     | |          | |    
+//      | | ___ | |__| (___   ___| |__   ___  __| |_   _| | ___ _ __ | |__  
+//  _   | |/ _ \| '_ \\___ \ / __| '_ \ / _ \/ _` | | | | |/ _ \ '__|| '_ \ 
+// | |__| | (_) | |_) |___) | (__| | | |  __/ (_| | |_| | |  __/ | _ | | | |
+//  \____/ \___/|_.__/_____/ \___|_| |_|\___|\__,_|\__,_|_|\___|_|(_)|_| |_|
+//                                                                          
+//                                                                          
+//
+// Description:
+//
+//   Schedules parity jobs across a pool of workers, within global limits on memory, threads and the number of
+//   jobs sharing a device
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_JOBSCHEDULER
+#define _H_JOBSCHEDULER
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "ParityJob.h"
+#include <pthread.h>
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Something that happened to a job. Events are formatted once, in both output styles, by the thread that posts them.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	JobEvent
+{
+public:
+	// Construction/Destruction
+
+					JobEvent() : _jobId(0), _client(-1) {}
+					JobEvent(const unsigned int id, const int c) : _jobId(id), _client(c) {}
+
+	// Accessors
+
+inline		unsigned int &		jobId()				{return _jobId;}
+inline	const	unsigned int		jobId() const			{return _jobId;}
+inline		int &			client()			{return _client;}
+inline	const	int			client() const			{return _client;}
+inline		fstl::string &		text()				{return _text;}
+inline	const	fstl::string &		text() const			{return _text;}
+inline		fstl::string &		json()				{return _json;}
+inline	const	fstl::string &		json() const			{return _json;}
+
+private:
+	// Data members
+
+		unsigned int		_jobId;
+		int			_client;
+		fstl::string		_text;
+		fstl::string		_json;
+};
+
+typedef	fstl::array<JobEvent>		JobEventArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	ScheduledJob
+{
+public:
+	// Enumerations
+
+		enum			JobState {Queued, Running};
+
+	// Construction/Destruction
+
+					ScheduledJob()
+					: _id(0), _priority(0), _client(-1), _state(Queued), _device(0), _memory(0), _lastProgress(0), _percent(0),
+					  _stage(Progress::StageIdle) {}
+
+	// Accessors
+
+inline		unsigned int &		id()				{return _id;}
+inline	const	unsigned int		id() const			{return _id;}
+inline		int &			priority()			{return _priority;}
+inline	const	int			priority() const		{return _priority;}
+inline		int &			client()			{return _client;}
+inline	const	int			client() const			{return _client;}
+inline		JobState &		state()				{return _state;}
+inline	const	JobState		state() const			{return _state;}
+inline		unsigned long long &	device()			{return _device;}
+inline	const	unsigned long long	device() const			{return _device;}
+inline		double &		memory()			{return _memory;}
+inline	const	double			memory() const			{return _memory;}
+inline		ParityJob &		job()				{return _job;}
+inline	const	ParityJob &		job() const			{return _job;}
+
+	// What the last progress event said, and when
+
+inline		double &		lastProgress()			{return _lastProgress;}
+inline	const	double			lastProgress() const		{return _lastProgress;}
+inline		float &			percent()			{return _percent;}
+inline	const	float			percent() const			{return _percent;}
+inline		Progress::Stage &	stage()				{return _stage;}
+inline	const	Progress::Stage		stage() const			{return _stage;}
+
+private:
+	// Data members
+
+		unsigned int		_id;
+		int			_priority;
+		int			_client;
+		JobState		_state;
+		unsigned long long	_device;
+		double			_memory;
+		double			_lastProgress;
+		float			_percent;
+		Progress::Stage		_stage;
+		ParityJob		_job;
+};
+
+typedef	fstl::array<ScheduledJob *>	ScheduledJobArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	JobScheduler
+{
+public:
+	// Construction/Destruction
+
+					JobScheduler();
+virtual					~JobScheduler();
+
+	// Implementation
+
+virtual		bool			start(const unsigned int workers, const double memoryBudget, const unsigned int deviceLimit, const unsigned int threadBudget);
+virtual		void			stop();
+virtual		unsigned int		submit(const ParityJob & job, const int priority, const int client);
+virtual		bool			cancel(const unsigned int id);
+virtual		bool			pause(const unsigned int id, const bool paused);
+virtual		int			sampleProgress();
+virtual		void			listJobs(JobEventArray & lines, const int client);
+virtual		void			takeEvents(JobEventArray & events);
+
+	// Accessors
+
+inline		unsigned int &		workerCount()			{return _workerCount;}
+inline	const	unsigned int		workerCount() const		{return _workerCount;}
+inline		double &		memoryBudget()			{return _memoryBudget;}
+inline	const	double			memoryBudget() const		{return _memoryBudget;}
+inline		unsigned int &		deviceLimit()			{return _deviceLimit;}
+inline	const	unsigned int		deviceLimit() const		{return _deviceLimit;}
+inline		unsigned int &		threadBudget()			{return _threadBudget;}
+inline	const	unsigned int		threadBudget() const		{return _threadBudget;}
+inline	const	int			wakeHandle() const		{return _wakePipe[0];}
+
+private:
+	// Private implementation
+
+static		void *			workerThread(void * param);
+virtual		void			workerLoop();
+virtual		ScheduledJob *		pickJob();
+virtual		bool			isRunnable(const ScheduledJob & candidate, const double memoryInUse) const;
+virtual		void			postEvent(const ScheduledJob & sj, const char * event, const fstl::string & textFields, const fstl::string & jsonFields);
+static		JobEvent		makeEvent(const ScheduledJob & sj, const char * event, const fstl::string & textFields, const fstl::string & jsonFields);
+static		unsigned long long	deviceOf(const fstl::wstring & filespec);
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					JobScheduler(const JobScheduler & rhs);
+inline		JobScheduler &		operator =(const JobScheduler & rhs);
+
+	// Data members
+
+		unsigned int		_workerCount;
+		double			_memoryBudget;
+		unsigned int		_deviceLimit;
+		unsigned int		_threadBudget;
+
+		pthread_mutex_t		_lock;
+		pthread_cond_t		_wake;
+		fstl::array<pthread_t>	_workers;
+		bool			_stopping;
+		unsigned int		_nextId;
+		ScheduledJobArray	_jobs;
+		JobEventArray		_events;
+		int			_wakePipe[2];
+};
+
+#endif // _H_JOBSCHEDULER
+// ---------------------------------------------------------------------------------------------------------------------------------
+// JobScheduler.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
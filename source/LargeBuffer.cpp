@@ -0,0 +1,325 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _                          ____         __  __                           
+// | |                        |  _ \       / _|/ _|                          
+// | |     __ _ _ __ __ _  ___| |_) |_   _| |_| |_ ___ _ __  ___ _ __  _ __  
+// | |    / _` | '__/ _` |/ _ \  _ <| | | |  _|  _/ _ \ '__|/ __| '_ \| '_ \ 
+// | |___| (_| | | | (_| |  __/ |_) | |_| | | | ||  __/ | _| (__| |_) | |_) |
+// |______\__,_|_|  \__, |\___|____/ \__,_|_| |_| \___|_|(_)\___| .__/| .__/ 
+//                   __/ |                                      | |   | |    
+//                  |___/                                       |_|   |_|    
+//
+// Description:
+//
+//   Page-granular allocation for the big working buffers, with huge pages and NUMA-friendly placement
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "LargeBuffer.h"
+
+#ifdef	_LINUX
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sched.h>
+#endif
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Every mapping starts with a small header (so release() knows how much to give back), followed by the buffer itself
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	size_t	HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+static	const	size_t	HEADER_SIZE = 64;
+
+typedef	struct
+{
+	size_t			length;
+	LargeBuffer::HugePages	pages;
+} MappingHeader;
+
+// get_mempolicy() flags (from numaif.h, which isn't always installed)
+
+static	const	unsigned long	MEMPOLICY_F_NODE = 1;
+static	const	unsigned long	MEMPOLICY_F_ADDR = 2;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	size_t	roundUp(const size_t value, const size_t unit)
+{
+	return (value + unit - 1) / unit * unit;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The NUMA node a page lives on (-1 if we can't tell, or there's no such thing here)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	int	nodeOf(const void * address)
+{
+#if	defined(_LINUX) && defined(SYS_get_mempolicy)
+	int	node = -1;
+	if (syscall(SYS_get_mempolicy, &node, NULL, 0, address, MEMPOLICY_F_NODE | MEMPOLICY_F_ADDR)) return -1;
+	return node;
+#else
+	return -1;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	bool	threadPinned()
+{
+#ifdef	_LINUX
+	cpu_set_t	set;
+	CPU_ZERO(&set);
+	if (sched_getaffinity(0, sizeof(set), &set)) return false;
+	return CPU_COUNT(&set) == 1;
+#else
+	return false;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BufferPlacement::BufferPlacement()
+{
+	reset();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	BufferPlacement::~BufferPlacement()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	BufferPlacement::reset()
+{
+	buffers() = 0;
+	bytes() = 0;
+	explicitBytes() = 0;
+	transparentBytes() = 0;
+	localBytes() = 0;
+	node() = -1;
+	cpu() = -1;
+	pinned() = false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	BufferPlacement::fields(const bool json) const
+{
+	char	buf[256];
+	if (json)	sprintf(buf, "\"buffers\":%u,\"bytes\":%.0f,\"huge_explicit\":%.0f,\"huge_transparent\":%.0f,\"local\":%.0f,\"node\":%d,\"cpu\":%d,\"pinned\":%s", buffers(), bytes(), explicitBytes(), transparentBytes(), localBytes(), node(), cpu(), pinned() ? "true" : "false");
+	else		sprintf(buf, "buffers=%u bytes=%.0f huge_explicit=%.0f huge_transparent=%.0f local=%.0f node=%d cpu=%d pinned=%s", buffers(), bytes(), explicitBytes(), transparentBytes(), localBytes(), node(), cpu(), pinned() ? "yes" : "no");
+	return buf;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Returns a buffer of at least 'bytes' bytes, zeroed, or NULL if there's no memory for it. The pages are touched here, so they're
+// placed on the calling thread's node; allocate a buffer on the thread that's going to use it. If 'placement' is given, the
+// buffer is added to it.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned char *	LargeBuffer::allocate(const unsigned int bytes, const HugePages huge, BufferPlacement * placement)
+{
+	size_t		length = roundUp(static_cast<size_t>(bytes) + HEADER_SIZE, 4096);
+	HugePages	pages = HugeOff;
+	unsigned char *	base = NULL;
+	bool		wantHuge = huge != HugeOff && bytes >= HUGE_PAGE_SIZE;
+
+#ifdef	_LINUX
+	// Explicit huge pages come from the reserved pool, and there may not be any
+
+	if (wantHuge && huge == HugeExplicit)
+	{
+		size_t	hugeLength = roundUp(length, HUGE_PAGE_SIZE);
+		void *	ptr = mmap(NULL, hugeLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+		if (ptr != MAP_FAILED)
+		{
+			base = static_cast<unsigned char *>(ptr);
+			length = hugeLength;
+			pages = HugeExplicit;
+		}
+	}
+
+	// Transparent huge pages only back whole, aligned huge pages, so map a little extra and trim it back to an aligned range
+
+	if (wantHuge && !base)
+	{
+		size_t	hugeLength = roundUp(length, HUGE_PAGE_SIZE);
+		void *	ptr = mmap(NULL, hugeLength + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr != MAP_FAILED)
+		{
+			unsigned char *	raw = static_cast<unsigned char *>(ptr);
+			unsigned char *	aligned = reinterpret_cast<unsigned char *>(roundUp(reinterpret_cast<size_t>(raw), HUGE_PAGE_SIZE));
+			if (aligned > raw) munmap(raw, aligned - raw);
+			if (aligned < raw + HUGE_PAGE_SIZE) munmap(aligned + hugeLength, raw + HUGE_PAGE_SIZE - aligned);
+
+			base = aligned;
+			length = hugeLength;
+			pages = madvise(base, length, MADV_HUGEPAGE) ? HugeOff : HugeTransparent;
+		}
+	}
+
+	if (!base)
+	{
+		void *	ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (ptr == MAP_FAILED) return NULL;
+		base = static_cast<unsigned char *>(ptr);
+	}
+#else
+	// Large pages need the 'lock pages in memory' privilege, so this will usually fail (quietly) to regular pages
+
+#ifdef	MEM_LARGE_PAGES
+	SIZE_T	largePage = GetLargePageMinimum();
+	if (wantHuge && huge == HugeExplicit && largePage)
+	{
+		size_t	largeLength = roundUp(length, largePage);
+		base = static_cast<unsigned char *>(VirtualAlloc(NULL, largeLength, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE));
+		if (base)
+		{
+			length = largeLength;
+			pages = HugeExplicit;
+		}
+	}
+#endif
+
+	if (!base) base = static_cast<unsigned char *>(VirtualAlloc(NULL, length, MEM_COMMIT, PAGE_READWRITE));
+	if (!base) return NULL;
+#endif
+
+	// First touch
+
+	memset(base, 0, length);
+
+	MappingHeader &	header = *reinterpret_cast<MappingHeader *>(base);
+	header.length = length;
+	header.pages = pages;
+
+	// Note where it went
+
+	if (placement)
+	{
+		int	node = nodeOf(base + HEADER_SIZE);
+		int	home = currentNode();
+
+		placement->buffers() += 1;
+		placement->bytes() += bytes;
+		if (pages == HugeExplicit)	placement->explicitBytes() += bytes;
+		if (pages == HugeTransparent)	placement->transparentBytes() += bytes;
+		if (node >= 0 && node == home)	placement->localBytes() += bytes;
+		if (placement->buffers() == 1)	placement->node() = node;
+		else if (placement->node() != node) placement->node() = -1;
+		placement->cpu() = currentCpu();
+		placement->pinned() = threadPinned();
+	}
+
+	return base + HEADER_SIZE;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	LargeBuffer::release(unsigned char * buffer)
+{
+	if (!buffer) return;
+
+	unsigned char *	base = buffer - HEADER_SIZE;
+
+#ifdef	_LINUX
+	munmap(base, reinterpret_cast<MappingHeader *>(base)->length);
+#else
+	VirtualFree(base, 0, MEM_RELEASE);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Ties the calling thread to one CPU (the one it's running on now, if 'cpu' is negative) so that the memory it touches stays on
+// its own node, and its caches stay warm
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LargeBuffer::pinThread(const int cpu)
+{
+	int	target = cpu >= 0 ? cpu % static_cast<int>(getProcessorCount()) : currentCpu();
+	if (target < 0) return false;
+
+#ifdef	_LINUX
+	cpu_set_t	set;
+	CPU_ZERO(&set);
+	CPU_SET(target, &set);
+	return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+	if (target >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return false;
+	return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << target) != 0;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	LargeBuffer::currentCpu()
+{
+#ifdef	_LINUX
+	return sched_getcpu();
+#else
+	return -1;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	LargeBuffer::currentNode()
+{
+#if	defined(_LINUX) && defined(SYS_getcpu)
+	unsigned int	cpu = 0, node = 0;
+	if (syscall(SYS_getcpu, &cpu, &node, NULL)) return -1;
+	return static_cast<int>(node);
+#else
+	return -1;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	LargeBuffer::hugePagesName(const HugePages huge)
+{
+	switch(huge)
+	{
+		case HugeOff:		return "off";
+		case HugeExplicit:	return "explicit";
+		default:		return "transparent";
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LargeBuffer::parseHugePages(const fstl::wstring & name, HugePages & huge)
+{
+	if	(name == _T("off"))		huge = HugeOff;
+	else if (name == _T("transparent"))	huge = HugeTransparent;
+	else if (name == _T("explicit"))	huge = HugeExplicit;
+	else					return false;
+	return true;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// LargeBuffer.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,118 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _                          ____         __  __           _     
+// | |                        |  _ \       / _|/ _|         | |    
+// | |     __ _ _ __ __ _  ___| |_) |_   _| |_| |_ ___ _ __ | |__  
+// | |    / _` | '__/ _` |/ _ \  _ <| | | |  _|  _/ _ \ '__|| '_ \ 
+// | |___| (_| | | | (_| |  __/ |_) | |_| | | | ||  __/ | _ | | | |
+// |______\__,_|_|  \__, |\___|____/ \__,_|_| |_| \___|_|(_)|_| |_|
+//                   __/ |                                         
+//                  |___/                                          
+//
+// Description:
+//
+//   Page-granular allocation for the big working buffers, with huge pages and NUMA-friendly placement
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_LARGEBUFFER
+#define _H_LARGEBUFFER
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Where an operation's big buffers ended up. Pages are only given a home when they're first touched, so every buffer is touched
+// by the thread that allocates it (which is the thread that works on it); 'local' counts the bytes that landed on that thread's
+// own NUMA node.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	BufferPlacement
+{
+public:
+	// Construction/Destruction
+
+					BufferPlacement();
+virtual					~BufferPlacement();
+
+	// Implementation
+
+virtual		void			reset();
+virtual		fstl::string		fields(const bool json) const;
+
+	// Accessors
+
+inline		unsigned int &		buffers()			{return _buffers;}
+inline	const	unsigned int		buffers() const			{return _buffers;}
+inline		double &		bytes()				{return _bytes;}
+inline	const	double			bytes() const			{return _bytes;}
+inline		double &		explicitBytes()			{return _explicitBytes;}
+inline	const	double			explicitBytes() const		{return _explicitBytes;}
+inline		double &		transparentBytes()		{return _transparentBytes;}
+inline	const	double			transparentBytes() const	{return _transparentBytes;}
+inline		double &		localBytes()			{return _localBytes;}
+inline	const	double			localBytes() const		{return _localBytes;}
+inline		int &			node()				{return _node;}
+inline	const	int			node() const			{return _node;}
+inline		int &			cpu()				{return _cpu;}
+inline	const	int			cpu() const			{return _cpu;}
+inline		bool &			pinned()			{return _pinned;}
+inline	const	bool			pinned() const			{return _pinned;}
+
+private:
+	// Data members
+
+		unsigned int		_buffers;
+		double			_bytes;
+		double			_explicitBytes;
+		double			_transparentBytes;
+		double			_localBytes;
+		int			_node;
+		int			_cpu;
+		bool			_pinned;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Page-granular allocation for the engine's big buffers (the parity, recovery and tile buffers, which can run to gigabytes.)
+// Anything of a huge page or more can be backed by huge pages, either explicitly (from the reserved pool, falling back to
+// transparent ones if the pool is empty) or transparently (the kernel is asked to use them, where it can.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	LargeBuffer
+{
+public:
+	// Enumerations
+
+		enum			HugePages {HugeOff, HugeTransparent, HugeExplicit};
+
+	// Implementation
+
+static		unsigned char *		allocate(const unsigned int bytes, const HugePages huge, BufferPlacement * placement = NULL);
+static		void			release(unsigned char * buffer);
+static		bool			pinThread(const int cpu = -1);
+static		int			currentCpu();
+static		int			currentNode();
+static		const	char *		hugePagesName(const HugePages huge);
+static		bool			parseHugePages(const fstl::wstring & name, HugePages & huge);
+};
+
+#endif // _H_LARGEBUFFER
+// ---------------------------------------------------------------------------------------------------------------------------------
+// LargeBuffer.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,337 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _                     _ _____           _ _                             
+// | |                   | |  __ \         (_) |                            
+// | |     ___   ___ __ _| | |__) |_ _ _ __ _| |_ _   _     ___ _ __  _ __  
+// | |    / _ \ / __/ _` | |  ___/ _` | '__| | __| | | |   / __| '_ \| '_ \ 
+// | |___| (_) | (_| (_| | | |  | (_| | |  | | |_| |_| | _| (__| |_) | |_) |
+// |______\___/ \___\__,_|_|_|   \__,_|_|  |_|\__|\__, |(_)\___| .__/| .__/ 
+//                                                 __/ |       | |   | |    
+//                                                |___/        |_|   |_|    
+//
+// Description:
+//
+//   Local XOR parity for groups of recoverable files
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "LocalParity.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	char	localParityIdentifier[8] = "FSRLPAR";
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	LocalParity::LocalParity()
+	: _groupSize(0)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	LocalParity::~LocalParity()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	LocalParity::reset()
+{
+	path() = _T("");
+	baseName() = _T("");
+	groupSize() = 0;
+	dataSizes().erase();
+	dataHashes().erase();
+	available().erase();
+	pending().erase();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::wstring	LocalParity::groupFilespec(const fstl::wstring & path, const fstl::wstring & baseName, const unsigned int group)
+{
+	TCHAR	ext[16];
+	swprintf(ext, _T(".l%03u"), group + 1);
+	return path + PATH_SEPARATOR + baseName + ext;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Each group is a run of groupSize consecutive recoverable files, and its parity is the XOR of them all (each one padded with
+// zeros out to the size of the largest one in the group)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::layout(const DataFileArray & dataFiles, const unsigned int size)
+{
+	groupSize() = size;
+	dataSizes().erase();
+	if (!size) return false;
+
+	unsigned int	column = 0;
+	for (unsigned int i = 0; i < dataFiles.size(); ++i)
+	{
+		if (!dataFiles[i].recoverable()) continue;
+
+		unsigned int	group = column++ / size;
+		if (group == dataSizes().size()) dataSizes() += 0;
+		dataSizes()[group] = fstl::max(dataSizes()[group], dataFiles[i].fileSize());
+	}
+
+	return dataSizes().size() != 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::start(const fstl::wstring & dir, const fstl::wstring & base, const DataFileArray & dataFiles, const unsigned int size)
+{
+	reset();
+
+	path() = dir;
+	baseName() = base;
+	if (!layout(dataFiles, size))
+	{
+		reset();
+		return false;
+	}
+
+	// Start each group's file with a placeholder header (the real one goes in when we know the set hash)
+
+	unsigned char	noHash[EmDeeFive::HASH_SIZE_IN_BYTES];
+	memset(noHash, 0, sizeof(noHash));
+
+	for (unsigned int i = 0; i < groupCount(); ++i)
+	{
+		FILE *	fp = _wfopen(groupFilespec(i).asArray(), _T("wb"));
+		if (!fp)
+		{
+			reset();
+			return false;
+		}
+		fclose(fp);
+
+		fstl::ucharArray	hash;
+		hash.populate(0, EmDeeFive::HASH_SIZE_IN_BYTES);
+		dataHashes() += hash;
+		available() += true;
+
+		EmDeeFive	md5;
+		md5.start();
+		pending() += md5;
+
+		if (!writeHeader(i, noHash))
+		{
+			reset();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Stores the next piece of a group's parity (pieces must arrive in order, since we hash them as we go)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::process(const unsigned int group, const unsigned int offset, const unsigned char * data, const unsigned int length)
+{
+	if (group >= pending().size() || offset + length > dataSizes()[group]) return false;
+	if (!length) return true;
+
+	if (!writeFileRange(groupFilespec(group), sizeof(LocalParityHeader) + offset, data, length)) return false;
+	return pending()[group].processBits(data, length * 8);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::finish(const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES])
+{
+	if (pending().size() != groupCount()) return false;
+
+	for (unsigned int i = 0; i < groupCount(); ++i)
+	{
+		pending()[i].finish();
+		const unsigned char *	hash = pending()[i].getHash();
+		if (!hash) return false;
+		memcpy(&dataHashes()[i][0], hash, EmDeeFive::HASH_SIZE_IN_BYTES);
+
+		if (!writeHeader(i, setHash)) return false;
+	}
+
+	pending().erase();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::read(const fstl::wstring & dir, const fstl::wstring & base, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const DataFileArray & dataFiles)
+{
+	reset();
+
+	path() = dir;
+	baseName() = base;
+
+	unsigned int	recoverableCount = 0;
+	for (unsigned int i = 0; i < dataFiles.size(); ++i)
+	{
+		if (dataFiles[i].recoverable()) ++recoverableCount;
+	}
+
+	// Any one of the group files tells us how the set was grouped
+
+	for (unsigned int i = 0; i < recoverableCount && !groupSize(); ++i)
+	{
+		if (!doesFileExist(groupFilespec(i))) continue;
+
+		LocalParityHeader	header;
+		if (!readFileRange(groupFilespec(i), 0, reinterpret_cast<unsigned char *>(&header), sizeof(header))) continue;
+		if (memcmp(header.identifier, localParityIdentifier, sizeof(header.identifier)) || header.version != VERSION) continue;
+		if (memcmp(header.setHash, setHash, EmDeeFive::HASH_SIZE_IN_BYTES) || header.groupIndex != i) continue;
+
+		if (!layout(dataFiles, header.groupSize) || header.groupCount != groupCount())
+		{
+			reset();
+			return false;
+		}
+	}
+
+	if (!groupSize())
+	{
+		// No local parity (or not for this set) isn't an error, it just means every repair goes through the PAR volumes
+
+		reset();
+		return false;
+	}
+
+	// Which groups do we actually have?
+
+	bool	any = false;
+	for (unsigned int i = 0; i < groupCount(); ++i)
+	{
+		LocalParityHeader	header;
+		memset(&header, 0, sizeof(header));
+
+		bool	ok = doesFileExist(groupFilespec(i)) && getFileLength(groupFilespec(i)) == sizeof(header) + dataSizes()[i];
+		ok = ok && readFileRange(groupFilespec(i), 0, reinterpret_cast<unsigned char *>(&header), sizeof(header));
+		ok = ok && !memcmp(header.identifier, localParityIdentifier, sizeof(header.identifier)) && header.version == VERSION;
+		ok = ok && !memcmp(header.setHash, setHash, EmDeeFive::HASH_SIZE_IN_BYTES);
+		ok = ok && header.groupSize == groupSize() && header.groupIndex == i && header.dataSize == dataSizes()[i];
+
+		fstl::ucharArray	hash;
+		hash.populate(0, EmDeeFive::HASH_SIZE_IN_BYTES);
+		if (ok) memcpy(&hash[0], header.dataHash, EmDeeFive::HASH_SIZE_IN_BYTES);
+
+		dataHashes() += hash;
+		available() += ok;
+		any = any || ok;
+	}
+
+	if (!any)
+	{
+		reset();
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::writeHeader(const unsigned int group, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES]) const
+{
+	if (group >= groupCount()) return false;
+
+	LocalParityHeader	header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.identifier, localParityIdentifier, sizeof(header.identifier));
+	header.version = VERSION;
+	memcpy(header.setHash, setHash, EmDeeFive::HASH_SIZE_IN_BYTES);
+	header.groupSize = groupSize();
+	header.groupIndex = group;
+	header.groupCount = groupCount();
+	header.dataSize = dataSizes()[group];
+	memcpy(header.dataHash, &dataHashes()[group][0], EmDeeFive::HASH_SIZE_IN_BYTES);
+
+	return writeFileRange(groupFilespec(group), 0, reinterpret_cast<const unsigned char *>(&header), sizeof(header));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// XORs a change to one of the group's files into its parity (the caller needs to rehash the group when it's done)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::apply(const unsigned int group, const unsigned int offset, const unsigned char * delta, const unsigned int length)
+{
+	if (group >= groupCount() || !available()[group] || offset + length > dataSizes()[group]) return false;
+	if (!length) return true;
+
+	unsigned char *	buffer = new unsigned char[length];
+	if (!buffer) return false;
+
+	bool	rc = readGroup(group, offset, buffer, length);
+	if (rc)
+	{
+		for (unsigned int i = 0; i < length; ++i) buffer[i] ^= delta[i];
+		rc = writeFileRange(groupFilespec(group), sizeof(LocalParityHeader) + offset, buffer, length);
+	}
+
+	delete[] buffer;
+	return rc;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::rehash(const unsigned int group, progressCallback callback, void * callbackData)
+{
+	if (group >= groupCount() || !available()[group]) return false;
+
+	return EmDeeFive::processFile(groupFilespec(group), &dataHashes()[group][0], 1, 0, callback, callbackData, sizeof(LocalParityHeader));
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::verifyGroup(const unsigned int group, progressCallback callback, void * callbackData) const
+{
+	if (group >= groupCount() || !available()[group]) return false;
+	if (getFileLength(groupFilespec(group)) != sizeof(LocalParityHeader) + dataSizes()[group]) return false;
+
+	unsigned char	hash[EmDeeFive::HASH_SIZE_IN_BYTES];
+	if (!EmDeeFive::processFile(groupFilespec(group), hash, 1, 0, callback, callbackData, sizeof(LocalParityHeader))) return false;
+
+	return !memcmp(hash, &dataHashes()[group][0], EmDeeFive::HASH_SIZE_IN_BYTES);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	LocalParity::readGroup(const unsigned int group, const unsigned int offset, unsigned char * buffer, const unsigned int length) const
+{
+	if (group >= groupCount() || offset + length > dataSizes()[group]) return false;
+	if (!length) return true;
+
+	return readFileRange(groupFilespec(group), sizeof(LocalParityHeader) + offset, buffer, length);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// LocalParity.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
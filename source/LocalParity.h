@@ -0,0 +1,136 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _                     _ _____           _ _             _     
+// | |                   | |  __ \         (_) |           | |    
+// | |     ___   ___ __ _| | |__) |_ _ _ __ _| |_ _   _    | |__  
+// | |    / _ \ / __/ _` | |  ___/ _` | '__| | __| | | |   | '_ \ 
+// | |___| (_) | (_| (_| | | |  | (_| | |  | | |_| |_| | _ | | | |
+// |______\___/ \___\__,_|_|_|   \__,_|_|  |_|\__|\__, |(_)|_| |_|
+//                                                 __/ |          
+//                                                |___/           
+//
+// Description:
+//
+//   Local XOR parity for groups of recoverable files, stored alongside the PAR volumes so a single
+//   damaged file can be rebuilt by reading just its group
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_LOCALPARITY
+#define _H_LOCALPARITY
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "EmDeeFive.h"
+#include "DataFile.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	LocalParity
+{
+public:
+	// Enumerations
+
+		enum			{DEFAULT_GROUP_SIZE = 10};
+		enum			{VERSION = 1};
+
+	// Types
+
+		#pragma pack(1)
+		typedef	struct	tag_local_parity_header
+		{
+			char		identifier[8];
+			unsigned int	version;
+			unsigned char	setHash[16];
+			unsigned int	groupSize;
+			unsigned int	groupIndex;
+			unsigned int	groupCount;
+			unsigned int	dataSize;
+			unsigned char	dataHash[16];
+		} LocalParityHeader;
+		#pragma pack()
+
+	// Construction/Destruction
+
+					LocalParity();
+virtual					~LocalParity();
+
+	// Implementation
+
+virtual		void			reset();
+virtual		bool			start(const fstl::wstring & path, const fstl::wstring & baseName, const DataFileArray & dataFiles, const unsigned int groupSize);
+virtual		bool			process(const unsigned int group, const unsigned int offset, const unsigned char * data, const unsigned int length);
+virtual		bool			finish(const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES]);
+virtual		bool			read(const fstl::wstring & path, const fstl::wstring & baseName, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const DataFileArray & dataFiles);
+virtual		bool			writeHeader(const unsigned int group, const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES]) const;
+virtual		bool			apply(const unsigned int group, const unsigned int offset, const unsigned char * delta, const unsigned int length);
+virtual		bool			rehash(const unsigned int group, progressCallback callback = NULL, void * callbackData = NULL);
+virtual		bool			verifyGroup(const unsigned int group, progressCallback callback = NULL, void * callbackData = NULL) const;
+virtual		bool			readGroup(const unsigned int group, const unsigned int offset, unsigned char * buffer, const unsigned int length) const;
+
+static		fstl::wstring		groupFilespec(const fstl::wstring & path, const fstl::wstring & baseName, const unsigned int group);
+
+	// Accessors
+
+inline		fstl::wstring &		path()				{return _path;}
+inline	const	fstl::wstring &		path() const			{return _path;}
+inline		fstl::wstring &		baseName()			{return _baseName;}
+inline	const	fstl::wstring &		baseName() const		{return _baseName;}
+inline		unsigned int &		groupSize()			{return _groupSize;}
+inline	const	unsigned int		groupSize() const		{return _groupSize;}
+inline		fstl::uintArray &	dataSizes()			{return _dataSizes;}
+inline	const	fstl::uintArray &	dataSizes() const		{return _dataSizes;}
+inline		fstl::array<fstl::ucharArray> & dataHashes()		{return _dataHashes;}
+inline	const	fstl::array<fstl::ucharArray> & dataHashes() const	{return _dataHashes;}
+inline		fstl::boolArray &	available()			{return _available;}
+inline	const	fstl::boolArray &	available() const		{return _available;}
+inline		EmDeeFiveArray &	pending()			{return _pending;}
+inline	const	EmDeeFiveArray &	pending() const			{return _pending;}
+
+inline	const	unsigned int		groupCount() const		{return dataSizes().size();}
+inline	const	unsigned int		groupOf(const unsigned int column) const {return column / groupSize();}
+inline	const	fstl::wstring		groupFilespec(const unsigned int group) const {return groupFilespec(path(), baseName(), group);}
+inline	const	bool			isLoaded() const		{return groupSize() && groupCount();}
+
+private:
+	// Private implementation
+
+virtual		bool			layout(const DataFileArray & dataFiles, const unsigned int groupSize);
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					LocalParity(const LocalParity & rhs);
+inline		LocalParity &		operator =(const LocalParity & rhs);
+
+	// Data members
+
+		fstl::wstring		_path;
+		fstl::wstring		_baseName;
+		unsigned int		_groupSize;
+		fstl::uintArray		_dataSizes;
+		fstl::array<fstl::ucharArray> _dataHashes;
+		fstl::boolArray		_available;
+		EmDeeFiveArray		_pending;
+};
+
+#endif // _H_LOCALPARITY
+// ---------------------------------------------------------------------------------------------------------------------------------
+// LocalParity.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -31,8 +31,13 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "OverlappedRead.h"
+#include "EngineStats.h"
+
+#ifdef	_LINUX
+#include <fcntl.h>
+#endif
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -42,6 +47,11 @@
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+static	bool	overlappedIODisabled = false;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_LINUX
 	OverlappedRead::OverlappedRead()
 	: _buffer1(static_cast<unsigned char *>(0)), _buffer2(static_cast<unsigned char *>(0)), _alternateBuffer(false),
 	_bufferCleared(false), _supportsOverlapped(false), _fileLength(0), _bytesRead(0), _startOffset(0), _handle(INVALID_HANDLE_VALUE)
@@ -50,8 +60,16 @@
 
 	// Forcefully disable it, if the user wants it that way...
 
-	if (theApp.GetProfileInt(_T("Options"), _T("disableOverlappingIO"), 0)) supportsOverlapped() = false;
+	if (overlappedDisabled()) supportsOverlapped() = false;
 }
+#else
+	OverlappedRead::OverlappedRead()
+	: _buffer1(static_cast<unsigned char *>(0)), _buffer2(static_cast<unsigned char *>(0)), _alternateBuffer(false),
+	_bufferCleared(false), _supportsOverlapped(false), _fileLength(0), _bytesRead(0), _startOffset(0), _handle(-1)
+{
+	// The kernel's read-ahead does the overlapping for us
+}
+#endif
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -60,27 +78,40 @@
 	close();
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Set by the app (from the user's preferences) before any reads are started
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool &	OverlappedRead::overlappedDisabled()
+{
+	return overlappedIODisabled;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Sharing only means something on Win32, where we'd otherwise lock out the writer; on Linux, opening a file never locks anybody out
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	OverlappedRead::open(const fstl::wstring & name, const unsigned int offset, const unsigned int maxLength)
+#ifndef	_LINUX
+bool	OverlappedRead::open(const fstl::wstring & name, const unsigned int offset, const unsigned int maxLength, const bool shared)
+#else
+bool	OverlappedRead::open(const fstl::wstring & name, const unsigned int offset, const unsigned int maxLength, const bool)
+#endif
 {
 	// Allocate the I/O buffers
 
+#ifndef	_LINUX
 	if (!buffer1()) buffer1() = (unsigned char *) VirtualAlloc(NULL, BUFFER_SIZE, MEM_COMMIT, PAGE_READWRITE);
-	if (!buffer1())
-	{
-		AfxMessageBox(_T("Unable to allocate virtual RAM (1)"));
-		return false;
-	}
+#else
+	if (!buffer1()) buffer1() = fstl::allocate<unsigned char>(BUFFER_SIZE);
+#endif
+	if (!buffer1()) return false;
 
 	if (supportsOverlapped())
 	{
+#ifndef	_LINUX
 		if (!buffer2()) buffer2() = (unsigned char *) VirtualAlloc(NULL, BUFFER_SIZE, MEM_COMMIT, PAGE_READWRITE);
-		if (!buffer2())
-		{
-			AfxMessageBox(_T("Unable to allocate virtual RAM (2)"));
-			return false;
-		}
+#endif
+		if (!buffer2()) return false;
 
 		// Reset this to true, so that our first read will toggle it back to zero before the read
 
@@ -97,7 +128,7 @@ bool	OverlappedRead::open(const fstl::wstring & name, const unsigned int offset,
 
 	// Make sure we can open a file
 
-	if (handle() != INVALID_HANDLE_VALUE) return false;
+	if (isOpen()) return false;
 
 	// Init these...
 
@@ -114,15 +145,25 @@ bool	OverlappedRead::open(const fstl::wstring & name, const unsigned int offset,
 
 	if (fileLength() > maxLength) fileLength() = maxLength;
 
-	// Open the file
+	// Open the file (shared files are ones we expect somebody else to still be writing to, such as a download in progress)
 
+#ifndef	_LINUX
 	int	ovl = supportsOverlapped() ? FILE_FLAG_OVERLAPPED:0;
-	handle() = CreateFile(filename().asArray(), GENERIC_READ, 0, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING|ovl|FILE_FLAG_SEQUENTIAL_SCAN, NULL);
-	if (handle() == INVALID_HANDLE_VALUE) return false;
+	int	share = shared ? FILE_SHARE_READ|FILE_SHARE_WRITE:0;
+	handle() = CreateFile(filename().asArray(), GENERIC_READ, share, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING|ovl|FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (!isOpen()) return false;
 
 	// Clear out the overlapped struct
 
 	memset(&overlapped(), 0, sizeof(OVERLAPPED));
+#else
+	handle() = ::open(fstl::string(filename().asArray()).asArray(), O_RDONLY);
+	if (!isOpen()) return false;
+
+	posix_fadvise(handle(), 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+	EngineStats::count(EngineStats::Opens, 1);
 
 	// Done
 
@@ -138,7 +179,8 @@ void	OverlappedRead::close()
 	startOffset() = 0;
 	filename() = _T("");
 
-	if (handle() != INVALID_HANDLE_VALUE)
+#ifndef	_LINUX
+	if (isOpen())
 	{
 		CloseHandle(handle());
 		handle() = INVALID_HANDLE_VALUE;
@@ -155,6 +197,16 @@ void	OverlappedRead::close()
 		VirtualFree(buffer2(), 0, MEM_RELEASE);
 		buffer2() = static_cast<unsigned char *>(0);
 	}
+#else
+	if (isOpen())
+	{
+		::close(handle());
+		handle() = -1;
+	}
+
+	fstl::deallocate(buffer1());
+	buffer1() = static_cast<unsigned char *>(0);
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -163,11 +215,14 @@ bool	OverlappedRead::startRead()
 {
 	// "Different strokes for different folks..."
 
+#ifdef	_LINUX
+	return nonOverlappedStartRead();
+#else
 	if (!supportsOverlapped()) return nonOverlappedStartRead();
 
 	// Make sure we have an open file
 
-	if (handle() == INVALID_HANDLE_VALUE) return false;
+	if (!isOpen()) return false;
 
 	// Done?
 
@@ -194,19 +249,27 @@ bool	OverlappedRead::startRead()
 	// Okay, we got an error we don't allow, inform the caller
 
 	return false;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 unsigned char *	OverlappedRead::finishRead(unsigned int & readCount)
 {
+	// Whatever the caller spends waiting in here, it isn't spending on its own work
+
+	EngineTimer	timer(EngineStats::ReadWait);
+
 	// "Different strokes for different folks..."
 
+#ifdef	_LINUX
+	return nonOverlappedFinishRead(readCount);
+#else
 	if (!supportsOverlapped()) return nonOverlappedFinishRead(readCount);
 
 	// Make sure we have an open file
 
-	if (handle() == INVALID_HANDLE_VALUE) return static_cast<unsigned char *>(0);
+	if (!isOpen()) return static_cast<unsigned char *>(0);
 
 	// Init the read count
 
@@ -242,6 +305,7 @@ unsigned char *	OverlappedRead::finishRead(unsigned int & readCount)
 	// Keep track of where we are...
 
 	bytesRead() += br;
+	EngineStats::count(EngineStats::BytesRead, br);
 
 	// Which buffer are we working with?
 
@@ -258,6 +322,7 @@ unsigned char *	OverlappedRead::finishRead(unsigned int & readCount)
 
 	readCount = br;
 	return pBuf;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -266,13 +331,17 @@ bool	OverlappedRead::nonOverlappedStartRead()
 {
 	// Make sure we have an open file
 
-	if (handle() == INVALID_HANDLE_VALUE) return false;
+	if (!isOpen()) return false;
 
 	// Move to the starting offset?
 
 	if (!bytesRead() && startOffset())
 	{
+#ifndef	_LINUX
 		SetFilePointer(handle(), startOffset(), NULL, FILE_BEGIN);
+#else
+		lseek(handle(), static_cast<off_t>(startOffset()), SEEK_SET);
+#endif
 	}
 
 	// That's all we do here.. there's nothing to start when it's not overlapped
@@ -286,7 +355,7 @@ unsigned char *	OverlappedRead::nonOverlappedFinishRead(unsigned int & readCount
 {
 	// Make sure we have an open file
 
-	if (handle() == INVALID_HANDLE_VALUE) return static_cast<unsigned char *>(0);
+	if (!isOpen()) return static_cast<unsigned char *>(0);
 
 	// Init the read count
 
@@ -310,6 +379,7 @@ unsigned char *	OverlappedRead::nonOverlappedFinishRead(unsigned int & readCount
 	// Read some data
 
 	DWORD	br = 0;
+#ifndef	_LINUX
 	if (!ReadFile(handle(), buffer1(), BUFFER_SIZE, &br, NULL))
 	{
 		// We do allow certain errors...
@@ -322,6 +392,21 @@ unsigned char *	OverlappedRead::nonOverlappedFinishRead(unsigned int & readCount
 			return static_cast<unsigned char *>(0);
 		}
 	}
+#else
+	// Keep going until the buffer is full (or we hit the end), just like ReadFile would
+
+	while (br < BUFFER_SIZE)
+	{
+		ssize_t	count = ::read(handle(), buffer1() + br, BUFFER_SIZE - br);
+		if (count < 0)
+		{
+			if (errno == EINTR) continue;
+			return static_cast<unsigned char *>(0);
+		}
+		if (!count) break;
+		br += static_cast<DWORD>(count);
+	}
+#endif
 
 	// Adjust br based on a possibly limited file length
 
@@ -333,6 +418,7 @@ unsigned char *	OverlappedRead::nonOverlappedFinishRead(unsigned int & readCount
 	// Keep track of where we are...
 
 	bytesRead() += br;
+	EngineStats::count(EngineStats::BytesRead, br);
 
 	// Do we need to clear out any of the leftover buffer (for padding)?
 
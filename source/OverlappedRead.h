@@ -55,12 +55,13 @@ virtual					~OverlappedRead();
 
 	// Implementation
 
-virtual		bool			open(const fstl::wstring & name, const unsigned int offset = 0, const unsigned int maxLength = 0xffffffff);
+virtual		bool			open(const fstl::wstring & name, const unsigned int offset = 0, const unsigned int maxLength = 0xffffffff, const bool shared = false);
 virtual		void			close();
 virtual		bool			startRead();
 virtual		unsigned char *		finishRead(unsigned int & readCount);
 virtual		bool			nonOverlappedStartRead();
 virtual		unsigned char *		nonOverlappedFinishRead(unsigned int & readCount);
+static		bool &			overlappedDisabled();
 
 	// Accessors
 
@@ -82,11 +83,20 @@ inline		unsigned int &		bytesRead()			{return _bytesRead;}
 inline	const	unsigned int		bytesRead() const		{return _bytesRead;}
 inline		unsigned int &		startOffset()			{return _startOffset;}
 inline	const	unsigned int		startOffset() const		{return _startOffset;}
+#ifndef	_LINUX
 inline		HANDLE &		handle()			{return _handle;}
 inline	const	HANDLE			handle() const			{return _handle;}
 inline		OVERLAPPED &		overlapped()			{return _overlapped;}
 inline	const	OVERLAPPED &		overlapped() const		{return _overlapped;}
 
+inline		bool			isOpen() const			{return handle() != INVALID_HANDLE_VALUE;}
+#else
+inline		int &			handle()			{return _handle;}
+inline	const	int			handle() const			{return _handle;}
+
+inline		bool			isOpen() const			{return handle() >= 0;}
+#endif
+
 inline		bool			finishedReadingFile() const	{return bytesRead()+startOffset() >= fileLength();}
 
 private:
@@ -106,8 +116,12 @@ inline		OverlappedRead &	operator =(const OverlappedRead & rhs);
 		unsigned int		_fileLength;
 		unsigned int		_bytesRead;
 		unsigned int		_startOffset;
+#ifndef	_LINUX
 		HANDLE			_handle;
 		OVERLAPPED		_overlapped;
+#else
+		int			_handle;
+#endif
 };
 
 typedef	fstl::array<OverlappedRead *>	OverlappedReadPointerArray;
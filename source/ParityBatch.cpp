@@ -0,0 +1,138 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _         ____        _       _                         
+// |  __ \         (_) |       |  _ \      | |     | |                        
+// | |__) |_ _ _ __ _| |_ _   _| |_) | __ _| |_ ___| |__      ___ _ __  _ __  
+// |  ___/ _` | '__| | __| | | |  _ < / _` | __/ __| '_ \    / __| '_ \| '_ \ 
+// | |  | (_| | |  | | |_| |_| | |_) | (_| | || (__| | | | _| (__| |_) | |_) |
+// |_|   \__,_|_|  |_|\__|\__, |____/ \__,_|\__\___|_| |_|(_)\___| .__/| .__/ 
+//                         __/ |                                 | |   | |    
+//                        |___/                                  |_|   |_|    
+//
+// Description:
+//
+//   Runs many parity jobs concurrently on a shared work-stealing pool
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "ParityBatch.h"
+#include "WorkPool.h"
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// What each job's task needs to know (the job's progress gets tagged with its index on the way to the caller)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	struct
+{
+	ParityBatch *		batch;
+	unsigned int		index;
+} BatchEntry;
+
+static	bool	entryCallback(void * userData, const fstl::wstring & displayText, const float percent)
+{
+	BatchEntry &	entry = *reinterpret_cast<BatchEntry *>(userData);
+	return entry.batch->callback()(entry.batch->callbackData(), entry.index, displayText, percent);
+}
+
+static	void	jobTask(void * userData)
+{
+	BatchEntry &	entry = *reinterpret_cast<BatchEntry *>(userData);
+	ParityJob &	job = entry.batch->jobs()[entry.index];
+
+	// Without a callback, the jobs just keep their own progress (for the caller to sample)
+
+	if (entry.batch->callback())	job.run(entryCallback, &entry);
+	else				job.run();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityBatch::ParityBatch()
+	: _seconds(0), _callback(NULL), _callbackData(NULL)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityBatch::~ParityBatch()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Runs every job, using 'threads' threads (one per CPU if zero.) The callback may be called from any of the pool's threads, and
+// returning false from it only cancels the job it was called for. Returns false only if the pool couldn't be started; look at
+// the jobs themselves for how they went.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityBatch::run(const unsigned int threads, batchCallback callback, void * callbackData)
+{
+	this->callback() = callback;
+	this->callbackData() = callbackData;
+	seconds() = 0;
+
+	WorkPool	pool;
+	pool.pinThreads() = jobs().size() && jobs()[0].options().pinThreads();
+	if (!pool.start(threads)) return false;
+
+	double	start = getSeconds();
+
+	// The jobs running at once share the memory (and CPUs) that one job would normally have to itself
+
+	unsigned int	concurrent = fstl::max(fstl::min(pool.threadCount(), jobs().size()), static_cast<unsigned int>(1));
+	unsigned int	cpuShare = fstl::max(getProcessorCount() / concurrent, static_cast<unsigned int>(1));
+
+	fstl::array<BatchEntry>	entries;
+	entries.reserve(jobs().size());
+
+	for (unsigned int i = 0; i < jobs().size(); ++i)
+	{
+		ParityJob &	job = jobs()[i];
+		job.pool() = &pool;
+		if (!job.options().memoryLimit()) job.options().memoryLimit() = BufferPlan::memoryBudget(job.options()) / concurrent;
+		if (!job.options().threadLimit()) job.options().threadLimit() = cpuShare;
+
+		BatchEntry	entry = {this, i};
+		entries += entry;
+	}
+
+	WorkGroup	group;
+	for (unsigned int i = 0; i < entries.size(); ++i)
+	{
+		pool.submit(jobTask, &entries[i], group);
+	}
+
+	pool.wait(group);
+	pool.stop();
+
+	for (unsigned int i = 0; i < jobs().size(); ++i)
+	{
+		jobs()[i].pool() = NULL;
+	}
+
+	seconds() = getSeconds() - start;
+	return true;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityBatch.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
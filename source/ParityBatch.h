@@ -0,0 +1,93 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _         ____        _       _         _     
+// |  __ \         (_) |       |  _ \      | |     | |       | |    
+// | |__) |_ _ _ __ _| |_ _   _| |_) | __ _| |_ ___| |__     | |__  
+// |  ___/ _` | '__| | __| | | |  _ < / _` | __/ __| '_ \    | '_ \ 
+// | |  | (_| | |  | | |_| |_| | |_) | (_| | || (__| | | | _ | | | |
+// |_|   \__,_|_|  |_|\__|\__, |____/ \__,_|\__\___|_| |_|(_)|_| |_|
+//                         __/ |                                    
+//                        |___/                                     
+//
+// Description:
+//
+//   Runs many parity jobs concurrently on a shared work-stealing pool
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_PARITYBATCH
+#define _H_PARITYBATCH
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "ParityJob.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	bool	(*batchCallback)(void * userData, const unsigned int jobIndex, const fstl::wstring & displayText, const float percent);
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Runs many jobs at once, on one shared pool. Each job is a task, and so is each file it checks, so when one set is stuck waiting
+// on a slow disk, the pool's other threads get on with the files of the other sets.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	ParityBatch
+{
+public:
+	// Construction/Destruction
+
+					ParityBatch();
+virtual					~ParityBatch();
+
+	// Implementation
+
+virtual		bool			run(const unsigned int threads = 0, batchCallback callback = NULL, void * callbackData = NULL);
+
+	// Accessors
+
+inline		ParityJobArray &	jobs()				{return _jobs;}
+inline	const	ParityJobArray &	jobs() const			{return _jobs;}
+inline		double &		seconds()			{return _seconds;}
+inline	const	double			seconds() const			{return _seconds;}
+inline		batchCallback &		callback()			{return _callback;}
+inline	const	batchCallback		callback() const		{return _callback;}
+inline		void *&			callbackData()			{return _callbackData;}
+inline	const	void *			callbackData() const		{return _callbackData;}
+
+private:
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					ParityBatch(const ParityBatch & rhs);
+inline		ParityBatch &		operator =(const ParityBatch & rhs);
+
+	// Data members
+
+		ParityJobArray		_jobs;
+		double			_seconds;
+		batchCallback		_callback;
+		void *			_callbackData;
+};
+
+#endif // _H_PARITYBATCH
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityBatch.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -31,8 +31,9 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "ParityFile.h"
+#include "EngineStats.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -43,7 +44,7 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 	ParityFile::ParityFile()
-	: _volumeNumber(0), _dataOffset(0), _dataSize(0), _status(Unknown)
+	: _volumeNumber(0), _codec(CodecVandermonde), _dataOffset(0), _dataSize(0), _status(Unknown)
 {
 	memset(_hash, 0, sizeof(_hash));
 	memset(_setHash, 0, sizeof(_setHash));
@@ -62,11 +63,12 @@ bool	ParityFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES
 {
 	// Clear out the actual hash until we calculate a valid one
 
-	memset(actualHash, 0, sizeof(actualHash));
+	memset(actualHash, 0, EmDeeFive::HASH_SIZE_IN_BYTES);
 
 	// Does the file specifically exist?
 
-	if (!doesFileExist(filespec()))
+	fstl::wstring	spec;
+	if (!doesFileExist(filespec(spec)))
 	{
 		status() = Missing;
 		statusString() = _T("File is missing");
@@ -75,7 +77,7 @@ bool	ParityFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES
 
 	// Get the file length
 
-	unsigned int	size = getFileLength(filespec());
+	unsigned int	size = getFileLength(spec);
 	if (!size)
 	{
 		status() = Error;
@@ -85,7 +87,10 @@ bool	ParityFile::validate(unsigned char actualHash[EmDeeFive::HASH_SIZE_IN_BYTES
 
 	// Get the MD5 checksum of the file (starting at offset 0x20)
 
-	if (!EmDeeFive::processFile(filespec(), actualHash, totalFiles, curIndex, callback, callbackData, 0x20))
+	EngineStats::count(EngineStats::InputFiles, 1);
+	EngineStats::count(EngineStats::InputBytes, size > 0x20 ? size - 0x20 : 0);
+
+	if (!EmDeeFive::processFile(spec, actualHash, totalFiles, curIndex, callback, callbackData, 0x20))
 	{
 		status() = Error;
 		statusString() = _T("Unable to read the file");
@@ -138,7 +143,7 @@ bool	ParityFile::readPARHeader(const fstl::wstring & path, const fstl::wstring &
 		// Make sure all the 64-bit values have a "high" dword of zero... that is kinda pointless in the header, since the
 		// header would have to contain a HUGE number of files to outgrow a friggin' 32-bit value! Sheesh, talk about overkill.
 
-		if (header.volumeNumberHigh || header.dataSizeHigh || header.fileCountHigh || header.fileListSizeHigh || header.startOffsetDataHigh || header.startOffsetFileListHigh || header.volumeNumberHigh)
+		if (header.volumeNumberHigh > CodecFft || header.dataSizeHigh || header.fileCountHigh || header.fileListSizeHigh || header.startOffsetDataHigh || header.startOffsetFileListHigh)
 		{
 			throw	_T("Either this is the year 3000 and hard drives are\n")
 				_T("amazingly huge now, (and I'm dead) or you're trying\n")
@@ -161,7 +166,7 @@ bool	ParityFile::readPARHeader(const fstl::wstring & path, const fstl::wstring &
 
 			// Add it to the list
 
-			dataFiles += df;
+			dataFiles += fstl::move(df);
 		}
 
 		// Setup the parityFile structure
@@ -171,6 +176,7 @@ bool	ParityFile::readPARHeader(const fstl::wstring & path, const fstl::wstring &
 		memcpy(hash(), header.controlHash, EmDeeFive::HASH_SIZE_IN_BYTES);
 		memcpy(setHash(), header.setHash, EmDeeFive::HASH_SIZE_IN_BYTES);
 		volumeNumber() = header.volumeNumberLow;
+		codec() = static_cast<ParityCodec>(header.volumeNumberHigh);
 
 		// Finally, set the created-by string
 
@@ -230,7 +236,7 @@ bool	ParityFile::isFromSet(const fstl::wstring & path, const fstl::wstring & nam
 	{
 		// Build the filename
 
-		fstl::wstring	filespec = path + _T("\\") + name;
+		fstl::wstring	filespec = path + PATH_SEPARATOR + name;
 
 		// Open the file
 
@@ -304,16 +310,21 @@ fstl::ucharArray	ParityFile::storePARHeader(DataFileArray & dataFiles) const
 		memcpy(header.controlHash, hash(), EmDeeFive::HASH_SIZE_IN_BYTES);
 		memcpy(header.setHash, setHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
 		header.volumeNumberLow = volumeNumber();
+		header.volumeNumberHigh = codec();
 		header.fileCountLow = dataFiles.size();
 		header.startOffsetFileListLow = 0x60;
 		header.fileListSizeLow = fileListSize;
 		header.startOffsetDataLow = header.startOffsetFileListLow + header.fileListSizeLow;
 		header.dataSizeLow = (volumeNumber()) ? largestFile:0;
 
-		// Store the header
+		// The FFT codec works on 16-bit words, so its volumes are padded out to an even length
+
+		if (codec() == CodecFft) header.dataSizeLow = (header.dataSizeLow + 1) & ~1;
+
+		// Store the header (room for the file list, too, so it isn't regrown with every entry)
 
-		result.populate(0, sizeof(header));
-		memcpy(&result[0], &header, sizeof(header));
+		result.reserve(sizeof(header) + fileListSize);
+		result.append(reinterpret_cast<const unsigned char *>(&header), sizeof(header));
 
 		// Store the file entries
 
@@ -327,9 +338,10 @@ fstl::ucharArray	ParityFile::storePARHeader(DataFileArray & dataFiles) const
 			result += ar;
 		}
 	}
-	catch (const TCHAR * err)
+	catch (const TCHAR *)
 	{
-		AfxMessageBox(err);
+		// The caller knows what it was trying to write, and reports it
+
 		result.erase();
 		return result;
 	}
@@ -350,15 +362,14 @@ bool	ParityFile::writePARHeader(FILE * fp, DataFileArray & dataFiles) const
 		// Generate a header
 
 		fstl::ucharArray	headerBuffer = storePARHeader(dataFiles);
-		if (!headerBuffer.size()) throw "";
+		if (!headerBuffer.size()) throw _T("unable to build the header");
 
 		// Write it
 
 		if (fwrite(&headerBuffer[0], headerBuffer.size(), 1, fp) != 1) throw _T("write failed");
 	}
-	catch (const TCHAR * err)
+	catch (const TCHAR *)
 	{
-		if (err && *err) AfxMessageBox(err);
 		return false;
 	}
 
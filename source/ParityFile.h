@@ -38,6 +38,7 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "EmDeeFive.h"
+#include "SharedPath.h"
 #include "DataFile.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -49,6 +50,11 @@ public:
 
 		enum			FileStatus {Unknown, Valid, Corrupt, Missing, Misnamed, Error};
 
+		// The codec used for the volume's data (stored in the header's volumeNumberHigh, which other PAR clients require to
+		// be zero, so they'll refuse FFT-coded volumes rather than misread them)
+
+		enum			ParityCodec {CodecVandermonde = 0, CodecFft = 1};
+
 	// Types
 
 		#pragma pack(1)
@@ -78,9 +84,18 @@ public:
 
 					ParityFile();
 virtual					~ParityFile();
+#ifdef	FSTL_MOVE
+					ParityFile(const ParityFile & rhs) = default;
+					ParityFile(ParityFile && rhs) = default;
+#endif
 
 	// Operators
 
+#ifdef	FSTL_MOVE
+		ParityFile &		operator =(const ParityFile & rhs) = default;
+		ParityFile &		operator =(ParityFile && rhs) = default;
+#endif
+
 		bool			operator==(const ParityFile & rhs) {return volumeNumber() == rhs.volumeNumber();}
 		bool			operator<(const ParityFile & rhs) {return volumeNumber() < rhs.volumeNumber();}
 		bool			operator>(const ParityFile & rhs) {return volumeNumber() > rhs.volumeNumber();}
@@ -98,14 +113,16 @@ static		fstl::wstring		getStatusString(const FileStatus status);
 
 inline		fstl::wstring &		fileName()		{return _fileName;}
 inline	const	fstl::wstring &		fileName() const	{return _fileName;}
-inline		fstl::wstring &		filePath()		{return _filePath;}
-inline	const	fstl::wstring &		filePath() const	{return _filePath;}
+inline		SharedPath &		filePath()		{return _filePath;}
+inline	const	fstl::wstring &		filePath() const	{return _filePath.path();}
 inline		unsigned char *		hash()			{return _hash;}
 inline	const	unsigned char *		hash() const		{return _hash;}
 inline		unsigned char *		setHash()		{return _setHash;}
 inline	const	unsigned char *		setHash() const		{return _setHash;}
 inline		int &			volumeNumber()		{return _volumeNumber;}
 inline	const	int			volumeNumber() const	{return _volumeNumber;}
+inline		ParityCodec &		codec()			{return _codec;}
+inline	const	ParityCodec		codec() const		{return _codec;}
 inline		unsigned int &		dataOffset()		{return _dataOffset;}
 inline	const	unsigned int		dataOffset() const	{return _dataOffset;}
 inline		unsigned int &		dataSize()		{return _dataSize;}
@@ -115,16 +132,18 @@ inline	const	FileStatus		status() const		{return _status;}
 inline		fstl::wstring &		statusString()		{return _statusString;}
 inline	const	fstl::wstring &		statusString() const	{return _statusString;}
 
-inline	const	fstl::wstring		filespec() const	{return filePath() + _T("\\") + fileName();}
+inline	const	fstl::wstring		filespec() const	{fstl::wstring spec; return _filePath.filespec(fileName(), spec);}
+inline	const	fstl::wstring &		filespec(fstl::wstring & buffer) const {return _filePath.filespec(fileName(), buffer);}
 
 private:
 	// Data members
 
 		fstl::wstring		_fileName;
-		fstl::wstring		_filePath;
+		SharedPath		_filePath;
 		unsigned char		_hash[EmDeeFive::HASH_SIZE_IN_BYTES];
 		unsigned char		_setHash[EmDeeFive::HASH_SIZE_IN_BYTES];
 		int			_volumeNumber;
+		ParityCodec		_codec;
 		unsigned int		_dataOffset;
 		unsigned int		_dataSize;
 		FileStatus		_status;
@@ -31,12 +31,17 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
+#ifndef	_LINUX
 #include <direct.h>
-#include "FSRaid.h"
+#endif
+#include "FSRaidCore.h"
 #include "ParityInfo.h"
 #include "EmDeeFive.h"
 #include "OverlappedRead.h"
 #include "FastWrite.h"
+#include "FftCodec.h"
+#include "GaloisField.h"
+#include "EngineStats.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -44,11 +49,16 @@
 #define new DEBUG_NEW
 #endif
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Roughly what an operation allocates for each file in the set, for sizing its arena up front
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	const	unsigned int	ARENA_BYTES_PER_FILE = 2048;
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 	ParityInfo::ParityInfo(const unsigned int rsRaidBits)
-	: _rsRaidBits(rsRaidBits), _gflog(static_cast<unsigned int *>(0)), _gfexp(static_cast<unsigned int *>(0)),
-	_vandMatrix(static_cast<unsigned int *>(0)), _recoveryArrays(static_cast<unsigned int *>(0))
+	: _rsRaidBits(rsRaidBits), _gflog(static_cast<unsigned int *>(0)), _gfexp(static_cast<unsigned int *>(0)), _progress(static_cast<Progress *>(0))
 {
 }
 
@@ -67,19 +77,47 @@ void	ParityInfo::reset()
 	defaultBaseName().erase();
 
 	dataFiles().erase();
+	hashIndex().erase();
+	hashChain().erase();
 	parityFiles().erase();
 
-	delete[] gflog();
-	gflog() = static_cast<unsigned int *>(0);
+	// The field tables are shared, so we just let go of them
 
-	delete[] gfexp();
+	gflog() = static_cast<unsigned int *>(0);
 	gfexp() = static_cast<unsigned int *>(0);
 
-	delete[] vandMatrix();
-	vandMatrix() = static_cast<unsigned int *>(0);
+	blockMap().reset();
+	localParity().reset();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Indexes the data files by the first four bytes of their checksums. Each key maps to the first file that has it, and the chain
+// leads from each file to the next one with the same key (or past the end of the list, for the last one.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	unsigned int	hashKey(const unsigned char * hash)
+{
+	unsigned int	key;
+	memcpy(&key, hash, sizeof(key));
+	return key;
+}
+
+void	ParityInfo::indexHashes()
+{
+	hashIndex().erase();
+	hashIndex().reserve(dataFiles().size());
+	hashChain().erase();
+	hashChain().populate(dataFiles().size(), dataFiles().size());
+
+	// Backwards, so each file is pushed onto the front of its key's chain, and the chains come out in order
 
-	delete[] recoveryArrays();
-	recoveryArrays() = static_cast<unsigned int *>(0);
+	for (unsigned int i = dataFiles().size(); i > 0; --i)
+	{
+		unsigned int	key = hashKey(dataFiles()[i-1].hash());
+		const unsigned int *	next = hashIndex().find(key);
+		if (next) hashChain()[i-1] = *next;
+		hashIndex()[key] = i-1;
+	}
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -90,11 +128,13 @@ bool	ParityInfo::validateDataFile(const unsigned int index, const unsigned int t
 
 	if (index >= dataFiles().size())
 	{
-		AfxMessageBox(_T("Cannot validate data file (index out of range)"));
+		lastError() = _T("Cannot validate data file (index out of range)");
 		return false;
 	}
 
-	// Validate it
+	// Validate it (and count the work in our stats)
+
+	EngineStatsScope	statsScope(&stats());
 
 	return validateDataFile(dataFiles()[index], totalFiles, curIndex, callback, callbackData);
 }
@@ -106,9 +146,13 @@ bool	ParityInfo::validateDataFile(DataFile & df, const unsigned int totalFiles,
 	unsigned char	actualHash[EmDeeFive::HASH_SIZE_IN_BYTES];
 	if (!df.validate(actualHash, totalFiles, curIndex, callback, callbackData))
 	{
-		// Scan the list of files to see if this checksum matches another file in the set
+		// See if this checksum matches another file in the set. Only the files whose checksums start the same way can match,
+		// and the index chains them together (without an index, we have to look at them all.)
 
-		for (unsigned int i = 0; i < dataFiles().size(); ++i)
+		const unsigned int *	first = hashIndex().find(hashKey(actualHash));
+		if (!first && hashIndex().size()) return true;
+
+		for (unsigned int i = first ? *first : 0; i < dataFiles().size(); i = first ? hashChain()[i] : i + 1)
 		{
 			if (!memcmp(dataFiles()[i].hash(), actualHash, EmDeeFive::HASH_SIZE_IN_BYTES))
 			{
@@ -126,6 +170,10 @@ bool	ParityInfo::validateDataFile(DataFile & df, const unsigned int totalFiles,
 
 bool	ParityInfo::loadParFile(fstl::wstring & filename)
 {
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
 	try
 	{
 		// Reset the parity info
@@ -136,7 +184,7 @@ bool	ParityInfo::loadParFile(fstl::wstring & filename)
 
 		defaultPath() = filename;
 		defaultBaseName() = filename;
-		int	idx = defaultPath().rfind(_T("\\"));
+		int	idx = defaultPath().rfind(PATH_SEPARATOR);
 		if (idx >= 0)
 		{
 			defaultPath().erase(idx);
@@ -155,14 +203,17 @@ bool	ParityInfo::loadParFile(fstl::wstring & filename)
 		ParityFile	parityFile;
 		{
 			DataFileArray	dfa;
-			static	fstl::wstring	headerErr;
 			if (!parityFile.readPARHeader(defaultPath(), defaultBaseName(), createdByString(), dfa)) throw _T("Unable to read file header");
 			if (!validateParFile(parityFile, 1, 0))
 			{
-				static	fstl::wstring	err = _T("Cannot validate file.\n\nThe file status is reported to be:\n\n") + parityFile.statusString();
-				throw err.asArray();
+				// The message lives in lastError() until the handler below picks it up (it can't be a static, since two
+				// sets may be loading at the same time on different threads)
+
+				lastError() = _T("Cannot validate file.\n\nThe file status is reported to be:\n\n") + parityFile.statusString();
+				throw lastError().asArray();
 			}
-			dataFiles() = dfa;
+			dataFiles() = fstl::move(dfa);
+			indexHashes();
 		}
 
 		// Save the set hash
@@ -177,6 +228,14 @@ bool	ParityInfo::loadParFile(fstl::wstring & filename)
 			defaultBaseName().erase(idx);
 		}
 
+		// Load the block map, if the set has one (it's optional, so it's not an error if it doesn't)
+
+		blockMap().read(BlockMap::sidecarFilespec(defaultPath(), defaultBaseName()), setHash(), dataFiles());
+
+		// ...and the local parity groups (also optional)
+
+		localParity().read(defaultPath(), defaultBaseName(), setHash(), dataFiles());
+
 		// Find the par files
 
 		if (!findParFiles(parityFiles())) throw _T("Unable to scan the directory for PAR files");
@@ -196,12 +255,13 @@ bool	ParityInfo::loadParFile(fstl::wstring & filename)
 	}
 	catch (const TCHAR * err)
 	{
+		fstl::wstring	msg = fstl::wstring(_T("An error has occurred while trying to read the PAR file:\n\n")) + err;
+
 		// Make sure we're reset
 
 		reset();
 
-		fstl::wstring	msg = fstl::wstring(_T("An error has occurred while trying to read the PAR file:\n\n")) + err;
-		AfxMessageBox(msg.asArray());
+		lastError() = msg;
 		return false;
 	}
 
@@ -220,11 +280,13 @@ bool	ParityInfo::validateParFile(const unsigned int index, const unsigned int to
 
 	if (index >= parityFiles().size())
 	{
-		AfxMessageBox(_T("Cannot validate parity file (index out of range)"));
+		lastError() = _T("Cannot validate parity file (index out of range)");
 		return false;
 	}
 
-	// Validate it
+	// Validate it (and count the work in our stats)
+
+	EngineStatsScope	statsScope(&stats());
 
 	return validateParFile(parityFiles()[index], totalFiles, curIndex, callback, callbackData);
 }
@@ -245,64 +307,50 @@ bool	ParityInfo::findParFiles(ParityFileArray & pfa) const
 
 	pfa.erase();
 
-	// Filespec
+	// Get the candidates
 
-	_wfinddata_t	fd;
-	fstl::wstring	filespec = defaultPath() + _T("\\") + defaultBaseName() + _T(".*");
-	intptr_t	handle = 0;
+	fstl::WStringArray	names;
+	if (!findFiles(defaultPath(), defaultBaseName(), names)) return false;
 
 	// Start scanning files
 
-	try
+	for (unsigned int n = 0; n < names.size(); ++n)
 	{
-		handle = _wfindfirst((TCHAR *) filespec.asArray(), &fd);
-		if (handle <= 0) throw _T("Unable to get directory listing for Pxx file scan");
-
-		do
-		{
-			// Get the extension...
+		const fstl::wstring &	name = names[n];
 
-			fstl::wstring	ext = fd.name;
-			int	idx = ext.rfind(_T("."));
+		// Get the extension...
 
-			if (idx == -1) continue;
-			ext.erase(0, idx+1);
+		fstl::wstring	ext = name;
+		int	idx = ext.rfind(_T("."));
 
-			if (ext.length() != 3) continue;
-			if (towlower(ext[0]) != _T('p') && towlower(ext[0]) != _T('q')) continue;
-			if (towlower(ext[1]) != _T('a') && !iswdigit(ext[1])) continue;
-			if (towlower(ext[2]) != _T('r') && !iswdigit(ext[2])) continue;
+		if (idx == -1) continue;
+		ext.erase(0, idx+1);
 
-			// Does it match the set hash?
+		if (ext.length() != 3) continue;
+		if (towlower(ext[0]) != _T('p') && towlower(ext[0]) != _T('q')) continue;
+		if (towlower(ext[1]) != _T('a') && !iswdigit(ext[1])) continue;
+		if (towlower(ext[2]) != _T('r') && !iswdigit(ext[2])) continue;
 
-			if (!ParityFile::isFromSet(defaultPath(), fd.name, setHash())) continue;
+		// Does it match the set hash?
 
-			// We have a match, try to load it
+		if (!ParityFile::isFromSet(defaultPath(), name, setHash())) continue;
 
-			ParityFile	thisParityFile;
-			DataFileArray	dfa;
-			fstl::wstring	creatorString;
-			if (!thisParityFile.readPARHeader(defaultPath(), fd.name, creatorString, dfa)) continue;
-
-			// Add this parity file to the set
+		// We have a match, try to load it
 
-			pfa += thisParityFile;
-		} while (_wfindnext(handle, &fd) == 0);
+		ParityFile	thisParityFile;
+		DataFileArray	dfa;
+		fstl::wstring	creatorString;
+		if (!thisParityFile.readPARHeader(defaultPath(), name, creatorString, dfa)) continue;
 
-		// Sort the parity files
+		// Add this parity file to the set
 
-		pfa.sort();
-		pfa.unique();
+		pfa += fstl::move(thisParityFile);
+	}
 
-		// Cleanup
+	// Sort the parity files
 
-		_findclose(handle);
-	}
-	catch (const TCHAR *)
-	{
-		if (handle > 0) _findclose(handle);
-		return false;
-	}
+	pfa.sort();
+	pfa.unique();
 
 	return true;
 }
@@ -311,17 +359,33 @@ bool	ParityInfo::findParFiles(ParityFileArray & pfa) const
 
 bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BYTES], ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData)
 {
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	// Everything the operation allocates along the way (hashes, headers, file lists, names) comes from its own arena
+
+	fstl::arena			arena;
+	fstl::arenaScope		arenaScope(arena);
+	arena.reserve((dataVolumes.size() + parityVolumes.size()) * ARENA_BYTES_PER_FILE);
+
 	EmDeeFiveArray			inputHashes;
 	EmDeeFiveArray			inputHashes16k;
+	BlockMap			inputBlocks;
+	bool				writeBlockMap = options().writeBlockMap();
+	bool				fftCodec = options().fftCodec() && parityVolumes.size() > 1;
+	FftCodec			codec;
+	fstl::uintArray			vandMatrix;
+	LocalParity			localGroups;
+	unsigned int			localGroupSize = options().localGroupSize();
+	bool				writeLocalParity = options().localParity() && localGroupSize;
 
 	fstl::array<unsigned char *>	outputBuffers;
 	FastWriteArray			outputFiles;
 
-	FILE *				fp = NULL;
-
 	// Clear this out
 
-	memset(parSetHash, 0, sizeof(parSetHash));
+	memset(parSetHash, 0, EmDeeFive::HASH_SIZE_IN_BYTES);
 
 	// Count the recoverable files
 
@@ -339,50 +403,48 @@ bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BY
 		}
 	}
 
-	// Total output data (used by the progress bar)
+	stats().add(EngineStats::InputBytes, totalInputData);
+	stats().add(EngineStats::InputFiles, dataVolumes.size());
 
-	__int64		totalOutputData = largestInputFile * (parityVolumes.size()-1);
+	// The FFT codec works on 16-bit words, so its volumes are padded out to an even length
+
+	unsigned int	parityDataSize = fftCodec ? (largestInputFile + 1) & ~1 : largestInputFile;
 
 	try
 	{
-		// Determine how much memory to use for each output buffer
-
-		MEMORYSTATUS	memStat;
-		GlobalMemoryStatus(&memStat);
+		// Plan how to use our memory: the buffer count covers every parity volume (remember, we don't allocate RAM for the PAR
+		// file.) The FFT codec also needs a piece of every recoverable file at once, plus its own working set. Only the plain
+		// Vandermonde codec can fold one file at a time into volumes that are already on disk.
 
-		double	memPercentage = static_cast<double>(theApp.GetProfileInt(_T("Options"), _T("memoryPercent"), 10)) / 100;
-		if (memPercentage < 0) memPercentage = 0;
-		if (memPercentage > 1) memPercentage = 1;
-		double	memToUse = static_cast<double>(memStat.dwTotalPhys) * memPercentage;
+		unsigned int	bufferCount = parityVolumes.size() ? parityVolumes.size() - 1 : 0;
+		if (fftCodec) bufferCount += recoverableCount + FftCodec::dataSpan(recoverableCount) * 2;
+		if (writeLocalParity) bufferCount += 1;
 
-		// Our memToUse contains the total memory (for all buffers), we now need to know how much per buffer
-		// (remember, we don't allocate RAM for the PAR file.)
+		if (!planBuffers(dataVolumes, parityVolumes, bufferCount, parityDataSize, !fftCodec && !writeLocalParity, true, callback, callbackData)) throw _T("Operation cancelled");
 
-		unsigned int	memToUsePerBuffer = 1;
-		if (parityVolumes.size() > 1) memToUsePerBuffer = static_cast<unsigned int>(memToUse / (parityVolumes.size() - 1));
-		if (largestInputFile && memToUsePerBuffer > largestInputFile) memToUsePerBuffer = largestInputFile;
-
-		if (memToUsePerBuffer % OverlappedRead::BUFFER_SIZE)
-		{
-			memToUsePerBuffer /= OverlappedRead::BUFFER_SIZE;
-			memToUsePerBuffer += 1;
-			memToUsePerBuffer *= OverlappedRead::BUFFER_SIZE;
-		}
+		bool		fileMajor = plan().order() == BufferPlan::FileMajor;
+		unsigned int	memToUsePerBuffer = plan().tileSize();
 
 		// Make sure we have a valid operation
 
 		if (!parityVolumes.size()) throw _T("No parity files to be generated");
 		if (parityVolumes.size() > recoverableCount + 1) throw _T("Cannot create more parity files than recoverable data files");
-		if (recoverableCount + parityVolumes.size() >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+		if (fftCodec && !FftCodec::supports(recoverableCount, parityVolumes.size()-1)) throw _T("Too many files for the FFT codec");
+		if (!fftCodec && recoverableCount + parityVolumes.size() >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
 		if (recoverableCount && !largestInputFile) throw _T("No file size to any of the data files?!");
 
 		// Generate the GF tables
 
 		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
 
-		// Setup the MxN Vandermonde matrix where M is the number of parity devices, and N is the number of data devices
+		// Setup the MxN Vandermonde matrix where M is the number of parity devices, and N is the number of data devices (the
+		// FFT codec has no matrix, just its own tables)
 
-		if (!genVandermondeMatrix(recoverableCount, parityVolumes.size()-1)) throw _T("unable to generate Vandermonde matrix");
+		if (fftCodec)
+		{
+			if (!codec.init()) throw _T("unable to generate FFT codec tables");
+		}
+		else if (!genVandermondeMatrix(recoverableCount, parityVolumes.size()-1, vandMatrix)) throw _T("unable to generate Vandermonde matrix");
 
 		// This is necessary, since the FastWrites can't be copied around
 
@@ -400,6 +462,8 @@ bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BY
 
 			// Generate a header
 
+			parityVolumes[i].codec() = fftCodec ? ParityFile::CodecFft : ParityFile::CodecVandermonde;
+
 			fstl::ucharArray	fileHeader = parityVolumes[i].storePARHeader(dataVolumes);
 			if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
 
@@ -407,11 +471,12 @@ bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BY
 
 			outputFiles[i].write(&fileHeader[0], fileHeader.size());
 
-			// Allocate our output buffers (only for the pxx files, not the actual PAR file, as it has no data)
+			// Allocate our output buffers (only for the pxx files, not the actual PAR file, as it has no data -- and in file-major
+			// order, the volumes are updated on disk)
 
-			if (i)
+			if (i && !fileMajor)
 			{
-				unsigned char *	ptr = new unsigned char[memToUsePerBuffer];
+				unsigned char *	ptr = allocBuffer(memToUsePerBuffer);
 				if (!ptr) throw _T("Cannot allocate output buffer");
 				outputBuffers += ptr;
 			}
@@ -436,137 +501,39 @@ bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BY
 			inputHashes16k += md5;
 		}
 
-		// Read in a block (group of chunks)
-
-		__int64		totalInputDataRead = 0;
-		__int64		totalOutputDataWritten = 0;
-		unsigned int	groupOffset = 0;
-		while(totalInputDataRead < totalInputData)
-		{
-			// Clear out the output buffer for this group
-
-			for (unsigned int i = 0; i < outputBuffers.size(); ++i)
-			{
-				if (outputBuffers[i]) memset(outputBuffers[i], 0, memToUsePerBuffer);
-			}
-
-			// Visit each D (data device)
-
-			unsigned int	currentRecoverableFile = 0;
-			for (unsigned int j = 0; j < dataVolumes.size(); ++j)
-			{
-				// Prime the buffer
-
-				if (groupOffset < dataVolumes[j].fileSize())
-				{
-					OverlappedRead	or;
-					if (!or.open(dataVolumes[j].filespec(), groupOffset)) throw _T("Unable to open data file");
-					if (!or.startRead()) throw _T("Unable to read data file");
-
-					// We don't process the entire input file, we only process so many blocks of data...
-
-					unsigned int	blocksPerChunk = memToUsePerBuffer / OverlappedRead::BUFFER_SIZE;
-
-					// Process a chunk of this input file
-
-					while(blocksPerChunk--)
-					{
-						double	percent = static_cast<double>(totalInputDataRead+totalOutputDataWritten) / static_cast<double>(totalInputData+totalOutputData) * 100.0f;
-						if (callback && !callback(callbackData, _T("Generating parity data..."), static_cast<float>(percent))) throw _T("Operation cancelled");
-
-						// Get some data
-
-						unsigned int	oldBytesRead = or.bytesRead();
-						unsigned int	readCount;
-						unsigned char *	readBuffer = or.finishRead(readCount);
-						if (!readBuffer) throw _T("Unable to read");
-						if (!readCount) break;
-
-						// Track the data read
-
-						totalInputDataRead += readCount;
-
-						// Only prime the next read if we've got another block to read...
-
-						if (blocksPerChunk && !or.startRead()) throw _T("Unable to prime the reader for data file");
-
-						// Hash is block
-
-						if (!inputHashes[j].processBits(readBuffer, readCount * 8)) throw false;
-
-						// Hash the first 16K of the input file
-
-						if (!groupOffset && oldBytesRead < 16*1024)
-						{
-							unsigned int	hashCount = readCount;
-							if (hashCount > 16*1024 - oldBytesRead) hashCount = 16*1024 - oldBytesRead;
-							if (!inputHashes16k[j].processBits(readBuffer, hashCount * 8)) throw false;
-						}
-
-						// Generate parity data for recoverable files
-
-						if (dataVolumes[j].recoverable())
-						{
-							// Munge it with the PAR data (this contains an optimized gfADD and gfMUL merged right into this loop for speed)
-
-							for (unsigned int i = 1; i < outputBuffers.size(); ++i)
-							{
-								unsigned int	matrixValue = vandMatrix()[currentRecoverableFile + ((i-1)*recoverableCount)];
-								if (!matrixValue) continue;
-
-								unsigned char tab[0x100];
-								make_lut(tab, matrixValue);
-
-								unsigned char *	dst = outputBuffers[i] + oldBytesRead;
-								unsigned char *	src = readBuffer;
-
-								for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
-								{
-									(*dst) ^= tab[*src];
-								}
-							}
-						}
-					}
-				}
-
-				// Track the recoverable files processed
-
-				if (dataVolumes[j].recoverable())
-				{
-					++currentRecoverableFile;
-				}
-			}
+		// Setup the per-block hashes
 
-			// Write the output buffers
+		if (writeBlockMap) inputBlocks.start(dataVolumes);
 
-			if (totalOutputDataWritten < totalOutputData)
-			{
-				for (unsigned int i = 1; i < outputBuffers.size(); ++i)
-				{
-					// How many bytes to process?
+		// Setup the local parity groups (one XOR volume per group of recoverable files, alongside the PAR files)
 
-					unsigned int	bytes = memToUsePerBuffer;
-					if (groupOffset + bytes > largestInputFile) bytes = largestInputFile - groupOffset;
+		if (writeLocalParity)
+		{
+			fstl::wstring	baseName = parityVolumes[0].fileName();
+			int		idx = baseName.rfind(_T("."));
+			if (idx >= 0) baseName.erase(idx);
 
-					// Write the data out in chunks, so we have a smooth progress bar
+			if (!localGroups.start(parityVolumes[0].filePath(), baseName, dataVolumes, localGroupSize)) throw _T("Unable to create local parity files");
+		}
 
-					for (unsigned int k = 0; k < bytes; k += OverlappedRead::BUFFER_SIZE)
-					{
-						double	percent = static_cast<double>(totalInputDataRead+totalOutputDataWritten) / static_cast<double>(totalInputData+totalOutputData) * 100.0f;
-						if (callback && !callback(callbackData, _T("Writing parity data..."), static_cast<float>(percent))) throw _T("Operation cancelled");
+		// File-major order does it all in one go
 
-						__int64		b = OverlappedRead::BUFFER_SIZE;
-						if (k + b > bytes) b = bytes - k;
-						if (!outputFiles[i].write(outputBuffers[i] + k, static_cast<unsigned int>(b))) throw _T("Unable to write PAR file header");
+		if (fileMajor && !genParDataFileMajor(parityVolumes, dataVolumes, outputFiles, vandMatrix, inputHashes, inputHashes16k, writeBlockMap ? &inputBlocks : NULL, parityDataSize, callback, callbackData))
+		{
+			throw lastError().asArray();
+		}
 
-						totalOutputDataWritten += b;
-					}
-				}
-			}
+		// ...otherwise, it's done a group at a time (the PAR file has no row, as it has no data)
 
-			// Next group
+		fstl::intArray	volumeRows;
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			volumeRows += parityVolumes[i].volumeNumber() - 1;
+		}
 
-			groupOffset += memToUsePerBuffer;
+		if (!fileMajor && !genParDataGroupMajor(volumeRows, dataVolumes, outputFiles, outputBuffers, &inputHashes, &inputHashes16k, writeBlockMap ? &inputBlocks : NULL, writeLocalParity ? &localGroups : NULL, fftCodec ? &codec : NULL, parityDataSize, callback, callbackData))
+		{
+			throw lastError().asArray();
 		}
 
 		// Finish the input data hashes and calculate the set hash
@@ -608,276 +575,341 @@ bool	ParityInfo::genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BY
 
 		memcpy(parSetHash, setHashPointer, EmDeeFive::HASH_SIZE_IN_BYTES);
 
-		// Set the percent bar to zero
-
-		if (callback && !callback(callbackData, _T("Fingerprinting PAR file headers..."), 0)) throw _T("Operation cancelled");
+		// Write the block map alongside the PAR file
 
-		// Dump the output buffers
-
-		unsigned int	totalParData = (parityVolumes.size() - 1) * largestInputFile;
-		unsigned int	totalParDataWritten = 0;
-
-		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		if (writeBlockMap)
 		{
-			// Close the output file
-
-			outputFiles[i].close();
-
-			// Cleanup the output buffer
-
-			delete[] outputBuffers[i];
-			outputBuffers[i] = 0;
-
-			// Copy the set hash into the volume
-
-			memcpy(parityVolumes[i].setHash(), setHashPointer, EmDeeFive::HASH_SIZE_IN_BYTES);
-
-			// Generate a new header that contains all the proper data file hashes
-			{
-				fstl::ucharArray	fileHeader = parityVolumes[i].storePARHeader(dataVolumes);
-				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
-
-				// Write the new header
-
-				fp = _wfopen(parityVolumes[i].filespec().asArray(), _T("r+b"));
-				if (!fp) throw _T("Unable to open output file for header write");
-				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
-				fclose(fp);
-				fp = NULL;
-			}
+			fstl::wstring	baseName = parityVolumes[0].fileName();
+			int		idx = baseName.rfind(_T("."));
+			if (idx >= 0) baseName.erase(idx);
 
-			// Checksum the par file
+			if (!inputBlocks.finish()) throw _T("Unable to fingerprint data file blocks");
+			if (!inputBlocks.write(BlockMap::sidecarFilespec(parityVolumes[0].filePath(), baseName), setHashPointer)) throw _T("Unable to write block map");
+		}
 
-			if (!EmDeeFive::processFile(parityVolumes[i].filespec(), parityVolumes[i].hash(), parityVolumes.size(), i, callback, callbackData, 0x20)) throw _T("Unable to fingerprint PAR file");
+		// Finish off the local parity groups (their headers carry the set hash, too)
 
-			// Generate a final header, with the entire file's fingerprint
-			{
-				fstl::ucharArray	fileHeader = parityVolumes[i].storePARHeader(dataVolumes);
-				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+		if (writeLocalParity && !localGroups.finish(setHashPointer)) throw _T("Unable to write local parity data");
 
-				// Write the new header
+		// Write the final headers
 
-				fp = _wfopen(parityVolumes[i].filespec().asArray(), _T("r+b"));
-				if (!fp) throw _T("Unable to open output file for header write");
-				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
-				fclose(fp);
-				fp = NULL;
-			}
-		}
+		if (!finishParFiles(parityVolumes, dataVolumes, outputFiles, outputBuffers, setHashPointer, callback, callbackData)) throw lastError().asArray();
 	}
 	catch (const TCHAR * err)
 	{
-		// Close any open files
-
-		if (fp) fclose(fp);
-
-		// Cleanup the output buffers
+		// Cleanup the buffers
 
 		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
 		{
-			delete[] outputBuffers[i];
+			LargeBuffer::release(outputBuffers[i]);
 		}
 
 		// Error exit
 
 		fstl::wstring	msg = fstl::wstring(_T("Unable to generate parity archive: \n\n")) + err;
-		AfxMessageBox(msg.asArray());
+		lastError() = msg;
 		return false;
 	}
 
 	return true;
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The big working buffers (parity, recovery and tile buffers) come from here, so they're placed with the thread that works on them,
+// and backed by huge pages where the options ask for it. Free them with LargeBuffer::release().
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-void	ParityInfo::make_lut(unsigned char lut[0x100], const int m) const
+unsigned char *	ParityInfo::allocBuffer(const unsigned int bytes)
 {
-        for (int j = 0x100; --j; )
-	{
-                lut[j] = gfexp()[gflog()[m] + gflog()[j]];
-	}
-        lut[0] = 0;
+	return LargeBuffer::allocate(bytes, options().hugePages(), &placement());
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The out-of-core half of genParFiles, for when memory is too tight for a sensible number of passes: the volumes are laid down
+// (zeroed) first, then each data file is read straight through, and every tile of it is folded into every volume, in place.
+// On entry, the output files hold just their headers.
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	ParityInfo::recoverFiles(ParityFileArray & inParityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex)
+bool	ParityInfo::genParDataFileMajor(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, FastWriteArray & outputFiles, const fstl::uintArray & vandMatrix, EmDeeFiveArray & inputHashes, EmDeeFiveArray & inputHashes16k, BlockMap * inputBlocks, const unsigned int parityDataSize, progressCallback callback, void * callbackData)
 {
-	ParityFileArray			parityVolumes = inParityVolumes;
-
-	fstl::array<unsigned char *>	outputBuffers;
-	FastWriteArray			outputFiles;
+	unsigned int	tileSize = plan().tileSize();
+	unsigned char *	dataTile = NULL;
+	unsigned char *	parityTile = NULL;
 
 	try
 	{
-		// Count the recoverable files and the files needed to be recovered
+		dataTile = allocBuffer(tileSize);
+		parityTile = allocBuffer(tileSize);
+		if (!dataTile || !parityTile) throw _T("Cannot allocate file-major buffers");
 
-		unsigned int	recoverableCount = 0;
-		unsigned int	validCount = 0;
-		unsigned int	corruptCount = 0;
-		unsigned int	largestInputFile = 0;
-		__int64		totalInputData = 0;
-		__int64		totalOutputData = 0;
-		unsigned int	parityCount = 0;
-		int		adjustedRepairSingleIndex = -1;
-		fstl::boolArray	dataFileValidityFlags;
+		// The progress bar covers laying down the volumes, reading the data, and reading & writing the volumes for each tile
 
+		unsigned int	recoverableCount = 0;
+		double		totalInputData = 0;
+		double		feedData = 0;
 		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
 		{
-			DataFile &	df = dataVolumes[i];
+			totalInputData += dataVolumes[i].fileSize();
+			if (!dataVolumes[i].recoverable()) continue;
 
-			if (!df.recoverable()) continue;
+			feedData += dataVolumes[i].fileSize();
+			++recoverableCount;
+		}
 
-			recoverableCount++;
+		double	total = totalInputData + static_cast<double>(parityVolumes.size() - 1) * (static_cast<double>(parityDataSize) + feedData * 2);
+		double	done = 0;
 
-			if (df.status() == DataFile::Unknown)	throw _T("All files need to be checked before recovery");
-			if (df.status() == DataFile::Valid)
-			{
-				dataFileValidityFlags += true;
-				validCount++;
-				totalInputData += df.fileSize();
-			}
-			else
-			{
-				dataFileValidityFlags += false;
-				corruptCount++;
-				if (df.recoverable() && (repairSingleIndex == i || repairSingleIndex == -1)) totalOutputData += df.fileSize();
-			}
+		// Lay down the volumes, noting where each one's data starts (just past its header)
 
-			// Adjust the repair single index to skip over the non-recoverable files
+		fstl::uintArray	dataOffsets;
+		memset(parityTile, 0, tileSize);
 
-			if (repairSingleIndex == i) adjustedRepairSingleIndex = recoverableCount - 1;
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			dataOffsets += outputFiles[i].bytesWritten();
 
-			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+			for (unsigned int k = 0; i && k < parityDataSize; k += tileSize)
+			{
+				if (!report(callback, callbackData, Progress::StageWriting, _T("Writing parity data..."), done, total)) throw _T("Operation cancelled");
+
+				unsigned int	bytes = fstl::min(tileSize, parityDataSize - k);
+				if (!outputFiles[i].write(parityTile, bytes)) throw _T("Unable to write parity data");
+				done += bytes;
+			}
+
+			outputFiles[i].close();
 		}
 
-		// Generate a list of valid parity volume IDs
+		// Fold in the data files, one at a time
 
-		fstl::intArray	parityIDs;
-		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		unsigned int	currentRecoverableFile = 0;
+		fstl::wstring	filespec;
+		for (unsigned int j = 0; j < dataVolumes.size(); ++j)
 		{
-			if (parityVolumes[i].volumeNumber() == 0) continue;
-			if (parityVolumes[i].status() != ParityFile::Valid) continue;
-			if (parityIDs.size() < corruptCount) totalInputData += largestInputFile;
-			parityIDs += parityVolumes[i].volumeNumber();
-		}
+			DataFile &	dv = dataVolumes[j];
 
-		// Make sure we have a valid operation
+			OverlappedRead	or;
+			if (dv.fileSize())
+			{
+				if (!or.open(dv.filespec(), 0)) throw _T("Unable to open data file");
+				if (!or.startRead()) throw _T("Unable to read data file");
+			}
 
-		if (!corruptCount) throw _T("There are no files to recover");
-		if (parityIDs.size() < corruptCount) throw _T("You do not have enough parity files to recover the set");
-		if (parityIDs.size() > recoverableCount) throw _T("Cannot have more parity files than recoverable data files");
-		if (recoverableCount + parityIDs.size() >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+			unsigned int	fileOffset = 0;
+			while(fileOffset < dv.fileSize())
+			{
+				TraceSpan	tileSpan("tile");
 
-		// Generate the GF tables
+				// Fill a tile (hashing as we go)
 
-		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+				unsigned int	tileBytes = 0;
+				while(tileBytes < tileSize)
+				{
+					if (!report(callback, callbackData, Progress::StageEncoding, _T("Generating parity data..."), done, total)) throw _T("Operation cancelled");
 
-		// Generate the recovery array
+					unsigned int	oldBytesRead = or.bytesRead();
+					unsigned int	readCount;
+					unsigned char *	readBuffer = or.finishRead(readCount);
+					if (!readBuffer) throw _T("Unable to read");
+					if (!readCount) break;
 
-		bool	setUnrecoverable;
-		bool	rc = analyzeRecoverable(dataFileValidityFlags, parityIDs, parityVolumes, corruptCount, setUnrecoverable);
-		if (!rc && !setUnrecoverable) throw _T("Unable to generate recovery matrix");
-		if (!rc && setUnrecoverable) throw _T("");
+					done += readCount;
 
-//		if (!genRecoveryMultipliers(dataFileValidityFlags, parityIDs)) throw _T("Unable to generate recovery matrix");
+					// Keep the next read going while we deal with this one
 
-		// Determine how much memory to use for each output buffer
+					if (!or.finishedReadingFile() && !or.startRead()) throw _T("Unable to prime the reader for data file");
 
-		MEMORYSTATUS	memStat;
-		GlobalMemoryStatus(&memStat);
+					if (!inputHashes[j].processBits(readBuffer, readCount * 8)) throw _T("Unable to hash data file");
 
-		double	memPercentage = static_cast<double>(theApp.GetProfileInt(_T("Options"), _T("memoryPercent"), 10)) / 100;
-		if (memPercentage < 0) memPercentage = 0;
-		if (memPercentage > 1) memPercentage = 1;
-		double	memToUse = static_cast<double>(memStat.dwTotalPhys) * memPercentage;
+					if (oldBytesRead < 16*1024)
+					{
+						unsigned int	hashCount = fstl::min(readCount, 16*1024 - oldBytesRead);
+						if (!inputHashes16k[j].processBits(readBuffer, hashCount * 8)) throw _T("Unable to hash data file");
+					}
 
-		// Our memToUse contains the total memory (for all buffers), we now need to know how much per buffer
-		// (remember, we don't allocate RAM for the PAR file.)
+					if (inputBlocks && !inputBlocks->process(j, readBuffer, readCount)) throw _T("Unable to fingerprint data file blocks");
 
-		unsigned int	memToUsePerBuffer = static_cast<unsigned int>(memToUse / corruptCount);
-		if (memToUsePerBuffer > largestInputFile) memToUsePerBuffer = largestInputFile;
+					memcpy(dataTile + tileBytes, readBuffer, readCount);
+					tileBytes += readCount;
 
-		if (memToUsePerBuffer % OverlappedRead::BUFFER_SIZE)
-		{
-			memToUsePerBuffer /= OverlappedRead::BUFFER_SIZE;
-			memToUsePerBuffer += 1;
-			memToUsePerBuffer *= OverlappedRead::BUFFER_SIZE;
-		}
+					if (or.finishedReadingFile()) break;
+				}
 
-		// Setup the output buffers
+				if (!tileBytes) throw _T("Unable to read data file");
 
-		for (unsigned int i = 0; i < dataFileValidityFlags.size(); ++i)
-		{
-			if (dataFileValidityFlags[i] == true) continue;
+				// Update every volume with this tile
 
-			// Allocate our output buffers
+				for (unsigned int i = 1; dv.recoverable() && i < parityVolumes.size(); ++i)
+				{
+					if (!report(callback, callbackData, Progress::StageEncoding, _T("Updating parity data..."), done, total)) throw _T("Operation cancelled");
+					done += static_cast<double>(tileBytes) * 2;
 
-			unsigned char *	ptr = NULL;
-			
-			if (adjustedRepairSingleIndex == -1 || adjustedRepairSingleIndex == i)
-			{
-				ptr = new unsigned char[memToUsePerBuffer];
-				if (!ptr) throw _T("Cannot allocate output buffer");
+					unsigned int	matrixValue = vandMatrix[currentRecoverableFile + ((i-1)*recoverableCount)];
+					if (!matrixValue) continue;
+
+					unsigned char tab[0x100];
+					make_lut(tab, matrixValue);
+
+					unsigned int	offset = dataOffsets[i] + fileOffset;
+					if (!readFileRange(parityVolumes[i].filespec(filespec), offset, parityTile, tileBytes)) throw _T("Unable to read parity data");
+
+					{
+						EngineTimer	timer(EngineStats::Galois);
+
+						unsigned char *	dst = parityTile;
+						unsigned char *	src = dataTile;
+						for (unsigned int n = 0; n < tileBytes; ++n, ++src, ++dst)
+						{
+							(*dst) ^= tab[*src];
+						}
+					}
+
+					if (!writeFileRange(parityVolumes[i].filespec(filespec), offset, parityTile, tileBytes)) throw _T("Unable to write parity data");
+				}
 
+				fileOffset += tileBytes;
 			}
-			outputBuffers += ptr;
+
+			if (dv.recoverable()) ++currentRecoverableFile;
 		}
+	}
+	catch (const TCHAR * err)
+	{
+		LargeBuffer::release(dataTile);
+		LargeBuffer::release(parityTile);
+		lastError() = err;
+		return false;
+	}
 
-		// Output files
-		{
-			// We need to do this, because the FastWrite doesn't like being moved around
+	LargeBuffer::release(dataTile);
+	LargeBuffer::release(parityTile);
+	return true;
+}
 
-			outputFiles.reserve(dataVolumes.size());
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Plans how genParFiles & extendParFiles use their memory: 'bufferCount' working buffers, each holding a piece of one of the
+// volumes (or of whatever else the caller needs at once.) Without 'readAll', only the recoverable files get read.
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-			unsigned int	outputIndex = 0;
-			for (unsigned int i = 0; i < dataVolumes.size(); ++i)
-			{
-				DataFile &	df = dataVolumes[i];
-				if (df.status() == DataFile::Valid) continue;
-				if (!df.recoverable()) continue;
+bool	ParityInfo::planBuffers(const DataFileArray & dataVolumes, const ParityFileArray & volumes, const unsigned int bufferCount, const unsigned int outputBytes, const bool allowFileMajor, const bool readAll, progressCallback callback, void * callbackData)
+{
+	// We don't allocate RAM for the PAR file
 
-				// Only process those files we're supposed to bother repairing
+	unsigned int	outputCount = 0;
+	for (unsigned int i = 0; i < volumes.size(); ++i)
+	{
+		if (volumes[i].volumeNumber()) ++outputCount;
+	}
 
-				FastWrite	fw;
-				outputFiles += fw;
+	plan().reset();
+	placement().reset();
+	plan().budget() = BufferPlan::memoryBudget(options());
+	plan().bufferCount() = bufferCount;
+	plan().outputCount() = outputCount;
+	plan().outputBytes() = outputBytes;
+	plan().allowFileMajor() = allowFileMajor;
+	for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+	{
+		if (readAll || dataVolumes[i].recoverable()) plan().addInput(dataVolumes[i].fileSize(), dataVolumes[i].recoverable());
+	}
+	if (dataVolumes.size() && volumes.size()) plan().setDevices(dataVolumes[0].filespec(), volumes[0].filespec());
+	plan().build();
 
-				if (outputBuffers[outputIndex])
-				{
-					if (!outputFiles[outputIndex].open(df.filespec())) throw _T("Unable to open output file for write");
-				}
+	return report(callback, callbackData, Progress::StagePlanning, plan().summary().asArray(), 0, 1);
+}
 
-				outputIndex++;
-			}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The in-memory half of genParFiles (and all of extendParFiles): the same slice of every data file is read in turn, and each
+// volume's slice of parity is built up in its output buffer, then appended to its file. 'volumeRows' gives each output its row
+// of the Vandermonde matrix (-1 for the PAR file, which has no data.) Given the input hashes, every data file is read & hashed;
+// otherwise, only the recoverable files are read. The block map, the local parity groups and the FFT codec are all optional.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::genParDataGroupMajor(const fstl::intArray & volumeRows, DataFileArray & dataVolumes, FastWriteArray & outputFiles, fstl::array<unsigned char *> & outputBuffers, EmDeeFiveArray * inputHashes, EmDeeFiveArray * inputHashes16k, BlockMap * inputBlocks, LocalParity * localGroups, FftCodec * codec, const unsigned int parityDataSize, progressCallback callback, void * callbackData)
+{
+	unsigned int			memToUsePerBuffer = plan().tileSize();
+	fstl::array<unsigned char *>	inputBuffers;
+	unsigned char *			localBuffer = NULL;
+
+	try
+	{
+		// Total input & output data (used by the progress bar)
+
+		unsigned int	recoverableCount = 0;
+		__int64		totalInputData = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			if (dataVolumes[i].recoverable()) ++recoverableCount;
+			if (dataVolumes[i].recoverable() || inputHashes) totalInputData += dataVolumes[i].fileSize();
 		}
 
-		// Visit the valid files first
+		__int64		totalOutputData = 0;
+		for (unsigned int i = 0; i < volumeRows.size(); ++i)
+		{
+			if (volumeRows[i] >= 0) totalOutputData += parityDataSize;
+		}
+
+		// The FFT codec's input buffers (one per recoverable file)
+
+		for (unsigned int i = 0; codec && i < recoverableCount; ++i)
+		{
+			unsigned char *	ptr = allocBuffer(memToUsePerBuffer);
+			if (!ptr) throw _T("Cannot allocate input buffer");
+			inputBuffers += ptr;
+		}
+
+		// The local parity groups' buffer (one group is built at a time)
+
+		unsigned int	localGroupSize = localGroups ? localGroups->groupSize() : 0;
+		if (localGroups)
+		{
+			localBuffer = allocBuffer(memToUsePerBuffer);
+			if (!localBuffer) throw _T("Cannot allocate local parity buffer");
+		}
+
+		// Read in a block (group of chunks)
 
 		__int64		totalInputDataRead = 0;
 		__int64		totalOutputDataWritten = 0;
 		unsigned int	groupOffset = 0;
+		fstl::uintArray	outputCovered;
+		fstl::uintArray	inputCovered;
+		unsigned int	localCovered = 0;
+		outputCovered.populate(0, outputBuffers.size());
+		inputCovered.populate(0, inputBuffers.size());
+
 		while(totalInputDataRead < totalInputData)
 		{
-			// Clear out the output buffer for this group
+			TraceSpan	groupSpan("group");
 
-			for (unsigned int i = 0; i < outputBuffers.size(); ++i)
-			{
-				if (outputBuffers[i]) memset(outputBuffers[i], 0, memToUsePerBuffer);
-			}
+			// Nothing in the buffers belongs to this group yet (the first input to reach each byte stores it, rather than
+			// accumulating into a cleared buffer)
 
-			unsigned int	totalVolumesUsed = 0;
+			outputCovered.fill(0);
+			inputCovered.fill(0);
+
+			// Visit each D (data device)
+
+			unsigned int	currentRecoverableFile = 0;
 			for (unsigned int j = 0; j < dataVolumes.size(); ++j)
 			{
-				DataFile &	df = dataVolumes[j];
-				if (!df.recoverable()) continue;
-				if (df.status() != DataFile::Valid) continue;
+				// Without any hashes to build, only the recoverable files need to be read
 
-				if (groupOffset < df.fileSize())
+				if (!inputHashes && !dataVolumes[j].recoverable()) continue;
+
+				// Each local parity group starts out with a clean buffer
+
+				if (localGroups && dataVolumes[j].recoverable() && !(currentRecoverableFile % localGroupSize))
 				{
-					// Prime the buffer
+					localCovered = 0;
+				}
 
+				// Prime the buffer
+
+				if (groupOffset < dataVolumes[j].fileSize())
+				{
 					OverlappedRead	or;
-	                                if (!or.open(df.filespec(), groupOffset)) throw _T("Unable to open data file");
+					if (!or.open(dataVolumes[j].filespec(), groupOffset)) throw _T("Unable to open data file");
 					if (!or.startRead()) throw _T("Unable to read data file");
 
 					// We don't process the entire input file, we only process so many blocks of data...
@@ -888,10 +920,7 @@ bool	ParityInfo::recoverFiles(ParityFileArray & inParityVolumes, DataFileArray &
 
 					while(blocksPerChunk--)
 					{
-						// Keep the user informed
-
-						double	percent = static_cast<double>(totalInputDataRead+totalOutputDataWritten) / static_cast<double>(totalInputData+totalOutputData) * 100.0f;
-						if (callback && !callback(callbackData, _T("Recovering data files..."), static_cast<float>(percent))) throw _T("Operation cancelled");
+						if (!report(callback, callbackData, Progress::StageEncoding, _T("Generating parity data..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
 
 						// Get some data
 
@@ -901,237 +930,2547 @@ bool	ParityInfo::recoverFiles(ParityFileArray & inParityVolumes, DataFileArray &
 						if (!readBuffer) throw _T("Unable to read");
 						if (!readCount) break;
 
-						// Track our progress
+						// Track the data read
 
 						totalInputDataRead += readCount;
 
-						// Prime the next read
+						// Only prime the next read if we've got another block to read...
 
-						if (!or.startRead()) throw _T("Unable to prime the reader for data file");
+						if (blocksPerChunk && !or.startRead()) throw _T("Unable to prime the reader for data file");
 
-						// Generate the data for recoverable files
+						// Hash is block
 
-						for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+						if (inputHashes && !(*inputHashes)[j].processBits(readBuffer, readCount * 8)) throw _T("Unable to hash data file");
+
+						// Hash the first 16K of the input file
+
+						if (inputHashes16k && !groupOffset && oldBytesRead < 16*1024)
 						{
-							// Skip those files we're not supposed to bother repairing
+							unsigned int	hashCount = readCount;
+							if (hashCount > 16*1024 - oldBytesRead) hashCount = 16*1024 - oldBytesRead;
+							if (!(*inputHashes16k)[j].processBits(readBuffer, hashCount * 8)) throw _T("Unable to hash data file");
+						}
 
-							if (!outputBuffers[i]) continue;
+						// Hash the blocks, for the block map
 
-							unsigned int	mplier = recoveryArrays()[totalVolumesUsed + (i*recoverableCount)];
-							if (!mplier) continue;
+						if (inputBlocks && !inputBlocks->process(j, readBuffer, readCount)) throw _T("Unable to fingerprint data file blocks");
 
-							unsigned char tab[0x100];
-							make_lut(tab, mplier);
+						// Fold recoverable files into their local parity group
 
-							unsigned char *	dst = outputBuffers[i] + oldBytesRead;
-							unsigned char *	src = readBuffer;
+						if (localGroups && dataVolumes[j].recoverable())
+						{
+							mulContribute(localBuffer, readBuffer, oldBytesRead, readCount, NULL, localCovered);
+						}
+
+						// Generate parity data for recoverable files (the FFT codec needs the whole group at once, so for that,
+						// we just collect it)
+
+						if (dataVolumes[j].recoverable() && codec)
+						{
+							mulContribute(inputBuffers[currentRecoverableFile], readBuffer, oldBytesRead, readCount, NULL, inputCovered[currentRecoverableFile]);
+						}
+						else if (dataVolumes[j].recoverable())
+						{
+							// Munge it with the PAR data (this contains an optimized gfADD and gfMUL merged right into this loop for speed)
 
-							for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+							for (unsigned int i = 0; i < outputBuffers.size(); ++i)
 							{
-								(*dst) ^= tab[*src];
+								if (volumeRows[i] < 0) continue;
+
+								unsigned int	matrixValue = gfPOW(currentRecoverableFile + 1, volumeRows[i]);
+								if (!matrixValue) continue;
+
+								unsigned char tab[0x100];
+								make_lut(tab, matrixValue);
+
+								mulContribute(outputBuffers[i], readBuffer, oldBytesRead, readCount, tab, outputCovered[i]);
 							}
 						}
 					}
 				}
 
-				++totalVolumesUsed;
+				// Track the recoverable files processed (the last file in a local parity group means that group's piece is done)
+
+				if (dataVolumes[j].recoverable())
+				{
+					if (localGroups && (currentRecoverableFile % localGroupSize == localGroupSize - 1 || currentRecoverableFile == recoverableCount - 1))
+					{
+						unsigned int	group = localGroups->groupOf(currentRecoverableFile);
+						unsigned int	groupBytes = localGroups->dataSizes()[group];
+						clearUncovered(localBuffer, localCovered, memToUsePerBuffer);
+						if (groupOffset < groupBytes && !localGroups->process(group, groupOffset, localBuffer, fstl::min(memToUsePerBuffer, groupBytes - groupOffset))) throw _T("Unable to write local parity data");
+					}
+
+					++currentRecoverableFile;
+				}
 			}
 
-			// Visit the parity files next
+			// Encode the group
 
-			unsigned int	parityVolumesUsed = 0;
-			for (unsigned int j = 0; parityVolumesUsed < corruptCount && j < parityVolumes.size(); ++j)
+			if (codec && totalOutputDataWritten < totalOutputData)
 			{
-				ParityFile &	pf = parityVolumes[j];
-				if (!pf.volumeNumber()) continue;
-				if (pf.status() != ParityFile::Valid) continue;
-
-				// We skip the PAR header when restoring files, so how big is that header?
+				if (!report(callback, callbackData, Progress::StageEncoding, _T("Generating parity data..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
 
-				unsigned int	headerSize = 0;
-				FILE *	fp = _wfopen(pf.filespec().asArray(), _T("rb"));
-				if (!fp) throw _T("Unable to get header size for parity file");
-				fseek(fp, 0x50, SEEK_SET);
-				fread(&headerSize, 4, 1, fp);
-				fclose(fp);
+				for (unsigned int i = 0; i < inputBuffers.size(); ++i)
+				{
+					clearUncovered(inputBuffers[i], inputCovered[i], memToUsePerBuffer);
+				}
 
-				// Prime the buffer
+				fstl::array<unsigned char *>	parityBuffers;
+				for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+				{
+					if (volumeRows[i] >= 0) parityBuffers += outputBuffers[i];
+				}
 
-				OverlappedRead	or;
-				if (!or.open(pf.filespec(), groupOffset)) throw _T("Unable to open parity file");
+				if (!codec->encode(inputBuffers, parityBuffers, memToUsePerBuffer)) throw _T("Unable to generate FFT parity data");
+			}
 
-				if (groupOffset < largestInputFile)
-				{
-					if (!or.startRead()) throw _T("Unable to read parity file");
+			// Write the output buffers (unrecoverable files can be bigger than the volumes, so we may already be done with them)
 
-					// We don't process the entire input file, we only process so many blocks of data...
+			for (unsigned int i = 0; totalOutputDataWritten < totalOutputData && i < outputBuffers.size(); ++i)
+			{
+				if (volumeRows[i] < 0) continue;
 
-					unsigned int	bytesProcessed = 0;
+				// How many bytes to process?
 
-					// Process a chunk of this input file
+				unsigned int	bytes = memToUsePerBuffer;
+				if (groupOffset + bytes > parityDataSize) bytes = parityDataSize - groupOffset;
 
-					while(bytesProcessed < memToUsePerBuffer)
-					{
-						// Keep the user informed
+				// The FFT codec writes every byte of its output; otherwise, whatever no input reached is zero
 
-						float	percent = static_cast<float>(totalInputDataRead+totalOutputDataWritten) / static_cast<float>(totalInputData+totalOutputData) * 100.0f;
-						if (callback && !callback(callbackData, _T("Recovering data files..."), percent)) throw _T("Operation cancelled");
+				if (!codec) clearUncovered(outputBuffers[i], outputCovered[i], bytes);
 
-						// Get some data
+				// Write the data out in chunks, so we have a smooth progress bar
 
-						unsigned int	oldBytesRead = or.bytesRead();
-						unsigned int	readCount;
-						unsigned char *	readBuffer = or.finishRead(readCount);
-						if (!readBuffer) throw _T("Unable to read");
-						if (!readCount) break;
+				for (unsigned int k = 0; k < bytes; k += OverlappedRead::BUFFER_SIZE)
+				{
+					if (!report(callback, callbackData, Progress::StageWriting, _T("Writing parity data..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
 
-						// Skip the header?
+					unsigned int	b = OverlappedRead::BUFFER_SIZE;
+					if (k + b > bytes) b = bytes - k;
+					if (!outputFiles[i].write(outputBuffers[i] + k, b)) throw _T("Unable to write parity data");
 
-						if (!oldBytesRead)
-						{
-							readCount -= headerSize;
-							readBuffer += headerSize;
-						}
+					totalOutputDataWritten += b;
+				}
+			}
 
-						// Make sure we don't overflow our buffer
+			// Next group
 
-						if (bytesProcessed + readCount > memToUsePerBuffer)
-						{
-							readCount = memToUsePerBuffer - bytesProcessed;
-						}
+			groupOffset += memToUsePerBuffer;
+		}
+	}
+	catch (const TCHAR * err)
+	{
+		for (unsigned int i = 0; i < inputBuffers.size(); ++i)
+		{
+			LargeBuffer::release(inputBuffers[i]);
+		}
+		LargeBuffer::release(localBuffer);
+		lastError() = err;
+		return false;
+	}
 
-						// Track our progress
+	// Done with the FFT codec's input (and the local parity)
 
-						totalInputDataRead += readCount;
+	for (unsigned int i = 0; i < inputBuffers.size(); ++i)
+	{
+		LargeBuffer::release(inputBuffers[i]);
+	}
+	LargeBuffer::release(localBuffer);
+	return true;
+}
 
-						// Prime the next read
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Closes the volumes that genParFiles & extendParFiles have written and gives them their final headers: the header gets the set
+// hash and the data file hashes, then the volume is fingerprinted, and the header is written again with the fingerprint in it.
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-						if (!or.startRead()) throw _T("Unable to prime the reader for parity file");
+bool	ParityInfo::finishParFiles(ParityFileArray & volumes, DataFileArray & dataVolumes, FastWriteArray & outputFiles, fstl::array<unsigned char *> & outputBuffers, const unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BYTES], progressCallback callback, void * callbackData)
+{
+	FILE *	fp = NULL;
 
-						// Generate the data for recoverable files
+	try
+	{
+		// Set the percent bar to zero
 
-						for (unsigned int i = 0; i < outputBuffers.size(); ++i)
-						{
-							// Skip those files we're not supposed to bother repairing
+		if (!report(callback, callbackData, Progress::StageHashing, _T("Fingerprinting PAR file headers..."), 0, 1)) throw _T("Operation cancelled");
+
+		for (unsigned int i = 0; i < volumes.size(); ++i)
+		{
+			// Close the output file
+
+			outputFiles[i].close();
+
+			// Cleanup the output buffer
+
+			LargeBuffer::release(outputBuffers[i]);
+			outputBuffers[i] = 0;
+
+			// Copy the set hash into the volume
+
+			memcpy(volumes[i].setHash(), parSetHash, EmDeeFive::HASH_SIZE_IN_BYTES);
+
+			// Generate a new header that contains all the proper data file hashes
+			{
+				fstl::ucharArray	fileHeader = volumes[i].storePARHeader(dataVolumes);
+				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+
+				// Write the new header
+
+				fp = _wfopen(volumes[i].filespec().asArray(), _T("r+b"));
+				if (!fp) throw _T("Unable to open output file for header write");
+				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
+				fclose(fp);
+				fp = NULL;
+			}
+
+			// Checksum the par file
+
+			if (!EmDeeFive::processFile(volumes[i].filespec(), volumes[i].hash(), volumes.size(), i, callback, callbackData, 0x20)) throw _T("Unable to fingerprint PAR file");
+
+			// Generate a final header, with the entire file's fingerprint
+			{
+				fstl::ucharArray	fileHeader = volumes[i].storePARHeader(dataVolumes);
+				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+
+				// Write the new header
+
+				fp = _wfopen(volumes[i].filespec().asArray(), _T("r+b"));
+				if (!fp) throw _T("Unable to open output file for header write");
+				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
+				fclose(fp);
+				fp = NULL;
+			}
+		}
+	}
+	catch (const TCHAR * err)
+	{
+		if (fp) fclose(fp);
+		lastError() = err;
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::extendParFiles(ParityFileArray & newVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	// Transient allocations come from the operation's arena
+
+	fstl::arena			arena;
+	fstl::arenaScope		arenaScope(arena);
+	arena.reserve((dataVolumes.size() + newVolumes.size()) * ARENA_BYTES_PER_FILE);
+
+	fstl::array<unsigned char *>	outputBuffers;
+	FastWriteArray			outputFiles;
+
+	try
+	{
+		if (isFftCoded(parityFiles())) throw _T("Recovery volumes cannot be added to an FFT-coded set");
+
+		// Count the recoverable files (they're the only ones we need to read, since the data file hashes are already known)
+
+		unsigned int	recoverableCount = 0;
+		unsigned int	largestInputFile = 0;
+		__int64		totalInputData = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			if (!dataVolumes[i].recoverable()) continue;
+
+			// The new volumes must agree with the existing ones, so we can only build them from known-good data
+
+			if (dataVolumes[i].status() != DataFile::Valid) throw _T("All recoverable data files must be valid before adding recovery volumes");
+
+			recoverableCount++;
+			totalInputData += dataVolumes[i].fileSize();
+			largestInputFile = fstl::max(largestInputFile, dataVolumes[i].fileSize());
+		}
+
+		stats().add(EngineStats::InputBytes, totalInputData);
+		stats().add(EngineStats::InputFiles, recoverableCount);
+
+		// Make sure we have a valid operation
+
+		int	highestVolume = 0;
+		for (unsigned int i = 0; i < newVolumes.size(); ++i)
+		{
+			if (newVolumes[i].volumeNumber() <= 0) throw _T("Only recovery volumes (not the PAR file) may be added to a set");
+			highestVolume = fstl::max(highestVolume, newVolumes[i].volumeNumber());
+		}
+
+		if (!newVolumes.size()) throw _T("No parity files to be generated");
+		if (!recoverableCount || !largestInputFile) throw _T("There are no recoverable files in this set");
+		if (static_cast<unsigned int>(highestVolume) > recoverableCount) throw _T("Cannot create more parity files than recoverable data files");
+		if (recoverableCount + highestVolume >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+
+		// Plan how to use our memory (one buffer per new volume, and only the recoverable files are read)
+
+		if (!planBuffers(dataVolumes, newVolumes, newVolumes.size(), largestInputFile, false, false, callback, callbackData)) throw _T("Operation cancelled");
+
+		unsigned int	memToUsePerBuffer = plan().tileSize();
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		// This is necessary, since the FastWrites can't be copied around
+
+		outputFiles.reserve(newVolumes.size());
+
+		// Setup the output buffers & files
+
+		for (unsigned int i = 0; i < newVolumes.size(); ++i)
+		{
+			// The new volumes belong to the existing set
+
+			memcpy(newVolumes[i].setHash(), setHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
+
+			// Setup the fastwrite file
+
+			FastWrite	fw;
+			outputFiles += fw;
+			if (!outputFiles[i].open(newVolumes[i].filespec())) throw _T("Unable to open/create output file");
+
+			// Write the header's placeholder...
+
+			fstl::ucharArray	fileHeader = newVolumes[i].storePARHeader(dataVolumes);
+			if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+			outputFiles[i].write(&fileHeader[0], fileHeader.size());
+
+			unsigned char *	ptr = allocBuffer(memToUsePerBuffer);
+			if (!ptr) throw _T("Cannot allocate output buffer");
+			outputBuffers += ptr;
+		}
+
+		// Each volume only depends on its own row of the Vandermonde matrix (row N-1 for volume N), so we don't need the whole
+		// matrix, and the data file hashes are already known
+
+		fstl::intArray	volumeRows;
+		for (unsigned int i = 0; i < newVolumes.size(); ++i)
+		{
+			volumeRows += newVolumes[i].volumeNumber() - 1;
+		}
+
+		if (!genParDataGroupMajor(volumeRows, dataVolumes, outputFiles, outputBuffers, NULL, NULL, NULL, NULL, NULL, largestInputFile, callback, callbackData)) throw lastError().asArray();
+
+		// Write the final headers
+
+		if (!finishParFiles(newVolumes, dataVolumes, outputFiles, outputBuffers, setHash(), callback, callbackData)) throw lastError().asArray();
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the output buffers
+
+		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+		{
+			LargeBuffer::release(outputBuffers[i]);
+		}
+
+		// Error exit
+
+		fstl::wstring	msg = fstl::wstring(_T("Unable to add recovery volumes: \n\n")) + err;
+		lastError() = msg;
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::updateParFiles(const unsigned int index, const fstl::wstring & oldFilespec, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	unsigned char *	parityBuffer = NULL;
+	RangeFile *	volumeFiles = NULL;
+	FILE *		fp = NULL;
+
+	try
+	{
+		// Make sure we have a valid operation
+
+		if (index >= dataFiles().size()) throw _T("Cannot update data file (index out of range)");
+		if (isFftCoded(parityFiles())) throw _T("FFT-coded parity volumes cannot be updated in place");
+
+		DataFile &	df = dataFiles()[index];
+		if (getFileLength(df.filespec()) != df.fileSize()) throw _T("The modified file must be the same length as the original");
+		if (getFileLength(oldFilespec) != df.fileSize()) throw _T("The original file is not the right length");
+
+		// Make sure the original really is the original, because we can't undo what we're about to do to the parity volumes
+
+		unsigned char	oldHash[EmDeeFive::HASH_SIZE_IN_BYTES];
+		if (!EmDeeFive::processFile(oldFilespec, oldHash, 1, 0, callback, callbackData)) throw _T("Unable to fingerprint the original file");
+		if (memcmp(oldHash, df.hash(), EmDeeFive::HASH_SIZE_IN_BYTES)) throw _T("The original file does not match the one in this set");
+
+		// Which column of the Vandermonde matrix does this file occupy?
+
+		unsigned int	column = 0;
+		unsigned int	recoverableCount = 0;
+		for (unsigned int i = 0; i < dataFiles().size(); ++i)
+		{
+			if (!dataFiles()[i].recoverable()) continue;
+			if (i < index) ++column;
+			++recoverableCount;
+		}
+
+		// Only the valid volumes can be updated (the others won't belong to the set any more, once its hash changes)
+
+		fstl::intArray	volumes;
+		for (unsigned int i = 0; i < parityFiles().size(); ++i)
+		{
+			if (parityFiles()[i].status() == ParityFile::Valid) volumes += i;
+		}
+
+		if (!volumes.size()) throw _T("There are no valid parity volumes to update");
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		parityBuffer = new unsigned char[OverlappedRead::BUFFER_SIZE];
+		if (!parityBuffer) throw _T("Cannot allocate parity buffer");
+
+		// Each volume is read & written a block at a time, so keep them all open for the duration
+
+		volumeFiles = new RangeFile[volumes.size()];
+		if (!volumeFiles) throw _T("Cannot allocate parity volume list");
+
+		for (unsigned int i = 0; i < volumes.size(); ++i)
+		{
+			if (!parityFiles()[volumes[i]].volumeNumber()) continue;
+			if (!volumeFiles[i].open(parityFiles()[volumes[i]].filespec(), true)) throw _T("Unable to open parity file for update");
+		}
+
+		// Read the original and the modified file side-by-side. Parity is linear, so each volume changes by
+		// coef * (old XOR new), where coef is this file's entry in the volume's row of the Vandermonde matrix.
+
+		OverlappedRead	oldRead;
+		OverlappedRead	newRead;
+		if (!oldRead.open(oldFilespec)) throw _T("Unable to open the original file");
+		if (!newRead.open(df.filespec())) throw _T("Unable to open the modified file");
+		if (!oldRead.startRead()) throw _T("Unable to read the original file");
+		if (!newRead.startRead()) throw _T("Unable to read the modified file");
+
+		EmDeeFive	newHash;
+		EmDeeFive	newHash16k;
+
+		for(;;)
+		{
+			// Keep the user informed
+
+			if (!report(callback, callbackData, Progress::StageEncoding, _T("Updating parity data..."), static_cast<double>(newRead.bytesRead()), static_cast<double>(df.fileSize()))) throw _T("Operation cancelled");
+
+			// Get some data
+
+			unsigned int	offset = newRead.bytesRead();
+			unsigned int	oldCount, newCount;
+			unsigned char *	oldBuffer = oldRead.finishRead(oldCount);
+			unsigned char *	newBuffer = newRead.finishRead(newCount);
+			if (!oldBuffer || !newBuffer) throw _T("Unable to read");
+			if (oldCount != newCount) throw _T("The original and modified files changed length during the update");
+			if (!newCount) break;
+
+			if (!oldRead.startRead()) throw _T("Unable to prime the reader for the original file");
+			if (!newRead.startRead()) throw _T("Unable to prime the reader for the modified file");
+
+			// Hash the new contents as we go (the first 16K gets its own hash, too)
+
+			if (!newHash.processBits(newBuffer, newCount * 8)) throw _T("Unable to fingerprint the modified file");
+			if (offset < 16*1024)
+			{
+				unsigned int	hashCount = fstl::min(newCount, 16*1024 - offset);
+				if (!newHash16k.processBits(newBuffer, hashCount * 8)) throw _T("Unable to fingerprint the modified file");
+			}
+
+			// Non-recoverable files don't contribute to the parity data
+
+			if (!df.recoverable()) continue;
+
+			// The delta goes in place of the old data
+
+			for (unsigned int n = 0; n < oldCount; ++n) oldBuffer[n] ^= newBuffer[n];
+
+			// Local parity is a plain XOR, so it just takes the delta as-is
+
+			if (localParity().isLoaded() && localParity().available()[localParity().groupOf(column)])
+			{
+				if (!localParity().apply(localParity().groupOf(column), offset, oldBuffer, oldCount)) throw _T("Unable to update local parity data");
+			}
+
+			for (unsigned int i = 0; i < volumes.size(); ++i)
+			{
+				ParityFile &	pf = parityFiles()[volumes[i]];
+				if (!pf.volumeNumber()) continue;
+
+				unsigned char	tab[0x100];
+				make_lut(tab, gfPOW(column+1, pf.volumeNumber()-1));
+
+				if (!volumeFiles[i].read(pf.dataOffset() + offset, parityBuffer, oldCount)) throw _T("Unable to read parity file");
+
+				{
+					EngineTimer	timer(EngineStats::Galois);
+
+					unsigned char *	dst = parityBuffer;
+					unsigned char *	src = oldBuffer;
+					for (unsigned int n = 0; n < oldCount; ++n, ++src, ++dst)
+					{
+						(*dst) ^= tab[*src];
+					}
+				}
+
+				if (!volumeFiles[i].write(pf.dataOffset() + offset, parityBuffer, oldCount)) throw _T("Unable to write parity file");
+			}
+		}
+
+		delete[] volumeFiles;
+		volumeFiles = NULL;
+		delete[] parityBuffer;
+		parityBuffer = NULL;
+
+		// Store the new file hashes
+
+		newHash.finish();
+		newHash16k.finish();
+		memcpy(df.hash(), newHash.getHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
+		memcpy(df.hashFirst16K(), newHash16k.getHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
+		indexHashes();
+
+		// The set hash is built from the data file hashes, so that changes too
+
+		EmDeeFive	newSetHash;
+		for (unsigned int i = 0; i < dataFiles().size(); ++i)
+		{
+			if (!dataFiles()[i].recoverable()) continue;
+			if (!newSetHash.processBits(dataFiles()[i].hash(), EmDeeFive::HASH_SIZE_IN_BYTES * 8)) throw _T("Unable to calculate set hash");
+		}
+		newSetHash.finish();
+		memcpy(setHash(), newSetHash.getHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
+
+		// Keep the block map up to date, too
+
+		if (blockMap().isLoaded())
+		{
+			if (!blockMap().rebuild(index, df)) throw _T("Unable to fingerprint data file blocks");
+			if (!blockMap().write(BlockMap::sidecarFilespec(defaultPath(), defaultBaseName()), setHash())) throw _T("Unable to write block map");
+		}
+
+		// ...and the local parity groups (every group's header carries the set hash, but only this file's group changed)
+
+		if (localParity().isLoaded())
+		{
+			unsigned int	group = localParity().groupOf(column);
+			if (df.recoverable() && localParity().available()[group] && !localParity().rehash(group, callback, callbackData)) throw _T("Unable to fingerprint local parity data");
+
+			for (unsigned int i = 0; i < localParity().groupCount(); ++i)
+			{
+				if (localParity().available()[i] && !localParity().writeHeader(i, setHash())) throw _T("Unable to write local parity header");
+			}
+		}
+
+		// Rewrite the headers. The PAR format fingerprints each volume in its entirety, so this part still needs to read the
+		// volumes, but it doesn't need to read any of the data files.
+
+		for (unsigned int i = 0; i < volumes.size(); ++i)
+		{
+			ParityFile &	pf = parityFiles()[volumes[i]];
+			memcpy(pf.setHash(), setHash(), EmDeeFive::HASH_SIZE_IN_BYTES);
+
+			// Write the header with the new file list & set hash
+			{
+				fstl::ucharArray	fileHeader = pf.storePARHeader(dataFiles());
+				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+
+				fp = _wfopen(pf.filespec().asArray(), _T("r+b"));
+				if (!fp) throw _T("Unable to open output file for header write");
+				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
+				fclose(fp);
+				fp = NULL;
+			}
+
+			// Checksum the par file
+
+			if (!EmDeeFive::processFile(pf.filespec(), pf.hash(), volumes.size(), i, callback, callbackData, 0x20)) throw _T("Unable to fingerprint PAR file");
+
+			// Generate a final header, with the entire file's fingerprint
+			{
+				fstl::ucharArray	fileHeader = pf.storePARHeader(dataFiles());
+				if (!fileHeader.size()) throw _T("Unable to generate PAR file header");
+
+				fp = _wfopen(pf.filespec().asArray(), _T("r+b"));
+				if (!fp) throw _T("Unable to open output file for header write");
+				if (fwrite(&fileHeader[0], fileHeader.size(), 1, fp) != 1) throw _T("Unable to write PAR file header");
+				fclose(fp);
+				fp = NULL;
+			}
+		}
+	}
+	catch (const TCHAR * err)
+	{
+		if (fp) fclose(fp);
+		delete[] volumeFiles;
+		delete[] parityBuffer;
+
+		// Error exit
+
+		fstl::wstring	msg = fstl::wstring(_T("Unable to update parity archive: \n\n")) + err;
+		lastError() = msg;
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityInfo::make_lut(unsigned char lut[0x100], const int m) const
+{
+        for (int j = 0x100; --j; )
+	{
+                lut[j] = gfexp()[gflog()[m] + gflog()[j]];
+	}
+        lut[0] = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Folds 'count' bytes of 'src' (multiplied through 'lut', or as-is if there's no lut) into 'buffer' at 'offset'. Nothing past
+// 'covered' has been written since the buffer was last used, so rather than clearing the whole buffer up front and XORing into
+// it, that part is simply overwritten by whichever input gets there first.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityInfo::mulContribute(unsigned char * buffer, const unsigned char * src, const unsigned int offset, const unsigned int count, const unsigned char * lut, unsigned int & covered)
+{
+	// Anything we skipped over is zero
+
+	if (offset > covered)
+	{
+		memset(buffer + covered, 0, offset - covered);
+		covered = offset;
+	}
+
+	EngineTimer	timer(EngineStats::Galois);
+
+	unsigned char *	dst = buffer + offset;
+	unsigned int	end = offset + count;
+	unsigned int	xorCount = covered < end ? covered - offset : count;
+
+	// Accumulate into what's already there...
+
+	unsigned int	n = 0;
+	if (lut)	for (; n < xorCount; ++n) dst[n] ^= lut[src[n]];
+	else		for (; n < xorCount; ++n) dst[n] ^= src[n];
+
+	// ...and store the rest
+
+	if (lut)	for (; n < count; ++n) dst[n] = lut[src[n]];
+	else if (n < count) memcpy(dst + n, src + n, count - n);
+
+	if (end > covered) covered = end;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Zeros the part of the first 'bytes' bytes of 'buffer' that no input has covered
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityInfo::clearUncovered(unsigned char * buffer, unsigned int & covered, const unsigned int bytes)
+{
+	if (covered < bytes)
+	{
+		memset(buffer + covered, 0, bytes - covered);
+		covered = bytes;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::accumulateDataFile(RecoveryAccumulator & accumulator, const unsigned int index, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	unsigned char *	rowBuffer = NULL;
+	unsigned char *	luts = NULL;
+
+	try
+	{
+		if (index >= dataFiles().size()) throw _T("Cannot accumulate data file (index out of range)");
+		if (isFftCoded(parityFiles())) throw _T("FFT-coded sets cannot be accumulated");
+
+		DataFile &	df = dataFiles()[index];
+		if (!df.recoverable()) return true;
+		if (df.status() != DataFile::Valid) throw _T("Only valid data files may be accumulated");
+
+		// Which column of the Vandermonde matrix does this file occupy?
+
+		unsigned int	column = 0;
+		for (unsigned int i = 0; i < index; ++i)
+		{
+			if (dataFiles()[i].recoverable()) ++column;
+		}
+
+		if (column >= accumulator.folded().size()) throw _T("Accumulator does not match this set");
+		if (accumulator.folded()[column]) return true;
+
+		// We need the GF tables for the multipliers
+
+		if ((!gflog() || !gfexp()) && !genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		// One lookup table per row (the multiplier for volume v is (column+1)^(v-1))
+
+		luts = new unsigned char[accumulator.rowCount() * 0x100];
+		if (!luts) throw _T("Cannot allocate lookup tables");
+
+		for (unsigned int row = 0; row < accumulator.rowCount(); ++row)
+		{
+			make_lut(luts + row * 0x100, gfPOW(column+1, row));
+		}
+
+		rowBuffer = new unsigned char[OverlappedRead::BUFFER_SIZE];
+		if (!rowBuffer) throw _T("Cannot allocate row buffer");
+
+		// Fold the file into each row
+
+		OverlappedRead	overlappedRead;
+		if (!overlappedRead.open(df.filespec(), 0, 0xffffffff, true)) throw _T("Unable to open data file");
+		if (!overlappedRead.startRead()) throw _T("Unable to read data file");
+
+		for(;;)
+		{
+			// Keep the user informed
+
+			if (!report(callback, callbackData, Progress::StageRecovering, _T("Accumulating recovery data..."), static_cast<double>(overlappedRead.bytesRead()), static_cast<double>(df.fileSize()))) throw _T("Operation cancelled");
+
+			unsigned int	offset = overlappedRead.bytesRead();
+			unsigned int	readCount;
+			unsigned char *	readBuffer = overlappedRead.finishRead(readCount);
+			if (!readBuffer) throw _T("Unable to read");
+			if (!readCount) break;
+
+			if (!overlappedRead.startRead()) throw _T("Unable to prime the reader for data file");
+
+			for (unsigned int row = 0; row < accumulator.rowCount(); ++row)
+			{
+				if (!accumulator.readRow(row, offset, rowBuffer, readCount)) throw _T("Unable to read accumulated recovery data");
+
+				{
+					EngineTimer	timer(EngineStats::Galois);
+
+					unsigned char *	tab = luts + row * 0x100;
+					unsigned char *	dst = rowBuffer;
+					unsigned char *	src = readBuffer;
+
+					for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+					{
+						(*dst) ^= tab[*src];
+					}
+				}
+
+				if (!accumulator.writeRow(row, offset, rowBuffer, readCount)) throw _T("Unable to write accumulated recovery data");
+			}
+		}
+
+		accumulator.folded()[column] = true;
+
+		delete[] rowBuffer;
+		delete[] luts;
+	}
+	catch (const TCHAR * err)
+	{
+		delete[] rowBuffer;
+		delete[] luts;
+
+		// The rows are only partially updated, so they're no good to anybody now. This isn't worth bothering the user about,
+		// since the repair will simply fall back to reading all of the valid data files.
+
+		TRACE(_T("Unable to accumulate recovery data: %s\n"), err);
+		accumulator.close();
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Repairs whatever is damaged in the loaded set, picking the cheapest way to do it: local parity groups first, then (depending on
+// what's left) byte-level error correction, block-level recovery or whole-file recovery from the PAR volumes. The file status
+// must be up to date (i.e. the set has been checked).
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::repairSet(progressCallback callback, void * callbackData, RecoveryAccumulator * accumulator)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	// Files that are the only damaged one in their local parity group can be rebuilt from just that group, which is far less
+	// reading than going through the PAR volumes
+
+	if (localParity().isLoaded() && options().localRepair())
+	{
+		if (!recoverLocal(dataFiles(), callback, callbackData)) return false;
+	}
+
+	// If we have a block map and some of the damaged files are still around, we only need to rebuild their damaged blocks
+
+	// (FFT-coded sets can only be repaired a whole file at a time)
+
+	bool	fftCoded = isFftCoded(parityFiles());
+	bool	partialRepair = false;
+	for (unsigned int i = 0; !fftCoded && blockMap().isLoaded() && i < dataFiles().size(); ++i)
+	{
+		DataFile &	df = dataFiles()[i];
+		if (df.recoverable() && df.status() == DataFile::Corrupt) partialRepair = true;
+	}
+
+	// More damaged files than valid parity volumes? Rebuilding whole files (or blocks) can't work, but if the damage is
+	// scattered, correcting it a byte at a time might
+
+	unsigned int	damagedCount = 0;
+	unsigned int	validParityCount = 0;
+	for (unsigned int i = 0; i < dataFiles().size(); ++i)
+	{
+		DataFile &	df = dataFiles()[i];
+		if (df.recoverable() && df.status() != DataFile::Valid) ++damagedCount;
+	}
+	for (unsigned int i = 0; i < parityFiles().size(); ++i)
+	{
+		ParityFile &	pf = parityFiles()[i];
+		if (pf.volumeNumber() && pf.status() == ParityFile::Valid) ++validParityCount;
+	}
+
+	// The local parity took care of everything?
+
+	if (!damagedCount) return true;
+
+	if (!fftCoded && damagedCount > validParityCount && options().errorCorrection())
+	{
+		return correctErrors(parityFiles(), dataFiles(), callback, callbackData);
+	}
+
+	if (partialRepair)
+	{
+		return recoverBlocks(parityFiles(), dataFiles(), callback, callbackData);
+	}
+
+	return recoverFiles(parityFiles(), dataFiles(), callback, callbackData, -1, accumulator);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::recoverFiles(ParityFileArray & inParityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex, RecoveryAccumulator * accumulator)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	// FFT-coded sets have their own path (there's no recovery matrix, and no accumulator)
+
+	if (isFftCoded(inParityVolumes)) return recoverFilesFft(inParityVolumes, dataVolumes, callback, callbackData, repairSingleIndex);
+
+	// Transient allocations come from the operation's arena
+
+	fstl::arena			arena;
+	fstl::arenaScope		arenaScope(arena);
+	arena.reserve((dataVolumes.size() + inParityVolumes.size()) * ARENA_BYTES_PER_FILE);
+
+	ParityFileArray			parityVolumes;
+	fstl::uintArray			multipliers;
+
+	fstl::array<unsigned char *>	outputBuffers;
+	FastWriteArray			outputFiles;
+	unsigned char *			syndromeBuffer = NULL;
+
+	try
+	{
+		// Count the recoverable files and the files needed to be recovered
+
+		unsigned int	recoverableCount = 0;
+		unsigned int	validCount = 0;
+		unsigned int	corruptCount = 0;
+		unsigned int	largestInputFile = 0;
+		__int64		totalInputData = 0;
+		__int64		validInputData = 0;
+		__int64		totalOutputData = 0;
+		unsigned int	parityCount = 0;
+		int		adjustedRepairSingleIndex = -1;
+		fstl::boolArray	dataFileValidityFlags;
+
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+
+			if (!df.recoverable()) continue;
+
+			recoverableCount++;
+
+			if (df.status() == DataFile::Unknown)	throw _T("All files need to be checked before recovery");
+			if (df.status() == DataFile::Valid)
+			{
+				dataFileValidityFlags += true;
+				validCount++;
+				totalInputData += df.fileSize();
+				validInputData += df.fileSize();
+			}
+			else
+			{
+				dataFileValidityFlags += false;
+				corruptCount++;
+				if (df.recoverable() && (repairSingleIndex == i || repairSingleIndex == -1)) totalOutputData += df.fileSize();
+			}
+
+			// Adjust the repair single index to skip over the non-recoverable files
+
+			if (repairSingleIndex == i) adjustedRepairSingleIndex = recoverableCount - 1;
+
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
+
+		// Generate a list of valid parity volume IDs
+
+		fstl::intArray	parityIDs;
+		for (unsigned int i = 0; i < inParityVolumes.size(); ++i)
+		{
+			if (inParityVolumes[i].volumeNumber() == 0) continue;
+			if (inParityVolumes[i].status() != ParityFile::Valid) continue;
+			if (parityIDs.size() < corruptCount) totalInputData += largestInputFile;
+			parityIDs += inParityVolumes[i].volumeNumber();
+		}
+
+		// Make sure we have a valid operation
+
+		if (!corruptCount) throw _T("There are no files to recover");
+		if (parityIDs.size() < corruptCount) throw _T("You do not have enough parity files to recover the set");
+		if (parityIDs.size() > recoverableCount) throw _T("Cannot have more parity files than recoverable data files");
+		if (recoverableCount + parityIDs.size() >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+
+		// What we'll read: the valid files, plus one parity volume for each file we're missing
+
+		stats().add(EngineStats::InputBytes, totalInputData);
+		stats().add(EngineStats::InputFiles, validCount + corruptCount);
+
+		// If the valid files were accumulated while the set was downloading (and they're exactly the files that are still
+		// valid), we can skip reading them again. We'll prefer the parity volumes that the accumulator has rows for.
+
+		bool	useAccumulator = accumulator && accumulator->isOpen() && accumulator->folded().size() == recoverableCount;
+		for (unsigned int i = 0; useAccumulator && i < dataFileValidityFlags.size(); ++i)
+		{
+			if (accumulator->folded()[i] != dataFileValidityFlags[i]) useAccumulator = false;
+		}
+
+		if (useAccumulator)
+		{
+			fstl::intArray	preferredIDs;
+			fstl::intArray	otherIDs;
+			for (unsigned int i = 0; i < parityIDs.size(); ++i)
+			{
+				if (accumulator->hasRowForVolume(parityIDs[i]))	preferredIDs += parityIDs[i];
+				else						otherIDs += parityIDs[i];
+			}
+
+			parityIDs = preferredIDs;
+			parityIDs += otherIDs;
+		}
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		// Generate the recovery array
+
+		bool	setUnrecoverable;
+		bool	rc = analyzeRecoverable(dataFileValidityFlags, parityIDs, inParityVolumes, parityVolumes, corruptCount, setUnrecoverable, multipliers);
+		if (!rc && !setUnrecoverable) throw _T("Unable to generate recovery matrix");
+		if (!rc && setUnrecoverable) throw _T("");
+
+		// The accumulator is only useful if it has a row for every parity volume we ended up with
+
+		for (unsigned int i = 0; useAccumulator && i < parityVolumes.size(); ++i)
+		{
+			if (!accumulator->hasRowForVolume(parityVolumes[i].volumeNumber())) useAccumulator = false;
+		}
+
+		// If so, we read one accumulated row per parity volume, instead of every valid data file
+
+		if (useAccumulator)
+		{
+			totalInputData -= validInputData;
+			totalInputData += static_cast<__int64>(largestInputFile) * corruptCount;
+
+			syndromeBuffer = new unsigned char[OverlappedRead::BUFFER_SIZE];
+			if (!syndromeBuffer) throw _T("Cannot allocate accumulator buffer");
+		}
+
+//		if (!genRecoveryMultipliers(dataFileValidityFlags, parityIDs)) throw _T("Unable to generate recovery matrix");
+
+		// Plan how to use our memory: one buffer per file being rebuilt. Each pass reads a piece of every valid file (or of
+		// every accumulated row) and of every parity volume we're using.
+
+		plan().reset();
+		placement().reset();
+		plan().budget() = BufferPlan::memoryBudget(options());
+		plan().bufferCount() = corruptCount;
+		plan().outputCount() = corruptCount;
+		plan().outputBytes() = largestInputFile;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			if (!useAccumulator && dataVolumes[i].recoverable() && dataVolumes[i].status() == DataFile::Valid) plan().addInput(dataVolumes[i].fileSize());
+		}
+		for (unsigned int i = 0; i < corruptCount * (useAccumulator ? 2 : 1); ++i)
+		{
+			plan().addInput(largestInputFile);
+		}
+		plan().setDevices(parityVolumes[0].filespec(), dataVolumes[0].filespec());
+		plan().build();
+
+		unsigned int	memToUsePerBuffer = plan().tileSize();
+		if (!report(callback, callbackData, Progress::StagePlanning, plan().summary().asArray(), 0, 1)) throw _T("Operation cancelled");
+
+		// Setup the output buffers
+
+		for (unsigned int i = 0; i < dataFileValidityFlags.size(); ++i)
+		{
+			if (dataFileValidityFlags[i] == true) continue;
+
+			// Allocate our output buffers
+
+			unsigned char *	ptr = NULL;
+			
+			if (adjustedRepairSingleIndex == -1 || adjustedRepairSingleIndex == i)
+			{
+				ptr = allocBuffer(memToUsePerBuffer);
+				if (!ptr) throw _T("Cannot allocate output buffer");
+
+			}
+			outputBuffers += ptr;
+		}
+
+		// Output files
+		{
+			// We need to do this, because the FastWrite doesn't like being moved around
+
+			outputFiles.reserve(dataVolumes.size());
+
+			unsigned int	outputIndex = 0;
+			for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+			{
+				DataFile &	df = dataVolumes[i];
+				if (df.status() == DataFile::Valid) continue;
+				if (!df.recoverable()) continue;
+
+				// Only process those files we're supposed to bother repairing
+
+				FastWrite	fw;
+				outputFiles += fw;
+
+				if (outputBuffers[outputIndex])
+				{
+					if (!outputFiles[outputIndex].open(df.filespec())) throw _T("Unable to open output file for write");
+				}
+
+				outputIndex++;
+			}
+		}
+
+		// Visit the valid files first
+
+		__int64		totalInputDataRead = 0;
+		__int64		totalOutputDataWritten = 0;
+		unsigned int	groupOffset = 0;
+		fstl::uintArray	outputCovered;
+		outputCovered.populate(0, outputBuffers.size());
+
+		while(totalInputDataRead < totalInputData)
+		{
+			TraceSpan	groupSpan("group");
+
+			// Nothing in the output buffers belongs to this group yet
+
+			outputCovered.fill(0);
+
+			unsigned int	totalVolumesUsed = 0;
+			for (unsigned int j = 0; j < dataVolumes.size(); ++j)
+			{
+				DataFile &	df = dataVolumes[j];
+				if (!df.recoverable()) continue;
+				if (df.status() != DataFile::Valid) continue;
+
+				// The accumulator already holds this file's contribution
+
+				if (useAccumulator)
+				{
+					++totalVolumesUsed;
+					continue;
+				}
+
+				if (groupOffset < df.fileSize())
+				{
+					// Prime the buffer
+
+					OverlappedRead	or;
+	                                if (!or.open(df.filespec(), groupOffset)) throw _T("Unable to open data file");
+					if (!or.startRead()) throw _T("Unable to read data file");
+
+					// We don't process the entire input file, we only process so many blocks of data...
+
+					unsigned int	blocksPerChunk = memToUsePerBuffer / OverlappedRead::BUFFER_SIZE;
+
+					// Process a chunk of this input file
+
+					while(blocksPerChunk--)
+					{
+						// Keep the user informed
+
+						if (!report(callback, callbackData, Progress::StageRecovering, _T("Recovering data files..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
+
+						// Get some data
+
+						unsigned int	oldBytesRead = or.bytesRead();
+						unsigned int	readCount;
+						unsigned char *	readBuffer = or.finishRead(readCount);
+						if (!readBuffer) throw _T("Unable to read");
+						if (!readCount) break;
+
+						// Track our progress
+
+						totalInputDataRead += readCount;
+
+						// Prime the next read
+
+						if (!or.startRead()) throw _T("Unable to prime the reader for data file");
+
+						// Generate the data for recoverable files
+
+						for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+						{
+							// Skip those files we're not supposed to bother repairing
+
+							if (!outputBuffers[i]) continue;
+
+							unsigned int	mplier = multipliers[totalVolumesUsed + (i*recoverableCount)];
+							if (!mplier) continue;
+
+							unsigned char tab[0x100];
+							make_lut(tab, mplier);
+
+							mulContribute(outputBuffers[i], readBuffer, oldBytesRead, readCount, tab, outputCovered[i]);
+						}
+					}
+				}
+
+				++totalVolumesUsed;
+			}
+
+			// Visit the parity files next
+
+			unsigned int	parityVolumesUsed = 0;
+			for (unsigned int j = 0; parityVolumesUsed < corruptCount && j < parityVolumes.size(); ++j)
+			{
+				ParityFile &	pf = parityVolumes[j];
+				if (!pf.volumeNumber()) continue;
+				if (pf.status() != ParityFile::Valid) continue;
+
+				// We skip the PAR header when restoring files, so how big is that header?
+
+				unsigned int	headerSize = 0;
+				FILE *	fp = _wfopen(pf.filespec().asArray(), _T("rb"));
+				if (!fp) throw _T("Unable to get header size for parity file");
+				fseek(fp, 0x50, SEEK_SET);
+				fread(&headerSize, 4, 1, fp);
+				fclose(fp);
+
+				// Prime the buffer
+
+				OverlappedRead	or;
+				if (!or.open(pf.filespec(), groupOffset)) throw _T("Unable to open parity file");
+
+				if (groupOffset < largestInputFile)
+				{
+					if (!or.startRead()) throw _T("Unable to read parity file");
+
+					// We don't process the entire input file, we only process so many blocks of data...
+
+					unsigned int	bytesProcessed = 0;
+
+					// Process a chunk of this input file
+
+					while(bytesProcessed < memToUsePerBuffer)
+					{
+						// Keep the user informed
+
+						if (!report(callback, callbackData, Progress::StageRecovering, _T("Recovering data files..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
+
+						// Get some data
+
+						unsigned int	oldBytesRead = or.bytesRead();
+						unsigned int	readCount;
+						unsigned char *	readBuffer = or.finishRead(readCount);
+						if (!readBuffer) throw _T("Unable to read");
+						if (!readCount) break;
+
+						// Skip the header?
+
+						if (!oldBytesRead)
+						{
+							readCount -= headerSize;
+							readBuffer += headerSize;
+						}
+
+						// Make sure we don't overflow our buffer
+
+						if (bytesProcessed + readCount > memToUsePerBuffer)
+						{
+							readCount = memToUsePerBuffer - bytesProcessed;
+						}
+
+						// Track our progress
+
+						totalInputDataRead += readCount;
+
+						// Prime the next read
+
+						if (!or.startRead()) throw _T("Unable to prime the reader for parity file");
+
+						// Generate the data for recoverable files
+
+						for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+						{
+							// Skip those files we're not supposed to bother repairing
+
+							if (!outputBuffers[i]) continue;
+
+							unsigned int	mplier = multipliers[totalVolumesUsed + (i*recoverableCount)];
+							if (!mplier) continue;
+
+							unsigned char tab[0x100];
+							make_lut(tab, mplier);
+
+							mulContribute(outputBuffers[i], readBuffer, bytesProcessed, readCount, tab, outputCovered[i]);
+						}
+
+						bytesProcessed += readCount;
+					}
+				}
+
+				// Fold in the accumulated contribution of the valid data files to this parity row (it takes the same
+				// multipliers as the parity volume itself, since the two simply XOR together)
+
+				if (useAccumulator && groupOffset < largestInputFile)
+				{
+					unsigned int	bytes = fstl::min(memToUsePerBuffer, largestInputFile - groupOffset);
+
+					for (unsigned int k = 0; k < bytes; k += OverlappedRead::BUFFER_SIZE)
+					{
+						// Keep the user informed
+
+						if (!report(callback, callbackData, Progress::StageRecovering, _T("Recovering data files..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
+
+						// Get some data
+
+						unsigned int	readCount = OverlappedRead::BUFFER_SIZE;
+						if (k + readCount > bytes) readCount = bytes - k;
+						if (!accumulator->readRow(pf.volumeNumber() - 1, groupOffset + k, syndromeBuffer, readCount)) throw _T("Unable to read accumulated recovery data");
+
+						// Track our progress
+
+						totalInputDataRead += readCount;
+
+						// Generate the data for recoverable files
+
+						for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+						{
+							// Skip those files we're not supposed to bother repairing
 
 							if (!outputBuffers[i]) continue;
 
-							unsigned int	mplier = recoveryArrays()[totalVolumesUsed + (i*recoverableCount)];
-							if (!mplier) continue;
+							unsigned int	mplier = multipliers[totalVolumesUsed + (i*recoverableCount)];
+							if (!mplier) continue;
+
+							unsigned char tab[0x100];
+							make_lut(tab, mplier);
+
+							mulContribute(outputBuffers[i], syndromeBuffer, k, readCount, tab, outputCovered[i]);
+						}
+					}
+				}
+
+				++totalVolumesUsed;
+				++parityVolumesUsed;
+			}
+
+			// Write the output files
+
+			unsigned int	outputIndex = 0;
+			for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+			{
+				DataFile &	df = dataVolumes[i];
+				if (df.status() == DataFile::Valid) continue;
+				if (!df.recoverable()) continue;
+
+				// Only process those files we're supposed to bother repairing
+
+				unsigned char *	buffer = outputBuffers[outputIndex];
+
+				if (buffer && groupOffset < df.fileSize())
+				{
+					// Get the file
+
+					FastWrite &	fw = outputFiles[outputIndex];
+
+					// How many bytes to process?
+
+					unsigned int	bytes = memToUsePerBuffer;
+					if (groupOffset + bytes > df.fileSize()) bytes = df.fileSize() - groupOffset;
+
+					clearUncovered(buffer, outputCovered[outputIndex], bytes);
+
+					for (unsigned int k = 0; k < bytes; k += OverlappedRead::BUFFER_SIZE)
+					{
+						// Keep the user informed
+
+						if (!report(callback, callbackData, Progress::StageWriting, _T("Writing recovered data files..."), static_cast<double>(totalInputDataRead+totalOutputDataWritten), static_cast<double>(totalInputData+totalOutputData))) throw _T("Operation cancelled");
+
+						// How many bytes to write?
+
+						unsigned int	b = OverlappedRead::BUFFER_SIZE;
+						if (k + b > bytes) b = bytes - k;
+						if (!fw.write(buffer + k, b)) throw _T("Unable to write recovered data");
+
+						totalOutputDataWritten += b;
+					}
+				}
+
+				outputIndex++;
+			}
+
+			// Next group
+
+			groupOffset += memToUsePerBuffer;
+		}
+
+		// Update the datafiles
+
+		unsigned int	outputIndex = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+			if (df.status() == DataFile::Valid) continue;
+			if (!df.recoverable()) continue;
+
+			// Only process those files we're supposed to bother repairing
+
+			unsigned char *	buffer = outputBuffers[outputIndex];
+
+			if (buffer)
+			{
+				// Mark the file as unknown
+
+				df.status() = DataFile::Unknown;
+
+				// Free its buffer
+
+				LargeBuffer::release(buffer);
+				outputBuffers[outputIndex] = 0;
+			}
+
+			outputIndex++;
+		}
+
+		delete[] syndromeBuffer;
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the output buffers
+
+		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+		{
+			LargeBuffer::release(outputBuffers[i]);
+		}
+
+		delete[] syndromeBuffer;
+
+		// Error exit
+
+		if (err && wcslen(err))
+		{
+			fstl::wstring	msg = fstl::wstring(_T("Unable to restore data files: \n\n")) + err;
+			lastError() = msg;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Rebuilds any file that is the only damaged one in its local parity group, using just that group (so it reads a handful of
+// files, rather than the whole set.) Anything it can't handle is left for recoverFiles(); the files it does rebuild are checked
+// again straight away, so the caller knows what's left.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::recoverLocal(DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	unsigned char *	inputBuffer = NULL;
+	unsigned char *	outputBuffer = NULL;
+
+	try
+	{
+		if (!localParity().isLoaded()) throw _T("There is no local parity for this set");
+
+		// Which recoverable files belong to which group?
+
+		fstl::array<fstl::intArray>	groups;
+		unsigned int			largestInputFile = 0;
+		unsigned int			column = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+			if (!df.recoverable()) continue;
+			if (df.status() == DataFile::Unknown) throw _T("All files need to be checked before recovery");
+
+			unsigned int	group = localParity().groupOf(column++);
+			if (group == groups.size()) groups += fstl::intArray();
+			groups[group] += i;
+
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
+
+		if (groups.size() != localParity().groupCount()) throw _T("The local parity files do not match this set");
+
+		// Determine how much of each file we can process at a time
+
+		double	memToUse = BufferPlan::memoryBudget(options());
+
+		unsigned int	pieceSize = static_cast<unsigned int>(memToUse / 2);
+		pieceSize = fstl::max(pieceSize - pieceSize % OverlappedRead::BUFFER_SIZE, static_cast<unsigned int>(OverlappedRead::BUFFER_SIZE));
+		if (largestInputFile && pieceSize > largestInputFile) pieceSize = largestInputFile;
+
+		inputBuffer = new unsigned char[pieceSize];
+		if (!inputBuffer) throw _T("Cannot allocate input buffer");
+		outputBuffer = new unsigned char[pieceSize];
+		if (!outputBuffer) throw _T("Cannot allocate output buffer");
+
+		for (unsigned int g = 0; g < groups.size(); ++g)
+		{
+			// Local parity can only fix one file per group
+
+			int		damaged = -1;
+			unsigned int	damagedCount = 0;
+			for (unsigned int i = 0; i < groups[g].size(); ++i)
+			{
+				if (dataVolumes[groups[g][i]].status() == DataFile::Valid) continue;
+				damaged = groups[g][i];
+				++damagedCount;
+			}
+
+			if (damagedCount != 1) continue;
+			if (repairSingleIndex >= 0 && damaged != repairSingleIndex) continue;
+			if (!localParity().available()[g]) continue;
+
+			// Make sure the group's parity is good, or we'd just be writing garbage over the file
+
+			if (!localParity().verifyGroup(g, callback, callbackData)) continue;
+
+			// Rebuild it: the group's parity XOR every other file in the group (shorter files are padded with zeros)
+
+			DataFile &	target = dataVolumes[damaged];
+			fstl::wstring	filespec;
+
+			for (unsigned int offset = 0; offset < target.fileSize(); offset += pieceSize)
+			{
+				if (!report(callback, callbackData, Progress::StageRecovering, _T("Rebuilding from local parity..."), static_cast<double>(offset), static_cast<double>(target.fileSize()))) throw _T("Operation cancelled");
+
+				unsigned int	length = fstl::min(pieceSize, target.fileSize() - offset);
+				if (!localParity().readGroup(g, offset, outputBuffer, length)) throw _T("Unable to read local parity data");
+
+				for (unsigned int i = 0; i < groups[g].size(); ++i)
+				{
+					if (groups[g][i] == damaged) continue;
+
+					DataFile &	df = dataVolumes[groups[g][i]];
+					if (offset >= df.fileSize()) continue;
+
+					unsigned int	readCount = fstl::min(length, df.fileSize() - offset);
+					if (!readFileRange(df.filespec(filespec), offset, inputBuffer, readCount)) throw _T("Unable to read");
+
+					unsigned char *	dst = outputBuffer;
+					unsigned char *	src = inputBuffer;
+
+					for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+					{
+						(*dst) ^= *src;
+					}
+				}
+
+				if (!writeFileRange(target.filespec(filespec), offset, outputBuffer, length)) throw _T("Unable to write recovered data");
+			}
+
+			// Empty files still need to exist, and anything that was too long gets cut back down to size
+
+			if (!target.fileSize() && !writeFileRange(target.filespec(), 0, outputBuffer, 0)) throw _T("Unable to write recovered data");
+
+			if (getFileLength(target.filespec()) > target.fileSize())
+			{
+				if (!truncateFile(target.filespec(), target.fileSize())) throw _T("Unable to truncate recovered data file");
+			}
+
+			// Check it now, so the caller knows whether the PAR volumes are still needed
+
+			validateDataFile(target, 1, 0, callback, callbackData);
+		}
+
+		delete[] inputBuffer;
+		delete[] outputBuffer;
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the buffers
+
+		delete[] inputBuffer;
+		delete[] outputBuffer;
+
+		// Error exit
+
+		if (err && wcslen(err))
+		{
+			fstl::wstring	msg = fstl::wstring(_T("Unable to restore data files: \n\n")) + err;
+			lastError() = msg;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::recoverBlocks(ParityFileArray & inParityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	// Transient allocations come from the operation's arena
+
+	fstl::arena			arena;
+	fstl::arenaScope		arenaScope(arena);
+	arena.reserve((dataVolumes.size() + inParityVolumes.size()) * ARENA_BYTES_PER_FILE);
+
+	fstl::array<unsigned char *>	outputBuffers;
+	fstl::uintArray			outputCovered;
+	unsigned char *			inputBuffer = NULL;
+
+	try
+	{
+		if (!blockMap().isLoaded() || blockMap().fileSizes().size() != dataVolumes.size()) throw _T("This set does not have a block map");
+		if (isFftCoded(inParityVolumes)) throw _T("FFT-coded sets can only be repaired a whole file at a time");
+
+		// Gather the recoverable files and find out which of their blocks are damaged
+
+		fstl::uintArray			columns;
+		fstl::array<fstl::boolArray>	damage;
+		unsigned int			largestInputFile = 0;
+		unsigned int			damagedFileCount = 0;
+
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+			if (!df.recoverable()) continue;
+
+			if (df.status() == DataFile::Unknown) throw _T("All files need to be checked before recovery");
+
+			fstl::boolArray	damaged;
+			if (df.status() == DataFile::Valid)
+			{
+				damaged.populate(false, BlockMap::blockCount(df.fileSize()));
+			}
+			else if (df.status() == DataFile::Corrupt)
+			{
+				if (!blockMap().mapDamage(i, df, damaged, callback, callbackData)) throw _T("Unable to map the damage in a data file");
+				++damagedFileCount;
+			}
+			else
+			{
+				// Missing (or otherwise unusable) files are damaged from one end to the other
+
+				damaged.populate(true, BlockMap::blockCount(df.fileSize()));
+				++damagedFileCount;
+			}
+
+			columns += i;
+			damage += damaged;
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
+
+		unsigned int	recoverableCount = columns.size();
+
+		// Generate a list of valid parity volume IDs
+
+		fstl::intArray	parityIDs;
+		for (unsigned int i = 0; i < inParityVolumes.size(); ++i)
+		{
+			if (inParityVolumes[i].volumeNumber() == 0) continue;
+			if (inParityVolumes[i].status() != ParityFile::Valid) continue;
+			parityIDs += inParityVolumes[i].volumeNumber();
+		}
+
+		// Make sure we have a valid operation
+
+		if (!damagedFileCount) throw _T("There are no files to recover");
+		if (parityIDs.size() > recoverableCount) throw _T("Cannot have more parity files than recoverable data files");
+		if (recoverableCount + parityIDs.size() >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		// Determine how many blocks we can process at a time
+
+		double	memToUse = BufferPlan::memoryBudget(options());
+
+		unsigned int	blocksPerPiece = static_cast<unsigned int>(memToUse / (damagedFileCount + 1) / BlockMap::BLOCK_SIZE);
+		if (!blocksPerPiece) blocksPerPiece = 1;
+
+		unsigned int	largestBlockCount = BlockMap::blockCount(largestInputFile);
+		if (blocksPerPiece > largestBlockCount) blocksPerPiece = largestBlockCount;
+		unsigned int	pieceSize = blocksPerPiece * BlockMap::BLOCK_SIZE;
+
+		inputBuffer = new unsigned char[pieceSize];
+		if (!inputBuffer) throw _T("Cannot allocate input buffer");
+
+		// Walk through the blocks, finding runs of blocks that are damaged in the same set of files. Each run gets its own
+		// recovery matrix, and only reads the same range from the other files.
+
+		unsigned int	block = 0;
+		while(block < largestBlockCount)
+		{
+			fstl::boolArray	dataFileValidityFlags;
+			unsigned int	corruptCount = 0;
+			for (unsigned int c = 0; c < recoverableCount; ++c)
+			{
+				bool	damaged = block < damage[c].size() && damage[c][block];
+				dataFileValidityFlags += !damaged;
+				if (damaged) ++corruptCount;
+			}
+
+			if (!corruptCount)
+			{
+				++block;
+				continue;
+			}
+
+			fstl::uintArray	validColumns;
+			for (unsigned int c = 0; c < recoverableCount; ++c)
+			{
+				if (dataFileValidityFlags[c]) validColumns += c;
+			}
+
+			unsigned int	runEnd = block + 1;
+			for (bool samePattern = true; samePattern && runEnd < largestBlockCount; )
+			{
+				for (unsigned int c = 0; samePattern && c < recoverableCount; ++c)
+				{
+					bool	damaged = runEnd < damage[c].size() && damage[c][runEnd];
+					if (damaged == dataFileValidityFlags[c]) samePattern = false;
+				}
+
+				if (samePattern) ++runEnd;
+			}
+
+			// Generate the recovery array for this run
+
+			if (parityIDs.size() < corruptCount) throw _T("You do not have enough parity files to recover the set");
+
+			fstl::intArray	runParityIDs = parityIDs;
+			ParityFileArray	parityVolumes;
+			bool		setUnrecoverable;
+			fstl::uintArray	multipliers;
+			bool		rc = analyzeRecoverable(dataFileValidityFlags, runParityIDs, inParityVolumes, parityVolumes, corruptCount, setUnrecoverable, multipliers);
+			if (!rc && !setUnrecoverable) throw _T("Unable to generate recovery matrix");
+			if (!rc && setUnrecoverable) throw _T("");
+
+			while(outputBuffers.size() < corruptCount)
+			{
+				unsigned char *	ptr = new unsigned char[pieceSize];
+				if (!ptr) throw _T("Cannot allocate output buffer");
+				outputBuffers += ptr;
+				outputCovered += 0;
+			}
+
+			fstl::wstring	filespec;
+
+			for (unsigned int piece = block; piece < runEnd; piece += blocksPerPiece)
+			{
+				// Keep the user informed
+
+				if (!report(callback, callbackData, Progress::StageRecovering, _T("Recovering damaged blocks..."), static_cast<double>(piece), static_cast<double>(largestBlockCount))) throw _T("Operation cancelled");
+
+				unsigned int	offset = piece * BlockMap::BLOCK_SIZE;
+				unsigned int	length = fstl::min(blocksPerPiece, runEnd - piece) * BlockMap::BLOCK_SIZE;
+				if (offset + length > largestInputFile) length = largestInputFile - offset;
+
+				outputCovered.fill(0);
+
+				// Valid files first, then the parity volumes (the same order the recovery matrix uses)
+
+				unsigned int	inputCount = validColumns.size() + parityVolumes.size();
+				for (unsigned int totalVolumesUsed = 0; totalVolumesUsed < inputCount; ++totalVolumesUsed)
+				{
+					unsigned int	fileOffset = offset;
+					unsigned int	readCount = length;
+
+					if (totalVolumesUsed < validColumns.size())
+					{
+						DataFile &	df = dataVolumes[columns[validColumns[totalVolumesUsed]]];
+						df.filespec(filespec);
+
+						// Shorter files are padded with zeros, which don't contribute anything
+
+						if (offset >= df.fileSize()) readCount = 0;
+						else if (offset + readCount > df.fileSize()) readCount = df.fileSize() - offset;
+					}
+					else
+					{
+						ParityFile &	pf = parityVolumes[totalVolumesUsed - validColumns.size()];
+						pf.filespec(filespec);
+						fileOffset += pf.dataOffset();
+					}
+
+					if (readCount)
+					{
+						if (!readFileRange(filespec, fileOffset, inputBuffer, readCount)) throw _T("Unable to read");
+
+						// Generate the data for the damaged ranges
+
+						for (unsigned int i = 0; i < corruptCount; ++i)
+						{
+							unsigned int	mplier = multipliers[totalVolumesUsed + (i*recoverableCount)];
+							if (!mplier) continue;
+
+							unsigned char tab[0x100];
+							make_lut(tab, mplier);
+
+							mulContribute(outputBuffers[i], inputBuffer, 0, readCount, tab, outputCovered[i]);
+						}
+					}
+				}
+
+				// Patch the recovered ranges into the damaged files
+
+				unsigned int	outputIndex = 0;
+				for (unsigned int c = 0; c < recoverableCount; ++c)
+				{
+					if (dataFileValidityFlags[c]) continue;
+
+					DataFile &	df = dataVolumes[columns[c]];
+					if (offset < df.fileSize())
+					{
+						unsigned int	writeCount = fstl::min(length, df.fileSize() - offset);
+						clearUncovered(outputBuffers[outputIndex], outputCovered[outputIndex], writeCount);
+
+						if (!writeFileRange(df.filespec(filespec), offset, outputBuffers[outputIndex], writeCount)) throw _T("Unable to write recovered data");
+					}
+
+					++outputIndex;
+				}
+			}
+
+			block = runEnd;
+		}
+
+		// Anything that was too long gets cut back down to size, and everything we touched will need checking again
+
+		for (unsigned int c = 0; c < recoverableCount; ++c)
+		{
+			DataFile &	df = dataVolumes[columns[c]];
+			if (df.status() == DataFile::Valid) continue;
+
+			if (getFileLength(df.filespec()) > df.fileSize())
+			{
+				if (!truncateFile(df.filespec(), df.fileSize())) throw _T("Unable to truncate recovered data file");
+			}
+
+			df.status() = DataFile::Unknown;
+		}
+
+		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+		{
+			delete[] outputBuffers[i];
+		}
+		delete[] inputBuffer;
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the buffers
+
+		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+		{
+			delete[] outputBuffers[i];
+		}
+		delete[] inputBuffer;
+
+		// Error exit
+
+		if (err && wcslen(err))
+		{
+			fstl::wstring	msg = fstl::wstring(_T("Unable to restore data files: \n\n")) + err;
+			lastError() = msg;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Error (rather than erasure) correction. recoverFiles treats a damaged file as entirely lost, so it needs a valid parity volume
+// for each one. Here we decode each byte column on its own, which lets us fix scattered damage spread across more files than we
+// have parity volumes, as long as no single column has too much of it (each unknown bad byte costs two syndromes, and each
+// known one -- the bytes of a missing file, or past the end of a short one -- costs one).
+//
+// The decoder needs syndromes for consecutive powers, so it uses the longest run of consecutively numbered valid volumes; any
+// others are used to double-check the corrections.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::correctErrors(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	fstl::array<unsigned char *>	syndromes;
+	fstl::array<unsigned char *>	fixes;
+	unsigned char *			inputBuffer = NULL;
+	TCHAR				errorText[256];
+
+	try
+	{
+		if (isFftCoded(parityVolumes)) throw _T("Error correction is not available for FFT-coded sets");
+
+		// Gather the recoverable files (we only trust the parts of them that are actually there)
+
+		fstl::uintArray	columns;
+		fstl::uintArray	usableSizes;
+		unsigned int	largestInputFile = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+			if (!df.recoverable()) continue;
+
+			if (df.status() == DataFile::Unknown) throw _T("All files need to be checked before recovery");
+
+			columns += i;
+			usableSizes += doesFileExist(df.filespec()) ? fstl::min(getFileLength(df.filespec()), df.fileSize()) : 0;
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
+
+		unsigned int	recoverableCount = columns.size();
+
+		// The valid parity volumes, in volume order
+
+		fstl::uintArray	rows;
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			if (parityVolumes[i].volumeNumber() == 0) continue;
+			if (parityVolumes[i].status() != ParityFile::Valid) continue;
+
+			unsigned int	j = rows.size();
+			rows += i;
+			for (; j && parityVolumes[rows[j-1]].volumeNumber() > parityVolumes[i].volumeNumber(); --j)
+			{
+				rows[j] = rows[j-1];
+			}
+			rows[j] = i;
+		}
+
+		unsigned int	syndromeCount = rows.size();
+
+		// Find the longest run of consecutive volume numbers
+
+		unsigned int	runStart = 0;
+		unsigned int	runCount = 0;
+		for (unsigned int i = 0; i < syndromeCount; )
+		{
+			unsigned int	j = i + 1;
+			while(j < syndromeCount && parityVolumes[rows[j]].volumeNumber() == parityVolumes[rows[j-1]].volumeNumber() + 1) ++j;
+
+			if (j - i > runCount)
+			{
+				runStart = i;
+				runCount = j - i;
+			}
+			i = j;
+		}
+
+		// Make sure we have a valid operation
+
+		if (!recoverableCount || !largestInputFile) throw _T("There are no files to recover");
+		if (runCount < 2) throw _T("Error correction needs at least two valid parity volumes with consecutive volume numbers");
+		if (recoverableCount + syndromeCount >= static_cast<unsigned int>(1 << rsRaidBits())) throw _T("Parity and data files may not total a value greater than 2^bit_depth");
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		unsigned int	firstExponent = parityVolumes[rows[runStart]].volumeNumber() - 1;
+
+		// The coefficient of each column in each syndrome, along with its lookup table
+
+		fstl::uintArray		coefficients;
+		fstl::ucharArray	coefficientLuts;
+		coefficientLuts.populate(0, recoverableCount * syndromeCount * 0x100);
+
+		for (unsigned int c = 0; c < recoverableCount; ++c)
+		{
+			for (unsigned int s = 0; s < syndromeCount; ++s)
+			{
+				unsigned int	coefficient = gfPOW(c+1, parityVolumes[rows[s]].volumeNumber()-1);
+				coefficients += coefficient;
+				make_lut(&coefficientLuts[(c*syndromeCount+s)*0x100], coefficient);
+			}
+		}
+
+		// Determine how much of each file we can process at a time (worst case, every file needs fixing in every piece)
+
+		double	memToUse = BufferPlan::memoryBudget(options());
+
+		unsigned int	pieceSize = static_cast<unsigned int>(memToUse / (syndromeCount + recoverableCount + 1));
+		pieceSize = fstl::max(pieceSize - pieceSize % OverlappedRead::BUFFER_SIZE, static_cast<unsigned int>(OverlappedRead::BUFFER_SIZE));
+		if (pieceSize > largestInputFile) pieceSize = largestInputFile;
+
+		inputBuffer = new unsigned char[pieceSize];
+		if (!inputBuffer) throw _T("Cannot allocate input buffer");
+
+		for (unsigned int s = 0; s < syndromeCount; ++s)
+		{
+			unsigned char *	ptr = new unsigned char[pieceSize];
+			if (!ptr) throw _T("Cannot allocate syndrome buffer");
+			syndromes += ptr;
+		}
+
+		// The corrections for each file are only allocated if that file needs them
+
+		fixes.populate(static_cast<unsigned char *>(0), recoverableCount);
+
+		fstl::boolArray		touched;
+		touched.populate(false, recoverableCount);
+
+		fstl::uintArray		erased;
+		fstl::uintArray		lastErased;
+		fstl::uintArray		erasureMultipliers;
+		fstl::ucharArray	erasureLuts;
+		unsigned int		correctedCount = 0;
+		unsigned int		uncorrectableCount = 0;
+
+		fstl::wstring	filespec;
+
+		for (unsigned int offset = 0; offset < largestInputFile; offset += pieceSize)
+		{
+			unsigned int	length = fstl::min(pieceSize, largestInputFile - offset);
+
+			for (unsigned int s = 0; s < syndromeCount; ++s)
+			{
+				memset(syndromes[s], 0, length);
+			}
+
+			fstl::boolArray	pieceTouched;
+			pieceTouched.populate(false, recoverableCount);
+			for (unsigned int c = 0; c < recoverableCount; ++c)
+			{
+				if (fixes[c]) memset(fixes[c], 0, length);
+			}
+
+			// Generate the syndromes for this piece (data first, then the parity we have)
+
+			for (unsigned int c = 0; c < recoverableCount; ++c)
+			{
+				// Keep the user informed
+
+				if (!report(callback, callbackData, Progress::StageRecovering, _T("Correcting errors..."), static_cast<double>(offset) + static_cast<double>(length) * c / (recoverableCount + syndromeCount), static_cast<double>(largestInputFile))) throw _T("Operation cancelled");
+
+				DataFile &	df = dataVolumes[columns[c]];
+				unsigned int	readCount = offset >= usableSizes[c] ? 0 : fstl::min(length, usableSizes[c] - offset);
+				if (!readCount) continue;
+
+				if (!readFileRange(df.filespec(filespec), offset, inputBuffer, readCount)) throw _T("Unable to read a data file");
+
+				for (unsigned int s = 0; s < syndromeCount; ++s)
+				{
+					EngineTimer	timer(EngineStats::Galois);
+
+					const unsigned char *	tab = &coefficientLuts[(c*syndromeCount+s)*0x100];
+					unsigned char *		dst = syndromes[s];
+					unsigned char *		src = inputBuffer;
+
+					for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+					{
+						(*dst) ^= tab[*src];
+					}
+				}
+			}
+
+			for (unsigned int s = 0; s < syndromeCount; ++s)
+			{
+				ParityFile &	pf = parityVolumes[rows[s]];
+				if (!readFileRange(pf.filespec(filespec), pf.dataOffset() + offset, inputBuffer, length)) throw _T("Unable to read a parity volume");
+
+				unsigned char *	dst = syndromes[s];
+				unsigned char *	src = inputBuffer;
+
+				for (unsigned int n = 0; n < length; ++n, ++src, ++dst)
+				{
+					(*dst) ^= *src;
+				}
+			}
+
+			// Work through the piece in segments that have the same set of erased columns (missing data)
+
+			for (unsigned int segStart = 0; segStart < length; )
+			{
+				unsigned int	position = offset + segStart;
+				unsigned int	segEnd = length;
+
+				erased.erase();
+				for (unsigned int c = 0; c < recoverableCount; ++c)
+				{
+					unsigned int	fileSize = dataVolumes[columns[c]].fileSize();
+
+					if (position >= usableSizes[c] && position < fileSize)
+					{
+						erased += c;
+						segEnd = fstl::min(segEnd, fileSize - offset);
+					}
+					else if (position < usableSizes[c])
+					{
+						segEnd = fstl::min(segEnd, usableSizes[c] - offset);
+					}
+				}
+
+				if (erased.size() > runCount) throw _T("There are too many missing files to correct this set");
 
-							unsigned char tab[0x100];
-							make_lut(tab, mplier);
+				// Solve for the erased columns in bulk (if there are no other errors, this is all we need) and take them out of
+				// the syndromes
+
+				if (erased.size())
+				{
+					EngineTimer	timer(EngineStats::Galois);
+
+					bool	sameErasures = erased.size() == lastErased.size();
+					for (unsigned int j = 0; sameErasures && j < erased.size(); ++j)
+					{
+						sameErasures = erased[j] == lastErased[j];
+					}
+
+					if (!sameErasures)
+					{
+						if (!genErasureMultipliers(erased, firstExponent, erasureMultipliers)) throw _T("Unable to generate erasure multipliers");
+
+						erasureLuts.erase();
+						erasureLuts.populate(0, erasureMultipliers.size() * 0x100);
+						for (unsigned int i = 0; i < erasureMultipliers.size(); ++i)
+						{
+							make_lut(&erasureLuts[i*0x100], erasureMultipliers[i]);
+						}
+
+						lastErased = erased;
+					}
+
+					for (unsigned int j = 0; j < erased.size(); ++j)
+					{
+						unsigned int	c = erased[j];
+						if (!fixes[c])
+						{
+							fixes[c] = new unsigned char[pieceSize];
+							if (!fixes[c]) throw _T("Cannot allocate correction buffer");
+							memset(fixes[c], 0, pieceSize);
+						}
+						pieceTouched[c] = true;
 
-							unsigned char *	dst = outputBuffers[i] + bytesProcessed;
-							unsigned char *	src = readBuffer;
+						for (unsigned int k = 0; k < erased.size(); ++k)
+						{
+							if (!erasureMultipliers[j*erased.size()+k]) continue;
+
+							const unsigned char *	tab = &erasureLuts[(j*erased.size()+k)*0x100];
+							unsigned char *		dst = fixes[c] + segStart;
+							unsigned char *		src = syndromes[runStart+k] + segStart;
 
-							for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+							for (unsigned int n = segStart; n < segEnd; ++n, ++src, ++dst)
 							{
 								(*dst) ^= tab[*src];
 							}
 						}
+					}
 
-						bytesProcessed += readCount;
+					for (unsigned int j = 0; j < erased.size(); ++j)
+					{
+						unsigned int	c = erased[j];
+						for (unsigned int s = 0; s < syndromeCount; ++s)
+						{
+							const unsigned char *	tab = &coefficientLuts[(c*syndromeCount+s)*0x100];
+							unsigned char *		dst = syndromes[s] + segStart;
+							unsigned char *		src = fixes[c] + segStart;
+
+							for (unsigned int n = segStart; n < segEnd; ++n, ++src, ++dst)
+							{
+								(*dst) ^= tab[*src];
+							}
+						}
 					}
 				}
 
-				++totalVolumesUsed;
-				++parityVolumesUsed;
+				// Whatever is left over is damage we don't know the location of, so each of those columns gets decoded
+
+				for (unsigned int n = segStart; n < segEnd; ++n)
+				{
+					bool	inconsistent = false;
+					for (unsigned int s = 0; !inconsistent && s < syndromeCount; ++s)
+					{
+						inconsistent = syndromes[s][n] != 0;
+					}
+
+					if (!inconsistent) continue;
+
+					unsigned int	runSyndromes[0x100];
+					for (unsigned int k = 0; k < runCount; ++k)
+					{
+						runSyndromes[k] = syndromes[runStart+k][n];
+					}
+
+					fstl::uintArray	errorColumns;
+					fstl::uintArray	errorValues;
+					bool		corrected = decodeColumn(runSyndromes, runCount, firstExponent, recoverableCount, erased, errorColumns, errorValues);
+
+					// Double-check against all of the syndromes (with too many errors, the decoder can come up with an
+					// answer that's wrong)
+
+					for (unsigned int s = 0; corrected && s < syndromeCount; ++s)
+					{
+						unsigned int	v = syndromes[s][n];
+						for (unsigned int l = 0; l < errorColumns.size(); ++l)
+						{
+							v ^= gfMUL(errorValues[l], coefficients[errorColumns[l]*syndromeCount+s]);
+						}
+						corrected = v == 0;
+					}
+
+					if (!corrected)
+					{
+						++uncorrectableCount;
+						continue;
+					}
+
+					for (unsigned int l = 0; l < errorColumns.size(); ++l)
+					{
+						unsigned int	c = errorColumns[l];
+						if (!fixes[c])
+						{
+							fixes[c] = new unsigned char[pieceSize];
+							if (!fixes[c]) throw _T("Cannot allocate correction buffer");
+							memset(fixes[c], 0, pieceSize);
+						}
+						pieceTouched[c] = true;
+
+						fixes[c][n] ^= static_cast<unsigned char>(errorValues[l]);
+					}
+
+					++correctedCount;
+				}
+
+				segStart = segEnd;
 			}
 
-			// Write the output files
+			// Patch the corrections into the files
 
-			unsigned int	outputIndex = 0;
-			for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+			for (unsigned int c = 0; c < recoverableCount; ++c)
 			{
-				DataFile &	df = dataVolumes[i];
-				if (df.status() == DataFile::Valid) continue;
-				if (!df.recoverable()) continue;
+				if (!pieceTouched[c]) continue;
 
-				// Only process those files we're supposed to bother repairing
+				DataFile &	df = dataVolumes[columns[c]];
+				if (offset >= df.fileSize()) continue;
 
-				unsigned char *	buffer = outputBuffers[outputIndex];
+				unsigned int	writeCount = fstl::min(length, df.fileSize() - offset);
+				unsigned int	readCount = offset >= usableSizes[c] ? 0 : fstl::min(writeCount, usableSizes[c] - offset);
+				if (readCount && !readFileRange(df.filespec(filespec), offset, inputBuffer, readCount)) throw _T("Unable to read a data file");
+				memset(inputBuffer + readCount, 0, writeCount - readCount);
 
-				if (buffer && groupOffset < df.fileSize())
+				for (unsigned int n = 0; n < writeCount; ++n)
 				{
-					// Get the file
+					inputBuffer[n] ^= fixes[c][n];
+				}
 
-					FastWrite &	fw = outputFiles[outputIndex];
+				if (!writeFileRange(df.filespec(filespec), offset, inputBuffer, writeCount)) throw _T("Unable to write corrected data");
+				touched[c] = true;
+			}
+		}
 
-					// How many bytes to process?
+		// Anything that was too long gets cut back down to size, and everything we touched will need checking again
 
-					unsigned int	bytes = memToUsePerBuffer;
-					if (groupOffset + bytes > df.fileSize()) bytes = df.fileSize() - groupOffset;
+		for (unsigned int c = 0; c < recoverableCount; ++c)
+		{
+			DataFile &	df = dataVolumes[columns[c]];
+			if (!touched[c] && df.status() == DataFile::Valid) continue;
 
-					for (unsigned int k = 0; k < bytes; k += OverlappedRead::BUFFER_SIZE)
-					{
-						// Keep the user informed
+			if (doesFileExist(df.filespec()) && getFileLength(df.filespec()) > df.fileSize())
+			{
+				if (!truncateFile(df.filespec(), df.fileSize())) throw _T("Unable to truncate corrected data file");
+			}
 
-						float	percent = static_cast<float>(totalInputDataRead+totalOutputDataWritten) / static_cast<float>(totalInputData+totalOutputData) * 100.0f;
-						if (callback && !callback(callbackData, _T("Writing recovered data files..."), percent)) throw _T("Operation cancelled");
+			df.status() = DataFile::Unknown;
+		}
 
-						// How many bytes to write?
+		TRACE(_T("Error correction: %u columns corrected, %u uncorrectable\n"), correctedCount, uncorrectableCount);
 
-						unsigned int	b = OverlappedRead::BUFFER_SIZE;
-						if (k + b > bytes) b = bytes - k;
-						if (!fw.write(buffer + k, b)) throw _T("Unable to write recovered data");
+		if (uncorrectableCount)
+		{
+			swprintf(errorText, _T("%u byte column(s) had more damage than the parity volumes can correct (%u were corrected)"), uncorrectableCount, correctedCount);
+			throw static_cast<const TCHAR *>(errorText);
+		}
 
-						totalOutputDataWritten += b;
-					}
-				}
+		for (unsigned int i = 0; i < fixes.size(); ++i)
+		{
+			delete[] fixes[i];
+		}
+		for (unsigned int i = 0; i < syndromes.size(); ++i)
+		{
+			delete[] syndromes[i];
+		}
+		delete[] inputBuffer;
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the buffers
 
-				outputIndex++;
-			}
+		for (unsigned int i = 0; i < fixes.size(); ++i)
+		{
+			delete[] fixes[i];
+		}
+		for (unsigned int i = 0; i < syndromes.size(); ++i)
+		{
+			delete[] syndromes[i];
+		}
+		delete[] inputBuffer;
 
-			// Next group
+		// Error exit
 
-			groupOffset += memToUsePerBuffer;
+		if (err && wcslen(err))
+		{
+			fstl::wstring	msg = fstl::wstring(_T("Unable to correct data files: \n\n")) + err;
+			lastError() = msg;
 		}
+		return false;
+	}
 
-		// Update the datafiles
+	return true;
+}
 
-		unsigned int	outputIndex = 0;
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Verifies the whole set in a single pass by computing the RS syndromes of every byte column (the parity we'd generate from the
+// data, XORed with the parity we have). A consistent column has all-zero syndromes. A single bad byte in a parity volume shows
+// up in just that volume's syndrome, and a single bad byte in a data file at column c (locator x = c+1) gives syndromes of
+// e * x^(v-1) for each volume v, so the ratio of any two syndromes identifies the column. Columns with more than one bad byte
+// can't be placed, and are reported in 'unlocated'.
+//
+// Files with damage are marked Corrupt, and if all of the damage could be placed, the rest are marked Valid. Needs at least two
+// parity volumes (with one, we could tell that a column is bad, but not where).
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::verifySyndromes(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, fstl::array<DamageRangeArray> & dataDamage, fstl::array<DamageRangeArray> & parityDamage, DamageRangeArray & unlocated, progressCallback callback, void * callbackData)
+{
+	lastError().erase();
+
+	EngineStatsScope	statsScope(&stats());
+
+	fstl::array<unsigned char *>	syndromes;
+	unsigned char *			inputBuffer = NULL;
+
+	try
+	{
+		if (isFftCoded(parityVolumes)) throw _T("FFT-coded volumes have no syndromes");
+
+		dataDamage.erase();
+		dataDamage.populate(DamageRangeArray(), dataVolumes.size());
+		parityDamage.erase();
+		parityDamage.populate(DamageRangeArray(), parityVolumes.size());
+		unlocated.erase();
+
+		// The recoverable files are the columns of the code, so we need every one of them
+
+		fstl::uintArray	columns;
+		fstl::uintArray	actualSizes;
+		unsigned int	largestInputFile = 0;
 		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
 		{
 			DataFile &	df = dataVolumes[i];
-			if (df.status() == DataFile::Valid) continue;
 			if (!df.recoverable()) continue;
 
-			// Only process those files we're supposed to bother repairing
+			if (!doesFileExist(df.filespec())) throw _T("A data file is missing");
 
-			unsigned char *	buffer = outputBuffers[outputIndex];
+			columns += i;
+			actualSizes += getFileLength(df.filespec());
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
 
-			if (buffer)
+		// Each parity volume we have gives us a syndrome (volumes of the wrong size are left for the full check)
+
+		fstl::uintArray	rows;
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			ParityFile &	pf = parityVolumes[i];
+			if (pf.volumeNumber() == 0) continue;
+			if (!doesFileExist(pf.filespec())) continue;
+			if (pf.dataSize() != largestInputFile || getFileLength(pf.filespec()) != pf.dataOffset() + pf.dataSize()) continue;
+
+			rows += i;
+		}
+
+		unsigned int	recoverableCount = columns.size();
+		unsigned int	syndromeCount = rows.size();
+
+		// Make sure we have a valid operation
+
+		if (!recoverableCount || !largestInputFile) throw _T("There are no files to verify");
+		if (syndromeCount < 2) throw _T("At least two parity volumes are needed to locate damage");
+
+		// Generate the GF tables
+
+		if (!genGaloisFieldTables()) throw _T("unable to generate Galois Field tables");
+
+		// The coefficient for each column in each syndrome, and the ratio of the first two (which is how we find the column of a
+		// single bad byte). The ratio isn't always unique -- it's x^d, where d is the difference between the volume numbers,
+		// which repeats if d shares a factor with 255 -- so we note where it's ambiguous and search those the long way.
+
+		fstl::uintArray	coefficients;
+		fstl::uintArray	columnRatios;
+		fstl::intArray	ratioColumns;
+		ratioColumns.populate(-1, 0x100);
+
+		for (unsigned int c = 0; c < recoverableCount; ++c)
+		{
+			for (unsigned int s = 0; s < syndromeCount; ++s)
 			{
-				// Mark the file as unknown
+				coefficients += gfPOW(c+1, parityVolumes[rows[s]].volumeNumber()-1);
+			}
 
-				df.status() = DataFile::Unknown;
+			unsigned int	ratio = gfDIV(coefficients[c*syndromeCount+1], coefficients[c*syndromeCount]);
+			columnRatios += ratio;
+			ratioColumns[ratio] = ratioColumns[ratio] == -1 ? static_cast<int>(c) : -2;
+		}
 
-				// Free its buffer
+		// Determine how much of each file we can process at a time
 
-				delete[] buffer;
-				outputBuffers[outputIndex] = 0;
+		double	memToUse = BufferPlan::memoryBudget(options());
+
+		unsigned int	pieceSize = static_cast<unsigned int>(memToUse / (syndromeCount + 1));
+		pieceSize = fstl::max(pieceSize - pieceSize % OverlappedRead::BUFFER_SIZE, static_cast<unsigned int>(OverlappedRead::BUFFER_SIZE));
+		if (pieceSize > largestInputFile) pieceSize = largestInputFile;
+
+		inputBuffer = new unsigned char[pieceSize];
+		if (!inputBuffer) throw _T("Cannot allocate input buffer");
+
+		for (unsigned int s = 0; s < syndromeCount; ++s)
+		{
+			unsigned char *	ptr = new unsigned char[pieceSize];
+			if (!ptr) throw _T("Cannot allocate syndrome buffer");
+			syndromes += ptr;
+		}
+
+		fstl::wstring	filespec;
+
+		// One pass across the set, a piece at a time
+
+		for (unsigned int offset = 0; offset < largestInputFile; offset += pieceSize)
+		{
+			unsigned int	length = fstl::min(pieceSize, largestInputFile - offset);
+
+			for (unsigned int s = 0; s < syndromeCount; ++s)
+			{
+				memset(syndromes[s], 0, length);
 			}
 
-			outputIndex++;
+			// Fold in the data files
+
+			for (unsigned int c = 0; c < recoverableCount; ++c)
+			{
+				// Keep the user informed
+
+				if (!report(callback, callbackData, Progress::StageVerifying, _T("Verifying syndromes..."), static_cast<double>(offset) + static_cast<double>(length) * c / (recoverableCount + syndromeCount), static_cast<double>(largestInputFile))) throw _T("");
+
+				// Short files read as zeros past their end (as does anything past the end a file is supposed to have)
+
+				DataFile &	df = dataVolumes[columns[c]];
+				unsigned int	usableSize = fstl::min(actualSizes[c], df.fileSize());
+				unsigned int	readCount = offset >= usableSize ? 0 : fstl::min(length, usableSize - offset);
+				if (!readCount) continue;
+
+				if (!readFileRange(df.filespec(filespec), offset, inputBuffer, readCount)) throw _T("Unable to read a data file");
+
+				for (unsigned int s = 0; s < syndromeCount; ++s)
+				{
+					EngineTimer	timer(EngineStats::Galois);
+
+					unsigned char tab[0x100];
+					make_lut(tab, coefficients[c*syndromeCount+s]);
+
+					unsigned char *	dst = syndromes[s];
+					unsigned char *	src = inputBuffer;
+
+					for (unsigned int n = 0; n < readCount; ++n, ++src, ++dst)
+					{
+						(*dst) ^= tab[*src];
+					}
+				}
+			}
+
+			// Fold in the parity we have
+
+			for (unsigned int s = 0; s < syndromeCount; ++s)
+			{
+				ParityFile &	pf = parityVolumes[rows[s]];
+				if (!readFileRange(pf.filespec(filespec), pf.dataOffset() + offset, inputBuffer, length)) throw _T("Unable to read a parity volume");
+
+				unsigned char *	dst = syndromes[s];
+				unsigned char *	src = inputBuffer;
+
+				for (unsigned int n = 0; n < length; ++n, ++src, ++dst)
+				{
+					(*dst) ^= *src;
+				}
+			}
+
+			// Find the inconsistent columns and figure out where the damage is
+
+			for (unsigned int n = 0; n < length; ++n)
+			{
+				unsigned int	nonZero = 0;
+				unsigned int	lastNonZero = 0;
+				for (unsigned int s = 0; s < syndromeCount; ++s)
+				{
+					if (syndromes[s][n])
+					{
+						++nonZero;
+						lastNonZero = s;
+					}
+				}
+
+				if (!nonZero) continue;
+
+				// Just one? That parity volume is bad (damage in a data file touches every syndrome)
+
+				if (nonZero == 1)
+				{
+					addDamage(parityDamage[rows[lastNonZero]], offset + n);
+					continue;
+				}
+
+				// A single bad byte in a data file?
+
+				int	column = -1;
+				if (nonZero == syndromeCount)
+				{
+					unsigned int	ratio = gfDIV(syndromes[1][n], syndromes[0][n]);
+					int		candidate = ratioColumns[ratio];
+
+					// If more than one column fits, we can't say which it is (-2)
+
+					for (unsigned int c = 0; candidate != -1 && column != -2 && c < recoverableCount; ++c)
+					{
+						if (candidate >= 0 && c != static_cast<unsigned int>(candidate)) continue;
+						if (columnRatios[c] != ratio) continue;
+
+						// The error value has to account for every syndrome, not just the first two
+
+						unsigned int	error = gfDIV(syndromes[0][n], coefficients[c*syndromeCount]);
+						bool		fits = true;
+						for (unsigned int s = 2; fits && s < syndromeCount; ++s)
+						{
+							fits = gfMUL(error, coefficients[c*syndromeCount+s]) == syndromes[s][n];
+						}
+
+						if (fits) column = column == -1 ? static_cast<int>(c) : -2;
+					}
+				}
+
+				if (column >= 0)	addDamage(dataDamage[columns[column]], offset + n);
+				else			addDamage(unlocated, offset + n);
+			}
 		}
-	}
-	catch (const TCHAR * err)
-	{
-		// Cleanup the output buffers
 
-		for (unsigned int i = 0; i < outputBuffers.size(); ++i)
+		// Update the status of everything we looked at. Damaged files are corrupt, and if we were able to place all of the
+		// damage, the rest are valid.
+
+		for (unsigned int c = 0; c < recoverableCount; ++c)
 		{
-			delete[] outputBuffers[i];
+			DataFile &	df = dataVolumes[columns[c]];
+
+			if (actualSizes[c] < df.fileSize())
+			{
+				df.status() = DataFile::Corrupt;
+				df.statusString() = _T("File is incomplete by ") + sizeString(df.fileSize() - actualSizes[c]);
+			}
+			else if (actualSizes[c] > df.fileSize())
+			{
+				df.status() = DataFile::Corrupt;
+				df.statusString() = _T("File is large by ") + sizeString(actualSizes[c] - df.fileSize());
+			}
+			else if (dataDamage[columns[c]].size())
+			{
+				df.status() = DataFile::Corrupt;
+				df.statusString() = damageString(dataDamage[columns[c]]);
+			}
+			else if (!unlocated.size())
+			{
+				df.status() = DataFile::Valid;
+				df.statusString() = _T("Valid (syndrome check)");
+			}
 		}
 
-		// Error exit
+		for (unsigned int s = 0; s < syndromeCount; ++s)
+		{
+			ParityFile &	pf = parityVolumes[rows[s]];
+
+			if (parityDamage[rows[s]].size())
+			{
+				pf.status() = ParityFile::Corrupt;
+				pf.statusString() = damageString(parityDamage[rows[s]]);
+			}
+			else if (!unlocated.size())
+			{
+				pf.status() = ParityFile::Valid;
+				pf.statusString() = _T("Valid (syndrome check)");
+			}
+		}
+
+		for (unsigned int i = 0; i < syndromes.size(); ++i)
+		{
+			delete[] syndromes[i];
+		}
+		delete[] inputBuffer;
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the buffers
 
-		if (err && wcslen(err))
+		for (unsigned int i = 0; i < syndromes.size(); ++i)
 		{
-			fstl::wstring	msg = fstl::wstring(_T("Unable to restore data files: \n\n")) + err;
-			AfxMessageBox(msg.asArray());
+			delete[] syndromes[i];
 		}
+		delete[] inputBuffer;
+
+		// Not being able to verify this way isn't fatal, the caller can always fall back to checking each file
+
+		TRACE(_T("Syndrome verification skipped: %s\n"), err);
 		return false;
 	}
 
@@ -1140,6 +3479,18 @@ bool	ParityInfo::recoverFiles(ParityFileArray & inParityVolumes, DataFileArray &
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
+bool	ParityInfo::isFftCoded(const ParityFileArray & parityVolumes)
+{
+	for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+	{
+		if (parityVolumes[i].codec() == ParityFile::CodecFft) return true;
+	}
+
+	return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
 unsigned int	ParityInfo::gfADD(const unsigned int a, const unsigned int b) const
 {
 	return a ^ b;
@@ -1191,62 +3542,252 @@ unsigned int	ParityInfo::gfPOW(const unsigned int a, const unsigned int b) const
 
 bool	ParityInfo::genGaloisFieldTables()
 {
-	// Compute the Galois Fields log & inverse log tables
-
-	unsigned int	x_to_w = 1 << rsRaidBits();
-	unsigned int	wordLimit = x_to_w - 1;
-	unsigned int	q_x;
-	switch	(rsRaidBits())
-	{
-		case 4:
-			q_x = (1<< 4) + (2) + 1;
-			break;
-		case 8:
-			q_x = (1<< 8) + (1<<4) + (1<<3) + (1<<2) + 1;
-			break;
-		case 16:
-			q_x = (1<<16) + (1<<12) + (1<<3) + (2) + 1;
-			break;
-		case 32:
-			q_x = (1<<32) + (1<<22) + (1<<2) + (2) + 1;
-			break;
-		case 64:
-			q_x = (1<<64) + (1<<4) + (1<<3) + (2) + 1;
-			break;
-		default:
-			AfxMessageBox(_T("Invalid bit depth, must be 8, 16 or 32"));
-			return false;
-	}
-
-	// Allocate the tables
-
-	delete[] gflog();
-	gflog() = new unsigned int[x_to_w];
-	memset(gflog(), 0, x_to_w * sizeof(unsigned int));
-	if (!gflog()) return false;
-
-	delete[] gfexp();
-	gfexp() = new unsigned int[x_to_w*2];
-	memset(gfexp(), 0, x_to_w * sizeof(unsigned int));
-	if (!gfexp()) return false;
-
-	for (unsigned int log = 0, bin = 1; log < wordLimit; ++log)
-	{
-		gflog()[bin] = log;
-		gfexp()[log] = bin;
-		gfexp()[log+wordLimit] = bin;
-
-		bin <<= 1;
-		if (bin > wordLimit) bin ^= q_x;
-	}
-	gfexp()[wordLimit] = gfexp()[0];
+	// The tables are built once per process (per bit depth) and shared between every set
+
+	const GaloisField *	field = GaloisField::fieldFor(rsRaidBits());
+	if (!field)
+	{
+		lastError() = _T("Invalid bit depth, must be 4, 8 or 16");
+		return false;
+	}
+
+	gflog() = field->log();
+	gfexp() = field->exp();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Polynomials are stored lowest power first
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	ParityInfo::evalPolynomial(const unsigned int * poly, const unsigned int degree, const unsigned int x) const
+{
+	unsigned int	result = 0;
+	for (int i = static_cast<int>(degree); i >= 0; --i)
+	{
+		result = gfMUL(result, x) ^ poly[i];
+	}
+
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// When the only damage is in known columns (erasures), each erased byte is a fixed linear combination of the first few syndromes.
+// These come from the Forney algorithm (see decodeColumn) applied to a single syndrome at a time. 'multipliers' is a square
+// matrix, one row per erased column.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::genErasureMultipliers(const fstl::uintArray & erased, const unsigned int firstExponent, fstl::uintArray & multipliers) const
+{
+	unsigned int	rho = erased.size();
+	if (rho >= 0x100) return false;
+
+	// The erasure locator: gamma(z) = product of (1 + X z) for each erased column's locator X
+
+	unsigned int	gamma[0x100];
+	memset(gamma, 0, sizeof(gamma));
+	gamma[0] = 1;
+	for (unsigned int i = 0; i < rho; ++i)
+	{
+		for (unsigned int j = i + 1; j > 0; --j)
+		{
+			gamma[j] ^= gfMUL(gamma[j-1], erased[i] + 1);
+		}
+	}
+
+	multipliers.erase();
+	for (unsigned int j = 0; j < rho; ++j)
+	{
+		unsigned int	x = erased[j] + 1;
+		unsigned int	xInv = gfDIV(1, x);
+
+		// gamma'(1/X) -- in characteristic 2, only the odd terms of the derivative survive
+
+		unsigned int	derivative = 0;
+		for (unsigned int i = 1; i <= rho; i += 2)
+		{
+			derivative ^= gfMUL(gamma[i], gfPOW(xInv, i-1));
+		}
+		if (!derivative) return false;
+
+		unsigned int	scale = gfDIV(gfDIV(x, derivative), gfPOW(x, firstExponent));
+
+		// For a single syndrome at k, omega(z) is just gamma(z) shifted up by k (and truncated)
+
+		for (unsigned int k = 0; k < rho; ++k)
+		{
+			unsigned int	omega = 0;
+			for (unsigned int i = k; i < rho; ++i)
+			{
+				omega ^= gfMUL(gamma[i-k], gfPOW(xInv, i));
+			}
+
+			multipliers += gfMUL(scale, omega);
+		}
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Decodes a single byte column, given 'count' syndromes for consecutive powers starting at 'firstExponent' and a list of known
+// bad (erased) columns. This is the classic errors-and-erasures RS decoder: Berlekamp-Massey on the Forney syndromes to find the
+// error locator, a Chien search over the columns we have (column c has the locator c+1), and the Forney algorithm for the error
+// values. Returns false if the column has more damage than the syndromes can account for.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::decodeColumn(const unsigned int * syndromes, const unsigned int count, const unsigned int firstExponent, const unsigned int columnCount, const fstl::uintArray & erased, fstl::uintArray & errorColumns, fstl::uintArray & errorValues) const
+{
+	errorColumns.erase();
+	errorValues.erase();
+
+	unsigned int	rho = erased.size();
+	if (rho > count || count >= 0x100) return false;
+
+	// The erasure locator: gamma(z) = product of (1 + X z) for each erased column's locator X
+
+	unsigned int	gamma[0x100];
+	memset(gamma, 0, sizeof(gamma));
+	gamma[0] = 1;
+	for (unsigned int i = 0; i < rho; ++i)
+	{
+		for (unsigned int j = i + 1; j > 0; --j)
+		{
+			gamma[j] ^= gfMUL(gamma[j-1], erased[i] + 1);
+		}
+	}
+
+	// The Forney syndromes (the syndromes with the erasures taken out) are the terms of gamma(z) * S(z) from rho to count-1
+
+	unsigned int	forney[0x100];
+	unsigned int	forneyCount = count - rho;
+	for (unsigned int k = 0; k < forneyCount; ++k)
+	{
+		unsigned int	v = 0;
+		for (unsigned int i = 0; i <= rho; ++i)
+		{
+			v ^= gfMUL(gamma[i], syndromes[k+rho-i]);
+		}
+		forney[k] = v;
+	}
+
+	// Berlekamp-Massey, for the error locator sigma(z)
+
+	unsigned int	sigma[0x100];
+	unsigned int	prev[0x100];
+	unsigned int	temp[0x100];
+	memset(sigma, 0, sizeof(sigma));
+	memset(prev, 0, sizeof(prev));
+	sigma[0] = prev[0] = 1;
+
+	unsigned int	errorCount = 0;
+	unsigned int	shift = 1;
+	unsigned int	lastDiscrepancy = 1;
+	for (unsigned int k = 0; k < forneyCount; ++k)
+	{
+		unsigned int	discrepancy = forney[k];
+		for (unsigned int i = 1; i <= errorCount; ++i)
+		{
+			discrepancy ^= gfMUL(sigma[i], forney[k-i]);
+		}
+
+		if (!discrepancy)
+		{
+			++shift;
+			continue;
+		}
+
+		unsigned int	scale = gfDIV(discrepancy, lastDiscrepancy);
+		memcpy(temp, sigma, sizeof(temp));
+		for (unsigned int i = 0; i + shift <= forneyCount; ++i)
+		{
+			sigma[i+shift] ^= gfMUL(scale, prev[i]);
+		}
+
+		if (2 * errorCount <= k)
+		{
+			errorCount = k + 1 - errorCount;
+			memcpy(prev, temp, sizeof(prev));
+			lastDiscrepancy = discrepancy;
+			shift = 1;
+		}
+		else
+		{
+			++shift;
+		}
+	}
+
+	if (2 * errorCount + rho > count) return false;
+
+	// Chien search -- we only need to look at the columns that exist (and aren't already known to be bad)
+
+	for (unsigned int i = 0; i < rho; ++i)
+	{
+		errorColumns += erased[i];
+	}
+
+	for (unsigned int c = 0; c < columnCount && errorColumns.size() < rho + errorCount; ++c)
+	{
+		bool	isErased = false;
+		for (unsigned int i = 0; !isErased && i < rho; ++i)
+		{
+			isErased = erased[i] == c;
+		}
+
+		if (!isErased && !evalPolynomial(sigma, errorCount, gfDIV(1, c+1))) errorColumns += c;
+	}
+
+	if (errorColumns.size() != rho + errorCount) return false;
+
+	// lambda(z) = sigma(z) * gamma(z) locates everything, and omega(z) = S(z) * lambda(z) mod z^count
+
+	unsigned int	lambda[0x100];
+	unsigned int	omega[0x100];
+	unsigned int	lambdaDegree = errorCount + rho;
+	memset(lambda, 0, sizeof(lambda));
+	for (unsigned int i = 0; i <= errorCount; ++i)
+	{
+		for (unsigned int j = 0; j <= rho; ++j)
+		{
+			lambda[i+j] ^= gfMUL(sigma[i], gamma[j]);
+		}
+	}
+
+	for (unsigned int k = 0; k < count; ++k)
+	{
+		unsigned int	v = 0;
+		for (unsigned int i = 0; i <= k && i <= lambdaDegree; ++i)
+		{
+			v ^= gfMUL(lambda[i], syndromes[k-i]);
+		}
+		omega[k] = v;
+	}
+
+	// Forney: the value at locator X is X * omega(1/X) / lambda'(1/X), divided by X^firstExponent (our syndromes don't start
+	// at the zeroth power)
+
+	for (unsigned int l = 0; l < errorColumns.size(); ++l)
+	{
+		unsigned int	x = errorColumns[l] + 1;
+		unsigned int	xInv = gfDIV(1, x);
+
+		unsigned int	derivative = 0;
+		for (unsigned int i = 1; i <= lambdaDegree; i += 2)
+		{
+			derivative ^= gfMUL(lambda[i], gfPOW(xInv, i-1));
+		}
+		if (!derivative) return false;
+
+		unsigned int	value = gfMUL(x, gfDIV(evalPolynomial(omega, count-1, xInv), derivative));
+		errorValues += gfDIV(value, gfPOW(x, firstExponent));
+	}
 
 	return true;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	ParityInfo::genVandermondeMatrix(const unsigned int dataFileCount, const unsigned int parityFileCount)
+bool	ParityInfo::genVandermondeMatrix(const unsigned int dataFileCount, const unsigned int parityFileCount, fstl::uintArray & matrix) const
 {
 	// For convenience...
 
@@ -1255,14 +3796,14 @@ bool	ParityInfo::genVandermondeMatrix(const unsigned int dataFileCount, const un
 
 	// Allocate the matrix
 
-	delete[] vandMatrix();
-	vandMatrix() = new unsigned int[mParity * nData];
-	if (!vandMatrix()) return false;
+	matrix.erase();
+	matrix.populate(0, mParity * nData);
+	if (matrix.size() != mParity * nData) return false;
 
 	// Build the matrix (n across, m down)
 
 //	TRACE("Dump of Vandermonde matrix:\n");
-	unsigned int *	ptr = vandMatrix();
+	unsigned int *	ptr = &matrix[0];
 
 	for (unsigned int m = 0; m < mParity; ++m)
 	{
@@ -1283,7 +3824,7 @@ bool	ParityInfo::genVandermondeMatrix(const unsigned int dataFileCount, const un
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidityFlags, const fstl::intArray & parityIDs, bool & setUnrecoverable)
+bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidityFlags, const fstl::intArray & parityIDs, bool & setUnrecoverable, fstl::uintArray & multipliers)
 {
 	// Until we formally determine otherwise, this set is recoverable
 
@@ -1441,14 +3982,18 @@ bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidity
 
 	// Allocate our resulting array
 
-	delete[] recoveryArrays();
-	recoveryArrays() = new unsigned int[totalCount * corruptCount];
-	if (!recoveryArrays()) return false;
+	multipliers.erase();
+	multipliers.populate(0, totalCount * corruptCount);
+	if (multipliers.size() != totalCount * corruptCount)
+	{
+		delete[] workingArrays;
+		return false;
+	}
 
 	// Simplify the double-sized array into the result array
 	{
 		unsigned int *	src = workingArrays;
-		unsigned int *	dst = recoveryArrays();
+		unsigned int *	dst = &multipliers[0];
 		for (unsigned int y = 0; y < corruptCount; ++y, src += totalCount * 2)
 		{
 			// Copy this row to the multiplier array
@@ -1463,7 +4008,7 @@ bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidity
 		#if 0
 		{
 			TRACE("Dump of resulting multiplier arrays:\n");
-			unsigned int *	ptr = recoveryArrays();
+			const unsigned int *	ptr = &multipliers[0];
 			for (unsigned int y = 0; y < corruptCount; ++y)
 			{
 				TRACE("[ ");
@@ -1481,7 +4026,7 @@ bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidity
 		{
 			for (unsigned int y = 0; y < corruptCount; ++y)
 			{
-				unsigned int *	ptr = recoveryArrays() + y*totalCount;
+				const unsigned int *	ptr = &multipliers[y*totalCount];
 				bool		recoverable = false;
 				for (unsigned int x = 0; x < totalCount && !recoverable; ++x, ptr++)
 				{
@@ -1510,10 +4055,11 @@ bool	ParityInfo::genRecoveryMultipliers(const fstl::boolArray & dataFileValidity
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlags, fstl::intArray & parityIDs, ParityFileArray & parityVolumes, const unsigned int corruptCount, bool & setUnrecoverable)
+bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlags, fstl::intArray & parityIDs, const ParityFileArray & available, ParityFileArray & parityVolumes, const unsigned int corruptCount, bool & setUnrecoverable, fstl::uintArray & multipliers)
 {
 	// There are some [rare] situations where data recovery is not possible. However, if there are extra PARs available, we can
-	// determine a different combination of PARs that might yield a recoverable situation.
+	// determine a different combination of PARs that might yield a recoverable situation. The volumes that get used (out of
+	// 'available') are returned in 'parityVolumes'.
 
 	// We use an exhaustive search of par-file combinations. We do this by defining a pattern and manipulating it...
 
@@ -1555,20 +4101,20 @@ bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlag
 			newParityIDs += parityIDs[pattern[i]];
 		}
 
-		// Build a new list of parity volumes
+		// Find the parity volumes (just where they are; they're only copied out once we know which ones we're using)
 
-		ParityFileArray	newParityVolumes;
-		newParityVolumes.reserve(corruptCount);
+		fstl::uintArray	volumeIndices;
+		volumeIndices.reserve(corruptCount);
 		for (unsigned int i = 0; i < corruptCount; ++i)
 		{
 			// Find the matching parity volume
 
 			bool	found = false;
-			for (unsigned int j = 0; j < parityVolumes.size(); ++j)
+			for (unsigned int j = 0; j < available.size(); ++j)
 			{
-				if (parityVolumes[j].volumeNumber() == newParityIDs[i])
+				if (available[j].volumeNumber() == newParityIDs[i])
 				{
-					newParityVolumes += parityVolumes[j];
+					volumeIndices += j;
 					found = true;
 					break;
 				}
@@ -1579,9 +4125,9 @@ bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlag
 
 		// Make sure we found all the volumes we needed
 
-		if (newParityVolumes.size() == corruptCount)
+		if (volumeIndices.size() == corruptCount)
 		{
-			bool	rc = genRecoveryMultipliers(dataFileValidityFlags, newParityIDs, setUnrecoverable);
+			bool	rc = genRecoveryMultipliers(dataFileValidityFlags, newParityIDs, setUnrecoverable, multipliers);
 
 			// If we have an error other than an unrecoverable scenario, bail
 
@@ -1591,8 +4137,14 @@ bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlag
 
 			if (rc == true)
 			{
-				parityIDs = newParityIDs;
-				parityVolumes = newParityVolumes;
+				parityIDs = fstl::move(newParityIDs);
+
+				parityVolumes.erase();
+				parityVolumes.reserve(corruptCount);
+				for (unsigned int i = 0; i < corruptCount; ++i)
+				{
+					parityVolumes += available[volumeIndices[i]];
+				}
 				return true;
 			}
 		}
@@ -1641,7 +4193,7 @@ bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlag
 
 	if (setUnrecoverable)
 	{
-		AfxMessageBox(	_T("You need at least one more PAR file or data file to recover this set. Please\n")
+		lastError() =	_T("You need at least one more PAR file or data file to recover this set. Please\n")
 				_T("continue reading, for instructions on how you might still be able to recover\n")
 				_T("your data files...\n")
 				_T("\n")
@@ -1667,13 +4219,249 @@ bool	ParityInfo::analyzeRecoverable(const fstl::boolArray & dataFileValidityFlag
 				_T("\n")
 				_T("If you are using datafiles with error correction in them (for example, RAR\n")
 				_T("files which include recovery records), try recovering as many of the data\n")
-				_T("files as you can, and then try to use the PAR files to recover the rest.\n"));
+				_T("files as you can, and then try to use the PAR files to recover the rest.\n");
 		return false;
 	}
 
 	return false;
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Recovery for FFT-coded sets. The codec needs a piece of every file we have at once (rather than folding them in one file at a
+// time, like the Vandermonde path does), so we work through the set a piece at a time.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityInfo::recoverFilesFft(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex)
+{
+	FftCodec			codec;
+	fstl::array<unsigned char *>	dataBuffers;
+	fstl::array<unsigned char *>	parityBuffers;
+
+	try
+	{
+		// Gather the recoverable files
+
+		fstl::uintArray	columns;
+		fstl::boolArray	dataPresent;
+		unsigned int	largestInputFile = 0;
+		unsigned int	corruptCount = 0;
+		for (unsigned int i = 0; i < dataVolumes.size(); ++i)
+		{
+			DataFile &	df = dataVolumes[i];
+			if (!df.recoverable()) continue;
+
+			if (df.status() == DataFile::Unknown) throw _T("All files need to be checked before recovery");
+
+			columns += i;
+			dataPresent += df.status() == DataFile::Valid;
+			if (df.status() != DataFile::Valid) ++corruptCount;
+			largestInputFile = fstl::max(largestInputFile, df.fileSize());
+		}
+
+		// Volume N holds the codeword position just past the data for N-1, so we only need to reach as far as the highest
+		// volume we have
+
+		unsigned int	parityDataSize = (largestInputFile + 1) & ~1;
+		unsigned int	parityCount = 0;
+		unsigned int	validParityCount = 0;
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			ParityFile &	pf = parityVolumes[i];
+			if (!pf.volumeNumber() || pf.status() != ParityFile::Valid) continue;
+			if (pf.codec() != ParityFile::CodecFft || pf.dataSize() != parityDataSize) continue;
+
+			parityCount = fstl::max(parityCount, static_cast<unsigned int>(pf.volumeNumber()));
+			++validParityCount;
+		}
+
+		fstl::intArray	parityIndices;
+		fstl::boolArray	parityPresent;
+		parityIndices.populate(-1, parityCount);
+		parityPresent.populate(false, parityCount);
+		for (unsigned int i = 0; i < parityVolumes.size(); ++i)
+		{
+			ParityFile &	pf = parityVolumes[i];
+			if (!pf.volumeNumber() || pf.status() != ParityFile::Valid) continue;
+			if (pf.codec() != ParityFile::CodecFft || pf.dataSize() != parityDataSize) continue;
+
+			parityIndices[pf.volumeNumber() - 1] = i;
+			parityPresent[pf.volumeNumber() - 1] = true;
+		}
+
+		// Make sure we have a valid operation
+
+		if (!corruptCount) throw _T("There are no files to recover");
+		if (validParityCount < corruptCount) throw _T("You do not have enough parity files to recover the set");
+		if (!FftCodec::supports(columns.size(), parityCount)) throw _T("Too many files for the FFT codec");
+		if (!codec.init()) throw _T("unable to generate FFT codec tables");
+
+		// Determine how much memory to use for each piece (we need one for every file we have, plus the codec's working set)
+
+		double	memToUse = BufferPlan::memoryBudget(options());
+
+		unsigned int	bufferCount = columns.size() + validParityCount + FftCodec::codewordSpan(columns.size(), parityCount);
+		unsigned int	pieceSize = static_cast<unsigned int>(memToUse / bufferCount);
+		if (pieceSize > parityDataSize) pieceSize = parityDataSize;
+
+		if (pieceSize % OverlappedRead::BUFFER_SIZE)
+		{
+			pieceSize /= OverlappedRead::BUFFER_SIZE;
+			pieceSize += 1;
+			pieceSize *= OverlappedRead::BUFFER_SIZE;
+		}
+
+		for (unsigned int c = 0; c < columns.size(); ++c)
+		{
+			unsigned char *	ptr = new unsigned char[pieceSize];
+			if (!ptr) throw _T("Cannot allocate data buffer");
+			dataBuffers += ptr;
+		}
+
+		for (unsigned int p = 0; p < parityCount; ++p)
+		{
+			unsigned char *	ptr = NULL;
+			if (parityPresent[p])
+			{
+				ptr = new unsigned char[pieceSize];
+				if (!ptr) throw _T("Cannot allocate parity buffer");
+			}
+			parityBuffers += ptr;
+		}
+
+		fstl::wstring	filespec;
+
+		// Work through the set a piece at a time
+
+		for (unsigned int offset = 0; offset < parityDataSize; offset += pieceSize)
+		{
+			if (!report(callback, callbackData, Progress::StageRecovering, _T("Recovering data files..."), static_cast<double>(offset), static_cast<double>(parityDataSize))) throw _T("Operation cancelled");
+
+			unsigned int	length = fstl::min(pieceSize, parityDataSize - offset);
+
+			// The files we have (padded with zeros)
+
+			for (unsigned int c = 0; c < columns.size(); ++c)
+			{
+				if (!dataPresent[c]) continue;
+
+				DataFile &	df = dataVolumes[columns[c]];
+				unsigned int	readCount = offset >= df.fileSize() ? 0 : fstl::min(length, df.fileSize() - offset);
+				if (readCount && !readFileRange(df.filespec(filespec), offset, dataBuffers[c], readCount)) throw _T("Unable to read a data file");
+				memset(dataBuffers[c] + readCount, 0, length - readCount);
+			}
+
+			for (unsigned int p = 0; p < parityCount; ++p)
+			{
+				if (!parityPresent[p]) continue;
+
+				ParityFile &	pf = parityVolumes[parityIndices[p]];
+				if (!readFileRange(pf.filespec(filespec), pf.dataOffset() + offset, parityBuffers[p], length)) throw _T("Unable to read a parity volume");
+			}
+
+			// Rebuild the rest
+
+			if (!codec.decode(dataBuffers, dataPresent, parityBuffers, parityPresent, length)) throw _T("Unable to decode the FFT parity data");
+
+			for (unsigned int c = 0; c < columns.size(); ++c)
+			{
+				if (dataPresent[c]) continue;
+				if (repairSingleIndex != -1 && repairSingleIndex != static_cast<int>(columns[c])) continue;
+
+				DataFile &	df = dataVolumes[columns[c]];
+				if (offset >= df.fileSize()) continue;
+
+				if (!writeFileRange(df.filespec(filespec), offset, dataBuffers[c], fstl::min(length, df.fileSize() - offset))) throw _T("Unable to write recovered data");
+			}
+		}
+
+		// Anything that was too long gets cut back down to size, and everything we rebuilt will need checking again
+
+		for (unsigned int c = 0; c < columns.size(); ++c)
+		{
+			if (dataPresent[c]) continue;
+			if (repairSingleIndex != -1 && repairSingleIndex != static_cast<int>(columns[c])) continue;
+
+			DataFile &	df = dataVolumes[columns[c]];
+			if (getFileLength(df.filespec()) > df.fileSize())
+			{
+				if (!truncateFile(df.filespec(), df.fileSize())) throw _T("Unable to truncate recovered data file");
+			}
+
+			df.status() = DataFile::Unknown;
+		}
+
+		for (unsigned int i = 0; i < dataBuffers.size(); ++i)
+		{
+			delete[] dataBuffers[i];
+		}
+		for (unsigned int i = 0; i < parityBuffers.size(); ++i)
+		{
+			delete[] parityBuffers[i];
+		}
+	}
+	catch (const TCHAR * err)
+	{
+		// Cleanup the buffers
+
+		for (unsigned int i = 0; i < dataBuffers.size(); ++i)
+		{
+			delete[] dataBuffers[i];
+		}
+		for (unsigned int i = 0; i < parityBuffers.size(); ++i)
+		{
+			delete[] parityBuffers[i];
+		}
+
+		// Error exit
+
+		if (err && wcslen(err))
+		{
+			fstl::wstring	msg = fstl::wstring(_T("Unable to restore data files: \n\n")) + err;
+			lastError() = msg;
+		}
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityInfo::addDamage(DamageRangeArray & ranges, const unsigned int offset)
+{
+	// Random garbage will have the occasional byte that happens to be right, so we don't split ranges over small gaps (otherwise
+	// a badly damaged file would need millions of them)
+
+	const	unsigned int	mergeGap = 64;
+
+	if (ranges.size() && offset <= ranges[ranges.size()-1].end() + mergeGap)
+	{
+		DamageRange &	last = ranges[ranges.size()-1];
+		last.length() = offset + 1 - last.start();
+		return;
+	}
+
+	ranges += DamageRange(offset, 1);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::wstring	ParityInfo::damageString(const DamageRangeArray & ranges)
+{
+	unsigned int	total = 0;
+	for (unsigned int i = 0; i < ranges.size(); ++i)
+	{
+		total += ranges[i].length();
+	}
+
+	TCHAR	dsp[256];
+	swprintf(dsp, _T("Corrupt - %d damaged range(s) totalling "), ranges.size());
+	fstl::wstring	result = fstl::wstring(dsp) + sizeString(total);
+
+	swprintf(dsp, _T(", first at offset %u"), ranges.size() ? ranges[0].start() : 0);
+	return result + dsp;
+}
+
 // ---------------------------------------------------------------------------------------------------------------------------------
 // ParityInfo.cpp - End of file
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -39,6 +39,45 @@
 
 #include "DataFile.h"
 #include "ParityFile.h"
+#include "RecoveryAccumulator.h"
+#include "BlockMap.h"
+#include "LocalParity.h"
+#include "ParityOptions.h"
+#include "BufferPlan.h"
+#include "EmDeeFive.h"
+#include "FastWrite.h"
+#include "Progress.h"
+#include "EngineStats.h"
+
+class	FftCodec;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	DamageRange
+{
+public:
+	// Construction/Destruction
+
+					DamageRange() : _start(0), _length(0) {}
+					DamageRange(const unsigned int s, const unsigned int l) : _start(s), _length(l) {}
+
+	// Accessors
+
+inline		unsigned int &		start()			{return _start;}
+inline	const	unsigned int		start() const		{return _start;}
+inline		unsigned int &		length()		{return _length;}
+inline	const	unsigned int		length() const		{return _length;}
+
+inline	const	unsigned int		end() const		{return start() + length();}
+
+private:
+	// Data members
+
+		unsigned int		_start;
+		unsigned int		_length;
+};
+
+typedef	fstl::array<DamageRange>		DamageRangeArray;
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -55,6 +94,7 @@ virtual					~ParityInfo();
 	// Implementation
 
 virtual		void			reset();
+virtual		void			indexHashes();
 virtual		bool			validateDataFile(const unsigned int index, const unsigned int totalFiles, const unsigned int curIndex, progressCallback callback = NULL, void * callbackData = NULL);
 virtual		bool			validateDataFile(DataFile & df, const unsigned int totalFiles, const unsigned int curIndex, progressCallback callback = NULL, void * callbackData = NULL) const;
 virtual		bool			loadParFile(fstl::wstring & filename);
@@ -62,8 +102,19 @@ virtual		bool			validateParFile(const unsigned int index, const unsigned int tot
 virtual		bool			validateParFile(ParityFile & pf, const unsigned int totalFiles, const unsigned int curIndex, progressCallback callback = NULL, void * callbackData = NULL) const;
 virtual		bool			findParFiles(ParityFileArray & pfa) const;
 virtual		bool			genParFiles(unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BYTES], ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback = NULL, void * callbackData = NULL);
+virtual		bool			extendParFiles(ParityFileArray & newVolumes, DataFileArray & dataVolumes, progressCallback callback = NULL, void * callbackData = NULL);
+virtual		bool			updateParFiles(const unsigned int index, const fstl::wstring & oldFilespec, progressCallback callback = NULL, void * callbackData = NULL);
 virtual		void			make_lut(unsigned char lut[0x100], const int m) const;
-virtual		bool			recoverFiles(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex = -1);
+static		void			mulContribute(unsigned char * buffer, const unsigned char * src, const unsigned int offset, const unsigned int count, const unsigned char * lut, unsigned int & covered);
+static		void			clearUncovered(unsigned char * buffer, unsigned int & covered, const unsigned int bytes);
+virtual		bool			repairSet(progressCallback callback, void * callbackData, RecoveryAccumulator * accumulator = NULL);
+virtual		bool			accumulateDataFile(RecoveryAccumulator & accumulator, const unsigned int index, progressCallback callback = NULL, void * callbackData = NULL);
+virtual		bool			recoverFiles(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex = -1, RecoveryAccumulator * accumulator = NULL);
+virtual		bool			recoverLocal(DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex = -1);
+virtual		bool			recoverBlocks(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData);
+virtual		bool			correctErrors(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData);
+virtual		bool			verifySyndromes(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, fstl::array<DamageRangeArray> & dataDamage, fstl::array<DamageRangeArray> & parityDamage, DamageRangeArray & unlocated, progressCallback callback = NULL, void * callbackData = NULL);
+static		bool			isFftCoded(const ParityFileArray & parityVolumes);
 
 	// Accessors
 
@@ -75,20 +126,42 @@ inline		fstl::wstring &		createdByString()	{return _createdByString;}
 inline	const	fstl::wstring &		createdByString() const	{return _createdByString;}
 inline		DataFileArray &		dataFiles()		{return _dataFiles;}
 inline	const	DataFileArray &		dataFiles() const	{return _dataFiles;}
+inline		fstl::flathash<unsigned int> & hashIndex()	{return _hashIndex;}
+inline	const	fstl::flathash<unsigned int> & hashIndex() const {return _hashIndex;}
+inline		fstl::uintArray &	hashChain()		{return _hashChain;}
+inline	const	fstl::uintArray &	hashChain() const	{return _hashChain;}
 inline		ParityFileArray &	parityFiles()		{return _parityFiles;}
 inline	const	ParityFileArray &	parityFiles() const	{return _parityFiles;}
 inline		unsigned int &		rsRaidBits()		{return _rsRaidBits;}
 inline	const	unsigned int		rsRaidBits() const	{return _rsRaidBits;}
-inline		unsigned int *&		gflog()			{return _gflog;}
+inline	const	unsigned int *&		gflog()			{return _gflog;}
 inline	const	unsigned int *		gflog() const		{return _gflog;}
-inline		unsigned int *&		gfexp()			{return _gfexp;}
+inline	const	unsigned int *&		gfexp()			{return _gfexp;}
 inline	const	unsigned int *		gfexp() const		{return _gfexp;}
-inline		unsigned int *&		vandMatrix()		{return _vandMatrix;}
-inline	const	unsigned int *		vandMatrix() const	{return _vandMatrix;}
-inline		unsigned int *&		recoveryArrays()	{return _recoveryArrays;}
-inline	const	unsigned int *		recoveryArrays() const	{return _recoveryArrays;}
 inline		unsigned char *		setHash()		{return _setHash;}
 inline	const	unsigned char *		setHash() const		{return _setHash;}
+inline		BlockMap &		blockMap()		{return _blockMap;}
+inline	const	BlockMap &		blockMap() const	{return _blockMap;}
+inline		LocalParity &		localParity()		{return _localParity;}
+inline	const	LocalParity &		localParity() const	{return _localParity;}
+inline		ParityOptions &		options()		{return _options;}
+inline	const	ParityOptions &		options() const		{return _options;}
+inline		BufferPlan &		plan()			{return _plan;}
+inline	const	BufferPlan &		plan() const		{return _plan;}
+inline		BufferPlacement &	placement()		{return _placement;}
+inline	const	BufferPlacement &	placement() const	{return _placement;}
+inline		fstl::wstring &		lastError()		{return _lastError;}
+inline	const	fstl::wstring &		lastError() const	{return _lastError;}
+
+	// If a progress object is attached, the engine keeps it up to date (and checks it for a cancel) instead of calling back
+
+inline		Progress *&		progress()		{return _progress;}
+inline	const	Progress *		progress() const	{return _progress;}
+
+	// Where the engine's time went (and how much it read), accumulated over everything this object has done
+
+inline		EngineStats &		stats()			{return _stats;}
+inline	const	EngineStats &		stats() const		{return _stats;}
 
 private:
 	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
@@ -104,9 +177,30 @@ virtual		unsigned int		gfMUL(const unsigned int a, const unsigned int b) const;
 virtual		unsigned int		gfDIV(const unsigned int a, const unsigned int b) const;
 virtual		unsigned int		gfPOW(const unsigned int a, const unsigned int b) const;
 virtual		bool			genGaloisFieldTables();
-virtual		bool			genVandermondeMatrix(const unsigned int dataFileCount, const unsigned int parityFileCount);
-virtual		bool			genRecoveryMultipliers(const fstl::boolArray & dataFileValidityFlags, const fstl::intArray & parityIDs, bool & setUnrecoverable);
-virtual		bool			analyzeRecoverable(const fstl::boolArray & dataFileValidityFlags, fstl::intArray & parityIDs, ParityFileArray & parityVolumes, const unsigned int corruptCount, bool & setUnrecoverable);
+virtual		unsigned int		evalPolynomial(const unsigned int * poly, const unsigned int degree, const unsigned int x) const;
+virtual		bool			genErasureMultipliers(const fstl::uintArray & erased, const unsigned int firstExponent, fstl::uintArray & multipliers) const;
+virtual		bool			decodeColumn(const unsigned int * syndromes, const unsigned int count, const unsigned int firstExponent, const unsigned int columnCount, const fstl::uintArray & erased, fstl::uintArray & errorColumns, fstl::uintArray & errorValues) const;
+virtual		bool			genVandermondeMatrix(const unsigned int dataFileCount, const unsigned int parityFileCount, fstl::uintArray & matrix) const;
+virtual		bool			genRecoveryMultipliers(const fstl::boolArray & dataFileValidityFlags, const fstl::intArray & parityIDs, bool & setUnrecoverable, fstl::uintArray & multipliers);
+virtual		bool			analyzeRecoverable(const fstl::boolArray & dataFileValidityFlags, fstl::intArray & parityIDs, const ParityFileArray & available, ParityFileArray & parityVolumes, const unsigned int corruptCount, bool & setUnrecoverable, fstl::uintArray & multipliers);
+virtual		unsigned char *		allocBuffer(const unsigned int bytes);
+virtual		bool			planBuffers(const DataFileArray & dataVolumes, const ParityFileArray & volumes, const unsigned int bufferCount, const unsigned int outputBytes, const bool allowFileMajor, const bool readAll, progressCallback callback, void * callbackData);
+virtual		bool			genParDataFileMajor(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, FastWriteArray & outputFiles, const fstl::uintArray & vandMatrix, EmDeeFiveArray & inputHashes, EmDeeFiveArray & inputHashes16k, BlockMap * inputBlocks, const unsigned int parityDataSize, progressCallback callback, void * callbackData);
+virtual		bool			genParDataGroupMajor(const fstl::intArray & volumeRows, DataFileArray & dataVolumes, FastWriteArray & outputFiles, fstl::array<unsigned char *> & outputBuffers, EmDeeFiveArray * inputHashes, EmDeeFiveArray * inputHashes16k, BlockMap * inputBlocks, LocalParity * localGroups, FftCodec * codec, const unsigned int parityDataSize, progressCallback callback, void * callbackData);
+virtual		bool			finishParFiles(ParityFileArray & volumes, DataFileArray & dataVolumes, FastWriteArray & outputFiles, fstl::array<unsigned char *> & outputBuffers, const unsigned char parSetHash[EmDeeFive::HASH_SIZE_IN_BYTES], progressCallback callback, void * callbackData);
+virtual		bool			recoverFilesFft(ParityFileArray & parityVolumes, DataFileArray & dataVolumes, progressCallback callback, void * callbackData, const int repairSingleIndex);
+static		void			addDamage(DamageRangeArray & ranges, const unsigned int offset);
+static		fstl::wstring		damageString(const DamageRangeArray & ranges);
+
+				// Every block's progress goes through here: a couple of stores when a progress object is attached,
+				// otherwise a percentage for the callback. Returns false if we've been cancelled.
+
+inline		bool			report(progressCallback callback, void * callbackData, const Progress::Stage stage, const TCHAR * text, const double done, const double total)
+					{
+						if (_progress) return _progress->update(stage, done, total);
+						if (!callback) return true;
+						return callback(callbackData, text, static_cast<float>(done / fstl::max(total, 1.0) * 100.0));
+					}
 
 	// Data members
 
@@ -115,13 +209,21 @@ virtual		bool			analyzeRecoverable(const fstl::boolArray & dataFileValidityFlags
 		fstl::wstring		_createdByString;
 		unsigned int		_version;
 		DataFileArray		_dataFiles;
+		fstl::flathash<unsigned int> _hashIndex;
+		fstl::uintArray		_hashChain;
 		ParityFileArray		_parityFiles;
 		unsigned int		_rsRaidBits;
-		unsigned int *		_gflog;
-		unsigned int *		_gfexp;
-		unsigned int *		_vandMatrix;
-		unsigned int *		_recoveryArrays;
+	const	unsigned int *		_gflog;
+	const	unsigned int *		_gfexp;
 		unsigned char		_setHash[16];
+		BlockMap		_blockMap;
+		LocalParity		_localParity;
+		ParityOptions		_options;
+		BufferPlan		_plan;
+		BufferPlacement		_placement;
+		fstl::wstring		_lastError;
+		Progress *		_progress;
+		EngineStats		_stats;
 };
 
 typedef	fstl::array<ParityInfo *>	ParityInfoPointerArray;
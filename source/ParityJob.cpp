@@ -0,0 +1,759 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _              _       _                        
+// |  __ \         (_) |            | |     | |                       
+// | |__) |_ _ _ __ _| |_ _   _     | | ___ | |__     ___ _ __  _ __  
+// |  ___/ _` | '__| | __| | | |_   | |/ _ \| '_ \   / __| '_ \| '_ \ 
+// | |  | (_| | |  | | |_| |_| | |__| | (_) | |_) |_| (__| |_) | |_) |
+// |_|   \__,_|_|  |_|\__|\__, |\____/ \___/|_.__/(_)\___| .__/| .__/ 
+//                         __/ |                         | |   | |    
+//                        |___/                          |_|   |_|    
+//
+// Description:
+//
+//   A single create/verify/repair/scrub operation on a PAR set, as run by the command-line tool and the
+//   job daemon
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "ParityInfo.h"
+#include "ParityJob.h"
+#include "WorkPool.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Sits between the engine and the caller's callback, so that we know when the caller cancelled (as opposed to the engine failing)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	bool	jobCallback(void * userData, const fstl::wstring & displayText, const float percent)
+{
+	ParityJob &	job = *reinterpret_cast<ParityJob *>(userData);
+
+	// Without a callback, this is only reached from the hashing (everything else goes straight to the progress object), and
+	// all we're given is a percentage -- so that's what we count, in hundredths
+
+	if (!job.callback()) return job.progress().update(Progress::StageHashing, percent * 100.0f, 10000);
+
+	if (!job.progress().proceed()) return false;
+	if (!job.callback()(job.callbackData(), displayText, percent)) job.progress().cancel();
+	return job.progress().proceed();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// With a pool, each file is checked as its own task. Files finish in any order, so progress is counted per file (not per block),
+// and the engine is only given a callback that notices a cancel.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	struct
+{
+	ParityJob *		job;
+	ParityInfo *		pi;
+	DataFile *		dataFile;
+	ParityFile *		parityFile;
+	unsigned int		bytes;
+	Trace *			trace;
+} FileCheck;
+
+typedef	fstl::array<FileCheck>	FileCheckArray;
+
+static	bool	cancelCallback(void * userData, const fstl::wstring &, const float)
+{
+	return reinterpret_cast<ParityJob *>(userData)->progress().proceed();
+}
+
+static	void	checkFileTask(void * userData)
+{
+	FileCheck &	check = *reinterpret_cast<FileCheck *>(userData);
+	if (check.job->cancelled()) return;
+
+	EngineStatsScope	statsScope(&check.pi->stats());
+	TraceScope		traceScope(check.trace);
+
+	if (check.dataFile)	check.pi->validateDataFile(*check.dataFile, 1, 0, cancelCallback, check.job);
+	else			check.pi->validateParFile(*check.parityFile, 1, 0, cancelCallback, check.job);
+
+	Progress &	progress = check.job->progress();
+	progress.add(Progress::StageVerifying, check.bytes);
+	if (check.job->callback()) jobCallback(check.job, _T("Verifying files..."), progress.percent());
+}
+
+static	void	runChecks(WorkPool & pool, FileCheckArray & checks)
+{
+	double	total = 0;
+	for (unsigned int i = 0; i < checks.size(); ++i) total += checks[i].bytes;
+	checks[0].job->progress().update(Progress::StageVerifying, 0, total);
+
+	WorkGroup	group;
+	for (unsigned int i = 0; i < checks.size(); ++i)
+	{
+		pool.submit(checkFileTask, &checks[i], group);
+	}
+
+	pool.wait(group);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	splitFilespec(const fstl::wstring & filespec, fstl::wstring & path, fstl::wstring & name)
+{
+	int	idx = filespec.rfind(PATH_SEPARATOR);
+	if (idx >= 0)
+	{
+		path = filespec.substring(0, idx);
+		name = filespec.substring(idx+1);
+	}
+	else
+	{
+		path = _T(".");
+		name = filespec;
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityJob::ParityJob()
+	: _type(Verify), _volumeCount(1), _status(Ok), _fileCount(0), _bytes(0), _seconds(0), _damaged(0), _callback(NULL),
+	  _callbackData(NULL), _pool(NULL)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityJob::~ParityJob()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::parseCommand(const fstl::wstring & command)
+{
+	if	(command == _T("create"))	type() = Create;
+	else if (command == _T("verify"))	type() = Verify;
+	else if (command == _T("repair"))	type() = Repair;
+	else if (command == _T("scrub"))	type() = Scrub;
+	else					return false;
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Parses the option at args[index]. Returns the number of arguments used, 0 if it isn't one of ours, or -1 if its value is missing
+// (or isn't valid.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	ParityJob::parseOption(const fstl::WStringArray & args, const unsigned int index)
+{
+	const fstl::wstring &	arg = args[index];
+	bool			hasValue = index + 1 < args.size();
+
+	// Options with a value
+
+	if (arg == _T("-r") || arg == _T("-u") || arg == _T("-m") || arg == _T("--threads") || arg == _T("--huge-pages") ||
+	    arg == _T("--trace"))
+	{
+		if (!hasValue) return -1;
+
+		const fstl::wstring &	value = args[index+1];
+		if	(arg == _T("-r"))	volumeCount() = value.asUInt();
+		else if (arg == _T("-u"))	unprotectedFilespecs() += value;
+		else if (arg == _T("-m"))	options().memoryPercent() = value.asUInt();
+		else if (arg == _T("--threads"))	options().threadLimit() = value.asUInt();
+		else if (arg == _T("--trace"))	traceFilespec() = value;
+		else if (!LargeBuffer::parseHugePages(value, options().hugePages())) return -1;
+		return 2;
+	}
+
+	// Switches
+
+	if	(arg == _T("--fft"))			options().fftCodec() = true;
+	else if (arg == _T("--local"))			options().localParity() = true;
+	else if (arg.substring(0, 8) == _T("--local="))	{options().localParity() = true; options().localGroupSize() = arg.substring(8).asUInt();}
+	else if (arg == _T("--no-blockmap"))		options().writeBlockMap() = false;
+	else if (arg == _T("--quick"))			options().quickCheck() = true;
+	else if (arg == _T("--syndrome"))		options().syndromeCheck() = true;
+	else if (arg == _T("--no-local-repair"))	options().localRepair() = false;
+	else if (arg == _T("--no-error-correction"))	options().errorCorrection() = false;
+	else if (arg == _T("--pin-threads"))		options().pinThreads() = true;
+	else						return 0;
+
+	return 1;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The first argument is the PAR file, anything after that is a data file (only 'create' takes data files)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::addArgument(const fstl::wstring & arg)
+{
+	if (!parFilespec().length())
+	{
+		parFilespec() = arg;
+		return true;
+	}
+
+	if (type() != Create) return false;
+
+	dataFilespecs() += arg;
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::isComplete() const
+{
+	if (!parFilespec().length()) return false;
+	if (type() == Create && (!dataFilespecs().size() || !volumeCount())) return false;
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::run(progressCallback callback, void * callbackData)
+{
+	status() = Ok;
+	fileCount() = 0;
+	bytes() = 0;
+	seconds() = 0;
+	damaged() = 0;
+	message().erase();
+	problemNames().erase();
+	problemStatuses().erase();
+	plan().reset();
+	placement().reset();
+
+	this->callback() = callback;
+	this->callbackData() = callbackData;
+	progress().restart();
+	stats().reset();
+
+	// A pool pins its own workers; otherwise, keep this thread where it is, so the buffers it touches stay on its node
+
+	if (options().pinThreads() && !pool()) LargeBuffer::pinThread();
+
+	// With a trace file, the engine's work is recorded (on every thread that does some of it) and written out at the end
+
+	Trace		trace;
+	TraceScope	traceScope(traceFilespec().length() ? &trace : NULL);
+
+	double	start = getSeconds();
+
+	switch(type())
+	{
+		case Create:	createSet(); break;
+		case Verify:	verifySet(); break;
+		default:	repairSet(); break;
+	}
+
+	seconds() = getSeconds() - start;
+	progress().finish();
+
+	if (traceFilespec().length() && !trace.write(traceFilespec()) && status() != Error)
+	{
+		fail(_T("Unable to write the trace to ") + traceFilespec());
+	}
+
+	if (cancelled())
+	{
+		status() = Cancelled;
+		message() = _T("Cancelled");
+	}
+
+	return status() != Error && status() != Cancelled;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	ParityJob::typeName() const
+{
+	switch(type())
+	{
+		case Create:	return "create";
+		case Verify:	return "verify";
+		case Repair:	return "repair";
+		default:	return "scrub";
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	ParityJob::statusName() const
+{
+	switch(status())
+	{
+		case Ok:	return "ok";
+		case Repaired:	return "repaired";
+		case Damaged:	return "damaged";
+		case Error:	return "error";
+		default:	return "cancelled";
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The results, as key=value pairs (or JSON members, without the braces, so the caller can add its own fields)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	ParityJob::fields(const bool json) const
+{
+	double	mbps = seconds() > 0 ? bytes() / (1024.0 * 1024.0) / seconds() : 0;
+
+	char	buf[512];
+	if (json)	sprintf(buf, "\"op\":\"%s\",\"status\":\"%s\",\"files\":%u,\"bytes\":%.0f,\"seconds\":%.3f,\"mbps\":%.1f", typeName(), statusName(), fileCount(), bytes(), seconds(), mbps);
+	else		sprintf(buf, "op=%s status=%s files=%u bytes=%.0f seconds=%.3f mbps=%.1f", typeName(), statusName(), fileCount(), bytes(), seconds(), mbps);
+
+	fstl::string	result = buf;
+
+	if (type() != Create)
+	{
+		sprintf(buf, json ? ",\"damaged\":%u" : " damaged=%u", damaged());
+		result += buf;
+	}
+
+	if (message().length())
+	{
+		result += json ? ",\"message\":" : " message=";
+		result += quoted(message());
+	}
+
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	ParityJob::problemFields(const unsigned int index, const bool json) const
+{
+	if (json) return fstl::string("\"name\":") + quoted(problemNames()[index]) + ",\"status\":" + quoted(problemStatuses()[index]);
+	return fstl::string("name=") + quoted(problemNames()[index]) + " status=" + quoted(problemStatuses()[index]);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Quotes (and escapes) a string for the output, which is the same for both formats
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+fstl::string	ParityJob::quoted(const fstl::wstring & str)
+{
+	fstl::string	mb(str.asArray());
+	fstl::string	result = "\"";
+
+	for (unsigned int i = 0; i < mb.length(); ++i)
+	{
+		char	c = mb[i];
+		if (c == '"' || c == '\\')	{char esc[3] = {'\\', c, 0}; result += esc;}
+		else if (c == '\n')		result += "\\n";
+		else if (c == '\r' || c == '\t')result += " ";
+		else				{char ch[2] = {c, 0}; result += ch;}
+	}
+
+	result += "\"";
+	return result;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityJob::fail(const fstl::wstring & msg)
+{
+	status() = Error;
+	message() = msg;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::createSet()
+{
+	// The set is named after the PAR file (without its extension)
+
+	fstl::wstring	path, baseName;
+	splitFilespec(parFilespec(), path, baseName);
+	int	idx = baseName.rfind(_T("."));
+	if (idx > 0) baseName.erase(idx);
+
+	// The volumes: the .par file, then .p01-.p99, .q00-.q99, etc.
+
+	ParityFileArray	parityVolumes;
+	for (unsigned int i = 0; i <= volumeCount(); ++i)
+	{
+		ParityFile	pf;
+		pf.volumeNumber() = i;
+		pf.filePath() = path;
+		pf.fileName() = baseName + _T(".");
+		pf.status() = ParityFile::Valid;
+		pf.statusString() = _T("Just created");
+
+		if (i == 0)
+		{
+			pf.fileName() += _T("par");
+		}
+		else
+		{
+			TCHAR	dsp[10];
+			_stprintf(dsp, _T("%c%02d"), (i / 100) + _T('p'), i % 100);
+			pf.fileName() += dsp;
+		}
+
+		parityVolumes += fstl::move(pf);
+	}
+
+	// The data files (non-recoverable ones first, just like the dialog)
+
+	DataFileArray	dataVolumes;
+	for (unsigned int pass = 0; pass < 2; ++pass)
+	{
+		const fstl::WStringArray &	list = pass ? dataFilespecs() : unprotectedFilespecs();
+		for (unsigned int i = 0; i < list.size(); ++i)
+		{
+			DataFile	df;
+			fstl::wstring	filePath;
+			splitFilespec(list[i], filePath, df.fileName());
+			df.filePath() = filePath;
+
+			if (!doesFileExist(df.filespec()))
+			{
+				fail(_T("File not found: ") + list[i]);
+				return false;
+			}
+
+			df.fileSize() = getFileLength(df.filespec());
+			df.recoverable() = pass ? true:false;
+			df.status() = DataFile::Valid;
+			df.statusString() = _T("Just created");
+			bytes() += df.fileSize();
+			dataVolumes += fstl::move(df);
+		}
+	}
+
+	fileCount() = dataVolumes.size();
+
+	ParityInfo	pi;
+	pi.options() = options();
+	if (!callback()) pi.progress() = &progress();
+
+	unsigned char	setHash[EmDeeFive::HASH_SIZE_IN_BYTES];
+	bool	ok = pi.genParFiles(setHash, parityVolumes, dataVolumes, jobCallback, this);
+	plan() = pi.plan();
+	placement() = pi.placement();
+	stats() = pi.stats();
+	if (!ok)
+	{
+		fail(pi.lastError());
+		return false;
+	}
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::loadSet(ParityInfo & pi)
+{
+	pi.options() = options();
+	if (!callback()) pi.progress() = &progress();
+
+	fstl::wstring	filename = parFilespec();
+	if (pi.loadParFile(filename)) return true;
+
+	fail(pi.lastError().length() ? pi.lastError() : _T("Unable to load ") + parFilespec());
+	return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::verifySet()
+{
+	ParityInfo	pi;
+	if (!loadSet(pi)) return false;
+
+	damaged() = checkSet(pi, false);
+	fileCount() = pi.dataFiles().size() + pi.parityFiles().size();
+	if (damaged()) status() = Damaged;
+
+	recordProblems(pi);
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Repairs the data files. A scrub reads every byte of the set (no shortcuts) and also rebuilds any recovery volumes that have gone
+// bad, so the set is back to full strength afterwards.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::repairSet()
+{
+	ParityInfo	pi;
+	if (!loadSet(pi)) return false;
+
+	// Find out what's broken
+
+	bool		scrub = type() == Scrub;
+	unsigned int	damagedCount = checkSet(pi, scrub);
+	if (cancelled()) return false;
+
+	fileCount() = pi.dataFiles().size() + pi.parityFiles().size();
+
+	if (damagedCount)
+	{
+		fstl::intArray	broken;
+		for (unsigned int i = 0; i < pi.dataFiles().size(); ++i)
+		{
+			if (pi.dataFiles()[i].status() != DataFile::Valid) broken += i;
+		}
+
+		// Fix it
+
+		bool	ok = pi.repairSet(jobCallback, this);
+		plan() = pi.plan();
+		placement() = pi.placement();
+		if (!ok)
+		{
+			damaged() = damagedCount;
+			if (!cancelled()) fail(pi.lastError());
+			recordProblems(pi);
+			return false;
+		}
+
+		// Make sure it worked (every repaired file gets hashed again, however it was repaired)
+
+		for (unsigned int i = 0; i < broken.size(); ++i)
+		{
+			DataFile &	df = pi.dataFiles()[broken[i]];
+			if (doesFileExist(df.filespec())) pi.validateDataFile(broken[i], broken.size(), i, jobCallback, this);
+			else				  df.status() = DataFile::Missing;
+
+			if (df.status() == DataFile::Valid)	bytes() += df.fileSize();
+			else					++damaged();
+		}
+
+		fileCount() = broken.size();
+		status() = damaged() ? Damaged : Repaired;
+	}
+
+	if (scrub && !damaged() && !rebuildVolumes(pi))
+	{
+		recordProblems(pi);
+		return false;
+	}
+
+	recordProblems(pi);
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Regenerates any recovery volume that failed validation (the data must all be valid by now)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	ParityJob::rebuildVolumes(ParityInfo & pi)
+{
+	ParityFileArray	rebuild;
+	for (unsigned int i = 0; i < pi.parityFiles().size(); ++i)
+	{
+		const ParityFile &	pf = pi.parityFiles()[i];
+		if (pf.volumeNumber() && pf.status() != ParityFile::Valid) rebuild += pf;
+	}
+
+	if (!rebuild.size()) return true;
+
+	bool	ok = pi.extendParFiles(rebuild, pi.dataFiles(), jobCallback, this);
+	plan() = pi.plan();
+	placement() = pi.placement();
+	if (!ok)
+	{
+		if (!cancelled()) fail(pi.lastError());
+		return false;
+	}
+
+	for (unsigned int i = 0; i < pi.parityFiles().size(); ++i)
+	{
+		ParityFile &	pf = pi.parityFiles()[i];
+		if (!pf.volumeNumber() || pf.status() == ParityFile::Valid) continue;
+
+		pf.status() = ParityFile::Valid;
+		pf.statusString() = _T("Rebuilt");
+		fileCount()++;
+	}
+
+	status() = Repaired;
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Checks everything in a loaded set (parity volumes first, then the data files), the same way the dialog does. Returns the
+// number of data files that aren't valid. A full check ignores the quick & syndrome shortcuts and hashes every file.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	ParityJob::checkSet(ParityInfo & pi, const bool fullCheck)
+{
+	// The quick check (and its threads) count against the set, like everything else
+
+	EngineStatsScope	statsScope(&pi.stats());
+
+	FileCheckArray	checks;
+	checks.reserve(pi.parityFiles().size() + pi.dataFiles().size());
+
+	// One buffer for every file's name, so checking the set doesn't allocate a path for each one
+
+	fstl::wstring	filespec;
+
+	// Parity volumes
+
+	for (unsigned int i = 0; i < pi.parityFiles().size() && !cancelled(); ++i)
+	{
+		ParityFile &	pf = pi.parityFiles()[i];
+		if (pf.status() == ParityFile::Valid && !fullCheck) continue;
+
+		if (!doesFileExist(pf.filespec(filespec)))
+		{
+			pf.status() = ParityFile::Missing;
+			pf.statusString() = _T("Missing");
+			continue;
+		}
+
+		unsigned int	size = getFileLength(filespec);
+		if (pool())
+		{
+			FileCheck	check = {this, &pi, NULL, &pf, size, Trace::current()};
+			checks += check;
+		}
+		else
+		{
+			pi.validateParFile(i, pi.parityFiles().size(), i, jobCallback, this);
+		}
+		bytes() += size;
+	}
+
+	if (checks.size()) runChecks(*pool(), checks);
+	checks.erase();
+
+	// Syndrome check? (whatever it settles, one way or the other, is skipped below)
+
+	fstl::boolArray	settled;
+	settled.populate(false, pi.dataFiles().size());
+
+	if (pi.options().syndromeCheck() && !fullCheck && !cancelled())
+	{
+		fstl::array<DamageRangeArray>	dataDamage;
+		fstl::array<DamageRangeArray>	parityDamage;
+		DamageRangeArray		unlocated;
+		if (pi.verifySyndromes(pi.parityFiles(), pi.dataFiles(), dataDamage, parityDamage, unlocated, jobCallback, this))
+		{
+			for (unsigned int i = 0; i < pi.dataFiles().size(); ++i)
+			{
+				DataFile &	df = pi.dataFiles()[i];
+				settled[i] = df.status() == DataFile::Valid || df.status() == DataFile::Corrupt;
+				if (settled[i]) bytes() += df.fileSize();
+			}
+		}
+	}
+
+	// Quick check? (anything that fails falls through to the full MD5 check)
+
+	if (pi.options().quickCheck() && pi.blockMap().hasCrcs() && !fullCheck && !cancelled())
+	{
+		fstl::intArray	indices;
+		for (unsigned int i = 0; i < pi.dataFiles().size(); ++i)
+		{
+			if (!settled[i] && doesFileExist(pi.dataFiles()[i].filespec(filespec))) indices += i;
+		}
+
+		fstl::boolArray	passed;
+		pi.blockMap().quickCheck(pi.dataFiles(), indices, passed, jobCallback, this, options().threadLimit());
+
+		for (unsigned int i = 0; i < indices.size(); ++i)
+		{
+			DataFile &	df = pi.dataFiles()[indices[i]];
+			bytes() += df.fileSize();
+			if (!passed[i]) continue;
+
+			df.status() = DataFile::Valid;
+			df.statusString() = _T("Valid (quick check)");
+			settled[indices[i]] = true;
+		}
+	}
+
+	// Everything else gets hashed
+
+	for (unsigned int i = 0; i < pi.dataFiles().size() && !cancelled(); ++i)
+	{
+		DataFile &	df = pi.dataFiles()[i];
+		if (settled[i]) continue;
+
+		if (!doesFileExist(df.filespec(filespec)))
+		{
+			df.status() = DataFile::Missing;
+			df.statusString() = _T("Missing");
+			continue;
+		}
+
+		if (pool())
+		{
+			FileCheck	check = {this, &pi, &df, NULL, df.fileSize(), Trace::current()};
+			checks += check;
+		}
+		else
+		{
+			pi.validateDataFile(i, pi.dataFiles().size(), i, jobCallback, this);
+		}
+		bytes() += df.fileSize();
+	}
+
+	if (checks.size()) runChecks(*pool(), checks);
+
+	unsigned int	damagedCount = 0;
+	for (unsigned int i = 0; i < pi.dataFiles().size(); ++i)
+	{
+		if (pi.dataFiles()[i].status() != DataFile::Valid) ++damagedCount;
+	}
+
+	return damagedCount;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	ParityJob::recordProblems(const ParityInfo & pi)
+{
+	// The engine's stats go with the results
+
+	stats() = pi.stats();
+
+	problemNames().erase();
+	problemStatuses().erase();
+
+	for (unsigned int i = 0; i < pi.dataFiles().size(); ++i)
+	{
+		const DataFile &	df = pi.dataFiles()[i];
+		if (df.status() == DataFile::Valid) continue;
+
+		problemNames() += df.fileName();
+		problemStatuses() += df.statusString();
+	}
+
+	for (unsigned int i = 0; i < pi.parityFiles().size(); ++i)
+	{
+		const ParityFile &	pf = pi.parityFiles()[i];
+		if (pf.status() == ParityFile::Valid) continue;
+
+		problemNames() += pf.fileName();
+		problemStatuses() += pf.statusString();
+	}
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityJob.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,179 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _              _       _        _     
+// |  __ \         (_) |            | |     | |      | |    
+// | |__) |_ _ _ __ _| |_ _   _     | | ___ | |__    | |__  
+// |  ___/ _` | '__| | __| | | |_   | |/ _ \| '_ \   | '_ \ 
+// | |  | (_| | |  | | |_| |_| | |__| | (_) | |_) |_ | | | |
+// |_|   \__,_|_|  |_|\__|\__, |\____/ \___/|_.__/(_)|_| |_|
+//                         __/ |                            
+//                        |___/                             
+//
+// Description:
+//
+//   A single create/verify/repair/scrub operation on a PAR set
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_PARITYJOB
+#define _H_PARITYJOB
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "ParityOptions.h"
+#include "BufferPlan.h"
+#include "Progress.h"
+#include "EngineStats.h"
+
+class	ParityInfo;
+class	WorkPool;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	ParityJob
+{
+public:
+	// Enumerations
+
+		enum			JobType {Create, Verify, Repair, Scrub};
+		enum			JobStatus {Ok, Repaired, Damaged, Error, Cancelled};
+
+	// Construction/Destruction
+
+					ParityJob();
+virtual					~ParityJob();
+
+	// Implementation
+
+virtual		bool			parseCommand(const fstl::wstring & command);
+virtual		int			parseOption(const fstl::WStringArray & args, const unsigned int index);
+virtual		bool			addArgument(const fstl::wstring & arg);
+virtual		bool			isComplete() const;
+virtual		bool			run(progressCallback callback = NULL, void * callbackData = NULL);
+virtual		const	char *		typeName() const;
+virtual		const	char *		statusName() const;
+virtual		fstl::string		fields(const bool json) const;
+virtual		fstl::string		problemFields(const unsigned int index, const bool json) const;
+static		fstl::string		quoted(const fstl::wstring & str);
+
+	// Accessors
+
+inline		JobType &		type()				{return _type;}
+inline	const	JobType			type() const			{return _type;}
+inline		fstl::wstring &		parFilespec()			{return _parFilespec;}
+inline	const	fstl::wstring &		parFilespec() const		{return _parFilespec;}
+inline		fstl::WStringArray &	dataFilespecs()			{return _dataFilespecs;}
+inline	const	fstl::WStringArray &	dataFilespecs() const		{return _dataFilespecs;}
+inline		fstl::WStringArray &	unprotectedFilespecs()		{return _unprotectedFilespecs;}
+inline	const	fstl::WStringArray &	unprotectedFilespecs() const	{return _unprotectedFilespecs;}
+inline		unsigned int &		volumeCount()			{return _volumeCount;}
+inline	const	unsigned int		volumeCount() const		{return _volumeCount;}
+inline		ParityOptions &		options()			{return _options;}
+inline	const	ParityOptions &		options() const			{return _options;}
+inline		fstl::wstring &		traceFilespec()			{return _traceFilespec;}
+inline	const	fstl::wstring &		traceFilespec() const		{return _traceFilespec;}
+
+	// Results (valid after run)
+
+inline		JobStatus &		status()			{return _status;}
+inline	const	JobStatus		status() const			{return _status;}
+inline		unsigned int &		fileCount()			{return _fileCount;}
+inline	const	unsigned int		fileCount() const		{return _fileCount;}
+inline		double &		bytes()				{return _bytes;}
+inline	const	double			bytes() const			{return _bytes;}
+inline		double &		seconds()			{return _seconds;}
+inline	const	double			seconds() const			{return _seconds;}
+inline		unsigned int &		damaged()			{return _damaged;}
+inline	const	unsigned int		damaged() const			{return _damaged;}
+inline		fstl::wstring &		message()			{return _message;}
+inline	const	fstl::wstring &		message() const			{return _message;}
+inline		fstl::WStringArray &	problemNames()			{return _problemNames;}
+inline	const	fstl::WStringArray &	problemNames() const		{return _problemNames;}
+inline		fstl::WStringArray &	problemStatuses()		{return _problemStatuses;}
+inline	const	fstl::WStringArray &	problemStatuses() const		{return _problemStatuses;}
+inline		BufferPlan &		plan()				{return _plan;}
+inline	const	BufferPlan &		plan() const			{return _plan;}
+inline		BufferPlacement &	placement()			{return _placement;}
+inline	const	BufferPlacement &	placement() const		{return _placement;}
+inline		EngineStats &		stats()				{return _stats;}
+inline	const	EngineStats &		stats() const			{return _stats;}
+
+	// Progress (the job passes its own callback to the engine, so it can tell a cancel from a failure.) Run without a callback,
+	// the engine only keeps the progress object up to date, for somebody else to sample -- and to cancel or pause the job with.
+
+inline		progressCallback &	callback()			{return _callback;}
+inline	const	progressCallback	callback() const		{return _callback;}
+inline		void *&			callbackData()			{return _callbackData;}
+inline	const	void *		callbackData() const		{return _callbackData;}
+inline		Progress &		progress()			{return _progress;}
+inline	const	Progress &		progress() const		{return _progress;}
+inline	const	bool			cancelled() const		{return _progress.cancelled();}
+
+	// Optional pool -- if set, the files in a set are checked in parallel (and any callback may come from a pool thread)
+
+inline		WorkPool *&		pool()				{return _pool;}
+inline	const	WorkPool *		pool() const			{return _pool;}
+
+private:
+	// Private implementation
+
+virtual		bool			createSet();
+virtual		bool			loadSet(ParityInfo & pi);
+virtual		bool			verifySet();
+virtual		bool			repairSet();
+virtual		bool			rebuildVolumes(ParityInfo & pi);
+virtual		unsigned int		checkSet(ParityInfo & pi, const bool fullCheck);
+virtual		void			recordProblems(const ParityInfo & pi);
+virtual		void			fail(const fstl::wstring & msg);
+
+	// Data members
+
+		JobType			_type;
+		fstl::wstring		_parFilespec;
+		fstl::WStringArray	_dataFilespecs;
+		fstl::WStringArray	_unprotectedFilespecs;
+		unsigned int		_volumeCount;
+		ParityOptions		_options;
+		fstl::wstring		_traceFilespec;
+
+		JobStatus		_status;
+		unsigned int		_fileCount;
+		double			_bytes;
+		double			_seconds;
+		unsigned int		_damaged;
+		fstl::wstring		_message;
+		fstl::WStringArray	_problemNames;
+		fstl::WStringArray	_problemStatuses;
+		BufferPlan		_plan;
+		BufferPlacement		_placement;
+		EngineStats		_stats;
+
+		progressCallback	_callback;
+		void *			_callbackData;
+		Progress		_progress;
+		WorkPool *		_pool;
+};
+
+typedef	fstl::array<ParityJob>		ParityJobArray;
+
+#endif // _H_PARITYJOB
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityJob.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _          ____        _   _                                     
+// |  __ \         (_) |        / __ \      | | (_)                                    
+// | |__) |_ _ _ __ _| |_ _   _| |  | |_ __ | |_ _  ___  _ __  ___     ___ _ __  _ __  
+// |  ___/ _` | '__| | __| | | | |  | | '_ \| __| |/ _ \| '_ \/ __|   / __| '_ \| '_ \ 
+// | |  | (_| | |  | | |_| |_| | |__| | |_) | |_| | (_) | | | \__ \ _| (__| |_) | |_) |
+// |_|   \__,_|_|  |_|\__|\__, |\____/| .__/ \__|_|\___/|_| |_|___/(_)\___| .__/| .__/ 
+//                         __/ |      | |                                 | |   | |    
+//                        |___/       |_|                                 |_|   |_|    
+//
+// Description:
+//
+//   The settings that steer the parity engine
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "ParityOptions.h"
+#include "LocalParity.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityOptions::ParityOptions()
+	: _memoryPercent(10), _writeBlockMap(true), _fftCodec(false), _localParity(false), _localGroupSize(LocalParity::DEFAULT_GROUP_SIZE),
+	  _localRepair(true), _errorCorrection(true), _quickCheck(false), _syndromeCheck(false), _memoryLimit(0), _threadLimit(0),
+	  _hugePages(LargeBuffer::HugeTransparent), _pinThreads(false)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	ParityOptions::~ParityOptions()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How many bytes the working buffers of a single operation may use, in total. An explicit limit (as handed out by a scheduler
+// that's sharing the machine between several operations) overrides the percentage.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+double	ParityOptions::memoryToUse() const
+{
+	if (memoryLimit() > 0) return memoryLimit();
+
+	double	memPercentage = static_cast<double>(memoryPercent()) / 100;
+	if (memPercentage > 1) memPercentage = 1;
+	return getPhysicalMemory() * memPercentage;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityOptions.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
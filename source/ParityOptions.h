@@ -0,0 +1,107 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____           _ _          ____        _   _                     _     
+// |  __ \         (_) |        / __ \      | | (_)                   | |    
+// | |__) |_ _ _ __ _| |_ _   _| |  | |_ __ | |_ _  ___  _ __  ___    | |__  
+// |  ___/ _` | '__| | __| | | | |  | | '_ \| __| |/ _ \| '_ \/ __|   | '_ \ 
+// | |  | (_| | |  | | |_| |_| | |__| | |_) | |_| | (_) | | | \__ \ _ | | | |
+// |_|   \__,_|_|  |_|\__|\__, |\____/| .__/ \__|_|\___/|_| |_|___/(_)|_| |_|
+//                         __/ |      | |                                    
+//                        |___/       |_|                                    
+//
+// Description:
+//
+//   The settings that steer the parity engine. The dialog fills these in from the registry, the
+//   command-line tool from its arguments; the core itself never goes looking for them.
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_PARITYOPTIONS
+#define _H_PARITYOPTIONS
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "LargeBuffer.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	ParityOptions
+{
+public:
+	// Construction/Destruction
+
+					ParityOptions();
+virtual					~ParityOptions();
+
+	// Implementation
+
+virtual		double			memoryToUse() const;
+
+	// Accessors
+
+inline		unsigned int &		memoryPercent()			{return _memoryPercent;}
+inline	const	unsigned int		memoryPercent() const		{return _memoryPercent;}
+inline		bool &			writeBlockMap()			{return _writeBlockMap;}
+inline	const	bool			writeBlockMap() const		{return _writeBlockMap;}
+inline		bool &			fftCodec()			{return _fftCodec;}
+inline	const	bool			fftCodec() const		{return _fftCodec;}
+inline		bool &			localParity()			{return _localParity;}
+inline	const	bool			localParity() const		{return _localParity;}
+inline		unsigned int &		localGroupSize()		{return _localGroupSize;}
+inline	const	unsigned int		localGroupSize() const		{return _localGroupSize;}
+inline		bool &			localRepair()			{return _localRepair;}
+inline	const	bool			localRepair() const		{return _localRepair;}
+inline		bool &			errorCorrection()		{return _errorCorrection;}
+inline	const	bool			errorCorrection() const		{return _errorCorrection;}
+inline		bool &			quickCheck()			{return _quickCheck;}
+inline	const	bool			quickCheck() const		{return _quickCheck;}
+inline		bool &			syndromeCheck()			{return _syndromeCheck;}
+inline	const	bool			syndromeCheck() const		{return _syndromeCheck;}
+inline		double &		memoryLimit()			{return _memoryLimit;}
+inline	const	double			memoryLimit() const		{return _memoryLimit;}
+inline		unsigned int &		threadLimit()			{return _threadLimit;}
+inline	const	unsigned int		threadLimit() const		{return _threadLimit;}
+inline		LargeBuffer::HugePages &hugePages()			{return _hugePages;}
+inline	const	LargeBuffer::HugePages	hugePages() const		{return _hugePages;}
+inline		bool &			pinThreads()			{return _pinThreads;}
+inline	const	bool			pinThreads() const		{return _pinThreads;}
+
+private:
+	// Data members
+
+		unsigned int		_memoryPercent;
+		bool			_writeBlockMap;
+		bool			_fftCodec;
+		bool			_localParity;
+		unsigned int		_localGroupSize;
+		bool			_localRepair;
+		bool			_errorCorrection;
+		bool			_quickCheck;
+		bool			_syndromeCheck;
+		double			_memoryLimit;
+		unsigned int		_threadLimit;
+		LargeBuffer::HugePages	_hugePages;
+		bool			_pinThreads;
+};
+
+#endif // _H_PARITYOPTIONS
+// ---------------------------------------------------------------------------------------------------------------------------------
+// ParityOptions.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,136 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____  _       _    __                         _     
+// |  __ \| |     | |  / _|                       | |    
+// | |__) | | __ _| |_| |_ ___  _ __ _ __ ___     | |__  
+// |  ___/| |/ _` | __|  _/ _ \| '__| '_ ` _ \    | '_ \ 
+// | |    | | (_| | |_| || (_) | |  | | | | | | _ | | | |
+// |_|    |_|\__,_|\__|_| \___/|_|  |_| |_| |_|(_)|_| |_|
+//                                                       
+//                                                       
+//
+// Description:
+//
+//   Just enough of Win32 and the Microsoft CRT for the core to build under _LINUX (included by stdafx.h
+//   in place of MFC)
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_PLATFORM
+#define _H_PLATFORM
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <wchar.h>
+#include <wctype.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types & macros the core would otherwise get from <windows.h> and <tchar.h> (this build is always Unicode)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	wchar_t		TCHAR;
+typedef	int		BOOL;
+typedef	int		LONG;
+typedef	long long	LONGLONG;
+typedef	unsigned int	DWORD;
+typedef	void *		PVOID;
+
+#define	__int64		long long
+#define	__T(x)		L##x
+#define	_T(x)		__T(x)
+#define	TRUE		1
+#define	FALSE		0
+#define	MAX_PATH	PATH_MAX
+
+// MFC's debug output (which compiles away in release builds anyway)
+
+#define	TRACE(...)
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The wide-character CRT calls the core uses. Filenames are converted with wcstombs(), so the caller should set a (UTF-8) locale
+// with setlocale() for anything outside of ASCII.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+inline	bool	platformNarrow(const wchar_t * src, char * dst, const size_t dstSize)
+{
+	size_t	len = wcstombs(dst, src, dstSize);
+	return len != static_cast<size_t>(-1) && len < dstSize;
+}
+
+inline	FILE *	_wfopen(const wchar_t * filename, const wchar_t * mode)
+{
+	char	name[MAX_PATH], m[16];
+	if (!platformNarrow(filename, name, sizeof(name)) || !platformNarrow(mode, m, sizeof(m))) return static_cast<FILE *>(0);
+	return fopen(name, m);
+}
+
+inline	int	_waccess(const wchar_t * filename, const int mode)
+{
+	char	name[MAX_PATH];
+	if (!platformNarrow(filename, name, sizeof(name))) return -1;
+	return access(name, mode);
+}
+
+inline	int	_wunlink(const wchar_t * filename)
+{
+	char	name[MAX_PATH];
+	if (!platformNarrow(filename, name, sizeof(name))) return -1;
+	return unlink(name);
+}
+
+inline	wchar_t * _wgetcwd(wchar_t * buffer, const int length)
+{
+	char	name[MAX_PATH];
+	if (!getcwd(name, sizeof(name))) return static_cast<wchar_t *>(0);
+	size_t	len = mbstowcs(buffer, name, length);
+	if (len == static_cast<size_t>(-1) || len >= static_cast<size_t>(length)) return static_cast<wchar_t *>(0);
+	return buffer;
+}
+
+// The C99 swprintf() wants the buffer length, which the Microsoft one doesn't. Every caller in the core formats into a fixed-size
+// array, so we can fill it in for them.
+
+#define	swprintf(buffer, ...)	swprintf(buffer, sizeof(buffer) / sizeof(buffer[0]), __VA_ARGS__)
+#define	_stprintf		swprintf
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Interlocked operations (GCC's atomic builtins are full barriers, like the Win32 ones)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+inline	LONG	InterlockedIncrement(volatile LONG * value)				{return __sync_add_and_fetch(value, 1);}
+inline	LONG	InterlockedDecrement(volatile LONG * value)				{return __sync_sub_and_fetch(value, 1);}
+inline	LONG	InterlockedExchangeAdd(volatile LONG * value, const LONG add)		{return __sync_fetch_and_add(value, add);}
+inline	LONGLONG InterlockedExchangeAdd64(volatile LONGLONG * value, const LONGLONG add)	{return __sync_fetch_and_add(value, add);}
+inline	PVOID	InterlockedCompareExchangePointer(PVOID volatile * dest, PVOID exchange, PVOID comparand)
+								{return __sync_val_compare_and_swap(dest, comparand, exchange);}
+
+#endif // _H_PLATFORM
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Platform.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -34,6 +34,7 @@
 #include "FSRaid.h"
 #include "HelpDialog.h"
 #include "PreferencesDialog.h"
+#include "RegInfo.h"
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -0,0 +1,163 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____                                                       
+// |  __ \                                                      
+// | |__) | __ ___   __ _ _ __ ___  ___ ___     ___ _ __  _ __  
+// |  ___/ '__/ _ \ / _` | '__/ _ \/ __/ __|   / __| '_ \| '_ \ 
+// | |   | | | (_) | (_| | | |  __/\__ \__ \ _| (__| |_) | |_) |
+// |_|   |_|  \___/ \__, |_|  \___||___/___/(_)\___| .__/| .__/ 
+//                   __/ |                         | |   | |    
+//                  |___/                          |_|   |_|    
+//
+// Description:
+//
+//   Lock-free progress counters and cancel/pause token, shared by the engine and whoever is watching it
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "Progress.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	Progress::Progress()
+	: _stage(StageIdle), _cancelled(false), _paused(false)
+{
+	restart();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	Progress::Progress(const Progress &)
+	: _stage(StageIdle), _cancelled(false), _paused(false)
+{
+	restart();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	Progress::~Progress()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Clears the counters for another run. A cancel (or pause) sticks, so one that arrives just before the run starts isn't lost.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Progress::restart()
+{
+	for (unsigned int i = 0; i < STAGE_COUNT; ++i)
+	{
+		store(_done[i], 0);
+		store(_total[i], 0);
+	}
+
+	_stage = StageIdle;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Marks the run as over (without checking for a pause, since there's nothing left to hold up)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Progress::finish()
+{
+	_stage = StageDone;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Progress::cancel()
+{
+	_cancelled = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Progress::pause()
+{
+	_paused = true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Progress::resume()
+{
+	_paused = false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How far through the current stage we are
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+float	Progress::percent() const
+{
+	Stage	current = stage();
+	if (current == StageDone) return 100.0f;
+
+	unsigned long long	t = total(current);
+	if (!t) return 0.0f;
+
+	return static_cast<float>(static_cast<double>(fstl::min(done(current), t)) / static_cast<double>(t) * 100.0);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const	char *	Progress::stageName(const Stage stage)
+{
+	switch(stage)
+	{
+		case StageIdle:		return "idle";
+		case StagePlanning:	return "planning";
+		case StageHashing:	return "hashing";
+		case StageEncoding:	return "encoding";
+		case StageWriting:	return "writing";
+		case StageRecovering:	return "recovering";
+		case StageVerifying:	return "verifying";
+		case StageDone:		return "done";
+		default:		break;
+	}
+	return "unknown";
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A paused job just naps; whoever paused it is in no hurry, and a cancel still gets noticed within one nap
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	Progress::waitWhilePaused()
+{
+	while(_paused && !_cancelled)
+	{
+#ifdef	_LINUX
+		usleep(50000);
+#else
+		Sleep(50);
+#endif
+	}
+
+	return !_cancelled;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Progress.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
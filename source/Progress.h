@@ -0,0 +1,142 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____                                       _     
+// |  __ \                                     | |    
+// | |__) | __ ___   __ _ _ __ ___  ___ ___    | |__  
+// |  ___/ '__/ _ \ / _` | '__/ _ \/ __/ __|   | '_ \ 
+// | |   | | | (_) | (_| | | |  __/\__ \__ \ _ | | | |
+// |_|   |_|  \___/ \__, |_|  \___||___/___/(_)|_| |_|
+//                   __/ |                            
+//                  |___/                             
+//
+// Description:
+//
+//   Lock-free progress counters and cancel/pause token, shared by the engine and whoever is watching it
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_PROGRESS
+#define _H_PROGRESS
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How far along a job is, and whether anybody wants it to stop (or wait.)
+//
+// The engine stores counters here as it goes -- a couple of plain stores per block, no formatting and no calls out -- and checks
+// proceed() to find out if it should carry on. Whoever is showing the progress (the dialog, the command line or the daemon)
+// samples it from its own thread, as often as it likes. Nothing here takes a lock.
+//
+// Each stage has its own done/total counters (mostly bytes; a stage reports in whatever units it counts in), so a stage that's
+// finished still shows what it did.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	Progress
+{
+public:
+	// Enumerations
+
+		enum			Stage {StageIdle, StagePlanning, StageHashing, StageEncoding, StageWriting, StageRecovering, StageVerifying,
+					       StageDone, STAGE_COUNT};
+
+	// Construction/Destruction
+
+					Progress();
+					Progress(const Progress & rhs);
+virtual					~Progress();
+
+	// Operators
+
+				// A copied job gets a fresh progress (it belongs to a run, not to the job's settings)
+
+inline		Progress &		operator =(const Progress &) {return *this;}
+
+	// Implementation
+
+virtual		void			restart();
+virtual		void			finish();
+virtual		void			cancel();
+virtual		void			pause();
+virtual		void			resume();
+virtual		float			percent() const;
+static		const	char *		stageName(const Stage stage);
+
+				// Records where 'stage' is up to (making it the current stage), and returns false if we should stop
+
+inline		bool			update(const Stage stage, const double done, const double total)
+					{
+						store(_done[stage], static_cast<unsigned long long>(done));
+						store(_total[stage], static_cast<unsigned long long>(total));
+						_stage = stage;
+						return proceed();
+					}
+
+				// For stages that are worked on by more than one thread at once (the total has to be set first)
+
+inline		bool			add(const Stage stage, const unsigned long long count)
+					{
+						increase(_done[stage], count);
+						_stage = stage;
+						return proceed();
+					}
+
+				// The check the engine makes every block: true to carry on, false if we've been cancelled. While we're
+				// paused, this doesn't return until we're resumed (or cancelled.)
+
+inline		bool			proceed()
+					{
+						if (!_paused) return !_cancelled;
+						return waitWhilePaused();
+					}
+
+	// Accessors
+
+inline		Stage			stage() const			{return static_cast<Stage>(_stage);}
+inline		bool			cancelled() const		{return _cancelled;}
+inline		bool			paused() const			{return _paused;}
+inline		unsigned long long	done(const Stage stage) const	{return load(_done[stage]);}
+inline		unsigned long long	total(const Stage stage) const	{return load(_total[stage]);}
+
+private:
+	// Private implementation
+
+virtual		bool			waitWhilePaused();
+
+	// The counters are 64 bits, which isn't a single store everywhere (so the platform gets to say how)
+
+#ifdef	_LINUX
+static	inline	void			store(volatile unsigned long long & dst, const unsigned long long value) {__atomic_store_n(&dst, value, __ATOMIC_RELAXED);}
+static	inline	unsigned long long	load(const volatile unsigned long long & src) {return __atomic_load_n(&src, __ATOMIC_RELAXED);}
+static	inline	void			increase(volatile unsigned long long & dst, const unsigned long long value) {__atomic_add_fetch(&dst, value, __ATOMIC_RELAXED);}
+#else
+static	inline	void			store(volatile unsigned long long & dst, const unsigned long long value) {InterlockedExchange64(reinterpret_cast<volatile LONGLONG *>(&dst), value);}
+static	inline	unsigned long long	load(const volatile unsigned long long & src) {return InterlockedCompareExchange64(const_cast<volatile LONGLONG *>(reinterpret_cast<const volatile LONGLONG *>(&src)), 0, 0);}
+static	inline	void			increase(volatile unsigned long long & dst, const unsigned long long value) {InterlockedExchangeAdd64(reinterpret_cast<volatile LONGLONG *>(&dst), value);}
+#endif
+
+	// Data members
+
+	volatile unsigned long long	_done[STAGE_COUNT];
+	volatile unsigned long long	_total[STAGE_COUNT];
+	volatile int			_stage;
+	volatile bool			_cancelled;
+	volatile bool			_paused;
+};
+
+#endif // _H_PROGRESS
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Progress.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
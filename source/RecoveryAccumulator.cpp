@@ -0,0 +1,160 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____                                                                           _       _                              
+// |  __ \                                      /\                                 | |     | |                             
+// | |__) |___  ___ _____   _____ _ __ _   _   /  \   ___ ___ _   _ _ __ ___  _   _| | __ _| |_ ___  _ __  ___ _ __  _ __  
+// |  _  // _ \/ __/ _ \ \ / / _ \ '__| | | | / /\ \ / __/ __| | | | '_ ` _ \| | | | |/ _` | __/ _ \| '__|/ __| '_ \| '_ \ 
+// | | \ \  __/ (_| (_) \ V /  __/ |  | |_| |/ ____ \ (_| (__| |_| | | | | | | |_| | | (_| | || (_) | | _| (__| |_) | |_) |
+// |_|  \_\___|\___\___/ \_/ \___|_|   \__, /_/    \_\___\___|\__,_|_| |_| |_|\__,_|_|\__,_|\__\___/|_|(_)\___| .__/| .__/ 
+//                                      __/ |                                                                 | |   | |    
+//                                     |___/                                                                  |_|   |_|    
+//
+// Description:
+//
+//   Accumulates data file contributions to the parity rows
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "RecoveryAccumulator.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	RecoveryAccumulator::RecoveryAccumulator()
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	RecoveryAccumulator::~RecoveryAccumulator()
+{
+	close();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RecoveryAccumulator::open(const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const unsigned int rowCount, const unsigned int recoverableCount)
+{
+	// Start clean
+
+	close();
+
+	if (!rowCount || !recoverableCount) return false;
+
+	// The rows live in the temp directory (not in the download directory, where they'd show up in the directory monitor), and
+	// are named after the set, so two sets don't step on each other
+
+	fstl::wstring	prefix = getTempDirectory();
+	if (prefix.length() && prefix[prefix.length()-1] != PATH_SEPARATOR_CHAR) prefix += PATH_SEPARATOR;
+	prefix += _T("FSRaid-");
+
+	for (unsigned int i = 0; i < EmDeeFive::HASH_SIZE_IN_BYTES; ++i)
+	{
+		TCHAR	hex[3];
+		_stprintf(hex, _T("%02X"), setHash[i]);
+		prefix += hex;
+	}
+
+	// Create the (empty) rows. They grow as data files are folded into them; anything past the end of a row is zero.
+
+	rowFilenames().reserve(rowCount);
+	rowHandles().reserve(rowCount);
+	for (unsigned int i = 0; i < rowCount; ++i)
+	{
+		TCHAR	suffix[16];
+		_stprintf(suffix, _T(".s%02d"), i + 1);
+
+		fstl::wstring	name = prefix + suffix;
+		RangeFile *	file = new RangeFile;
+		if (!file || !file->open(name, true, true))
+		{
+			delete file;
+			close();
+			return false;
+		}
+
+		rowFilenames() += name;
+		rowHandles() += file;
+	}
+
+	folded().populate(false, recoverableCount);
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	RecoveryAccumulator::close()
+{
+	for (unsigned int i = 0; i < rowHandles().size(); ++i)
+	{
+		delete rowHandles()[i];
+		_wunlink(rowFilenames()[i].asArray());
+	}
+
+	rowHandles().erase();
+	rowFilenames().erase();
+	folded().erase();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RecoveryAccumulator::readRow(const unsigned int row, const unsigned int offset, unsigned char * buffer, const unsigned int length)
+{
+	if (row >= rowCount()) return false;
+
+	// A short read just means nothing has been folded in that far, yet
+
+	unsigned int	readCount;
+	if (!rowHandles()[row]->read(offset, buffer, length, readCount)) return false;
+	if (readCount < length) memset(buffer + readCount, 0, length - readCount);
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RecoveryAccumulator::writeRow(const unsigned int row, const unsigned int offset, const unsigned char * buffer, const unsigned int length)
+{
+	if (row >= rowCount()) return false;
+
+	return rowHandles()[row]->write(offset, buffer, length);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	RecoveryAccumulator::foldedCount() const
+{
+	unsigned int	count = 0;
+	for (unsigned int i = 0; i < folded().size(); ++i)
+	{
+		if (folded()[i]) ++count;
+	}
+
+	return count;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// RecoveryAccumulator.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____                                                                           _       _              _     
+// |  __ \                                      /\                                 | |     | |            | |    
+// | |__) |___  ___ _____   _____ _ __ _   _   /  \   ___ ___ _   _ _ __ ___  _   _| | __ _| |_ ___  _ __ | |__  
+// |  _  // _ \/ __/ _ \ \ / / _ \ '__| | | | / /\ \ / __/ __| | | | '_ ` _ \| | | | |/ _` | __/ _ \| '__|| '_ \ 
+// | | \ \  __/ (_| (_) \ V /  __/ |  | |_| |/ ____ \ (_| (__| |_| | | | | | | |_| | | (_| | || (_) | | _ | | | |
+// |_|  \_\___|\___\___/ \_/ \___|_|   \__, /_/    \_\___\___|\__,_|_| |_| |_|\__,_|_|\__,_|\__\___/|_|(_)|_| |_|
+//                                      __/ |                                                                    
+//                                     |___/                                                                     
+//
+// Description:
+//
+//   Accumulates each valid data file's contribution to the parity rows (the syndromes) while a set is still
+//   downloading, so a later repair only needs to read the parity volumes it uses.
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_RECOVERYACCUMULATOR
+#define _H_RECOVERYACCUMULATOR
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "EmDeeFive.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	RecoveryAccumulator
+{
+public:
+	// Construction/Destruction
+
+					RecoveryAccumulator();
+virtual					~RecoveryAccumulator();
+
+	// Implementation
+
+virtual		bool			open(const unsigned char setHash[EmDeeFive::HASH_SIZE_IN_BYTES], const unsigned int rowCount, const unsigned int recoverableCount);
+virtual		void			close();
+virtual		bool			readRow(const unsigned int row, const unsigned int offset, unsigned char * buffer, const unsigned int length);
+virtual		bool			writeRow(const unsigned int row, const unsigned int offset, const unsigned char * buffer, const unsigned int length);
+virtual		unsigned int		foldedCount() const;
+
+	// Accessors
+
+inline		fstl::WStringArray &	rowFilenames()			{return _rowFilenames;}
+inline	const	fstl::WStringArray &	rowFilenames() const		{return _rowFilenames;}
+inline		fstl::array<RangeFile *> & rowHandles()			{return _rowHandles;}
+inline	const	fstl::array<RangeFile *> & rowHandles() const		{return _rowHandles;}
+inline		fstl::boolArray &	folded()			{return _folded;}
+inline	const	fstl::boolArray &	folded() const			{return _folded;}
+
+inline	const	unsigned int		rowCount() const		{return rowHandles().size();}
+inline	const	bool			isOpen() const			{return rowCount() != 0;}
+inline	const	bool			hasRowForVolume(const unsigned int volumeNumber) const {return volumeNumber && volumeNumber <= rowCount();}
+
+private:
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					RecoveryAccumulator(const RecoveryAccumulator & rhs);
+inline		RecoveryAccumulator &	operator =(const RecoveryAccumulator & rhs);
+
+	// Data members
+
+		fstl::WStringArray	_rowFilenames;
+		fstl::array<RangeFile *> _rowHandles;
+		fstl::boolArray		_folded;
+};
+
+#endif // _H_RECOVERYACCUMULATOR
+// ---------------------------------------------------------------------------------------------------------------------------------
+// RecoveryAccumulator.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,184 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____            _____        __                         
+// |  __ \          |_   _|      / _|                        
+// | |__) |___  __ _  | |  _ __ | |_ ___     ___ _ __  _ __  
+// |  _  // _ \/ _` | | | | '_ \|  _/ _ \   / __| '_ \| '_ \ 
+// | | \ \  __/ (_| |_| |_| | | | || (_) |_| (__| |_) | |_) |
+// |_|  \_\___|\__, |_____|_| |_|_| \___/(_)\___| .__/| .__/ 
+//              __/ |                           | |   | |    
+//             |___/                            |_|   |_|    
+//
+// Description:
+//
+//   Archive state persistence in the registry (Windows GUI only)
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaid.h"
+#include "RegInfo.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#define	MAX_ALLOWED 50
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+RegInfoArray	getRegInfo(unsigned int & maxAllowed)
+{
+	// Max size of the data
+
+	maxAllowed = theApp.GetProfileInt(_T("Archive States"), _T("maxAllowed"), MAX_ALLOWED);
+	unsigned int	totalUsed = theApp.GetProfileInt(_T("Archive States"), _T("totalused"), 0);
+	if (totalUsed > maxAllowed) totalUsed = maxAllowed;
+
+	// The information will go here...
+
+	RegInfoArray	ria;
+	ria.reserve(maxAllowed);
+
+	// Get the block of data from the registry
+
+	LPBYTE		data;
+	unsigned int	bytes;
+	if (theApp.GetProfileBinary(_T("Archive States"), _T("data"), &data, &bytes))
+	{
+		// Parse the data into the RegInfo array
+
+		unsigned int *	ptr = reinterpret_cast<unsigned int *>(data);
+
+		for(unsigned int i = 0; i < totalUsed; ++i)
+		{
+			RegInfo	ri;
+
+			ri.lastAccessed = *(ptr++);
+
+			ri.hashCount = *(ptr++);
+			ri.hash.reserve(ri.hashCount);
+
+			ri.dataCount = *(ptr++);
+			ri.data.reserve(ri.dataCount);
+
+			ri.parityCount = *(ptr++);
+			ri.parity.reserve(ri.parityCount);
+
+			unsigned char *	cptr = reinterpret_cast<unsigned char *>(ptr);
+
+			ri.hash.append(reinterpret_cast<const char *>(cptr), ri.hashCount);
+			cptr += ri.hashCount;
+			ri.data.append(reinterpret_cast<const char *>(cptr), ri.dataCount);
+			cptr += ri.dataCount;
+			ri.parity.append(reinterpret_cast<const char *>(cptr), ri.parityCount);
+			cptr += ri.parityCount;
+
+			// Add it to the list
+
+			ria += ri;
+
+			ptr = reinterpret_cast<unsigned int *>(cptr);
+		}
+
+		// Free it
+
+		delete[] data;
+	}
+
+	return ria;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	putRegInfo(const RegInfoArray & ria, const unsigned int maxAllowed)
+{
+	// Build the output data buffer (we need to update it, so we always know the last accessed time)
+
+	fstl::charArray	outputData;
+
+	// Calc reserved size...
+
+	unsigned int	reserveSize = 0;
+	for (unsigned int i = 0; i < ria.size(); ++i)
+	{
+		reserveSize += 16;
+		reserveSize += 16;
+
+		const RegInfo &	ri = ria[i];
+		reserveSize += ri.hash.size();
+		reserveSize += ri.data.size();
+		reserveSize += ri.parity.size();
+	}
+
+	outputData.reserve(reserveSize);
+
+	for (unsigned int i = 0; i < ria.size(); ++i)
+	{
+		const RegInfo &	ri = ria[i];
+		outputData += (ri.lastAccessed >>  0) & 0xff;
+		outputData += (ri.lastAccessed >>  8) & 0xff;
+		outputData += (ri.lastAccessed >> 16) & 0xff;
+		outputData += (ri.lastAccessed >> 24) & 0xff;
+
+		outputData += (ri.hashCount >>  0) & 0xff;
+		outputData += (ri.hashCount >>  8) & 0xff;
+		outputData += (ri.hashCount >> 16) & 0xff;
+		outputData += (ri.hashCount >> 24) & 0xff;
+
+		outputData += (ri.dataCount >>  0) & 0xff;
+		outputData += (ri.dataCount >>  8) & 0xff;
+		outputData += (ri.dataCount >> 16) & 0xff;
+		outputData += (ri.dataCount >> 24) & 0xff;
+
+		outputData += (ri.parityCount >>  0) & 0xff;
+		outputData += (ri.parityCount >>  8) & 0xff;
+		outputData += (ri.parityCount >> 16) & 0xff;
+		outputData += (ri.parityCount >> 24) & 0xff;
+
+		outputData += ri.hash;
+		outputData += ri.data;
+		outputData += ri.parity;
+	}
+
+	// Write the suckers out
+
+	theApp.WriteProfileInt(_T("Archive States"), _T("maxAllowed"), maxAllowed);
+	theApp.WriteProfileInt(_T("Archive States"), _T("totalUsed"), ria.size());
+	theApp.WriteProfileBinary(_T("Archive States"), _T("data"), reinterpret_cast<LPBYTE>(&outputData[0]), outputData.size());
+
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	wipeRegInfo()
+{
+	// Write the suckers out
+
+	theApp.WriteProfileInt(_T("Archive States"), _T("maxAllowed"), MAX_ALLOWED);
+	theApp.WriteProfileInt(_T("Archive States"), _T("totalUsed"), 0);
+	theApp.WriteProfileBinary(_T("Archive States"), _T("data"), reinterpret_cast<LPBYTE>("\0"), 1);
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// RegInfo.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
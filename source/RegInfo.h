@@ -0,0 +1,69 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _____            _____        __         _     
+// |  __ \          |_   _|      / _|       | |    
+// | |__) |___  __ _  | |  _ __ | |_ ___    | |__  
+// |  _  // _ \/ _` | | | | '_ \|  _/ _ \   | '_ \ 
+// | | \ \  __/ (_| |_| |_| | | | || (_) |_ | | | |
+// |_|  \_\___|\__, |_____|_| |_|_| \___/(_)|_| |_|
+//              __/ |                              
+//             |___/                               
+//
+// Description:
+//
+//   Archive state persistence in the registry (Windows GUI only)
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_REGINFO
+#define _H_REGINFO
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	RegInfo
+{
+public:
+
+inline	bool		operator <(RegInfo & rhs) {return lastAccessed < rhs.lastAccessed;}
+inline	bool		operator >(RegInfo & rhs) {return lastAccessed > rhs.lastAccessed;}
+	unsigned int	lastAccessed;
+	unsigned int	hashCount;
+	unsigned int	dataCount;
+	unsigned int	parityCount;
+	fstl::charArray	hash;
+	fstl::charArray	data;
+	fstl::charArray	parity;
+};
+typedef	fstl::array<RegInfo>	RegInfoArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+RegInfoArray	getRegInfo(unsigned int & maxAllowed);
+bool		putRegInfo(const RegInfoArray & ria, const unsigned int maxAllowed);
+void		wipeRegInfo();
+
+#endif // _H_REGINFO
+// ---------------------------------------------------------------------------------------------------------------------------------
+// RegInfo.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,261 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____ _                        _ _____      _   _                         
+//  / ____| |                      | |  __ \    | | | |                        
+// | (___ | |__   __ _ _ __ ___  __| | |__) |_ _| |_| |__      ___ _ __  _ __  
+//  \___ \| '_ \ / _` | '__/ _ \/ _` |  ___/ _` | __| '_ \    / __| '_ \| '_ \ 
+//  ____) | | | | (_| | | |  __/ (_| | |  | (_| | |_| | | | _| (__| |_) | |_) |
+// |_____/|_| |_|\__,_|_|  \___|\__,_|_|   \__,_|\__|_| |_|(_)\___| .__/| .__/ 
+//                                                                | |   | |    
+//                                                                |_|   |_|    
+//
+// Description:
+//
+//   Interned directory paths shared by the files in a set
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "SharedPath.h"
+
+#ifdef	_LINUX
+#include <pthread.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The intern table. An entry's count only drops to zero with the lock held, so a lookup can never hand out one that's on its way
+// out; taking another reference to a path you already hold doesn't need the lock.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+struct	SharedPath::Entry
+{
+	volatile long	references;
+	unsigned int	key;
+	fstl::wstring	path;
+	Entry *		next;
+};
+
+// The lock is never destroyed either (see the table, below)
+
+#ifdef	_LINUX
+static	pthread_mutex_t			internLock = PTHREAD_MUTEX_INITIALIZER;
+
+static	inline	void	lockInterned()		{pthread_mutex_lock(&internLock);}
+static	inline	void	unlockInterned()	{pthread_mutex_unlock(&internLock);}
+#else
+static	class	InternLock
+{
+public:
+	InternLock() {InitializeCriticalSection(&section);}
+
+	CRITICAL_SECTION	section;
+} internLock;
+
+static	inline	void	lockInterned()		{EnterCriticalSection(&internLock.section);}
+static	inline	void	unlockInterned()	{LeaveCriticalSection(&internLock.section);}
+#endif
+
+// Never destroyed, so a file that outlives everything else can still let go of its path
+
+fstl::flathash<SharedPath::Entry *> &	SharedPath::table()
+{
+	static	fstl::flathash<Entry *> *	interned = new fstl::flathash<Entry *>;
+	return *interned;
+}
+
+static	unsigned int	internCount;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	unsigned int	pathKey(const fstl::wstring & path)
+{
+	// FNV-1a
+
+	unsigned int	key = 2166136261u;
+	for (unsigned int i = 0; i < path.length(); ++i)
+	{
+		key ^= static_cast<unsigned int>(path[i]);
+		key *= 16777619u;
+	}
+	return key;
+}
+
+void	SharedPath::addReference(Entry * entry)
+{
+#ifdef	_LINUX
+	__sync_add_and_fetch(&entry->references, 1);
+#else
+	InterlockedIncrement(&entry->references);
+#endif
+}
+
+SharedPath::Entry *	SharedPath::intern(const fstl::wstring & path)
+{
+	if (!path.length()) return NULL;
+
+	// The table lives as long as the process, so it must not come out of an operation's arena
+
+	fstl::arena *	savedArena = fstl::arena::current();
+	fstl::arena::current() = NULL;
+
+	unsigned int	key = pathKey(path);
+
+	lockInterned();
+
+	Entry *&	head = table()[key];
+	Entry *		entry = head;
+	while(entry && entry->path != path) entry = entry->next;
+
+	if (entry)
+	{
+		addReference(entry);
+	}
+	else
+	{
+		entry = new Entry;
+		entry->references = 1;
+		entry->key = key;
+		entry->path = path;
+		entry->next = head;
+		head = entry;
+		++internCount;
+	}
+
+	unlockInterned();
+
+	fstl::arena::current() = savedArena;
+	return entry;
+}
+
+void	SharedPath::release(Entry * entry)
+{
+	if (!entry) return;
+
+	lockInterned();
+
+#ifdef	_LINUX
+	long	remaining = __sync_sub_and_fetch(&entry->references, 1);
+#else
+	long	remaining = InterlockedDecrement(&entry->references);
+#endif
+
+	if (!remaining)
+	{
+		Entry **	link = &table()[entry->key];
+		while(*link != entry) link = &(*link)->next;
+		*link = entry->next;
+		if (!table()[entry->key]) table().remove(entry->key);
+		--internCount;
+		delete entry;
+	}
+
+	unlockInterned();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	SharedPath::SharedPath()
+	: _entry(NULL)
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	SharedPath::SharedPath(const SharedPath & rhs)
+	: _entry(rhs._entry)
+{
+	if (_entry) addReference(_entry);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	SharedPath::SharedPath(const fstl::wstring & path)
+	: _entry(intern(path))
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	SharedPath::~SharedPath()
+{
+	release(_entry);
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+SharedPath &	SharedPath::operator =(const SharedPath & rhs)
+{
+	if (_entry == rhs._entry) return *this;
+	if (rhs._entry) addReference(rhs._entry);
+	release(_entry);
+	_entry = rhs._entry;
+	return *this;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+SharedPath &	SharedPath::operator =(const fstl::wstring & path)
+{
+	if (path == this->path()) return *this;
+	Entry *	entry = intern(path);
+	release(_entry);
+	_entry = entry;
+	return *this;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Builds path + separator + name into 'buffer'. Once the buffer has grown to fit, building into it again doesn't allocate.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const fstl::wstring &	SharedPath::filespec(const fstl::wstring & name, fstl::wstring & buffer) const
+{
+	buffer.reserve(path().length() + 1 + name.length());
+	buffer = path();
+	buffer += PATH_SEPARATOR_CHAR;
+	buffer += name;
+	return buffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	SharedPath::internedCount()
+{
+	lockInterned();
+	unsigned int	count = internCount;
+	unlockInterned();
+	return count;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+const fstl::wstring &	SharedPath::path() const
+{
+	static	const fstl::wstring	empty;
+	if (!_entry) return empty;
+	return _entry->path;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// SharedPath.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____ _                        _ _____      _   _         _     
+//  / ____| |                      | |  __ \    | | | |       | |    
+// | (___ | |__   __ _ _ __ ___  __| | |__) |_ _| |_| |__     | |__  
+//  \___ \| '_ \ / _` | '__/ _ \/ _` |  ___/ _` | __| '_ \    | '_ \ 
+//  ____) | | | | (_| | | |  __/ (_| | |  | (_| | |_| | | | _ | | | |
+// |_____/|_| |_|\__,_|_|  \___|\__,_|_|   \__,_|\__|_| |_|(_)|_| |_|
+//                                                                   
+//                                                                   
+//
+// Description:
+//
+//   Interned directory paths shared by the files in a set
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_SHAREDPATH
+#define _H_SHAREDPATH
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A directory path, interned. Every file in a set lives in one or two directories, so rather than each DataFile and ParityFile
+// carrying its own copy, equal paths share a single reference-counted string. Copying one is just a reference.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	SharedPath
+{
+public:
+	// Construction/Destruction
+
+					SharedPath();
+					SharedPath(const SharedPath & rhs);
+					SharedPath(const fstl::wstring & path);
+					~SharedPath();
+
+	// Operators
+
+		SharedPath &		operator =(const SharedPath & rhs);
+		SharedPath &		operator =(const fstl::wstring & path);
+inline					operator const fstl::wstring &() const	{return path();}
+
+	// Implementation
+
+		const fstl::wstring &	filespec(const fstl::wstring & name, fstl::wstring & buffer) const;
+static		unsigned int		internedCount();
+
+	// Accessors
+
+		const fstl::wstring &	path() const;
+
+private:
+	struct	Entry;
+
+	// Implementation (private)
+
+static		Entry *			intern(const fstl::wstring & path);
+static		void			addReference(Entry * entry);
+static		void			release(Entry * entry);
+static		fstl::flathash<Entry *> &	table();
+
+	// Data members
+
+		Entry *			_entry;
+};
+
+#endif // _H_SHAREDPATH
+// ---------------------------------------------------------------------------------------------------------------------------------
+// SharedPath.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
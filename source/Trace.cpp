@@ -0,0 +1,188 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _______                                     
+// |__   __|                                    
+//    | |_ __ __ _  ___ ___     ___ _ __  _ __  
+//    | | '__/ _` |/ __/ _ \   / __| '_ \| '_ \ 
+//    | | | | (_| | (_|  __/ _| (__| |_) | |_) |
+//    |_|_|  \__,_|\___\___|(_)\___| .__/| .__/ 
+//                                 | |   | |    
+//                                 |_|   |_|    
+//
+// Description:
+//
+//   Timeline of the engine's work, for Chrome/Perfetto
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "Trace.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	volatile LONG	lastSerial = 0;
+static	volatile LONG	lastOwner = 0;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	Trace::Trace()
+	: _serial(static_cast<unsigned int>(InterlockedIncrement(&lastSerial))), _origin(getSeconds())
+{
+#ifdef	_LINUX
+	pthread_mutex_init(&_lock, NULL);
+#else
+	InitializeCriticalSection(&_lock);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	Trace::~Trace()
+{
+	for (unsigned int i = 0; i < _rings.size(); ++i)
+	{
+		delete[] reinterpret_cast<unsigned char *>(_rings[i]);
+	}
+
+#ifdef	_LINUX
+	pthread_mutex_destroy(&_lock);
+#else
+	DeleteCriticalSection(&_lock);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Writes the events as a Chrome trace (each one a complete event, with its thread.) Only call this once the threads that recorded
+// into the trace are done with it.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	Trace::write(const fstl::wstring & filespec) const
+{
+	FILE *	fp = _wfopen(filespec.asArray(), _T("wb"));
+	if (!fp) return false;
+
+	fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"fsraid\"}}");
+
+	lock();
+
+	for (unsigned int i = 0; i < _rings.size(); ++i)
+	{
+		const TraceRing &	ring = *_rings[i];
+
+		// A full ring has lost its oldest events, so the thread's name says how many
+
+		unsigned int	first = ring.count > RING_SIZE ? ring.count - RING_SIZE : 0;
+		if (first)	fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u (%u events dropped)\"}}", ring.thread, ring.thread, first);
+		else		fprintf(fp, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", ring.thread, ring.thread);
+
+		for (unsigned int n = first; n != ring.count; ++n)
+		{
+			const TraceEvent &	e = ring.events[n % RING_SIZE];
+			fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}", e.name, ring.thread, (e.start - _origin) * 1000000.0, (e.end - e.start) * 1000000.0);
+		}
+	}
+
+	unlock();
+
+	fprintf(fp, "\n]}\n");
+
+	bool	ok = !ferror(fp);
+	return fclose(fp) == 0 && ok;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How many events are in the trace (not counting any that were dropped)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+unsigned int	Trace::eventCount() const
+{
+	lock();
+
+	unsigned int	count = 0;
+	for (unsigned int i = 0; i < _rings.size(); ++i)
+	{
+		count += fstl::min(_rings[i]->count, static_cast<unsigned int>(RING_SIZE));
+	}
+
+	unlock();
+	return count;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Finds this thread's ring in the trace (giving it one, the first time it records into it)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Trace::attach()
+{
+	if (!threadOwner()) threadOwner() = static_cast<unsigned int>(InterlockedIncrement(&lastOwner));
+
+	lock();
+
+	TraceRing *	ring = static_cast<TraceRing *>(0);
+	for (unsigned int i = 0; !ring && i < _rings.size(); ++i)
+	{
+		if (_rings[i]->owner == threadOwner()) ring = _rings[i];
+	}
+
+	if (!ring)
+	{
+		ring = reinterpret_cast<TraceRing *>(new unsigned char[sizeof(TraceRing) + (RING_SIZE - 1) * sizeof(TraceEvent)]);
+		ring->owner = threadOwner();
+		ring->thread = _rings.size() + 1;
+		ring->count = 0;
+		_rings += ring;
+	}
+
+	unlock();
+
+	threadRing() = ring;
+	threadSerial() = _serial;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Trace::lock() const
+{
+#ifdef	_LINUX
+	pthread_mutex_lock(&_lock);
+#else
+	EnterCriticalSection(&_lock);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	Trace::unlock() const
+{
+#ifdef	_LINUX
+	pthread_mutex_unlock(&_lock);
+#else
+	LeaveCriticalSection(&_lock);
+#endif
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Trace.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
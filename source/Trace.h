@@ -0,0 +1,207 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//  _______                     _     
+// |__   __|                   | |    
+//    | |_ __ __ _  ___ ___    | |__  
+//    | | '__/ _` |/ __/ _ \   | '_ \ 
+//    | | | | (_| | (_|  __/ _ | | | |
+//    |_|_|  \__,_|\___\___|(_)|_| |_|
+//                                    
+//                                    
+//
+// Description:
+//
+//   Timeline of the engine's work, for Chrome/Perfetto
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_TRACE
+#define _H_TRACE
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef	_LINUX
+#include <pthread.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A timeline of the engine's work -- each read, MD5 batch, GF tile, write and group, on every thread -- written out as a Chrome
+// trace (load it in Perfetto or chrome://tracing) so you can see whether the reads, the compute and the writes overlapped.
+//
+// Like the stats, it's recorded into whichever trace is current on the thread (see TraceScope), so there's nothing to pass around,
+// and nothing to pay when nobody is tracing. Each thread gets its own ring of events the first time it records one, so recording
+// doesn't take a lock; when a ring fills up, the oldest events are overwritten.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	struct	tag_trace_event
+{
+	const	char *		name;
+	double			start;
+	double			end;
+} TraceEvent;
+
+typedef	struct	tag_trace_ring
+{
+	unsigned int		owner;
+	unsigned int		thread;
+	unsigned int		count;
+	TraceEvent		events[1];
+} TraceRing;
+
+typedef	fstl::array<TraceRing *>	TraceRingArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	Trace
+{
+public:
+	// Enumerations
+
+		enum			{RING_SIZE = 32768};
+
+	// Construction/Destruction
+
+					Trace();
+virtual					~Trace();
+
+	// Implementation
+
+virtual		bool			write(const fstl::wstring & filespec) const;
+virtual		unsigned int		eventCount() const;
+
+				// Records an event that ran from 'start' to 'end' (in getSeconds() time.) The name is kept as a pointer, so
+				// it has to be a literal.
+
+inline		void			record(const char * name, const double start, const double end)
+					{
+						if (threadSerial() != _serial) attach();
+
+						TraceRing &	ring = *threadRing();
+						TraceEvent &	e = ring.events[ring.count++ % RING_SIZE];
+						e.name = name;
+						e.start = start;
+						e.end = end;
+					}
+
+				// The trace that this thread's engine work is recorded in (NULL if nobody is tracing)
+
+static	inline	Trace *&		current()
+					{
+						static	FSTL_THREAD_LOCAL	Trace *	threadTrace = static_cast<Trace *>(0);
+						return threadTrace;
+					}
+
+private:
+	// Explicitly disallowed calls
+
+					Trace(const Trace & rhs);
+		Trace &			operator =(const Trace & rhs);
+
+	// Utilitarian (private)
+
+virtual		void			attach();
+virtual		void			lock() const;
+virtual		void			unlock() const;
+
+				// The ring this thread last recorded into, and which trace it belongs to (every trace gets its own serial
+				// number, so a new trace at an old one's address doesn't pick up a ring it has already freed)
+
+static	inline	TraceRing *&		threadRing()
+					{
+						static	FSTL_THREAD_LOCAL	TraceRing *	ring = static_cast<TraceRing *>(0);
+						return ring;
+					}
+
+static	inline	unsigned int &		threadSerial()
+					{
+						static	FSTL_THREAD_LOCAL	unsigned int	serial = 0;
+						return serial;
+					}
+
+				// Which thread this is (a pool thread working for two traced jobs at once goes back and forth between
+				// them, and should find the ring it already has)
+
+static	inline	unsigned int &		threadOwner()
+					{
+						static	FSTL_THREAD_LOCAL	unsigned int	owner = 0;
+						return owner;
+					}
+
+	// Data members
+
+		unsigned int		_serial;
+		double			_origin;
+		TraceRingArray		_rings;
+#ifdef	_LINUX
+	mutable	pthread_mutex_t		_lock;
+#else
+	mutable	CRITICAL_SECTION	_lock;
+#endif
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Records this thread's engine work in 'trace' for as long as it lives (NULL to stop recording)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	TraceScope
+{
+public:
+inline				TraceScope(Trace * trace)
+				: _saved(Trace::current())
+				{
+					Trace::current() = trace;
+				}
+
+inline				~TraceScope()
+				{
+					Trace::current() = _saved;
+				}
+
+private:
+		Trace *			_saved;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Records the time it lives as one event in the current trace (the clock is only read if somebody is tracing)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	TraceSpan
+{
+public:
+inline				TraceSpan(const char * name)
+				: _trace(Trace::current()), _name(name), _start(_trace ? getSeconds() : 0)
+				{
+				}
+
+inline				~TraceSpan()
+				{
+					if (_trace) _trace->record(_name, _start, getSeconds());
+				}
+
+private:
+		Trace *			_trace;
+	const	char *			_name;
+		double			_start;
+};
+
+#endif // _H_TRACE
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Trace.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
@@ -31,8 +31,14 @@
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 #include "stdafx.h"
-#include "FSRaid.h"
+#include "FSRaidCore.h"
 #include "Utils.h"
+#include "EngineStats.h"
+
+#ifdef	_LINUX
+#include <dirent.h>
+#include <fcntl.h>
+#endif
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
@@ -42,12 +48,13 @@
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-#define	MAX_ALLOWED 50
-
-// ---------------------------------------------------------------------------------------------------------------------------------
-
 unsigned int	getFileLength(const fstl::wstring & filename)
 {
+#ifdef	_LINUX
+	struct stat	st;
+	if (stat(fstl::string(filename.asArray()).asArray(), &st)) return 0;
+	return static_cast<unsigned int>(st.st_size);
+#else
 	CFileStatus	status;
 	if (!CFile::GetStatus(filename.asArray(), status)) return 0;
 	return static_cast<unsigned int>(status.m_size);
@@ -57,12 +64,18 @@ unsigned int	getFileLength(const fstl::wstring & filename)
 //	struct _stat	st;
 //	if(_wstat(filename.asArray(), &st)) return 0;
 //	return st.st_size;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 bool	isDirectory(const fstl::wstring & filename)
 {
+#ifdef	_LINUX
+	struct stat	st;
+	if (stat(fstl::string(filename.asArray()).asArray(), &st)) return false;
+	return S_ISDIR(st.st_mode) ? true:false;
+#else
 	CFileStatus	status;
 	if (!CFile::GetStatus(filename.asArray(), status)) return false;
 	return (status.m_attribute & 0x10) ? true:false;
@@ -72,6 +85,7 @@ bool	isDirectory(const fstl::wstring & filename)
 //	struct _stat	st;
 //	if(_wstat(filename.asArray(), &st)) return false;
 //	return (st.st_mode & _S_IFDIR) ? true:false;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -81,199 +95,465 @@ bool	doesFileExist(const fstl::wstring & filename)
 	return _waccess(filename.asArray(), 0) == 0;
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Random access to files up to 4GB (the stdio functions top out at 2GB)
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-void	allowBackgroundProcessing()
+bool	readFileRange(const fstl::wstring & filename, const unsigned int offset, unsigned char * buffer, const unsigned int length)
 {
-	for (int i = 0; i < 10; i++)
-	{
-		MSG	msg;
+	EngineTimer	timer(EngineStats::ReadWait);
+	EngineStats::count(EngineStats::Opens, 1);
+	EngineStats::count(EngineStats::BytesRead, length);
 
-		if (!PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) break;
+#ifdef	_LINUX
+	int	fd = open(fstl::string(filename.asArray()).asArray(), O_RDONLY);
+	if (fd < 0) return false;
 
-		TranslateMessage(&msg);
-		DispatchMessage(&msg);
-	}
+	bool	ok = pread(fd, buffer, length, static_cast<off_t>(offset)) == static_cast<ssize_t>(length);
+
+	close(fd);
+	return ok;
+#else
+	HANDLE	handle = CreateFile(filename.asArray(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE) return false;
+
+	LONG	high = 0;
+	DWORD	br = 0;
+	bool	ok = SetFilePointer(handle, static_cast<LONG>(offset), &high, FILE_BEGIN) == offset && ReadFile(handle, buffer, length, &br, NULL) && br == length;
+
+	CloseHandle(handle);
+	return ok;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-fstl::wstring	sizeString(const unsigned int s)
+bool	writeFileRange(const fstl::wstring & filename, const unsigned int offset, const unsigned char * buffer, const unsigned int length)
 {
-	float	fs = static_cast<float>(s);
+	EngineTimer	timer(EngineStats::Writing);
+	EngineStats::count(EngineStats::BytesWritten, length);
 
-	TCHAR	dsp[90];
-	if (s >= 1024*1024*1024)
-	{
-		swprintf(dsp, _T("%.2fGB"), fs / (1024*1024*1024));
-	}
-	else if (s >= 1024*1024)
-	{
-		swprintf(dsp, _T("%.2fMB"), fs / (1024*1024));
-	}
-	else if (s >= 1024)
+#ifdef	_LINUX
+	int	fd = open(fstl::string(filename.asArray()).asArray(), O_WRONLY|O_CREAT, 0666);
+	if (fd < 0) return false;
+
+	bool	ok = pwrite(fd, buffer, length, static_cast<off_t>(offset)) == static_cast<ssize_t>(length);
+
+	close(fd);
+	return ok;
+#else
+	HANDLE	handle = CreateFile(filename.asArray(), GENERIC_WRITE, 0, NULL, OPEN_ALWAYS, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE) return false;
+
+	LONG	high = 0;
+	DWORD	bw = 0;
+	bool	ok = SetFilePointer(handle, static_cast<LONG>(offset), &high, FILE_BEGIN) == offset && WriteFile(handle, buffer, length, &bw, NULL) && bw == length;
+
+	CloseHandle(handle);
+	return ok;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	RangeFile::RangeFile()
+#ifdef	_LINUX
+	: _fd(-1)
+#else
+	: _handle(INVALID_HANDLE_VALUE)
+#endif
+{
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	RangeFile::~RangeFile()
+{
+	close();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Creating a file (which implies writing it) starts it out empty
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RangeFile::open(const fstl::wstring & filename, const bool writable, const bool create)
+{
+	close();
+	EngineStats::count(EngineStats::Opens, 1);
+
+#ifdef	_LINUX
+	if (create)	_fd = ::open(fstl::string(filename.asArray()).asArray(), O_RDWR|O_CREAT|O_TRUNC, 0666);
+	else		_fd = ::open(fstl::string(filename.asArray()).asArray(), writable ? O_RDWR : O_RDONLY);
+	return _fd >= 0;
+#else
+	if (create)	_handle = CreateFile(filename.asArray(), GENERIC_READ|GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, 0, NULL);
+	else		_handle = CreateFile(filename.asArray(), writable ? GENERIC_READ|GENERIC_WRITE : GENERIC_READ, writable ? 0 : FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	return _handle != INVALID_HANDLE_VALUE;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	RangeFile::close()
+{
+#ifdef	_LINUX
+	if (_fd >= 0) ::close(_fd);
+	_fd = -1;
+#else
+	if (_handle != INVALID_HANDLE_VALUE) CloseHandle(_handle);
+	_handle = INVALID_HANDLE_VALUE;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RangeFile::read(const unsigned int offset, unsigned char * buffer, const unsigned int length)
+{
+	unsigned int	readCount;
+	return read(offset, buffer, length, readCount) && readCount == length;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Reads what there is (up to 'length') -- reading past the end of the file isn't an error, it just comes up short
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RangeFile::read(const unsigned int offset, unsigned char * buffer, const unsigned int length, unsigned int & readCount)
+{
+	EngineTimer	timer(EngineStats::ReadWait);
+	readCount = 0;
+
+#ifdef	_LINUX
+	ssize_t	count = pread(_fd, buffer, length, static_cast<off_t>(offset));
+	if (count < 0) return false;
+	readCount = static_cast<unsigned int>(count);
+#else
+	LONG	high = 0;
+	DWORD	br = 0;
+	if (SetFilePointer(_handle, static_cast<LONG>(offset), &high, FILE_BEGIN) != offset || !ReadFile(_handle, buffer, length, &br, NULL)) return false;
+	readCount = br;
+#endif
+
+	EngineStats::count(EngineStats::BytesRead, readCount);
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	RangeFile::write(const unsigned int offset, const unsigned char * buffer, const unsigned int length)
+{
+	EngineTimer	timer(EngineStats::Writing);
+	EngineStats::count(EngineStats::BytesWritten, length);
+
+#ifdef	_LINUX
+	return pwrite(_fd, buffer, length, static_cast<off_t>(offset)) == static_cast<ssize_t>(length);
+#else
+	LONG	high = 0;
+	DWORD	bw = 0;
+	return SetFilePointer(_handle, static_cast<LONG>(offset), &high, FILE_BEGIN) == offset && WriteFile(_handle, buffer, length, &bw, NULL) && bw == length;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	truncateFile(const fstl::wstring & filename, const unsigned int length)
+{
+#ifdef	_LINUX
+	return truncate(fstl::string(filename.asArray()).asArray(), static_cast<off_t>(length)) == 0;
+#else
+	HANDLE	handle = CreateFile(filename.asArray(), GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+	if (handle == INVALID_HANDLE_VALUE) return false;
+
+	bool	ok = SetFilePointer(handle, length, NULL, FILE_BEGIN) == length && SetEndOfFile(handle);
+
+	CloseHandle(handle);
+	return ok;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Lists the files in a directory named "baseName.*" (just the names, not the full paths)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	findFiles(const fstl::wstring & path, const fstl::wstring & baseName, fstl::WStringArray & names)
+{
+	names.erase();
+
+#ifdef	_LINUX
+	DIR *	dir = opendir(fstl::string(path.asArray()).asArray());
+	if (!dir) return false;
+
+	fstl::wstring	prefix = baseName + _T(".");
+	for (dirent * de = readdir(dir); de; de = readdir(dir))
 	{
-		swprintf(dsp, _T("%.2fKB"), fs / (1024));
+		wchar_t	name[MAX_PATH];
+		size_t	len = mbstowcs(name, de->d_name, MAX_PATH - 1);
+		if (len == static_cast<size_t>(-1)) continue;
+		name[len] = 0;
+
+		if (!wcsncmp(name, prefix.asArray(), prefix.length())) names += fstl::wstring(name);
 	}
-	else
+
+	closedir(dir);
+#else
+	_wfinddata_t	fd;
+	fstl::wstring	filespec = path + PATH_SEPARATOR + baseName + _T(".*");
+	intptr_t	handle = _wfindfirst((TCHAR *) filespec.asArray(), &fd);
+	if (handle <= 0) return false;
+
+	do
 	{
-		swprintf(dsp, _T("%d bytes"), s);
-	}
+		names += fstl::wstring(fd.name);
+	} while (_wfindnext(handle, &fd) == 0);
 
-	return fstl::wstring(dsp);
+	_findclose(handle);
+#endif
+
+	return true;
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-fstl::wstring	getLastErrorString(const DWORD err)
+fstl::wstring	getTempDirectory()
 {
-	LPVOID	lpMsgBuf;
-	FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, NULL, err, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR) &lpMsgBuf, 0, NULL);
-	fstl::wstring	result(reinterpret_cast<TCHAR *>(lpMsgBuf));
-	LocalFree( lpMsgBuf );
-	return result;
+#ifdef	_LINUX
+	const char *	tmp = getenv("TMPDIR");
+	return fstl::wstring(tmp && *tmp ? tmp : "/tmp");
+#else
+	TCHAR	tempPath[MAX_PATH];
+	if (!GetTempPath(MAX_PATH, tempPath)) return fstl::wstring(_T("."));
+	return fstl::wstring(tempPath);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+double	getPhysicalMemory()
+{
+#ifdef	_LINUX
+	return static_cast<double>(sysconf(_SC_PHYS_PAGES)) * static_cast<double>(sysconf(_SC_PAGESIZE));
+#else
+	MEMORYSTATUS	memStat;
+	GlobalMemoryStatus(&memStat);
+	return static_cast<double>(memStat.dwTotalPhys);
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-RegInfoArray	getRegInfo(unsigned int & maxAllowed)
+#ifdef	_LINUX
+static	bool	readKernelNumber(const char * path, const char * key, double & value)
 {
-	// Max size of the data
+	FILE *	fp = fopen(path, "r");
+	if (!fp) return false;
 
-	maxAllowed = theApp.GetProfileInt(_T("Archive States"), _T("maxAllowed"), MAX_ALLOWED);
-	unsigned int	totalUsed = theApp.GetProfileInt(_T("Archive States"), _T("totalused"), 0);
-	if (totalUsed > maxAllowed) totalUsed = maxAllowed;
+	// Either the whole file is the number, or we look for a "key value" line
 
-	// The information will go here...
+	bool	found = false;
+	char	line[256];
+	while(!found && fgets(line, sizeof(line), fp))
+	{
+		char *	ptr = line;
+		if (key)
+		{
+			size_t	len = strlen(key);
+			if (strncmp(line, key, len) || (line[len] != ' ' && line[len] != ':')) continue;
+			ptr += len + 1;
+		}
 
-	RegInfoArray	ria;
-	ria.reserve(maxAllowed);
+		char *	end;
+		value = strtod(ptr, &end);
+		found = end != ptr;
+		if (found && strstr(end, "kB")) value *= 1024;
+		if (!key) break;
+	}
+
+	fclose(fp);
+	return found;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Limits 'available' to the headroom in our own memory cgroup and each of its parents. /proc/self/cgroup tells us where we are in
+// the hierarchy mounted at 'root': the v2 line has an empty controller list, a v1 line names the 'memory' controller among others.
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-	// Get the block of data from the registry
+static	void	limitToCgroup(const char * root, const bool v2, const char * limitName, const char * usageName, const char * inactiveKey, double & available)
+{
+	FILE *	fp = fopen("/proc/self/cgroup", "r");
+	if (!fp) return;
 
-	LPBYTE		data;
-	unsigned int	bytes;
-	if (theApp.GetProfileBinary(_T("Archive States"), _T("data"), &data, &bytes))
+	bool	found = false;
+	char	line[PATH_MAX + 256];
+	while(!found && fgets(line, sizeof(line), fp))
 	{
-		// Parse the data into the RegInfo array
+		// Lines look like "id:controller,controller,...:/path"
 
-		unsigned int *	ptr = reinterpret_cast<unsigned int *>(data);
+		char *	controllers = strchr(line, ':');
+		char *	path = controllers ? strchr(controllers + 1, ':') : NULL;
+		if (!path) continue;
+		*(controllers++) = 0;
+		*(path++) = 0;
 
-		for(unsigned int i = 0; i < totalUsed; ++i)
+		if (v2)
+		{
+			found = !strcmp(line, "0") && !*controllers;
+		}
+		else
 		{
-			RegInfo	ri;
+			char *	save;
+			for (char * tok = strtok_r(controllers, ",", &save); tok && !found; tok = strtok_r(NULL, ",", &save)) found = !strcmp(tok, "memory");
+		}
 
-			ri.lastAccessed = *(ptr++);
+		if (found) memmove(line, path, strlen(path) + 1);
+	}
 
-			ri.hashCount = *(ptr++);
-			ri.hash.reserve(ri.hashCount);
+	fclose(fp);
+	if (!found) return;
 
-			ri.dataCount = *(ptr++);
-			ri.data.reserve(ri.dataCount);
+	// Strip the newline and any trailing slash, so the root cgroup is an empty path
 
-			ri.parityCount = *(ptr++);
-			ri.parity.reserve(ri.parityCount);
+	size_t	len = strcspn(line, "\n");
+	while (len && line[len-1] == '/') --len;
+	line[len] = 0;
 
-			unsigned char *	cptr = reinterpret_cast<unsigned char *>(ptr);
+	// Walk up to the root; whichever level has the least headroom is what we've got
 
-			for (unsigned int i = 0; i < ri.hashCount; ++i)
-			{
-				ri.hash += *(cptr++);
-			}
-			for (unsigned int i = 0; i < ri.dataCount; ++i)
-			{
-				ri.data += *(cptr++);
-			}
-			for (unsigned int i = 0; i < ri.parityCount; ++i)
+	for(;;)
+	{
+		char	file[PATH_MAX * 2];
+		double	limit, usage, inactive;
+
+		snprintf(file, sizeof(file), "%s%s/%s", root, line, limitName);
+		if (readKernelNumber(file, NULL, limit))
+		{
+			snprintf(file, sizeof(file), "%s%s/%s", root, line, usageName);
+			if (readKernelNumber(file, NULL, usage))
 			{
-				ri.parity += *(cptr++);
+				snprintf(file, sizeof(file), "%s%s/memory.stat", root, line);
+				if (readKernelNumber(file, inactiveKey, inactive)) usage -= inactive;
+				available = fstl::min(available, limit - usage);
 			}
+		}
 
-			// Add it to the list
-
-			ria += ri;
+		char *	slash = strrchr(line, '/');
+		if (!slash) break;
+		*slash = 0;
+	}
+}
+#endif
 
-			ptr = reinterpret_cast<unsigned int *>(cptr);
-		}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// How much memory we could use without pushing anything else out. On Linux, that's the kernel's estimate of what's available,
+// further limited by the headroom left in our cgroups (a container's limit is usually far below the machine's memory.) Page cache
+// that the cgroup could drop (its inactive file pages) doesn't count against us.
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-		// Free it
+double	getAvailableMemory()
+{
+#ifdef	_LINUX
+	double	available;
+	if (!readKernelNumber("/proc/meminfo", "MemAvailable", available)) available = getPhysicalMemory();
+
+	limitToCgroup("/sys/fs/cgroup", true, "memory.max", "memory.current", "inactive_file", available);
+	limitToCgroup("/sys/fs/cgroup/memory", false, "memory.limit_in_bytes", "memory.usage_in_bytes", "total_inactive_file", available);
+
+	return fstl::max(available, 0.0);
+#else
+	MEMORYSTATUS	memStat;
+	GlobalMemoryStatus(&memStat);
+	return static_cast<double>(memStat.dwAvailPhys);
+#endif
+}
 
-		delete[] data;
-	}
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-	return ria;
+unsigned int	getProcessorCount()
+{
+#ifdef	_LINUX
+	long	count = sysconf(_SC_NPROCESSORS_ONLN);
+	return count > 0 ? static_cast<unsigned int>(count) : 1;
+#else
+	SYSTEM_INFO	si;
+	GetSystemInfo(&si);
+	return si.dwNumberOfProcessors ? si.dwNumberOfProcessors : 1;
+#endif
 }
 
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A monotonic clock, in seconds (only good for measuring intervals)
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-bool	putRegInfo(const RegInfoArray & ria, const unsigned int maxAllowed)
+double	getSeconds()
 {
-	// Build the output data buffer (we need to update it, so we always know the last accessed time)
+#ifdef	_LINUX
+	timespec	ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) / 1000000000.0;
+#else
+	LARGE_INTEGER	freq, count;
+	if (!QueryPerformanceFrequency(&freq) || !QueryPerformanceCounter(&count)) return static_cast<double>(GetTickCount()) / 1000.0;
+	return static_cast<double>(count.QuadPart) / static_cast<double>(freq.QuadPart);
+#endif
+}
 
-	fstl::charArray	outputData;
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-	// Calc reserved size...
+void	allowBackgroundProcessing()
+{
+	// There's no message pump to keep alive without a UI
 
-	unsigned int	reserveSize = 0;
-	for (unsigned int i = 0; i < ria.size(); ++i)
+#ifndef	_LINUX
+	for (int i = 0; i < 10; i++)
 	{
-		reserveSize += 16;
-		reserveSize += 16;
+		MSG	msg;
+
+		if (!PeekMessage(&msg, NULL, 0, 0, PM_REMOVE)) break;
 
-		const RegInfo &	ri = ria[i];
-		reserveSize += ri.hash.size();
-		reserveSize += ri.data.size();
-		reserveSize += ri.parity.size();
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
 	}
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
 
-	outputData.reserve(reserveSize);
+fstl::wstring	sizeString(const unsigned int s)
+{
+	float	fs = static_cast<float>(s);
 
-	for (unsigned int i = 0; i < ria.size(); ++i)
+	TCHAR	dsp[90];
+	if (s >= 1024*1024*1024)
 	{
-		const RegInfo &	ri = ria[i];
-		outputData += (ri.lastAccessed >>  0) & 0xff;
-		outputData += (ri.lastAccessed >>  8) & 0xff;
-		outputData += (ri.lastAccessed >> 16) & 0xff;
-		outputData += (ri.lastAccessed >> 24) & 0xff;
-
-		outputData += (ri.hashCount >>  0) & 0xff;
-		outputData += (ri.hashCount >>  8) & 0xff;
-		outputData += (ri.hashCount >> 16) & 0xff;
-		outputData += (ri.hashCount >> 24) & 0xff;
-
-		outputData += (ri.dataCount >>  0) & 0xff;
-		outputData += (ri.dataCount >>  8) & 0xff;
-		outputData += (ri.dataCount >> 16) & 0xff;
-		outputData += (ri.dataCount >> 24) & 0xff;
-
-		outputData += (ri.parityCount >>  0) & 0xff;
-		outputData += (ri.parityCount >>  8) & 0xff;
-		outputData += (ri.parityCount >> 16) & 0xff;
-		outputData += (ri.parityCount >> 24) & 0xff;
-
-		outputData += ri.hash;
-		outputData += ri.data;
-		outputData += ri.parity;
+		swprintf(dsp, _T("%.2fGB"), fs / (1024*1024*1024));
+	}
+	else if (s >= 1024*1024)
+	{
+		swprintf(dsp, _T("%.2fMB"), fs / (1024*1024));
+	}
+	else if (s >= 1024)
+	{
+		swprintf(dsp, _T("%.2fKB"), fs / (1024));
+	}
+	else
+	{
+		swprintf(dsp, _T("%d bytes"), s);
 	}
 
-	// Write the suckers out
-
-	theApp.WriteProfileInt(_T("Archive States"), _T("maxAllowed"), maxAllowed);
-	theApp.WriteProfileInt(_T("Archive States"), _T("totalUsed"), ria.size());
-	theApp.WriteProfileBinary(_T("Archive States"), _T("data"), reinterpret_cast<LPBYTE>(&outputData[0]), outputData.size());
-
-	return true;
+	return fstl::wstring(dsp);
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-void	wipeRegInfo()
+fstl::wstring	getLastErrorString(const DWORD err)
 {
-	// Write the suckers out
-
-	theApp.WriteProfileInt(_T("Archive States"), _T("maxAllowed"), MAX_ALLOWED);
-	theApp.WriteProfileInt(_T("Archive States"), _T("totalUsed"), 0);
-	theApp.WriteProfileBinary(_T("Archive States"), _T("data"), reinterpret_cast<LPBYTE>("\0"), 1);
+#ifdef	_LINUX
+	return fstl::wstring(strerror(static_cast<int>(err)));
+#else
+	LPVOID	lpMsgBuf;
+	FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, NULL, err, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR) &lpMsgBuf, 0, NULL);
+	fstl::wstring	result(reinterpret_cast<TCHAR *>(lpMsgBuf));
+	LocalFree( lpMsgBuf );
+	return result;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
@@ -290,6 +570,11 @@ void	stripUnicodeToAscii(fstl::wstring & str)
 
 fstl::wstring oemToAnsi(const fstl::wstring & oemString)
 {
+	// Code pages are a DOS/Windows thing; everywhere else, the names are already what they are
+
+#ifdef	_LINUX
+	return oemString;
+#else
 	// Convert the filename to multibyte
 
 	char	mbBuffer[MAX_PATH * 2];
@@ -302,12 +587,16 @@ fstl::wstring oemToAnsi(const fstl::wstring & oemString)
 
 	fstl::wstring	ansiString = ansiBuffer;
 	return ansiString;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 fstl::wstring ansiToOem(const fstl::wstring & ansiString)
 {
+#ifdef	_LINUX
+	return ansiString;
+#else
 	// Convert the filename to multibyte
 
 	char	mbBuffer[MAX_PATH * 2];
@@ -320,6 +609,7 @@ fstl::wstring ansiToOem(const fstl::wstring & ansiString)
 
 	fstl::wstring	oemString = oemBuffer;
 	return oemString;
+#endif
 }
 
 // ---------------------------------------------------------------------------------------------------------------------------------
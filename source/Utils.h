@@ -41,33 +41,59 @@
 // Types
 // ---------------------------------------------------------------------------------------------------------------------------------
 
-class	RegInfo
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A file held open for random access up to 4GB. readFileRange() & writeFileRange() open the file for every call, which is fine for
+// a header, but not for a pass over a whole volume.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	RangeFile
 {
 public:
+	// Construction/Destruction
+
+				RangeFile();
+virtual				~RangeFile();
+
+	// Implementation
+
+virtual		bool		open(const fstl::wstring & filename, const bool writable, const bool create = false);
+virtual		void		close();
+virtual		bool		read(const unsigned int offset, unsigned char * buffer, const unsigned int length);
+virtual		bool		read(const unsigned int offset, unsigned char * buffer, const unsigned int length, unsigned int & readCount);
+virtual		bool		write(const unsigned int offset, const unsigned char * buffer, const unsigned int length);
+
+private:
+	// Explicitly disallowed calls
+
+				RangeFile(const RangeFile &);
+		RangeFile &	operator =(const RangeFile &);
+
+	// Data members
 
-inline	bool		operator <(RegInfo & rhs) {return lastAccessed < rhs.lastAccessed;}
-inline	bool		operator >(RegInfo & rhs) {return lastAccessed > rhs.lastAccessed;}
-	unsigned int	lastAccessed;
-	unsigned int	hashCount;
-	unsigned int	dataCount;
-	unsigned int	parityCount;
-	fstl::charArray	hash;
-	fstl::charArray	data;
-	fstl::charArray	parity;
+#ifdef	_LINUX
+		int		_fd;
+#else
+		HANDLE		_handle;
+#endif
 };
-typedef	fstl::array<RegInfo>	RegInfoArray;
 
 // ---------------------------------------------------------------------------------------------------------------------------------
 
 unsigned int	getFileLength(const fstl::wstring & filename);
 bool		isDirectory(const fstl::wstring & filename);
 bool		doesFileExist(const fstl::wstring & filename);
+bool		readFileRange(const fstl::wstring & filename, const unsigned int offset, unsigned char * buffer, const unsigned int length);
+bool		writeFileRange(const fstl::wstring & filename, const unsigned int offset, const unsigned char * buffer, const unsigned int length);
+bool		truncateFile(const fstl::wstring & filename, const unsigned int length);
+bool		findFiles(const fstl::wstring & path, const fstl::wstring & baseName, fstl::WStringArray & names);
+fstl::wstring	getTempDirectory();
+double		getPhysicalMemory();
+double		getAvailableMemory();
+unsigned int	getProcessorCount();
+double		getSeconds();
 void		allowBackgroundProcessing();
 fstl::wstring	sizeString(const unsigned int s);
 fstl::wstring	getLastErrorString(const DWORD err);
-RegInfoArray	getRegInfo(unsigned int & maxAllowed);
-bool		putRegInfo(const RegInfoArray & ria, const unsigned int maxAllowed);
-void		wipeRegInfo();
 void		stripUnicodeToAscii(fstl::wstring & str);
 bool		shouldStrip(const fstl::wstring & str);
 bool		doesContainNonASCII(const fstl::wstring & str);
@@ -0,0 +1,456 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+// __          __        _    _____            _                     
+// \ \        / /       | |  |  __ \          | |                    
+//  \ \  /\  / /__  _ __| | _| |__) |__   ___ | |    ___ _ __  _ __  
+//   \ \/  \/ / _ \| '__| |/ /  ___/ _ \ / _ \| |   / __| '_ \| '_ \ 
+//    \  /\  / (_) | |  |   <| |  | (_) | (_) | | _| (__| |_) | |_) |
+//     \/  \/ \___/|_|  |_|\_\_|   \___/ \___/|_|(_)\___| .__/| .__/ 
+//                                                      | |   | |    
+//                                                      |_|   |_|    
+//
+// Description:
+//
+//   A pool of worker threads with per-thread task queues and work stealing
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "WorkPool.h"
+#include "LargeBuffer.h"
+
+#ifdef _DEBUG
+#define new DEBUG_NEW
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Which pool (and queue) the current thread works for, so that tasks submitted from inside a task land on the submitter's own
+// queue, and how deeply the current thread is nested in other groups' tasks while it waits on its own
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef	_LINUX
+#define	THREAD_LOCAL	__thread
+#else
+#define	THREAD_LOCAL	__declspec(thread)
+#endif
+
+static	THREAD_LOCAL	const WorkPool *	currentPool;
+static	THREAD_LOCAL	int			currentQueue;
+static	THREAD_LOCAL	unsigned int		helpDepth;
+
+// A thread that's waiting will run somebody else's task, which may wait in turn... this keeps the stack (and the delay before the
+// original waiter notices its group is done) from growing without bound
+
+static	const	unsigned int	MAX_HELP_DEPTH = 4;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	WorkPool::WorkQueue
+{
+public:
+					WorkQueue() : pool(NULL), index(0)
+					{
+#ifdef	_LINUX
+						pthread_mutex_init(&lock, NULL);
+#else
+						InitializeCriticalSection(&lock);
+#endif
+					}
+					~WorkQueue()
+					{
+#ifdef	_LINUX
+						pthread_mutex_destroy(&lock);
+#else
+						DeleteCriticalSection(&lock);
+#endif
+					}
+
+inline		void			enter()
+					{
+#ifdef	_LINUX
+						pthread_mutex_lock(&lock);
+#else
+						EnterCriticalSection(&lock);
+#endif
+					}
+inline		void			leave()
+					{
+#ifdef	_LINUX
+						pthread_mutex_unlock(&lock);
+#else
+						LeaveCriticalSection(&lock);
+#endif
+					}
+
+		WorkPool *		pool;
+		unsigned int		index;
+		WorkTaskArray		tasks;
+#ifdef	_LINUX
+		pthread_mutex_t		lock;
+#else
+		CRITICAL_SECTION	lock;
+#endif
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	WorkPool::WorkPool()
+	: _threadCount(0), _pinThreads(false), _queues(NULL), _nextQueue(0), _started(0), _stopping(false), _changes(0), _waiting(0)
+{
+#ifdef	_LINUX
+	sem_init(&_wakeup, 0, 0);
+#else
+	_wakeup = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+	WorkPool::~WorkPool()
+{
+	stop();
+
+#ifdef	_LINUX
+	sem_destroy(&_wakeup);
+#else
+	CloseHandle(_wakeup);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Starts the workers (one per CPU if 'threads' is zero.) If no threads can be started at all, tasks simply run as they're submitted.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	WorkPool::start(const unsigned int threads)
+{
+	stop();
+
+	unsigned int	count = threads ? threads : getProcessorCount();
+
+	_queues = new WorkQueue[count];
+	if (!_queues) return false;
+
+#ifdef	_LINUX
+	if (sem_init(&_available, 0, 0))
+	{
+		delete[] _queues;
+		_queues = NULL;
+		return false;
+	}
+#else
+	_available = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+	if (!_available)
+	{
+		delete[] _queues;
+		_queues = NULL;
+		return false;
+	}
+#endif
+
+	_started = 1;
+	_stopping = false;
+	_nextQueue = 0;
+
+	// Threads are numbered as they start, so the queues in use are always 0..threadCount-1
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		WorkQueue &	q = _queues[_threads.size()];
+		q.pool = this;
+		q.index = _threads.size();
+
+#ifdef	_LINUX
+		pthread_t	t;
+		if (!pthread_create(&t, NULL, workerThread, &q)) _threads += t;
+#else
+		DWORD	id;
+		HANDLE	h = CreateThread(NULL, 0, workerThread, &q, 0, &id);
+		if (h) _threads += h;
+#endif
+	}
+
+	_threadCount = _threads.size();
+	return true;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Shuts the workers down. Anything still queued is dropped, so wait on your groups first.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::stop()
+{
+	if (!_started) return;
+
+	_stopping = true;
+	for (unsigned int i = 0; i < _threads.size(); ++i)
+	{
+		releaseTask();
+	}
+
+	for (unsigned int i = 0; i < _threads.size(); ++i)
+	{
+#ifdef	_LINUX
+		pthread_join(_threads[i], NULL);
+#else
+		WaitForSingleObject(_threads[i], INFINITE);
+		CloseHandle(_threads[i]);
+#endif
+	}
+	_threads.erase();
+
+#ifdef	_LINUX
+	sem_destroy(&_available);
+#else
+	CloseHandle(_available);
+#endif
+
+	delete[] _queues;
+	_queues = NULL;
+	_threadCount = 0;
+	_started = 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Queues a task. From inside one of our own tasks, it goes on that worker's queue; otherwise, the queues take turns.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::submit(workFunction function, void * userData, WorkGroup & group)
+{
+	InterlockedIncrement(&group.pending());
+
+	if (!threadCount())
+	{
+		WorkTask	task(function, userData, &group);
+		runTask(task);
+		return;
+	}
+
+	unsigned int	index = currentPool == this ? currentQueue : static_cast<unsigned int>(InterlockedIncrement(&_nextQueue)) % threadCount();
+
+	WorkQueue &	q = _queues[index];
+	q.enter();
+	q.tasks += WorkTask(function, userData, &group);
+	q.leave();
+
+	releaseTask();
+	wakeWaiters();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Returns once every task in the group has finished. Rather than block, the caller runs the group's queued tasks itself (and,
+// if there are none left to run, somebody else's), so waiting from inside a task can't starve the pool. Only when there's nothing
+// it can run does it sleep, until a task is queued or a group finishes.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::wait(WorkGroup & group)
+{
+	int	home = currentPool == this ? currentQueue : -1;
+
+	while(group.pending())
+	{
+		// Anything that changes from here on wakes us up, even if it happens before we get to sleep
+
+		LONG	changes = _changes;
+
+		if (threadCount() && acquireTask())
+		{
+			WorkTask	task;
+			if (takeTask(home, &group, task) || (helpDepth < MAX_HELP_DEPTH && takeTask(home, NULL, task)))
+			{
+				const WorkPool *	savedPool = currentPool;
+				int			savedQueue = currentQueue;
+				currentPool = this;
+				currentQueue = home >= 0 ? home : 0;
+				++helpDepth;
+
+				runTask(task);
+
+				--helpDepth;
+				currentPool = savedPool;
+				currentQueue = savedQueue;
+				continue;
+			}
+
+			// Nothing we're allowed to run; give the slot back for a worker
+
+			releaseTask();
+		}
+
+		// Our group's tasks are all running elsewhere
+
+		InterlockedIncrement(&_waiting);
+		if (group.pending() && _changes == changes)
+		{
+#ifdef	_LINUX
+			while(sem_wait(&_wakeup) && errno == EINTR);
+#else
+			WaitForSingleObject(_wakeup, INFINITE);
+#endif
+		}
+		InterlockedDecrement(&_waiting);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef	_LINUX
+void *	WorkPool::workerThread(void * param)
+#else
+DWORD	WINAPI	WorkPool::workerThread(LPVOID param)
+#endif
+{
+	WorkQueue &	q = *reinterpret_cast<WorkQueue *>(param);
+	q.pool->workerLoop(q.index);
+	return 0;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::workerLoop(const unsigned int index)
+{
+	currentPool = this;
+	currentQueue = index;
+	helpDepth = 0;
+
+	// Worker n lives on CPU n, if asked (so whatever a job allocates stays on the node it runs on)
+
+	if (pinThreads()) LargeBuffer::pinThread(index);
+
+	for(;;)
+	{
+		// Wait for something to do
+
+#ifdef	_LINUX
+		while(sem_wait(&_available) && errno == EINTR);
+#else
+		WaitForSingleObject(_available, INFINITE);
+#endif
+
+		if (_stopping) break;
+
+		// We hold a slot, so there's a task out there with our name on it (somebody may beat us to the first one we see)
+
+		WorkTask	task;
+		while(!takeTask(index, NULL, task));
+		runTask(task);
+	}
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Only call this while holding a slot from acquireTask() (or the semaphore.) Takes the newest task from our own queue, or the
+// oldest one from anybody else's. If 'group' is given, only that group's tasks are considered.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	WorkPool::takeTask(const int home, const WorkGroup * group, WorkTask & task)
+{
+	if (home >= 0)
+	{
+		WorkQueue &	q = _queues[home];
+		q.enter();
+		for (int i = static_cast<int>(q.tasks.size()) - 1; i >= 0; --i)
+		{
+			if (group && q.tasks[i].group() != group) continue;
+
+			task = q.tasks[i];
+			q.tasks.erase(i, 1);
+			q.leave();
+			return true;
+		}
+		q.leave();
+	}
+
+	for (unsigned int n = 0; n < threadCount(); ++n)
+	{
+		unsigned int	index = (static_cast<unsigned int>(home + 1) + n) % threadCount();
+		if (static_cast<int>(index) == home) continue;
+
+		WorkQueue &	q = _queues[index];
+		q.enter();
+		for (unsigned int i = 0; i < q.tasks.size(); ++i)
+		{
+			if (group && q.tasks[i].group() != group) continue;
+
+			task = q.tasks[i];
+			q.tasks.erase(i, 1);
+			q.leave();
+			return true;
+		}
+		q.leave();
+	}
+
+	return false;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// The semaphore counts queued tasks -- whoever takes a count is owed a task
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+bool	WorkPool::acquireTask()
+{
+#ifdef	_LINUX
+	return sem_trywait(&_available) == 0;
+#else
+	return WaitForSingleObject(_available, 0) == WAIT_OBJECT_0;
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::releaseTask()
+{
+#ifdef	_LINUX
+	sem_post(&_available);
+#else
+	ReleaseSemaphore(_available, 1, NULL);
+#endif
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::runTask(WorkTask & task)
+{
+	WorkGroup *	group = task.group();
+	task.function()(task.userData());
+
+	// The waiter may be gone the moment this hits zero, so it's the last thing of theirs we touch
+
+	if (!InterlockedDecrement(&group->pending())) wakeWaiters();
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Wakes everybody sleeping in wait(). The change is counted first, so a waiter that's just about to sleep sees it and doesn't. (A
+// waiter that sees it anyway may leave a wakeup behind, which only costs the next one to sleep another look around.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+void	WorkPool::wakeWaiters()
+{
+	InterlockedIncrement(&_changes);
+
+	LONG	waiting = _waiting;
+	if (waiting <= 0) return;
+
+#ifdef	_LINUX
+	while(waiting--) sem_post(&_wakeup);
+#else
+	ReleaseSemaphore(_wakeup, waiting, NULL);
+#endif
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// WorkPool.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
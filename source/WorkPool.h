@@ -0,0 +1,180 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+// __          __        _    _____            _     _     
+// \ \        / /       | |  |  __ \          | |   | |    
+//  \ \  /\  / /__  _ __| | _| |__) |__   ___ | |   | |__  
+//   \ \/  \/ / _ \| '__| |/ /  ___/ _ \ / _ \| |   | '_ \ 
+//    \  /\  / (_) | |  |   <| |  | (_) | (_) | | _ | | | |
+//     \/  \/ \___/|_|  |_|\_\_|   \___/ \___/|_|(_)|_| |_|
+//                                                         
+//                                                         
+//
+// Description:
+//
+//   A pool of worker threads with per-thread task queues and work stealing
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef	_H_WORKPOOL
+#define _H_WORKPOOL
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Module setup (required includes, macros, etc.)
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#ifdef	_LINUX
+#include <pthread.h>
+#include <semaphore.h>
+#endif
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Types
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+typedef	void	(*workFunction)(void * userData);
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A set of tasks that somebody is waiting on. The count goes up when a task is submitted and down when it finishes.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	WorkGroup
+{
+public:
+	// Construction/Destruction
+
+					WorkGroup() : _pending(0) {}
+
+	// Accessors
+
+inline	volatile LONG &			pending()			{return _pending;}
+inline		LONG			pending() const			{return _pending;}
+
+private:
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					WorkGroup(const WorkGroup & rhs);
+inline		WorkGroup &		operator =(const WorkGroup & rhs);
+
+	// Data members
+
+	volatile LONG			_pending;
+};
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	WorkTask
+{
+public:
+	// Construction/Destruction
+
+					WorkTask() : _function(NULL), _userData(NULL), _group(NULL) {}
+					WorkTask(workFunction f, void * d, WorkGroup * g) : _function(f), _userData(d), _group(g) {}
+
+	// Accessors
+
+inline		workFunction &		function()			{return _function;}
+inline	const	workFunction		function() const		{return _function;}
+inline		void *&			userData()			{return _userData;}
+inline	const	void *			userData() const		{return _userData;}
+inline		WorkGroup *&		group()				{return _group;}
+inline	const	WorkGroup *		group() const			{return _group;}
+
+private:
+	// Data members
+
+		workFunction		_function;
+		void *			_userData;
+		WorkGroup *		_group;
+};
+
+typedef	fstl::array<WorkTask>		WorkTaskArray;
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A fixed set of worker threads, each with its own queue. Workers take their newest task first (it's the one most likely to
+// share a set with what they just did) and, when they run dry, steal the oldest task from somebody else's queue. Anybody waiting
+// on a group helps out by running tasks while it waits, so tasks may freely submit (and wait on) more tasks.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+class	WorkPool
+{
+public:
+	// Construction/Destruction
+
+					WorkPool();
+virtual					~WorkPool();
+
+	// Implementation
+
+virtual		bool			start(const unsigned int threads = 0);
+virtual		void			stop();
+virtual		void			submit(workFunction function, void * userData, WorkGroup & group);
+virtual		void			wait(WorkGroup & group);
+
+	// Accessors
+
+inline	const	unsigned int		threadCount() const		{return _threadCount;}
+inline		bool &			pinThreads()			{return _pinThreads;}
+inline	const	bool			pinThreads() const		{return _pinThreads;}
+
+private:
+	// Private implementation
+
+		class	WorkQueue;
+
+#ifdef	_LINUX
+static		void *			workerThread(void * param);
+#else
+static		DWORD	WINAPI		workerThread(LPVOID param);
+#endif
+virtual		void			workerLoop(const unsigned int index);
+virtual		bool			takeTask(const int home, const WorkGroup * group, WorkTask & task);
+virtual		bool			acquireTask();
+virtual		void			releaseTask();
+virtual		void			runTask(WorkTask & task);
+virtual		void			wakeWaiters();
+
+	// Explicitly disallowed calls (they appear here, because if we don't do this, the compiler will generate them for us)
+
+					WorkPool(const WorkPool & rhs);
+inline		WorkPool &		operator =(const WorkPool & rhs);
+
+	// Data members
+
+		unsigned int		_threadCount;
+		bool			_pinThreads;
+		WorkQueue *		_queues;
+	volatile LONG			_nextQueue;
+	volatile LONG			_started;
+	volatile bool			_stopping;
+	volatile LONG			_changes;
+	volatile LONG			_waiting;
+#ifdef	_LINUX
+		sem_t			_available;
+		sem_t			_wakeup;
+		fstl::array<pthread_t>	_threads;
+#else
+		HANDLE			_available;
+		HANDLE			_wakeup;
+		fstl::array<HANDLE>	_threads;
+#endif
+};
+
+#endif // _H_WORKPOOL
+// ---------------------------------------------------------------------------------------------------------------------------------
+// WorkPool.h - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------
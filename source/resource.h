@@ -26,6 +26,11 @@
 #define MENU_COPY_DATA_FILE             518
 #define MENU_COPY_PARITY_FILE           519
 #define MENU_CANCEL                     520
+#define MENU_EXTEND_PARITY_1            521
+#define MENU_EXTEND_PARITY_2            522
+#define MENU_EXTEND_PARITY_5            523
+#define MENU_EXTEND_PARITY_10           524
+#define MENU_UPDATE_DATA_FILE           525
 #define IDC_CHECK_BUTTON                1000
 #define IDC_CHECKALL_BUTTON             1002
 #define IDC_REPAIR_BUTTON               1003
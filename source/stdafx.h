@@ -4,6 +4,8 @@
 
 #pragma once
 
+#ifndef _LINUX
+
 #ifndef VC_EXTRALEAN
 #define VC_EXTRALEAN		// Exclude rarely-used stuff from Windows headers
 #endif
@@ -40,3 +42,9 @@
 #include <afxcmn.h>			// MFC support for Windows Common Controls
 #endif // _AFX_NO_AFXCMN_SUPPORT
 
+#else // _LINUX
+
+#include "Platform.h"		// The bits of Win32 & the CRT that the core needs, for the command-line build
+
+#endif // _LINUX
+
@@ -0,0 +1,106 @@
+// ---------------------------------------------------------------------------------------------------------------------------------
+//   _____ _        _          _______        _                       
+//  / ____| |      (_)        |__   __|      | |                      
+// | (___ | |_ _ __ _ _ __   __ _| | ___  ___| |_     ___ _ __  _ __  
+//  \___ \| __| '__| | '_ \ / _` | |/ _ \/ __| __|   / __| '_ \| '_ \ 
+//  ____) | |_| |  | | | | | (_| | |  __/\__ \ |_  _| (__| |_) | |_) |
+// |_____/ \__|_|  |_|_| |_|\__, |_|\___||___/\__|(_)\___| .__/| .__/ 
+//                           __/ |                       | |   | |    
+//                          |___/                        |_|   |_|    
+//
+// Description:
+//
+//   Checks for fstl::string's empty and reserved states
+//
+// Notes:
+//
+//   Best viewed with 8-character tabs and (at least) 132 columns
+//
+// History:
+//
+//   10/18/2026: Original creation
+//
+// ---------------------------------------------------------------------------------------------------------------------------------
+// Originally released under a custom license.
+// This historical re-release is provided under the MIT License.
+// See the LICENSE file in the repo root for details.
+//
+// https://github.com/nettlep
+//
+// Copyright 2002, Fluid Studios, all rights reserved.
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+#include "stdafx.h"
+#include "FSRaidCore.h"
+#include "SharedPath.h"
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	unsigned int	failures;
+
+static	void	check(const bool ok, const char * what)
+{
+	if (ok) return;
+	printf("FAILED: %s\n", what);
+	++failures;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+// A reserved string has a buffer before it has anything in it, so it mustn't be told apart from one that has never had a buffer
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	reservedEmptyStrings()
+{
+	fstl::wstring	empty;
+	fstl::wstring	reserved;
+	reserved.reserve(100);
+
+	check(reserved == empty, "a reserved empty string equals a default empty string");
+	check(!(reserved != empty), "a reserved empty string isn't unequal to a default empty string");
+	check(reserved.ncCompare(empty) == 0, "ncCompare of a reserved empty string and a default empty string");
+	check(empty.ncCompare(reserved) == 0, "ncCompare of a default empty string and a reserved empty string");
+	check(reserved == fstl::wstring(_T("")), "a reserved empty string equals \"\"");
+	check(reserved != fstl::wstring(_T("a")), "a reserved empty string doesn't equal \"a\"");
+	check(!(reserved < empty) && !(reserved > empty), "a reserved empty string sorts with a default empty string");
+
+	fstl::wstring	small;
+	small.reserve(4);
+	check(small == empty, "a locally reserved empty string equals a default empty string");
+
+	// Built up into a reserved buffer, then emptied again
+
+	reserved = _T("some/path");
+	reserved.erase();
+	check(reserved == empty, "an emptied string equals a default empty string");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+static	void	sharedPaths()
+{
+	SharedPath	path;
+	path = fstl::wstring(_T("some/path"));
+
+	fstl::wstring	buffer;
+	buffer.reserve(100);
+	path = buffer;
+	check(path.path() == fstl::wstring(), "assigning a reserved empty string clears a shared path");
+
+	path = fstl::wstring(_T("some/path"));
+	check(path.filespec(_T("file"), buffer) == fstl::wstring(_T("some/path") PATH_SEPARATOR _T("file")), "filespec builds into a buffer");
+}
+
+// ---------------------------------------------------------------------------------------------------------------------------------
+
+int	main()
+{
+	reservedEmptyStrings();
+	sharedPaths();
+
+	if (failures) return 1;
+	printf("ok\n");
+	return 0;
+}
+// ---------------------------------------------------------------------------------------------------------------------------------
+// StringTest.cpp - End of file
+// ---------------------------------------------------------------------------------------------------------------------------------